@@ -20,7 +20,7 @@ static T get_angle(const GeomCore::Vector<T, dim>& v1,
     const double clamped = std::max(-1.0, std::min(1.0, cos_theta));
 
     const double theta_rad = std::acos(clamped);
-    return static_cast<T>(radians_to_degrees(theta_rad));
+    return static_cast<T>(GeomCore::radians_to_degrees(theta_rad));
 }
 
 template<class T>
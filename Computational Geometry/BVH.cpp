@@ -0,0 +1,403 @@
+#include "BVH.hpp"
+#include "Parallel.hpp"
+#include "SpaceFillingCurve.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+using namespace GeomCore;
+
+namespace {
+
+    constexpr unsigned bin_count = 16;
+
+    // Nodes this deep split at the object median instead of the SAH, which
+    // bounds the tree depth for any input
+    constexpr unsigned sah_depth = 48;
+
+    // Marks a top-level node that stands in for a subtree built by a worker
+    constexpr uint32_t placeholder = UINT32_MAX;
+
+    template<size_t dim>
+    class builder {
+        public:
+            using node = typename BVH<dim>::node;
+            using box_type = Box<dim>;
+
+            // Primitive box with its index, moved around by the partitions so
+            // that every node's primitives are contiguous in memory
+            struct item {
+                box_type box;
+                uint32_t primitive;
+
+                double centroid(size_t axis) const { return box.lo[axis] + box.hi[axis]; }
+            };
+
+            struct task {
+                size_t begin, end;
+                unsigned depth;
+                std::vector<node> nodes;
+            };
+
+            explicit builder(item* items) : items(items) {}
+
+            // Build the subtree over items[begin..end) into out in depth-first
+            // order and return its root. With tasks set, ranges of at most
+            // cutoff primitives become placeholders for separate builds.
+            uint32_t build(std::vector<node>& out, size_t begin, size_t end, unsigned depth,
+                           std::vector<task>* tasks = nullptr, size_t cutoff = 0) {
+                uint32_t index = static_cast<uint32_t>(out.size());
+                out.push_back({});
+
+                box_type bounds, centers;
+                for (size_t i = begin; i < end; ++i) {
+                    bounds.expand(items[i].box);
+                    for (size_t k = 0; k < dim; ++k) {
+                        centers.lo[k] = std::min(centers.lo[k], items[i].centroid(k));
+                        centers.hi[k] = std::max(centers.hi[k], items[i].centroid(k));
+                    }
+                }
+                out[index].bounds = bounds;
+
+                if (tasks && end - begin <= cutoff) {
+                    out[index].first = static_cast<uint32_t>(tasks->size());
+                    out[index].count = placeholder;
+                    tasks->push_back({begin, end, depth, {}});
+                    return index;
+                }
+
+                size_t mid = end - begin <= BVH<dim>::leaf_size ? begin : split(begin, end, depth, centers);
+                if (mid == begin) {
+                    out[index].first = static_cast<uint32_t>(begin);
+                    out[index].count = static_cast<uint32_t>(end - begin);
+                    return index;
+                }
+
+                build(out, begin, mid, depth + 1, tasks, cutoff);
+                uint32_t right = build(out, mid, end, depth + 1, tasks, cutoff);
+                out[index].first = right;
+                out[index].count = 0;
+                return index;
+            }
+
+        private:
+            // Partition point of items[begin..end), or begin if all centroids
+            // coincide. Centroids are kept doubled (lo + hi) throughout.
+            size_t split(size_t begin, size_t end, unsigned depth, const box_type& centers) {
+                size_t count = end - begin;
+
+                if (depth < sah_depth) {
+                    std::array<double, dim> scale;
+                    for (size_t axis = 0; axis < dim; ++axis) {
+                        double extent = centers.hi[axis] - centers.lo[axis];
+                        scale[axis] = extent > 0.0 ? bin_count / extent : 0.0;
+                    }
+
+                    // One pass fills the bins of every axis
+                    std::array<std::array<box_type, bin_count>, dim> bins;
+                    std::array<std::array<size_t, bin_count>, dim> counts{};
+                    for (size_t i = begin; i < end; ++i) {
+                        for (size_t axis = 0; axis < dim; ++axis) {
+                            unsigned b = bin_of(items[i].centroid(axis), centers.lo[axis], scale[axis]);
+                            ++counts[axis][b];
+                            bins[axis][b].expand(items[i].box);
+                        }
+                    }
+
+                    int best_axis = -1;
+                    unsigned best_bin = 0;
+                    double best_cost = std::numeric_limits<double>::infinity();
+                    for (size_t axis = 0; axis < dim; ++axis) {
+                        if (scale[axis] == 0.0) continue;
+
+                        // Cost of a split before bin b: count times half area on either side
+                        std::array<double, bin_count> right_cost{};
+                        box_type right;
+                        size_t right_count = 0;
+                        for (unsigned b = bin_count - 1; b > 0; --b) {
+                            right.expand(bins[axis][b]);
+                            right_count += counts[axis][b];
+                            right_cost[b] = right.half_area() * right_count;
+                        }
+
+                        box_type left;
+                        size_t left_count = 0;
+                        for (unsigned b = 1; b < bin_count; ++b) {
+                            left.expand(bins[axis][b - 1]);
+                            left_count += counts[axis][b - 1];
+                            if (left_count == 0 || left_count == count) continue;
+                            double cost = left.half_area() * left_count + right_cost[b];
+                            if (cost < best_cost) {
+                                best_cost = cost;
+                                best_axis = static_cast<int>(axis);
+                                best_bin = b;
+                            }
+                        }
+                    }
+
+                    if (best_axis >= 0) {
+                        double lo = centers.lo[best_axis], s = scale[best_axis];
+                        item* mid = std::partition(items + begin, items + end, [&](const item& it) {
+                            return bin_of(it.centroid(best_axis), lo, s) < best_bin;
+                        });
+                        return static_cast<size_t>(mid - items);
+                    }
+                }
+
+                size_t axis = 0;
+                for (size_t k = 1; k < dim; ++k) {
+                    if (centers.hi[k] - centers.lo[k] > centers.hi[axis] - centers.lo[axis]) axis = k;
+                }
+                if (!(centers.hi[axis] > centers.lo[axis])) return begin;
+
+                size_t mid = begin + count / 2;
+                std::nth_element(items + begin, items + mid, items + end, [&](const item& p, const item& q) {
+                    return p.centroid(axis) < q.centroid(axis);
+                });
+                return mid;
+            }
+
+            static unsigned bin_of(double c, double lo, double scale) {
+                return std::min(bin_count - 1, static_cast<unsigned>((c - lo) * scale));
+            }
+
+            item* items;
+    };
+}
+
+/**
+ * @brief Bulk loads the hierarchy over boxes[0..n).
+ *
+ * The top levels are split on the calling thread until each remaining range
+ * is small enough to be one task; the tasks are built concurrently into
+ * their own node arrays and then spliced into the depth-first layout.
+ */
+template<size_t dim>
+void BVH<dim>::build(const box_type* boxes, size_t n, unsigned threads) {
+    if (n >= UINT32_MAX) {
+        throw std::length_error("BVH: too many primitives");
+    }
+
+    tree.clear();
+    order.resize(n);
+    slot_bounds.resize(n);
+    if (n == 0) return;
+    if (threads == 0) threads = default_thread_count();
+
+    using item = typename builder<dim>::item;
+    std::vector<item> items(n);
+    parallel_for(n, [&](size_t i) { items[i] = {boxes[i], static_cast<uint32_t>(i)}; }, threads, 4096);
+
+    builder<dim> b(items.data());
+    tree.reserve(2 * (n / leaf_size) + 1);
+
+    if (threads == 1 || n < 16384) {
+        b.build(tree, 0, n, 0);
+    } else {
+        using task = typename builder<dim>::task;
+        std::vector<node> top;
+        std::vector<task> tasks;
+        b.build(top, 0, n, 0, &tasks, std::max<size_t>(n / (8 * threads), 4096));
+
+        parallel_for(tasks.size(), [&](size_t t) {
+            tasks[t].nodes.reserve(2 * ((tasks[t].end - tasks[t].begin) / leaf_size) + 1);
+            b.build(tasks[t].nodes, tasks[t].begin, tasks[t].end, tasks[t].depth);
+        }, threads);
+
+        auto emit = [&](auto& self, uint32_t i) -> uint32_t {
+            uint32_t index = static_cast<uint32_t>(tree.size());
+            const node& t = top[i];
+            if (t.count == placeholder) {
+                for (node subtree_node : tasks[t.first].nodes) {
+                    if (subtree_node.count == 0) subtree_node.first += index;
+                    tree.push_back(subtree_node);
+                }
+                return index;
+            }
+            tree.push_back(t);
+            if (t.count == 0) {
+                self(self, i + 1);
+                uint32_t right = self(self, t.first);
+                tree[index].first = right;
+            }
+            return index;
+        };
+        emit(emit, 0);
+    }
+
+    parallel_for(n, [&](size_t k) {
+        order[k] = items[k].primitive;
+        slot_bounds[k] = items[k].box;
+    }, threads, 4096);
+}
+
+/**
+ * @brief Recomputes every node box bottom-up from the primitives' new boxes.
+ *
+ * Children follow their parent in the node array, so one reverse pass
+ * updates each inner node after both of its children.
+ */
+template<size_t dim>
+void BVH<dim>::refit(const box_type* boxes, unsigned threads) {
+    parallel_for(order.size(), [&](size_t k) { slot_bounds[k] = boxes[order[k]]; }, threads, 4096);
+
+    parallel_for(tree.size(), [&](size_t i) {
+        node& n = tree[i];
+        if (n.count == 0) return;
+        box_type bounds;
+        for (uint32_t k = n.first; k < n.first + n.count; ++k) bounds.expand(slot_bounds[k]);
+        n.bounds = bounds;
+    }, threads, 4096);
+
+    for (size_t i = tree.size(); i-- > 0;) {
+        node& n = tree[i];
+        if (n.count != 0) continue;
+        n.bounds = tree[i + 1].bounds;
+        n.bounds.expand(tree[n.first].bounds);
+    }
+}
+
+template<size_t dim>
+void BVH<dim>::refit(const std::vector<box_type>& boxes, unsigned threads) {
+    if (boxes.size() != order.size()) {
+        throw std::invalid_argument("BVH::refit: box count differs from the built primitive count");
+    }
+    refit(boxes.data(), threads);
+}
+
+/**
+ * @brief Runs m queries and gathers their candidates into offsets and hits.
+ *
+ * Queries are sorted along a Morton curve over the tree bounds, so that
+ * consecutive queries in a block walk mostly the same nodes while they are
+ * still in cache. Each block collects its candidates locally; the results
+ * are then scattered back to the callers' query order.
+ */
+template<size_t dim>
+template<class Center, class Query>
+void BVH<dim>::batch(size_t m, Center&& center, Query&& query, std::vector<uint32_t>& offsets,
+                     std::vector<uint32_t>& hits, unsigned threads) const {
+    if (m >= UINT32_MAX) {
+        throw std::length_error("BVH: too many queries");
+    }
+
+    offsets.assign(m + 1, 0);
+    hits.clear();
+    if (m == 0) return;
+
+    box_type root = bounds();
+    std::vector<std::pair<uint64_t, uint32_t>> sorted(m);
+    parallel_for(m, [&](size_t i) {
+        sorted[i] = {morton_code<dim>(center(i), root.lo, root.hi), static_cast<uint32_t>(i)};
+    }, threads, 4096);
+    std::sort(sorted.begin(), sorted.end());
+
+    constexpr size_t grain = 256;
+    std::vector<std::vector<uint32_t>> found((m + grain - 1) / grain);
+    parallel_blocks(m, grain, threads, [&](size_t begin, size_t end, unsigned) {
+        auto& out = found[begin / grain];
+        for (size_t j = begin; j < end; ++j) {
+            uint32_t q = sorted[j].second;
+            size_t before = out.size();
+            query(q, [&](uint32_t p) { out.push_back(p); });
+            offsets[q + 1] = static_cast<uint32_t>(out.size() - before);
+        }
+    });
+
+    size_t total = 0;
+    for (size_t i = 0; i < m; ++i) {
+        total += offsets[i + 1];
+        if (total >= UINT32_MAX) {
+            throw std::length_error("BVH: too many query results");
+        }
+        offsets[i + 1] = static_cast<uint32_t>(total);
+    }
+
+    hits.resize(total);
+    parallel_for(found.size(), [&](size_t block) {
+        const uint32_t* from = found[block].data();
+        size_t end = std::min(m, (block + 1) * grain);
+        for (size_t j = block * grain; j < end; ++j) {
+            uint32_t q = sorted[j].second;
+            uint32_t count = offsets[q + 1] - offsets[q];
+            std::copy(from, from + count, hits.begin() + offsets[q]);
+            from += count;
+        }
+    }, threads);
+}
+
+template<size_t dim>
+void BVH<dim>::query(const box_type* boxes, size_t m, std::vector<uint32_t>& offsets,
+                     std::vector<uint32_t>& hits, unsigned threads) const {
+    batch(m,
+          [&](size_t i) {
+              std::array<double, dim> c;
+              for (size_t k = 0; k < dim; ++k) c[k] = boxes[i].center(k);
+              return c;
+          },
+          [&](uint32_t i, auto&& visit) { query(boxes[i], visit); },
+          offsets, hits, threads);
+}
+
+template<size_t dim>
+void BVH<dim>::query(const point_type* points, size_t m, std::vector<uint32_t>& offsets,
+                     std::vector<uint32_t>& hits, unsigned threads) const {
+    batch(m,
+          [&](size_t i) {
+              std::array<double, dim> c;
+              for (size_t k = 0; k < dim; ++k) c[k] = points[i][k];
+              return c;
+          },
+          [&](uint32_t i, auto&& visit) { query(points[i], visit); },
+          offsets, hits, threads);
+}
+
+template<size_t dim>
+void BVH<dim>::intersect(const point_type* origins, const point_type* directions, size_t m, double t_max,
+                         std::vector<uint32_t>& offsets, std::vector<uint32_t>& hits, unsigned threads) const {
+    batch(m,
+          [&](size_t i) {
+              std::array<double, dim> c;
+              for (size_t k = 0; k < dim; ++k) c[k] = origins[i][k];
+              return c;
+          },
+          [&](uint32_t i, auto&& visit) { intersect(origins[i], directions[i], t_max, visit); },
+          offsets, hits, threads);
+}
+
+template class GeomCore::BVH<2>;
+template class GeomCore::BVH<3>;
+
+BoxR2 GeomCore::bounding_box(const SegmentR2& segment) {
+    BoxR2 box;
+    box.expand(segment[0]);
+    box.expand(segment[1]);
+    return box;
+}
+
+BoxR2 GeomCore::bounding_box(const std::vector<PointR2>& points) {
+    BoxR2 box;
+    for (const auto& p : points) box.expand(p);
+    return box;
+}
+
+BoxR3 GeomCore::bounding_box(const std::vector<PointR3>& points) {
+    BoxR3 box;
+    for (const auto& p : points) box.expand(p);
+    return box;
+}
+
+BoxR2 GeomCore::bounding_box(const PolygonR2& polygon) {
+    BoxR2 box;
+    for (const auto& v : polygon.get_vertices()) box.expand(v->point);
+    return box;
+}
+
+BoxR3 GeomCore::bounding_box(const PolygonR3& polygon) {
+    BoxR3 box;
+    for (const auto& v : polygon.get_vertices()) box.expand(v->point);
+    return box;
+}
@@ -0,0 +1,309 @@
+#pragma once
+
+#include "Point.hpp"
+#include "Polygon.hpp"
+#include "SegmentIntersection.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace GeomCore {
+
+    // Axis-aligned box. A default-constructed box is empty (lo > hi) and
+    // grows to fit whatever is added to it.
+    template<size_t dim>
+    struct Box {
+        std::array<double, dim> lo, hi;
+
+        Box() {
+            lo.fill(std::numeric_limits<double>::infinity());
+            hi.fill(-std::numeric_limits<double>::infinity());
+        }
+
+        bool empty() const { return lo[0] > hi[0]; }
+
+        void expand(const Vector<double, dim>& p) {
+            for (size_t k = 0; k < dim; ++k) {
+                lo[k] = std::min(lo[k], p[k]);
+                hi[k] = std::max(hi[k], p[k]);
+            }
+        }
+
+        void expand(const Box& b) {
+            for (size_t k = 0; k < dim; ++k) {
+                lo[k] = std::min(lo[k], b.lo[k]);
+                hi[k] = std::max(hi[k], b.hi[k]);
+            }
+        }
+
+        bool overlaps(const Box& b) const {
+            for (size_t k = 0; k < dim; ++k) {
+                if (b.hi[k] < lo[k] || hi[k] < b.lo[k]) return false;
+            }
+            return true;
+        }
+
+        bool contains(const Vector<double, dim>& p) const {
+            for (size_t k = 0; k < dim; ++k) {
+                if (p[k] < lo[k] || hi[k] < p[k]) return false;
+            }
+            return true;
+        }
+
+        double center(size_t axis) const { return 0.5 * (lo[axis] + hi[axis]); }
+
+        // Half the perimeter in 2D, half the surface area in 3D: proportional
+        // to the chance that a random line crosses the box
+        double half_area() const {
+            if (empty()) return 0.0;
+            double dx = hi[0] - lo[0], dy = hi[1] - lo[1];
+            if constexpr (dim == 2) return dx + dy;
+            else return dx * dy + dy * (hi[2] - lo[2]) + (hi[2] - lo[2]) * dx;
+        }
+
+        // Parameter interval [t_min, t_max] of origin + t * direction clipped
+        // to the box, given the reciprocal of direction (1 / 0 as infinity).
+        // Returns false if the ray misses the box within the interval.
+        bool clip(const Vector<double, dim>& origin, const std::array<double, dim>& inverse,
+                  double& t_min, double& t_max) const {
+            for (size_t k = 0; k < dim; ++k) {
+                double t0 = (lo[k] - origin[k]) * inverse[k];
+                double t1 = (hi[k] - origin[k]) * inverse[k];
+                if (t0 > t1) std::swap(t0, t1);
+                // A ray lying in a slab plane gives NaN, which leaves the interval as is
+                if (t0 > t_min) t_min = t0;
+                if (t1 < t_max) t_max = t1;
+            }
+            return t_min <= t_max;
+        }
+    };
+
+    using BoxR2 = Box<2>;
+    using BoxR3 = Box<3>;
+
+    BoxR2 bounding_box(const SegmentR2& segment);
+    BoxR2 bounding_box(const std::vector<PointR2>& points);
+    BoxR3 bounding_box(const std::vector<PointR3>& points);
+    BoxR2 bounding_box(const PolygonR2& polygon);
+    BoxR3 bounding_box(const PolygonR3& polygon);
+
+    // Bounding volume hierarchy over the boxes of n primitives (segments,
+    // polygons, triangles, planar patches, ...).
+    //
+    // The tree is bulk loaded top-down with the binned surface area
+    // heuristic and stored as one flat array in depth-first order: an inner
+    // node's left child is the next node and only the right child index is
+    // stored, so a traversal mostly walks forward through memory. Leaves hold
+    // up to leaf_size primitives, whose boxes are kept in leaf order.
+    //
+    // Queries report candidate primitives whose boxes meet the query; the
+    // caller runs the exact test (segment crossing, point in polygon, ray
+    // against plane). A visitor returning bool stops the query on false.
+    template<size_t dim>
+    class BVH {
+        public:
+            using point_type = Vector<double, dim>;
+            using box_type = Box<dim>;
+
+            static constexpr uint32_t NONE = UINT32_MAX;
+            static constexpr uint32_t leaf_size = 4;
+
+            struct node {
+                box_type bounds;
+                uint32_t first;   // leaf: first slot in primitives(); inner: right child
+                uint32_t count;   // primitives in a leaf, 0 for an inner node
+            };
+
+            BVH() = default;
+            explicit BVH(const std::vector<box_type>& boxes, unsigned threads = 0) { build(boxes, threads); }
+
+            // Bulk load over boxes[0..n). Subtrees below the top levels are
+            // built on separate threads; threads = 0 uses the hardware
+            // concurrency. The tree does not depend on the thread count.
+            void build(const box_type* boxes, size_t n, unsigned threads = 0);
+            void build(const std::vector<box_type>& boxes, unsigned threads = 0) { build(boxes.data(), boxes.size(), threads); }
+
+            // Refit the tree to moved primitives, keeping its topology:
+            // boxes[i] is the new box of primitive i. Cheap, but queries slow
+            // down if primitives move far from their neighbours; rebuild then.
+            void refit(const box_type* boxes, unsigned threads = 0);
+            void refit(const std::vector<box_type>& boxes, unsigned threads = 0);
+
+            // Primitives whose boxes overlap box, or contain p
+            template<class Visitor>
+            void query(const box_type& box, Visitor&& visit) const;
+            template<class Visitor>
+            void query(const point_type& p, Visitor&& visit) const;
+
+            // Primitives whose boxes meet origin + t * direction, 0 <= t <= t_max
+            template<class Visitor>
+            void intersect(const point_type& origin, const point_type& direction, double t_max, Visitor&& visit) const;
+
+            // Nearest primitive along origin + t * direction, 0 <= t <= t_max.
+            // hit(primitive, t_max) runs the exact test; on a hit before t_max
+            // it lowers t_max to the hit's parameter and returns true. Boxes
+            // are visited near to far and skipped once they start past t_max.
+            // Returns the closest primitive hit, or NONE; t_max ends at its
+            // parameter.
+            template<class Hit>
+            uint32_t closest_hit(const point_type& origin, const point_type& direction, double& t_max, Hit&& hit) const;
+
+            // Batched forms: the candidates of query i are
+            // hits[offsets[i]..offsets[i + 1]). Queries are traversed in
+            // spatially sorted order, blocks of them on separate threads.
+            void query(const box_type* boxes, size_t m, std::vector<uint32_t>& offsets,
+                       std::vector<uint32_t>& hits, unsigned threads = 0) const;
+            void query(const point_type* points, size_t m, std::vector<uint32_t>& offsets,
+                       std::vector<uint32_t>& hits, unsigned threads = 0) const;
+            void intersect(const point_type* origins, const point_type* directions, size_t m, double t_max,
+                           std::vector<uint32_t>& offsets, std::vector<uint32_t>& hits, unsigned threads = 0) const;
+
+            size_t size() const { return order.size(); }
+            bool empty() const { return order.empty(); }
+            box_type bounds() const { return tree.empty() ? box_type() : tree[0].bounds; }
+
+            const std::vector<node>& nodes() const { return tree; }
+            // Primitive index of every leaf slot
+            const std::vector<uint32_t>& primitives() const { return order; }
+
+        private:
+            // Depth bound: splits past a fixed depth fall back to the object
+            // median, which halves the remaining primitives
+            static constexpr size_t max_depth = 96;
+
+            template<class NodeTest, class Visitor>
+            void traverse(NodeTest&& test, Visitor&& visit) const;
+
+            template<class Center, class Query>
+            void batch(size_t m, Center&& center, Query&& query, std::vector<uint32_t>& offsets,
+                       std::vector<uint32_t>& hits, unsigned threads) const;
+
+            std::vector<node> tree;
+            std::vector<uint32_t> order;
+            std::vector<box_type> slot_bounds;
+    };
+
+    using BVH2 = BVH<2>;
+    using BVH3 = BVH<3>;
+
+    template<size_t dim>
+    template<class NodeTest, class Visitor>
+    void BVH<dim>::traverse(NodeTest&& test, Visitor&& visit) const {
+        if (tree.empty() || !test(tree[0].bounds)) return;
+
+        uint32_t stack[max_depth];
+        size_t top = 0;
+        uint32_t current = 0;
+        for (;;) {
+            const node& n = tree[current];
+            if (n.count == 0) {
+                uint32_t left = current + 1, right = n.first;
+                bool hit_left = test(tree[left].bounds), hit_right = test(tree[right].bounds);
+                if (hit_left) {
+                    if (hit_right) stack[top++] = right;
+                    current = left;
+                    continue;
+                }
+                if (hit_right) {
+                    current = right;
+                    continue;
+                }
+            } else {
+                for (uint32_t k = n.first; k < n.first + n.count; ++k) {
+                    if (!test(slot_bounds[k])) continue;
+                    if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, uint32_t>, bool>) {
+                        if (!visit(order[k])) return;
+                    } else {
+                        visit(order[k]);
+                    }
+                }
+            }
+            if (top == 0) return;
+            current = stack[--top];
+        }
+    }
+
+    template<size_t dim>
+    template<class Visitor>
+    void BVH<dim>::query(const box_type& box, Visitor&& visit) const {
+        traverse([&](const box_type& b) { return b.overlaps(box); }, visit);
+    }
+
+    template<size_t dim>
+    template<class Visitor>
+    void BVH<dim>::query(const point_type& p, Visitor&& visit) const {
+        traverse([&](const box_type& b) { return b.contains(p); }, visit);
+    }
+
+    template<size_t dim>
+    template<class Visitor>
+    void BVH<dim>::intersect(const point_type& origin, const point_type& direction, double t_max, Visitor&& visit) const {
+        std::array<double, dim> inverse;
+        for (size_t k = 0; k < dim; ++k) {
+            inverse[k] = direction[k] != 0.0 ? 1.0 / direction[k] : std::numeric_limits<double>::infinity();
+        }
+        traverse([&](const box_type& b) {
+            double t0 = 0.0, t1 = t_max;
+            return b.clip(origin, inverse, t0, t1);
+        }, visit);
+    }
+
+    template<size_t dim>
+    template<class Hit>
+    uint32_t BVH<dim>::closest_hit(const point_type& origin, const point_type& direction, double& t_max, Hit&& hit) const {
+        std::array<double, dim> inverse;
+        for (size_t k = 0; k < dim; ++k) {
+            inverse[k] = direction[k] != 0.0 ? 1.0 / direction[k] : std::numeric_limits<double>::infinity();
+        }
+        // Parameter where the ray enters b, or NaN if it misses b before t_max
+        auto entry = [&](const box_type& b) {
+            double t0 = 0.0, t1 = t_max;
+            return b.clip(origin, inverse, t0, t1) ? t0 : std::numeric_limits<double>::quiet_NaN();
+        };
+
+        uint32_t closest = NONE;
+        if (tree.empty() || std::isnan(entry(tree[0].bounds))) return closest;
+
+        struct pending {
+            uint32_t node;
+            double t;
+        };
+        pending stack[max_depth];
+        size_t top = 0;
+        uint32_t current = 0;
+        for (;;) {
+            const node& n = tree[current];
+            if (n.count == 0) {
+                uint32_t near = current + 1, far = n.first;
+                double t_near = entry(tree[near].bounds), t_far = entry(tree[far].bounds);
+                if (std::isnan(t_near) || t_far < t_near) {
+                    std::swap(near, far);
+                    std::swap(t_near, t_far);
+                }
+                if (!std::isnan(t_near)) {
+                    if (!std::isnan(t_far)) stack[top++] = {far, t_far};
+                    current = near;
+                    continue;
+                }
+            } else {
+                for (uint32_t k = n.first; k < n.first + n.count; ++k) {
+                    if (!std::isnan(entry(slot_bounds[k])) && hit(order[k], t_max)) closest = order[k];
+                }
+            }
+            // Entries pushed before t_max shrank may now be out of reach
+            do {
+                if (top == 0) return closest;
+                --top;
+            } while (stack[top].t > t_max);
+            current = stack[top].node;
+        }
+    }
+
+    extern template class BVH<2>;
+    extern template class BVH<3>;
+}
@@ -0,0 +1,852 @@
+#include "ConvexHull.hpp"
+#include "Parallel.hpp"
+#include "Predicates.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+using namespace GeomCore;
+
+namespace {
+
+    constexpr uint32_t NONE = UINT32_MAX;
+
+    // Points per block of the filter pass and of the parallel partitions
+    constexpr size_t block_size = 1 << 14;
+
+    // Point sets smaller than this are partitioned on one thread
+    constexpr size_t parallel_cutoff = 1 << 16;
+
+    void check_count(size_t n) {
+        if (n >= NONE) {
+            throw std::length_error("Too many points for a convex hull");
+        }
+    }
+
+    // Coordinates of an array of points
+    template<size_t dim, class Point>
+    struct interleaved {
+        const Point* points;
+
+        std::array<double, dim> operator()(size_t i) const {
+            std::array<double, dim> p;
+            for (size_t k = 0; k < dim; ++k) p[k] = points[i][k];
+            return p;
+        }
+
+        // Coordinate k of points [begin, end), gathered into buffer
+        const double* column(size_t k, size_t begin, size_t end, std::vector<double>& buffer) const {
+            buffer.resize(end - begin);
+            for (size_t i = begin; i < end; ++i) buffer[i - begin] = points[i][k];
+            return buffer.data();
+        }
+    };
+
+    // Coordinates of a point cloud, one array per axis
+    template<size_t dim>
+    struct columns {
+        std::array<const double*, dim> axis;
+
+        std::array<double, dim> operator()(size_t i) const {
+            std::array<double, dim> p;
+            for (size_t k = 0; k < dim; ++k) p[k] = axis[k][i];
+            return p;
+        }
+
+        const double* column(size_t k, size_t begin, size_t, std::vector<double>&) const {
+            return axis[k] + begin;
+        }
+    };
+
+    template<class Source>
+    double orient(const Source& source, uint32_t a, uint32_t b, uint32_t c) {
+        auto p = source(a), q = source(b), r = source(c);
+        return orient2d(p[0], p[1], q[0], q[1], r[0], r[1]);
+    }
+
+    bool lexicographic_less(const std::array<double, 2>& p, uint32_t i, const std::array<double, 2>& q, uint32_t j) {
+        if (p[0] != q[0]) return p[0] < q[0];
+        if (p[1] != q[1]) return p[1] < q[1];
+        return i < j;
+    }
+
+    /**
+     * @brief Andrew's monotone chain over the points named in ids.
+     *
+     * Sorts ids by x, then y, drops repeated points, and builds the lower
+     * chain left to right and the upper chain right to left, popping every
+     * point that does not make a strict left turn.
+     */
+    template<class Source>
+    void monotone_chain(const Source& source, std::vector<uint32_t>& ids, std::vector<uint32_t>& hull) {
+        hull.clear();
+        std::sort(ids.begin(), ids.end(), [&](uint32_t i, uint32_t j) {
+            return lexicographic_less(source(i), i, source(j), j);
+        });
+        ids.erase(std::unique(ids.begin(), ids.end(), [&](uint32_t i, uint32_t j) {
+            return source(i) == source(j);
+        }), ids.end());
+        if (ids.size() < 3) {
+            hull = ids;
+            return;
+        }
+
+        for (uint32_t p : ids) {
+            while (hull.size() >= 2 && orient(source, hull[hull.size() - 2], hull.back(), p) <= 0.0) hull.pop_back();
+            hull.push_back(p);
+        }
+        size_t lower = hull.size();
+        for (size_t i = ids.size() - 1; i-- > 0;) {
+            while (hull.size() > lower && orient(source, hull[hull.size() - 2], hull.back(), ids[i]) <= 0.0) hull.pop_back();
+            hull.push_back(ids[i]);
+        }
+        hull.pop_back();
+    }
+
+    /**
+     * @brief QuickHull over the points named in work, which it reorders.
+     *
+     * The lexicographically extreme points a and b split the rest into the
+     * points right of a -> b and right of b -> a. Each side is refined by
+     * its farthest point c from the chord: points right of a -> c or c -> b
+     * carry on, the rest lie in the triangle a, c, b and are dropped. Sides
+     * are ranges of work, partitioned in place, and processed from an
+     * explicit stack so the emitted points come out in hull order.
+     *
+     * Farthest points are chosen with rounded distances and may be slightly
+     * off, which can leave a point on the hull boundary in the output; a
+     * final monotone chain over the few emitted points removes it.
+     */
+    template<class Source>
+    void quickhull_2d(const Source& source, std::vector<uint32_t>& work, std::vector<uint32_t>& hull, unsigned threads) {
+        hull.clear();
+        if (work.empty()) return;
+        bool parallel = threads != 1;
+
+        auto first_last = [&](size_t begin, size_t end) {
+            std::array<uint32_t, 2> r{work[begin], work[begin]};
+            for (size_t i = begin + 1; i < end; ++i) {
+                uint32_t p = work[i];
+                auto c = source(p);
+                if (lexicographic_less(c, p, source(r[0]), r[0])) r[0] = p;
+                if (lexicographic_less(source(r[1]), r[1], c, p)) r[1] = p;
+            }
+            return r;
+        };
+
+        std::array<uint32_t, 2> ends;
+        if (parallel && work.size() >= parallel_cutoff) {
+            std::vector<std::array<uint32_t, 2>> partial((work.size() + block_size - 1) / block_size);
+            parallel_blocks(work.size(), block_size, threads, [&](size_t begin, size_t end, unsigned) {
+                partial[begin / block_size] = first_last(begin, end);
+            });
+            ends = partial[0];
+            for (const auto& r : partial) {
+                if (lexicographic_less(source(r[0]), r[0], source(ends[0]), ends[0])) ends[0] = r[0];
+                if (lexicographic_less(source(ends[1]), ends[1], source(r[1]), r[1])) ends[1] = r[1];
+            }
+        } else {
+            ends = first_last(0, work.size());
+        }
+        uint32_t a = ends[0], b = ends[1];
+        if (source(a) == source(b)) {
+            hull.push_back(a);
+            return;
+        }
+
+        // Point of work[begin..end) farthest right of the line a -> b
+        auto farthest = [&](uint32_t a, uint32_t b, size_t begin, size_t end) {
+            auto p = source(a), q = source(b);
+            double dx = q[0] - p[0], dy = q[1] - p[1];
+            double best = std::numeric_limits<double>::infinity();
+            uint32_t c = work[begin];
+            for (size_t i = begin; i < end; ++i) {
+                auto r = source(work[i]);
+                double d = dx * (r[1] - p[1]) - dy * (r[0] - p[0]);
+                if (d < best) {
+                    best = d;
+                    c = work[i];
+                }
+            }
+            return std::pair<double, uint32_t>(best, c);
+        };
+
+        std::vector<std::vector<uint32_t>> firsts, seconds;
+
+        // Reorder work[begin..end) into the points right of a -> c, then
+        // those right of c -> b; returns how many of each there are
+        auto split = [&](uint32_t a, uint32_t c, uint32_t b, size_t begin, size_t end) {
+            auto first = [&](uint32_t p) { return orient(source, a, c, p) < 0.0; };
+            auto second = [&](uint32_t p) { return orient(source, c, b, p) < 0.0; };
+
+            if (!parallel || end - begin < parallel_cutoff) {
+                auto mid = std::partition(work.begin() + begin, work.begin() + end, first);
+                auto last = std::partition(mid, work.begin() + end, second);
+                return std::pair<size_t, size_t>(mid - work.begin() - begin, last - mid);
+            }
+
+            size_t blocks = (end - begin + block_size - 1) / block_size;
+            firsts.assign(blocks, {});
+            seconds.assign(blocks, {});
+            parallel_blocks(end - begin, block_size, threads, [&](size_t lo, size_t hi, unsigned) {
+                auto& f = firsts[lo / block_size];
+                auto& s = seconds[lo / block_size];
+                for (size_t i = begin + lo; i < begin + hi; ++i) {
+                    uint32_t p = work[i];
+                    if (first(p)) f.push_back(p);
+                    else if (second(p)) s.push_back(p);
+                }
+            });
+            size_t out = begin;
+            for (const auto& f : firsts) out = std::copy(f.begin(), f.end(), work.begin() + out) - work.begin();
+            size_t mid = out;
+            for (const auto& s : seconds) out = std::copy(s.begin(), s.end(), work.begin() + out) - work.begin();
+            return std::pair<size_t, size_t>(mid - begin, out - mid);
+        };
+
+        // A step refines the side right of a -> b held in work[begin..end),
+        // or with a == NONE emits b
+        struct step {
+            uint32_t a, b;
+            size_t begin, end;
+        };
+
+        auto [lower, upper] = split(a, b, a, 0, work.size());
+        std::vector<uint32_t> emitted{a};
+        std::vector<step> stack{{b, a, lower, lower + upper}, {NONE, b, 0, 0}, {a, b, 0, lower}};
+
+        while (!stack.empty()) {
+            step s = stack.back();
+            stack.pop_back();
+            if (s.a == NONE) {
+                emitted.push_back(s.b);
+                continue;
+            }
+            if (s.begin == s.end) continue;
+
+            uint32_t c;
+            if (parallel && s.end - s.begin >= parallel_cutoff) {
+                size_t blocks = (s.end - s.begin + block_size - 1) / block_size;
+                std::vector<std::pair<double, uint32_t>> partial(blocks);
+                parallel_blocks(s.end - s.begin, block_size, threads, [&](size_t lo, size_t hi, unsigned) {
+                    partial[lo / block_size] = farthest(s.a, s.b, s.begin + lo, s.begin + hi);
+                });
+                auto best = partial[0];
+                for (const auto& r : partial) {
+                    if (r.first < best.first) best = r;
+                }
+                c = best.second;
+            } else {
+                c = farthest(s.a, s.b, s.begin, s.end).second;
+            }
+
+            auto [left, right] = split(s.a, c, s.b, s.begin, s.end);
+            stack.push_back({c, s.b, s.begin + left, s.begin + left + right});
+            stack.push_back({NONE, c, 0, 0});
+            stack.push_back({s.a, c, s.begin, s.begin + left});
+        }
+
+        monotone_chain(source, emitted, hull);
+    }
+
+    /**
+     * @brief QuickHull in 3D after Barber, Dobkin and Huhdanpaa, "The
+     * Quickhull Algorithm for Convex Hulls" (1996).
+     *
+     * Every point outside the current hull sits in the conflict list of one
+     * face it sees. The farthest point of a face's list is added: the faces
+     * it sees are found by a walk from that face, replaced by a fan of
+     * triangles from the point to their boundary (the horizon), and their
+     * conflict points are handed to the new faces or dropped. A point sees a
+     * face only if orient3d says it is strictly outside, so coplanar points
+     * never create faces.
+     */
+    template<class Source>
+    class quickhull_3d {
+        public:
+            quickhull_3d(const Source& source, const uint32_t* ids, size_t m) : source(source), ids(ids), m(m) {}
+
+            // Returns false if the points are coplanar
+            bool build(unsigned threads);
+
+            // Counter-clockwise faces, as indices into the source
+            void output(std::vector<IndexTriangle>& out) const {
+                out.clear();
+                for (const auto& f : faces) {
+                    if (f.alive) out.push_back({ids[f.v[0]], ids[f.v[1]], ids[f.v[2]]});
+                }
+            }
+
+        private:
+            // Face with corners v[0], v[1], v[2]; adj[i] is the face across
+            // the edge v[i] -> v[i + 1]. The rounded plane normal . p = offset
+            // only ranks conflict points by distance.
+            struct face {
+                std::array<uint32_t, 3> v, adj;
+                std::array<double, 3> normal;
+                double offset;
+                uint32_t conflicts = NONE;
+                uint32_t eye = NONE;
+                double eye_distance = 0.0;
+                uint32_t mark = 0;
+                bool visible = false;
+                bool alive = true;
+            };
+
+            std::array<double, 3> point(uint32_t l) const { return source(ids[l]); }
+
+            bool sees(const face& f, uint32_t l) const {
+                return orient3d(PointR3(point(f.v[0])), PointR3(point(f.v[1])), PointR3(point(f.v[2])), PointR3(point(l))) < 0.0;
+            }
+
+            bool collinear(uint32_t a, uint32_t b, uint32_t c) const {
+                auto p = point(a), q = point(b), r = point(c);
+                return orient2d(p[0], p[1], q[0], q[1], r[0], r[1]) == 0.0 &&
+                       orient2d(p[1], p[2], q[1], q[2], r[1], r[2]) == 0.0 &&
+                       orient2d(p[0], p[2], q[0], q[2], r[0], r[2]) == 0.0;
+            }
+
+            uint32_t add_face(uint32_t a, uint32_t b, uint32_t c);
+            void add_conflict(uint32_t f, uint32_t l);
+            bool initial_simplex(std::array<uint32_t, 4>& simplex) const;
+            void add_point(uint32_t f);
+
+            const Source& source;
+            const uint32_t* ids;
+            size_t m;
+
+            std::vector<face> faces;
+            std::vector<uint32_t> free_faces, pending;
+            std::vector<uint32_t> next_conflict;
+            std::vector<uint32_t> visible, created, starts_at, ends_at;
+            uint32_t stamp = 0;
+    };
+
+    template<class Source>
+    uint32_t quickhull_3d<Source>::add_face(uint32_t a, uint32_t b, uint32_t c) {
+        face f;
+        f.v = {a, b, c};
+        f.adj = {NONE, NONE, NONE};
+        auto p = point(a), q = point(b), r = point(c);
+        std::array<double, 3> e{q[0] - p[0], q[1] - p[1], q[2] - p[2]};
+        std::array<double, 3> g{r[0] - p[0], r[1] - p[1], r[2] - p[2]};
+        f.normal = {e[1] * g[2] - e[2] * g[1], e[2] * g[0] - e[0] * g[2], e[0] * g[1] - e[1] * g[0]};
+        f.offset = f.normal[0] * p[0] + f.normal[1] * p[1] + f.normal[2] * p[2];
+
+        if (!free_faces.empty()) {
+            uint32_t id = free_faces.back();
+            free_faces.pop_back();
+            faces[id] = f;
+            return id;
+        }
+        faces.push_back(f);
+        return static_cast<uint32_t>(faces.size() - 1);
+    }
+
+    template<class Source>
+    void quickhull_3d<Source>::add_conflict(uint32_t id, uint32_t l) {
+        face& f = faces[id];
+        auto p = point(l);
+        double d = f.normal[0] * p[0] + f.normal[1] * p[1] + f.normal[2] * p[2] - f.offset;
+        next_conflict[l] = f.conflicts;
+        f.conflicts = l;
+        if (f.eye == NONE || d > f.eye_distance) {
+            f.eye = l;
+            f.eye_distance = d;
+        }
+    }
+
+    /**
+     * @brief Four points spanning a tetrahedron, positively oriented.
+     *
+     * Takes the extremes along the widest axis, the point farthest from
+     * their line and the point farthest from the plane of the three, by
+     * rounded distances; any choice that the exact tests reject falls back
+     * to the first point that passes them.
+     */
+    template<class Source>
+    bool quickhull_3d<Source>::initial_simplex(std::array<uint32_t, 4>& s) const {
+        std::array<uint32_t, 3> lo{0, 0, 0}, hi{0, 0, 0};
+        for (uint32_t l = 1; l < m; ++l) {
+            auto p = point(l);
+            for (size_t k = 0; k < 3; ++k) {
+                if (p[k] < point(lo[k])[k]) lo[k] = l;
+                if (p[k] > point(hi[k])[k]) hi[k] = l;
+            }
+        }
+        size_t axis = 0;
+        double widest = -1.0;
+        for (size_t k = 0; k < 3; ++k) {
+            double extent = point(hi[k])[k] - point(lo[k])[k];
+            if (extent > widest) {
+                widest = extent;
+                axis = k;
+            }
+        }
+        if (!(widest > 0.0)) return false;
+        s[0] = lo[axis];
+        s[1] = hi[axis];
+
+        auto a = point(s[0]), b = point(s[1]);
+        std::array<double, 3> e{b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        double best = -1.0;
+        s[2] = NONE;
+        for (uint32_t l = 0; l < m; ++l) {
+            auto p = point(l);
+            double x = p[0] - a[0], y = p[1] - a[1], z = p[2] - a[2];
+            double cx = e[1] * z - e[2] * y, cy = e[2] * x - e[0] * z, cz = e[0] * y - e[1] * x;
+            double d = cx * cx + cy * cy + cz * cz;
+            if (d > best) {
+                best = d;
+                s[2] = l;
+            }
+        }
+        if (collinear(s[0], s[1], s[2])) {
+            s[2] = NONE;
+            for (uint32_t l = 0; l < m && s[2] == NONE; ++l) {
+                if (!collinear(s[0], s[1], l)) s[2] = l;
+            }
+            if (s[2] == NONE) return false;
+        }
+
+        auto c = point(s[2]);
+        std::array<double, 3> g{c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        std::array<double, 3> n{e[1] * g[2] - e[2] * g[1], e[2] * g[0] - e[0] * g[2], e[0] * g[1] - e[1] * g[0]};
+        best = -1.0;
+        s[3] = NONE;
+        for (uint32_t l = 0; l < m; ++l) {
+            auto p = point(l);
+            double d = std::abs(n[0] * (p[0] - a[0]) + n[1] * (p[1] - a[1]) + n[2] * (p[2] - a[2]));
+            if (d > best) {
+                best = d;
+                s[3] = l;
+            }
+        }
+        PointR3 pa(a), pb(b), pc(c);
+        if (orient3d(pa, pb, pc, PointR3(point(s[3]))) == 0.0) {
+            s[3] = NONE;
+            for (uint32_t l = 0; l < m && s[3] == NONE; ++l) {
+                if (orient3d(pa, pb, pc, PointR3(point(l))) != 0.0) s[3] = l;
+            }
+            if (s[3] == NONE) return false;
+        }
+        if (orient3d(pa, pb, pc, PointR3(point(s[3]))) < 0.0) std::swap(s[1], s[2]);
+        return true;
+    }
+
+    template<class Source>
+    bool quickhull_3d<Source>::build(unsigned threads) {
+        faces.clear();
+        free_faces.clear();
+        pending.clear();
+        stamp = 0;
+
+        std::array<uint32_t, 4> s;
+        if (m < 4 || !initial_simplex(s)) return false;
+
+        // With orient3d(a, b, c, d) > 0 these are counter-clockwise from outside
+        add_face(s[0], s[1], s[2]);
+        add_face(s[0], s[3], s[1]);
+        add_face(s[1], s[3], s[2]);
+        add_face(s[0], s[2], s[3]);
+        for (uint32_t f = 0; f < 4; ++f) {
+            for (uint32_t i = 0; i < 3; ++i) {
+                uint32_t u = faces[f].v[i], v = faces[f].v[(i + 1) % 3];
+                for (uint32_t g = 0; g < 4; ++g) {
+                    for (uint32_t j = 0; j < 3; ++j) {
+                        if (faces[g].v[j] == v && faces[g].v[(j + 1) % 3] == u) faces[f].adj[i] = g;
+                    }
+                }
+            }
+        }
+
+        // The first face each point sees, found in parallel
+        std::vector<uint8_t> owner(m);
+        parallel_blocks(m, block_size, m >= parallel_cutoff ? threads : 1, [&](size_t begin, size_t end, unsigned) {
+            for (size_t l = begin; l < end; ++l) {
+                uint8_t o = 4;
+                for (uint8_t f = 0; f < 4 && o == 4; ++f) {
+                    if (sees(faces[f], static_cast<uint32_t>(l))) o = f;
+                }
+                owner[l] = o;
+            }
+        });
+        next_conflict.assign(m, NONE);
+        for (uint32_t l = 0; l < m; ++l) {
+            if (owner[l] < 4) add_conflict(owner[l], l);
+        }
+        std::vector<uint8_t>().swap(owner);
+
+        starts_at.assign(m, NONE);
+        ends_at.assign(m, NONE);
+        for (uint32_t f = 0; f < 4; ++f) {
+            if (faces[f].conflicts != NONE) pending.push_back(f);
+        }
+        while (!pending.empty()) {
+            uint32_t f = pending.back();
+            pending.pop_back();
+            if (faces[f].alive && faces[f].conflicts != NONE) add_point(f);
+        }
+        return true;
+    }
+
+    template<class Source>
+    void quickhull_3d<Source>::add_point(uint32_t start) {
+        uint32_t eye = faces[start].eye;
+        ++stamp;
+
+        // Faces seen from the eye form a connected patch around start
+        visible.assign(1, start);
+        faces[start].mark = stamp;
+        faces[start].visible = true;
+        for (size_t k = 0; k < visible.size(); ++k) {
+            for (uint32_t g : faces[visible[k]].adj) {
+                if (faces[g].mark == stamp) continue;
+                faces[g].mark = stamp;
+                faces[g].visible = sees(faces[g], eye);
+                if (faces[g].visible) visible.push_back(g);
+            }
+        }
+
+        // Fan from the eye to every horizon edge, oriented as in the
+        // visible face it replaces
+        created.clear();
+        for (uint32_t vf : visible) {
+            for (uint32_t i = 0; i < 3; ++i) {
+                uint32_t g = faces[vf].adj[i];
+                if (faces[g].visible) continue;
+                uint32_t u = faces[vf].v[i], v = faces[vf].v[(i + 1) % 3];
+                uint32_t nf = add_face(u, v, eye);
+                faces[nf].adj[0] = g;
+                for (uint32_t j = 0; j < 3; ++j) {
+                    if (faces[g].v[j] == v && faces[g].v[(j + 1) % 3] == u) faces[g].adj[j] = nf;
+                }
+                starts_at[u] = nf;
+                ends_at[v] = nf;
+                created.push_back(nf);
+            }
+        }
+        for (uint32_t nf : created) {
+            faces[nf].adj[1] = starts_at[faces[nf].v[1]];
+            faces[nf].adj[2] = ends_at[faces[nf].v[0]];
+        }
+
+        for (uint32_t vf : visible) {
+            for (uint32_t l = faces[vf].conflicts; l != NONE;) {
+                uint32_t next = next_conflict[l];
+                if (l != eye) {
+                    for (uint32_t nf : created) {
+                        if (sees(faces[nf], l)) {
+                            add_conflict(nf, l);
+                            break;
+                        }
+                    }
+                }
+                l = next;
+            }
+            faces[vf].alive = false;
+            faces[vf].visible = false;
+            faces[vf].conflicts = NONE;
+            free_faces.push_back(vf);
+        }
+        for (uint32_t nf : created) {
+            if (faces[nf].conflicts != NONE) pending.push_back(nf);
+        }
+    }
+
+    // Half-space normal . p < threshold: the inside of one side of the
+    // filter polygon or polyhedron, shrunk by a bound on the rounding error
+    template<size_t dim>
+    struct half_space {
+        std::array<double, dim> normal;
+        double threshold;
+    };
+
+    // Directions whose extreme points span the filter: the axes and the
+    // diagonals, 8 in 2D and 14 in 3D
+    template<size_t dim>
+    constexpr size_t direction_count = 2 * dim + (size_t(1) << dim);
+
+    template<size_t dim>
+    std::array<std::array<double, dim>, direction_count<dim>> filter_directions() {
+        std::array<std::array<double, dim>, direction_count<dim>> directions{};
+        size_t d = 0;
+        for (size_t k = 0; k < dim; ++k) {
+            directions[d++][k] = -1.0;
+            directions[d++][k] = 1.0;
+        }
+        for (unsigned signs = 0; signs < (1u << dim); ++signs, ++d) {
+            for (size_t k = 0; k < dim; ++k) directions[d][k] = (signs >> k) & 1 ? -1.0 : 1.0;
+        }
+        return directions;
+    }
+
+    // Largest projection onto each direction over coordinate columns c of
+    // count points, with the first position reaching it. Lanes track their
+    // own maximum and its position, stored as a double, and are merged at
+    // the end; NaN coordinates never win.
+    template<size_t dim>
+    void extremes(const std::array<const double*, dim>& c, size_t count,
+                  std::array<std::pair<double, uint32_t>, direction_count<dim>>& best) {
+        constexpr size_t directions = direction_count<dim>;
+        static const auto direction = filter_directions<dim>();
+        constexpr double lowest = -std::numeric_limits<double>::infinity();
+        size_t vector_end = count - count % simd::width;
+
+        simd::vdouble value[directions], position[directions];
+        for (size_t d = 0; d < directions; ++d) {
+            value[d] = simd::broadcast(lowest);
+            position[d] = simd::broadcast(0.0);
+        }
+        double lanes[simd::width];
+        for (size_t l = 0; l < simd::width; ++l) lanes[l] = static_cast<double>(l);
+        auto lane = simd::load(lanes);
+
+        for (size_t i = 0; i < vector_end; i += simd::width) {
+            auto here = simd::add(simd::broadcast(static_cast<double>(i)), lane);
+            simd::vdouble p[dim];
+            for (size_t k = 0; k < dim; ++k) p[k] = simd::load(c[k] + i);
+            for (size_t d = 0; d < directions; ++d) {
+                auto s = simd::mul(p[0], simd::broadcast(direction[d][0]));
+                for (size_t k = 1; k < dim; ++k) s = simd::fmadd(p[k], simd::broadcast(direction[d][k]), s);
+                position[d] = simd::select_greater(s, value[d], here, position[d]);
+                value[d] = simd::select_greater(s, value[d], s, value[d]);
+            }
+        }
+
+        double values[simd::width], positions[simd::width];
+        for (size_t d = 0; d < directions; ++d) {
+            simd::store(values, value[d]);
+            simd::store(positions, position[d]);
+            best[d] = {lowest, 0};
+            for (size_t l = 0; l < simd::width; ++l) {
+                auto at = static_cast<uint32_t>(positions[l]);
+                if (values[l] > best[d].first || (values[l] == best[d].first && at < best[d].second)) best[d] = {values[l], at};
+            }
+            for (size_t i = vector_end; i < count; ++i) {
+                double s = 0.0;
+                for (size_t k = 0; k < dim; ++k) s += direction[d][k] * c[k][i];
+                if (s > best[d].first) best[d] = {s, static_cast<uint32_t>(i)};
+            }
+        }
+    }
+
+    /**
+     * @brief Half-spaces of the hull of the points extreme along the filter
+     * directions; empty if that hull is flat.
+     *
+     * The outward normal of a side and its offset are rounded, so a point
+     * could be misjudged by up to a few ulps of |normal| . (|p| + |a|),
+     * with a a corner of the side and |p| at most the largest coordinate
+     * magnitude r. Each threshold is lowered by sixteen times that bound,
+     * well over the error of computing the normal and both dot products,
+     * so a point passing every test is strictly inside the exact hull.
+     */
+    template<size_t dim, class Source>
+    std::vector<half_space<dim>> filter_sides(const Source& source, size_t n, unsigned threads) {
+        constexpr size_t count = direction_count<dim>;
+        using extreme = std::pair<double, uint32_t>;
+
+        size_t blocks = (n + block_size - 1) / block_size;
+        std::vector<std::array<extreme, count>> partial(blocks);
+        std::vector<std::array<std::vector<double>, dim>> buffers(threads == 0 ? default_thread_count() : threads);
+        parallel_blocks(n, block_size, threads, [&](size_t begin, size_t end, unsigned worker) {
+            std::array<const double*, dim> c;
+            for (size_t k = 0; k < dim; ++k) c[k] = source.column(k, begin, end, buffers[worker][k]);
+            auto& block = partial[begin / block_size];
+            extremes<dim>(c, end - begin, block);
+            for (auto& e : block) e.second += static_cast<uint32_t>(begin);
+        });
+        std::array<extreme, count> best = partial[0];
+        for (const auto& p : partial) {
+            for (size_t d = 0; d < count; ++d) {
+                if (p[d].first > best[d].first) best[d] = p[d];
+            }
+        }
+
+        // Largest coordinate magnitudes, from the axis extremes
+        std::array<double, dim> r;
+        for (size_t k = 0; k < dim; ++k) {
+            r[k] = std::max(std::abs(source(best[2 * k].second)[k]), std::abs(source(best[2 * k + 1].second)[k]));
+        }
+
+        std::vector<uint32_t> ids;
+        for (const auto& b : best) ids.push_back(b.second);
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+        std::vector<half_space<dim>> sides;
+        auto add_side = [&](uint32_t a, const std::array<double, dim>& normal, const std::array<double, dim>& permanent) {
+            auto p = source(a);
+            double offset = 0.0, bound = 0.0;
+            for (size_t k = 0; k < dim; ++k) {
+                offset += normal[k] * p[k];
+                bound += permanent[k] * (r[k] + std::abs(p[k]));
+            }
+            sides.push_back({normal, offset - 16.0 * predicate_epsilon * bound});
+        };
+
+        if constexpr (dim == 2) {
+            std::vector<uint32_t> hull;
+            monotone_chain(source, ids, hull);
+            if (hull.size() < 3) return {};
+            for (size_t i = 0; i < hull.size(); ++i) {
+                auto a = source(hull[i]), b = source(hull[(i + 1) % hull.size()]);
+                double ex = b[0] - a[0], ey = b[1] - a[1];
+                add_side(hull[i], {ey, -ex}, {std::abs(ey), std::abs(ex)});
+            }
+        } else {
+            quickhull_3d<Source> polytope(source, ids.data(), ids.size());
+            std::vector<IndexTriangle> faces;
+            if (!polytope.build(1)) return {};
+            polytope.output(faces);
+            for (const auto& f : faces) {
+                auto a = source(f[0]), b = source(f[1]), c = source(f[2]);
+                std::array<double, 3> e{b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+                std::array<double, 3> g{c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+                add_side(f[0],
+                         {e[1] * g[2] - e[2] * g[1], e[2] * g[0] - e[0] * g[2], e[0] * g[1] - e[1] * g[0]},
+                         {std::abs(e[1] * g[2]) + std::abs(e[2] * g[1]),
+                          std::abs(e[2] * g[0]) + std::abs(e[0] * g[2]),
+                          std::abs(e[0] * g[1]) + std::abs(e[1] * g[0])});
+            }
+        }
+        return sides;
+    }
+
+    /**
+     * @brief Keep the points not strictly inside every filter half-space.
+     *
+     * Each block is tested simd::width points at a time: the largest
+     * excess normal . p - threshold over all sides is kept per point, and
+     * the point survives unless it is negative.
+     */
+    template<size_t dim, class Source>
+    void filter(const Source& source, size_t n, std::vector<uint32_t>& candidates, unsigned threads) {
+        check_count(n);
+        candidates.clear();
+        if (n == 0) return;
+        auto sides = filter_sides<dim>(source, n, threads);
+        if (sides.empty()) {
+            candidates.resize(n);
+            std::iota(candidates.begin(), candidates.end(), 0u);
+            return;
+        }
+
+        size_t blocks = (n + block_size - 1) / block_size;
+        std::vector<std::vector<uint32_t>> kept(blocks);
+        std::vector<std::array<std::vector<double>, dim + 1>> buffers(threads == 0 ? default_thread_count() : threads);
+        parallel_blocks(n, block_size, threads, [&](size_t begin, size_t end, unsigned worker) {
+            size_t count = end - begin, vector_end = count - count % simd::width;
+            std::array<const double*, dim> c;
+            for (size_t k = 0; k < dim; ++k) c[k] = source.column(k, begin, end, buffers[worker][k]);
+            auto& excess = buffers[worker][dim];
+            excess.resize(count);
+
+            for (size_t i = 0; i < vector_end; i += simd::width) {
+                auto worst = simd::broadcast(-std::numeric_limits<double>::infinity());
+                for (const auto& h : sides) {
+                    auto s = simd::fmsub(simd::load(c[0] + i), simd::broadcast(h.normal[0]), simd::broadcast(h.threshold));
+                    for (size_t k = 1; k < dim; ++k) s = simd::fmadd(simd::load(c[k] + i), simd::broadcast(h.normal[k]), s);
+                    worst = simd::max(worst, s);
+                }
+                simd::store(excess.data() + i, worst);
+            }
+            for (size_t i = vector_end; i < count; ++i) {
+                double worst = -std::numeric_limits<double>::infinity();
+                for (const auto& h : sides) {
+                    double s = c[0][i] * h.normal[0] - h.threshold;
+                    for (size_t k = 1; k < dim; ++k) s += c[k][i] * h.normal[k];
+                    worst = std::max(worst, s);
+                }
+                excess[i] = worst;
+            }
+
+            auto& out = kept[begin / block_size];
+            for (size_t i = 0; i < count; ++i) {
+                // NaN coordinates are kept, and left to the exact tests
+                if (!(excess[i] < 0.0)) out.push_back(static_cast<uint32_t>(begin + i));
+            }
+        });
+        for (const auto& k : kept) candidates.insert(candidates.end(), k.begin(), k.end());
+    }
+
+    template<class Source>
+    void hull_2d(const Source& source, size_t n, std::vector<uint32_t>& hull, unsigned threads) {
+        std::vector<uint32_t> work;
+        filter<2>(source, n, work, threads);
+        quickhull_2d(source, work, hull, threads);
+    }
+
+    template<class Source>
+    void hull_3d(const Source& source, size_t n, std::vector<IndexTriangle>& faces, unsigned threads) {
+        std::vector<uint32_t> work;
+        filter<3>(source, n, work, threads);
+        quickhull_3d<Source> hull(source, work.data(), work.size());
+        faces.clear();
+        if (hull.build(threads)) hull.output(faces);
+    }
+}
+
+void GeomCore::convex_hull(const PointR2* points, size_t n, std::vector<uint32_t>& hull, unsigned threads) {
+    hull_2d(interleaved<2, PointR2>{points}, n, hull, threads);
+}
+
+void GeomCore::convex_hull(const PointCloud2& points, std::vector<uint32_t>& hull, unsigned threads) {
+    hull_2d(columns<2>{{points.x(), points.y()}}, points.size(), hull, threads);
+}
+
+std::vector<uint32_t> GeomCore::convex_hull(const std::vector<PointR2>& points, unsigned threads) {
+    std::vector<uint32_t> hull;
+    convex_hull(points.data(), points.size(), hull, threads);
+    return hull;
+}
+
+void GeomCore::monotone_chain_hull(const PointR2* points, size_t n, std::vector<uint32_t>& hull) {
+    check_count(n);
+    std::vector<uint32_t> ids(n);
+    std::iota(ids.begin(), ids.end(), 0u);
+    monotone_chain(interleaved<2, PointR2>{points}, ids, hull);
+}
+
+void GeomCore::quickhull(const PointR2* points, size_t n, std::vector<uint32_t>& hull, unsigned threads) {
+    check_count(n);
+    std::vector<uint32_t> work(n);
+    std::iota(work.begin(), work.end(), 0u);
+    quickhull_2d(interleaved<2, PointR2>{points}, work, hull, threads);
+}
+
+void GeomCore::convex_hull(const PointR3* points, size_t n, std::vector<IndexTriangle>& faces, unsigned threads) {
+    hull_3d(interleaved<3, PointR3>{points}, n, faces, threads);
+}
+
+void GeomCore::convex_hull(const PointCloud3& points, std::vector<IndexTriangle>& faces, unsigned threads) {
+    hull_3d(columns<3>{{points.x(), points.y(), points.z()}}, points.size(), faces, threads);
+}
+
+std::vector<GeomCore::IndexTriangle> GeomCore::convex_hull(const std::vector<PointR3>& points, unsigned threads) {
+    std::vector<IndexTriangle> faces;
+    convex_hull(points.data(), points.size(), faces, threads);
+    return faces;
+}
+
+void GeomCore::akl_toussaint_filter(const PointR2* points, size_t n, std::vector<uint32_t>& candidates, unsigned threads) {
+    filter<2>(interleaved<2, PointR2>{points}, n, candidates, threads);
+}
+
+void GeomCore::akl_toussaint_filter(const PointCloud2& points, std::vector<uint32_t>& candidates, unsigned threads) {
+    filter<2>(columns<2>{{points.x(), points.y()}}, points.size(), candidates, threads);
+}
+
+void GeomCore::akl_toussaint_filter(const PointR3* points, size_t n, std::vector<uint32_t>& candidates, unsigned threads) {
+    filter<3>(interleaved<3, PointR3>{points}, n, candidates, threads);
+}
+
+void GeomCore::akl_toussaint_filter(const PointCloud3& points, std::vector<uint32_t>& candidates, unsigned threads) {
+    filter<3>(columns<3>{{points.x(), points.y(), points.z()}}, points.size(), candidates, threads);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Point.hpp"
+#include "PointCloud.hpp"
+#include "Triangulation.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace GeomCore {
+
+    // Convex hulls of planar and spatial point sets.
+    //
+    // Every hull is reported by index into the input. All side and visibility
+    // decisions use the exact predicates; floating-point distances only pick
+    // which point to add next, so the hulls are exact for any input,
+    // including duplicate, collinear and coplanar points.
+    //
+    // The convex_hull entry points first run the Akl-Toussaint filter: the
+    // hull of the points extreme along a few fixed directions is inside the
+    // full hull, so every point strictly inside it can be dropped. The test is
+    // a branch-free vectorized pass over the input, split across threads, and
+    // leaves only a small fraction of the points for typical inputs.
+
+    // Vertices of the 2D hull of points[0..n), counter-clockwise from the
+    // lowest of the leftmost points. Points on hull edges are not vertices,
+    // duplicates are reported once; collinear input gives its two end points.
+    void convex_hull(const PointR2* points, size_t n, std::vector<uint32_t>& hull, unsigned threads = 0);
+    void convex_hull(const PointCloud2& points, std::vector<uint32_t>& hull, unsigned threads = 0);
+    std::vector<uint32_t> convex_hull(const std::vector<PointR2>& points, unsigned threads = 0);
+
+    // The same hull by Andrew's monotone chain alone: sort by x, then scan
+    // the lower and upper chains. O(n log n), serial, no filtering.
+    void monotone_chain_hull(const PointR2* points, size_t n, std::vector<uint32_t>& hull);
+
+    // The same hull by QuickHull without the filter. Partitions of large
+    // point sets run on separate threads; threads = 0 uses the hardware
+    // concurrency.
+    void quickhull(const PointR2* points, size_t n, std::vector<uint32_t>& hull, unsigned threads = 0);
+
+    // Faces of the 3D hull of points[0..n) by QuickHull, as triangles that
+    // are counter-clockwise seen from outside. Coplanar hull facets come out
+    // triangulated, possibly with corners inside the facet. Fewer than four
+    // non-coplanar points give no faces.
+    void convex_hull(const PointR3* points, size_t n, std::vector<IndexTriangle>& faces, unsigned threads = 0);
+    void convex_hull(const PointCloud3& points, std::vector<IndexTriangle>& faces, unsigned threads = 0);
+    std::vector<IndexTriangle> convex_hull(const std::vector<PointR3>& points, unsigned threads = 0);
+
+    // Indices of the points that survive the Akl-Toussaint filter, ascending.
+    // Every hull vertex survives.
+    void akl_toussaint_filter(const PointR2* points, size_t n, std::vector<uint32_t>& candidates, unsigned threads = 0);
+    void akl_toussaint_filter(const PointCloud2& points, std::vector<uint32_t>& candidates, unsigned threads = 0);
+    void akl_toussaint_filter(const PointR3* points, size_t n, std::vector<uint32_t>& candidates, unsigned threads = 0);
+    void akl_toussaint_filter(const PointCloud3& points, std::vector<uint32_t>& candidates, unsigned threads = 0);
+}
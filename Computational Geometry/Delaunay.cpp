@@ -0,0 +1,849 @@
+#include "Delaunay.hpp"
+#include "Parallel.hpp"
+#include "Predicates.hpp"
+#include "SpaceFillingCurve.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+using namespace GeomCore;
+
+static constexpr uint32_t NONE = Delaunay::NONE;
+
+// The vertex at infinity shared by all ghost triangles
+static constexpr uint32_t GHOST = NONE - 1;
+
+static uint32_t next_edge(uint32_t e) { return e % 3 == 2 ? e - 2 : e + 1; }
+static uint32_t prev_edge(uint32_t e) { return e % 3 == 0 ? e + 2 : e - 1; }
+
+// SplitMix64: a well-mixed hash of a counter
+static uint64_t mix(uint64_t z) {
+    z += 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Stable LSD radix sort on bits 32..62, carrying the low 32 bits along
+static void sort_high_bits(std::vector<uint64_t>& keys) {
+    std::vector<uint64_t> scratch(keys.size());
+    for (int shift : {32, 43, 53}) {
+        int bits = shift == 32 ? 11 : 10;
+        uint64_t mask = (uint64_t(1) << bits) - 1;
+        std::vector<size_t> count((size_t(1) << bits) + 1, 0);
+        for (uint64_t k : keys) ++count[((k >> shift) & mask) + 1];
+        for (size_t i = 1; i < count.size(); ++i) count[i] += count[i - 1];
+        for (uint64_t k : keys) scratch[count[(k >> shift) & mask]++] = k;
+        keys.swap(scratch);
+    }
+}
+
+/**
+ * @brief Copy the points, numbering vertices in insertion order.
+ *
+ * The spatial order is a biased randomized insertion order: each point joins
+ * round k with probability 2^-(k+1), rounds are inserted from the largest k
+ * down, and each round is sorted along a Hilbert curve. The random rounds
+ * keep the expected restructuring small, the curve keeps each location walk
+ * short. Rounds come from a hash of the point index, so equal inputs always
+ * give equal triangulations.
+ */
+void GeomCore::Delaunay::load(const PointR2* points, size_t n, bool spatial_order) {
+    if (n >= GHOST) {
+        throw std::length_error("Too many points to triangulate");
+    }
+    input_index.resize(n);
+    std::iota(input_index.begin(), input_index.end(), 0u);
+
+    if (spatial_order && n > 0) {
+        double min_x = std::numeric_limits<double>::infinity(), max_x = -min_x;
+        double min_y = min_x, max_y = max_x;
+        for (size_t i = 0; i < n; ++i) {
+            min_x = std::min(min_x, points[i][X]);
+            max_x = std::max(max_x, points[i][X]);
+            min_y = std::min(min_y, points[i][Y]);
+            max_y = std::max(max_y, points[i][Y]);
+        }
+        constexpr double cells = 8191.0;
+        double scale_x = max_x > min_x ? cells / (max_x - min_x) : 0.0;
+        double scale_y = max_y > min_y ? cells / (max_y - min_y) : 0.0;
+
+        constexpr uint64_t rounds = 20;
+        std::vector<uint64_t> keys(n);
+        for (size_t i = 0; i < n; ++i) {
+            double gx = std::clamp((points[i][X] - min_x) * scale_x, 0.0, cells);
+            double gy = std::clamp((points[i][Y] - min_y) * scale_y, 0.0, cells);
+            uint64_t h = hilbert_code(static_cast<uint32_t>(gx), static_cast<uint32_t>(gy), 13);
+            uint64_t round = std::min<uint64_t>(std::countl_zero(mix(n + i)), rounds);
+            keys[i] = (rounds - round) << 58 | h << 32 | i;
+        }
+        sort_high_bits(keys);
+        for (size_t i = 0; i < n; ++i) {
+            input_index[i] = static_cast<uint32_t>(keys[i]);
+        }
+    }
+
+    coords.resize(2 * n);
+    vertex_of.resize(n);
+    for (size_t v = 0; v < n; ++v) {
+        coords[2 * v] = points[input_index[v]][X];
+        coords[2 * v + 1] = points[input_index[v]][Y];
+        vertex_of[input_index[v]] = static_cast<uint32_t>(v);
+    }
+}
+
+void GeomCore::Delaunay::clear_mesh() {
+    corners.clear();
+    adjacent.clear();
+    constrained.clear();
+    exterior.clear();
+    vertex_triangle.clear();
+    stamp.clear();
+    epoch = 0;
+    last = 0;
+}
+
+void GeomCore::Delaunay::triangulate(const PointR2* points, size_t n) {
+    load(points, n, true);
+    clear_mesh();
+    if (n >= 3) build();
+}
+
+uint32_t GeomCore::Delaunay::add_triangle(uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t t = static_cast<uint32_t>(corners.size() / 3);
+    corners.insert(corners.end(), {a, b, c});
+    adjacent.insert(adjacent.end(), {NONE, NONE, NONE});
+    constrained.insert(constrained.end(), {0, 0, 0});
+    stamp.push_back(0);
+    return t;
+}
+
+bool GeomCore::Delaunay::is_ghost(uint32_t t) const {
+    return corners[3 * t] == GHOST || corners[3 * t + 1] == GHOST || corners[3 * t + 2] == GHOST;
+}
+
+double GeomCore::Delaunay::orient(uint32_t a, uint32_t b, uint32_t c) const {
+    return orient2d(coords[2 * a], coords[2 * a + 1], coords[2 * b], coords[2 * b + 1], coords[2 * c], coords[2 * c + 1]);
+}
+
+void GeomCore::Delaunay::build() {
+    uint32_t n = static_cast<uint32_t>(input_index.size());
+
+    // Seed with the first two distinct points and the first point off their line
+    auto same = [this](uint32_t p, uint32_t q) {
+        return coords[2 * p] == coords[2 * q] && coords[2 * p + 1] == coords[2 * q + 1];
+    };
+    uint32_t a = 0, b = NONE, c = NONE;
+    for (uint32_t p = 1; p < n && b == NONE; ++p) {
+        if (!same(a, p)) b = p;
+    }
+    if (b == NONE) return;
+    for (uint32_t p = 1; p < n && c == NONE; ++p) {
+        if (orient(a, b, p) != 0.0) c = p;
+    }
+    if (c == NONE) return;
+    if (orient(a, b, c) < 0.0) std::swap(b, c);
+
+    // A planar triangulation of n points has at most 2n triangles, ghosts included
+    corners.reserve(6 * n);
+    adjacent.reserve(6 * n);
+    constrained.reserve(6 * n);
+    stamp.reserve(2 * n);
+    fan.assign(n + 1, NONE);
+
+    // The ghost across hull edge u -> w is (w, u, GHOST)
+    uint32_t t = add_triangle(a, b, c);
+    uint32_t ga = add_triangle(b, a, GHOST);
+    uint32_t gb = add_triangle(c, b, GHOST);
+    uint32_t gc = add_triangle(a, c, GHOST);
+    link(3 * t, 3 * ga);
+    link(3 * t + 1, 3 * gb);
+    link(3 * t + 2, 3 * gc);
+    link(3 * ga + 1, 3 * gc + 2);
+    link(3 * gb + 1, 3 * ga + 2);
+    link(3 * gc + 1, 3 * gb + 2);
+    last = t;
+
+    for (uint32_t p = 0; p < n; ++p) {
+        if (p != a && p != b && p != c) insert(p);
+    }
+}
+
+/**
+ * @brief Visibility walk from the last inserted triangle towards point p.
+ *
+ * Crosses any edge that has p strictly on its far side, trying the edges in
+ * a rotating order, until reaching a triangle that contains p or stepping
+ * out of the hull into a ghost triangle.
+ */
+uint32_t GeomCore::Delaunay::locate(uint32_t p) {
+    uint32_t t = last;
+    if (is_ghost(t)) {
+        for (uint32_t e = 3 * t; e < 3 * t + 3; ++e) {
+            if (corners[e] != GHOST && corners[next_edge(e)] != GHOST) {
+                t = adjacent[e] / 3;
+                break;
+            }
+        }
+    }
+
+    uint32_t entered = NONE;
+    for (;;) {
+        uint32_t start = walk_step;
+        walk_step = walk_step == 2 ? 0 : walk_step + 1;
+
+        bool moved = false;
+        for (uint32_t k = 0; k < 3; ++k) {
+            uint32_t e = 3 * t + (start + k) % 3;
+            if (e == entered) continue;
+            if (orient(corners[e], corners[next_edge(e)], p) < 0.0) {
+                entered = adjacent[e];
+                t = entered / 3;
+                moved = true;
+                break;
+            }
+        }
+        if (!moved || is_ghost(t)) return t;
+    }
+}
+
+/**
+ * @brief Whether p conflicts with triangle t.
+ *
+ * For a real triangle: p is strictly inside its circumcircle. A ghost
+ * triangle's "circle" is the open half-plane beyond its hull edge plus the
+ * open edge itself.
+ */
+bool GeomCore::Delaunay::in_circle(uint32_t t, uint32_t p) const {
+    uint32_t a = corners[3 * t], b = corners[3 * t + 1], c = corners[3 * t + 2];
+    if (a != GHOST && b != GHOST && c != GHOST) {
+        return incircle(coords[2 * a], coords[2 * a + 1], coords[2 * b], coords[2 * b + 1],
+                        coords[2 * c], coords[2 * c + 1], coords[2 * p], coords[2 * p + 1]) > 0.0;
+    }
+
+    // Rotate to (a, b, GHOST)
+    if (a == GHOST) {
+        a = b;
+        b = c;
+    } else if (b == GHOST) {
+        b = a;
+        a = c;
+    }
+    double o = orient(a, b, p);
+    if (o != 0.0) return o > 0.0;
+
+    // Collinear: inside only strictly between a and b
+    int axis = coords[2 * a] != coords[2 * b] ? 0 : 1;
+    double pa = coords[2 * a + axis], pb = coords[2 * b + axis], pp = coords[2 * p + axis];
+    return (pa < pp && pp < pb) || (pb < pp && pp < pa);
+}
+
+/**
+ * @brief Bowyer-Watson insertion of point p.
+ *
+ * Collects the cavity of triangles in conflict with p by a search from the
+ * located triangle, then fans p to every edge on the cavity boundary. A
+ * cavity of k triangles always has k + 2 boundary edges, so its slots are
+ * reused and two triangles are appended.
+ */
+void GeomCore::Delaunay::insert(uint32_t p) {
+    uint32_t t = locate(p);
+
+    if (!is_ghost(t)) {
+        for (uint32_t e = 3 * t; e < 3 * t + 3; ++e) {
+            uint32_t v = corners[e];
+            if (coords[2 * v] == coords[2 * p] && coords[2 * v + 1] == coords[2 * p + 1]) {
+                vertex_of[input_index[p]] = v;
+                return;
+            }
+        }
+    }
+
+    if (epoch >= NONE - 2) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 0;
+    }
+    epoch += 2;
+    uint32_t inside = epoch, outside = epoch + 1;
+
+    cavity.clear();
+    boundary.clear();
+    stamp[t] = inside;
+    cavity.push_back(t);
+    for (size_t i = 0; i < cavity.size(); ++i) {
+        uint32_t c = cavity[i];
+        for (uint32_t e = 3 * c; e < 3 * c + 3; ++e) {
+            uint32_t twin = adjacent[e], neighbor = twin / 3;
+            if (stamp[neighbor] == inside) continue;
+            if (stamp[neighbor] != outside) {
+                if (in_circle(neighbor, p)) {
+                    stamp[neighbor] = inside;
+                    cavity.push_back(neighbor);
+                    continue;
+                }
+                stamp[neighbor] = outside;
+            }
+            boundary.push_back({corners[e], corners[next_edge(e)], twin});
+        }
+    }
+
+    while (cavity.size() < boundary.size()) {
+        cavity.push_back(add_triangle(NONE, NONE, NONE));
+    }
+
+    // New triangle j is (from, to, p); fan maps each boundary vertex to the
+    // new triangle starting there, with the ghost vertex in the last slot
+    uint32_t ghost_slot = static_cast<uint32_t>(fan.size() - 1);
+    auto slot = [ghost_slot](uint32_t v) { return v == GHOST ? ghost_slot : v; };
+    for (size_t j = 0; j < boundary.size(); ++j) {
+        const auto& edge = boundary[j];
+        uint32_t nt = cavity[j];
+        corners[3 * nt] = edge.from;
+        corners[3 * nt + 1] = edge.to;
+        corners[3 * nt + 2] = p;
+        link(3 * nt, edge.twin);
+        fan[slot(edge.from)] = nt;
+    }
+    for (size_t j = 0; j < boundary.size(); ++j) {
+        uint32_t nt = cavity[j];
+        link(3 * nt + 1, 3 * fan[slot(boundary[j].to)] + 2);
+        if (boundary[j].from != GHOST && boundary[j].to != GHOST) last = nt;
+    }
+}
+
+void GeomCore::Delaunay::index_vertices() {
+    vertex_triangle.assign(coords.size() / 2, NONE);
+    for (uint32_t e = 0; e < corners.size(); ++e) {
+        if (corners[e] != GHOST) vertex_triangle[corners[e]] = e / 3;
+    }
+}
+
+// Half-edge u -> w, or NONE
+uint32_t GeomCore::Delaunay::find_edge(uint32_t u, uint32_t w) const {
+    uint32_t t = vertex_triangle[u];
+    uint32_t start = 3 * t;
+    while (corners[start] != u) ++start;
+
+    // Outgoing edges of u in counter-clockwise order
+    uint32_t e = start;
+    do {
+        if (corners[next_edge(e)] == w) return e;
+        e = adjacent[prev_edge(e)];
+    } while (e != start);
+    return NONE;
+}
+
+/**
+ * @brief Replace the diagonal u -> w of the quad (u, y, w, x) by x -> y.
+ *
+ * Triangles (u, w, x) and (w, u, y) become (y, w, x) and (x, u, y) in the
+ * same slots; only two corners and three twin pairs change.
+ */
+void GeomCore::Delaunay::flip(uint32_t e) {
+    uint32_t g = adjacent[e];
+    uint32_t h2 = prev_edge(e), g2 = prev_edge(g);
+    uint32_t u = corners[e], w = corners[next_edge(e)];
+    uint32_t x = corners[h2], y = corners[g2];
+
+    uint32_t outer_a = adjacent[g2], outer_b = adjacent[h2];
+    uint8_t constrained_a = constrained[g2], constrained_b = constrained[h2];
+
+    corners[e] = y;
+    corners[g] = x;
+    link(e, outer_a);
+    link(g, outer_b);
+    link(h2, g2);
+    constrained[e] = constrained_a;
+    constrained[g] = constrained_b;
+    constrained[h2] = constrained[g2] = 0;
+
+    if (!vertex_triangle.empty()) {
+        vertex_triangle[u] = g / 3;
+        vertex_triangle[w] = e / 3;
+        vertex_triangle[x] = e / 3;
+        vertex_triangle[y] = g / 3;
+    }
+}
+
+/**
+ * @brief Insert segment ab as a constrained edge.
+ *
+ * Follows Sloan (1993): collect the edges the segment crosses, flip them
+ * until none crosses it, then restore the Delaunay property on the newly
+ * made edges by further flips, never flipping a constrained edge.
+ */
+void GeomCore::Delaunay::add_constraint(uint32_t a, uint32_t b) {
+    if (a >= vertex_of.size() || b >= vertex_of.size()) {
+        throw std::out_of_range("Constraint endpoint out of range");
+    }
+    if (corners.empty()) {
+        throw std::runtime_error("Cannot constrain an empty triangulation");
+    }
+    if (vertex_triangle.empty()) index_vertices();
+    constrain(vertex_of[a], vertex_of[b]);
+}
+
+/**
+ * @brief add_constraint on vertex numbers rather than input indices; pieces
+ *        of a segment through other vertices recurse here.
+ */
+void GeomCore::Delaunay::constrain(uint32_t a, uint32_t b) {
+    if (a == b) return;
+
+    // Points collinear with ab are on segment ab when on the same side of a as b
+    auto towards_b = [this, a, b](uint32_t v) {
+        int axis = coords[2 * a] != coords[2 * b] ? 0 : 1;
+        double pa = coords[2 * a + axis];
+        return (coords[2 * v + axis] > pa) == (coords[2 * b + axis] > pa);
+    };
+    auto mark = [this](uint32_t e) { constrained[e] = constrained[adjacent[e]] = 1; };
+
+    // Find the edge ab, a vertex on it, or the first edge it crosses
+    uint32_t start = 3 * vertex_triangle[a];
+    while (corners[start] != a) ++start;
+    uint32_t e = start, crossing = NONE;
+    do {
+        uint32_t v = corners[next_edge(e)], w = corners[prev_edge(e)];
+        if (v == b) {
+            mark(e);
+            return;
+        }
+        if (v != GHOST) {
+            double ov = orient(a, b, v);
+            if (ov == 0.0 && towards_b(v)) {
+                constrain(a, v);
+                constrain(v, b);
+                return;
+            }
+            if (w != GHOST && ov < 0.0 && orient(a, b, w) > 0.0) {
+                crossing = next_edge(e);
+                break;
+            }
+        }
+        e = adjacent[prev_edge(e)];
+    } while (e != start);
+    if (crossing == NONE) {
+        throw std::runtime_error("Triangulation is inconsistent");
+    }
+
+    // Walk along ab; each crossed edge runs from its right side to its left
+    std::vector<std::array<uint32_t, 2>> crossed;
+    for (uint32_t h = crossing;;) {
+        if (constrained[h]) {
+            throw std::invalid_argument("Constraint crosses another constraint");
+        }
+        crossed.push_back({corners[h], corners[next_edge(h)]});
+        uint32_t g = adjacent[h];
+        uint32_t z = corners[prev_edge(g)];
+        if (z == b) break;
+        double oz = orient(a, b, z);
+        if (oz == 0.0) {
+            constrain(a, z);
+            constrain(z, b);
+            return;
+        }
+        h = oz < 0.0 ? prev_edge(g) : next_edge(g);
+    }
+
+    auto crosses_ab = [&](uint32_t x, uint32_t y) {
+        if (x == a || x == b || y == a || y == b) return false;
+        double ox = orient(a, b, x), oy = orient(a, b, y);
+        double oa = orient(x, y, a), ob = orient(x, y, b);
+        return ((ox < 0.0 && oy > 0.0) || (ox > 0.0 && oy < 0.0)) &&
+               ((oa < 0.0 && ob > 0.0) || (oa > 0.0 && ob < 0.0));
+    };
+
+    // Flip crossed edges whose quad is convex until none crosses ab
+    std::vector<std::array<uint32_t, 2>> created;
+    for (size_t head = 0; head < crossed.size(); ++head) {
+        auto [u, w] = crossed[head];
+        uint32_t h = find_edge(u, w);
+        if (h == NONE) {
+            throw std::runtime_error("Triangulation is inconsistent");
+        }
+        uint32_t x = corners[prev_edge(h)], y = corners[prev_edge(adjacent[h])];
+        double ou = orient(x, y, u), ow = orient(x, y, w);
+        if (!((ou < 0.0 && ow > 0.0) || (ou > 0.0 && ow < 0.0))) {
+            crossed.push_back({u, w});
+            continue;
+        }
+        flip(h);
+        if (crosses_ab(x, y)) {
+            crossed.push_back({x, y});
+        } else {
+            created.push_back({x, y});
+        }
+    }
+
+    uint32_t ab = find_edge(a, b);
+    if (ab == NONE) {
+        throw std::runtime_error("Triangulation is inconsistent");
+    }
+    mark(ab);
+
+    // Restore the Delaunay property around the new edges
+    for (bool flipped = true; flipped;) {
+        flipped = false;
+        for (auto& edge : created) {
+            uint32_t h = find_edge(edge[0], edge[1]);
+            if (h == NONE || constrained[h]) continue;
+            uint32_t x = corners[prev_edge(h)], y = corners[prev_edge(adjacent[h])];
+            if (x == GHOST || y == GHOST) continue;
+            uint32_t u = corners[h], w = corners[next_edge(h)];
+            if (incircle(coords[2 * u], coords[2 * u + 1], coords[2 * w], coords[2 * w + 1],
+                         coords[2 * x], coords[2 * x + 1], coords[2 * y], coords[2 * y + 1]) > 0.0) {
+                flip(h);
+                edge = {x, y};
+                flipped = true;
+            }
+        }
+    }
+}
+
+// Mark the triangles reachable from the hull without crossing a constraint
+void GeomCore::Delaunay::remove_exterior() {
+    size_t count = corners.size() / 3;
+    exterior.assign(count, 0);
+
+    std::vector<uint32_t> queue;
+    for (uint32_t t = 0; t < count; ++t) {
+        if (!is_ghost(t)) continue;
+        exterior[t] = 1;
+        for (uint32_t e = 3 * t; e < 3 * t + 3; ++e) {
+            if (corners[e] == GHOST || corners[next_edge(e)] == GHOST || constrained[e]) continue;
+            uint32_t inner = adjacent[e] / 3;
+            if (!exterior[inner]) {
+                exterior[inner] = 1;
+                queue.push_back(inner);
+            }
+        }
+    }
+    for (size_t i = 0; i < queue.size(); ++i) {
+        uint32_t t = queue[i];
+        for (uint32_t e = 3 * t; e < 3 * t + 3; ++e) {
+            if (constrained[e]) continue;
+            uint32_t neighbor = adjacent[e] / 3;
+            if (!exterior[neighbor]) {
+                exterior[neighbor] = 1;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+}
+
+void GeomCore::Delaunay::triangulate(const PolygonR2& boundary, const std::vector<PointR2>& interior) {
+    const auto& vertices = boundary.get_vertices();
+    std::vector<PointR2> points;
+    points.reserve(vertices.size() + interior.size());
+    for (const auto& v : vertices) points.push_back(v -> point);
+    points.insert(points.end(), interior.begin(), interior.end());
+
+    triangulate(points);
+    if (corners.empty()) return;
+
+    uint32_t m = static_cast<uint32_t>(vertices.size());
+    for (uint32_t i = 0; i < m; ++i) {
+        add_constraint(i, i + 1 == m ? 0 : i + 1);
+    }
+    remove_exterior();
+}
+
+std::vector<IndexTriangle> GeomCore::Delaunay::triangles() const {
+    std::vector<IndexTriangle> result;
+    result.reserve(corners.size() / 6);
+    for (uint32_t t = 0; t < corners.size() / 3; ++t) {
+        if (is_ghost(t) || (!exterior.empty() && exterior[t])) continue;
+        result.push_back({input_index[corners[3 * t]], input_index[corners[3 * t + 1]], input_index[corners[3 * t + 2]]});
+    }
+    return result;
+}
+
+std::vector<std::array<uint32_t, 3>> GeomCore::Delaunay::neighbors() const {
+    size_t count = corners.size() / 3;
+    std::vector<uint32_t> id(count, NONE);
+    uint32_t next_id = 0;
+    for (uint32_t t = 0; t < count; ++t) {
+        if (is_ghost(t) || (!exterior.empty() && exterior[t])) continue;
+        id[t] = next_id++;
+    }
+
+    std::vector<std::array<uint32_t, 3>> result(next_id);
+    for (uint32_t t = 0; t < count; ++t) {
+        if (id[t] == NONE) continue;
+        for (uint32_t k = 0; k < 3; ++k) {
+            result[id[t]][k] = id[adjacent[3 * t + k] / 3];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Twin links and ghost triangles for a bare list of real triangles.
+ *
+ * Half-edges are bucketed by origin; the twin of u -> w is found among the
+ * few edges leaving w. Edges without a twin are on the hull and get a ghost.
+ */
+void GeomCore::Delaunay::rebuild_adjacency(unsigned threads) {
+    size_t n = coords.size() / 2;
+    uint32_t half = static_cast<uint32_t>(corners.size());
+
+    std::vector<uint32_t> first(n + 1, 0);
+    for (uint32_t e = 0; e < half; ++e) ++first[corners[e] + 1];
+    for (size_t v = 0; v < n; ++v) first[v + 1] += first[v];
+    std::vector<uint32_t> outgoing(half), fill(first.begin(), first.end() - 1);
+    for (uint32_t e = 0; e < half; ++e) outgoing[fill[corners[e]]++] = e;
+
+    adjacent.assign(half, NONE);
+    parallel_blocks(half, 1 << 16, threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t e = begin; e < end; ++e) {
+            uint32_t u = corners[e], w = corners[next_edge(static_cast<uint32_t>(e))];
+            for (uint32_t i = first[w]; i < first[w + 1]; ++i) {
+                if (corners[next_edge(outgoing[i])] == u) {
+                    adjacent[e] = outgoing[i];
+                    break;
+                }
+            }
+        }
+    });
+
+    constrained.assign(half, 0);
+    stamp.assign(half / 3, 0);
+    exterior.clear();
+    vertex_triangle.clear();
+    epoch = 0;
+    last = 0;
+
+    // fill is reused to find the ghost ending at each hull vertex
+    std::vector<uint32_t> hull;
+    for (uint32_t e = 0; e < half; ++e) {
+        if (adjacent[e] == NONE) hull.push_back(e);
+    }
+    std::vector<uint32_t> ghosts;
+    ghosts.reserve(hull.size());
+    for (uint32_t e : hull) {
+        uint32_t u = corners[e], w = corners[next_edge(e)];
+        uint32_t g = add_triangle(w, u, GHOST);
+        link(3 * g, e);
+        fill[w] = g;
+        ghosts.push_back(g);
+    }
+    for (uint32_t g : ghosts) {
+        link(3 * g + 1, 3 * fill[corners[3 * g + 1]] + 2);
+    }
+}
+
+/**
+ * @brief Whether the circumcircle of abc lies strictly between x = left and
+ * x = right, allowing generously for rounding in its center and radius.
+ */
+static bool circle_between(double ax, double ay, double bx, double by, double cx, double cy, double left, double right) {
+    double ux = bx - ax, uy = by - ay, vx = cx - ax, vy = cy - ay;
+    double cross = ux * vy - uy * vx;
+    // Nearly flat triangles have huge, poorly determined circles
+    if (std::abs(cross) <= 1e-6 * (std::abs(ux * vy) + std::abs(uy * vx))) return false;
+
+    double u2 = ux * ux + uy * uy, v2 = vx * vx + vy * vy;
+    double d = 2.0 * cross;
+    double ox = (vy * u2 - uy * v2) / d, oy = (ux * v2 - vx * u2) / d;
+    double r = std::sqrt(ox * ox + oy * oy);
+    double center = ax + ox;
+    double error = 1e-8 * ((std::abs(vy) * u2 + std::abs(uy) * v2) / std::abs(d) + std::abs(ax) + r);
+    return center - r - error > left && center + r + error < right;
+}
+
+/**
+ * @brief Delaunay triangulation built from independently triangulated strips.
+ *
+ * Points are split into vertical strips of equal size, each triangulated on
+ * its own thread. A strip triangle whose circumcircle stays strictly inside
+ * the strip's x-range contains no point of any other strip, so it is final.
+ * The vertices of all remaining triangles form the seam set; its Delaunay
+ * triangulation, constrained to the edges where final and non-final strip
+ * triangles meet, supplies exactly the missing triangles, which are found by
+ * a flood fill from those edges.
+ */
+void GeomCore::Delaunay::triangulate_parallel(const PointR2* points, size_t n, unsigned threads) {
+    if (threads == 0) threads = default_thread_count();
+
+    // Below this many points per strip the seams outweigh the parallel work
+    constexpr size_t min_strip = 1 << 14;
+    size_t strips = std::min<size_t>(threads, n / min_strip);
+    if (strips < 2) {
+        triangulate(points, n);
+        return;
+    }
+
+    load(points, n, false);
+    clear_mesh();
+
+    auto less_x = [this](uint32_t a, uint32_t b) {
+        if (coords[2 * a] != coords[2 * b]) return coords[2 * a] < coords[2 * b];
+        if (coords[2 * a + 1] != coords[2 * b + 1]) return coords[2 * a + 1] < coords[2 * b + 1];
+        return a < b;
+    };
+    std::vector<uint32_t> by_x(n);
+    std::iota(by_x.begin(), by_x.end(), 0u);
+    std::vector<size_t> bounds(strips + 1);
+    for (size_t s = 0; s <= strips; ++s) bounds[s] = n * s / strips;
+
+    auto split = [&](auto&& self, size_t lo, size_t hi) -> void {
+        if (hi - lo < 2) return;
+        size_t mid = (lo + hi) / 2;
+        std::nth_element(by_x.begin() + bounds[lo], by_x.begin() + bounds[mid], by_x.begin() + bounds[hi], less_x);
+        self(self, lo, mid);
+        self(self, mid, hi);
+    };
+    split(split, 0, strips);
+
+    // Keep copies of one point in a single strip
+    for (size_t s = 1; s < strips; ++s) {
+        uint32_t pivot = by_x[bounds[s]];
+        auto differs = [&](uint32_t p) {
+            return coords[2 * p] != coords[2 * pivot] || coords[2 * p + 1] != coords[2 * pivot + 1];
+        };
+        auto middle = std::partition(by_x.begin() + bounds[s - 1], by_x.begin() + bounds[s], differs);
+        bounds[s] = middle - by_x.begin();
+    }
+
+    std::vector<double> strip_min(strips, std::numeric_limits<double>::infinity());
+    std::vector<double> strip_max(strips, -std::numeric_limits<double>::infinity());
+    for (size_t s = 0; s < strips; ++s) {
+        for (size_t i = bounds[s]; i < bounds[s + 1]; ++i) {
+            strip_min[s] = std::min(strip_min[s], coords[2 * by_x[i]]);
+            strip_max[s] = std::max(strip_max[s], coords[2 * by_x[i]]);
+        }
+    }
+
+    struct strip_result {
+        std::vector<IndexTriangle> final;
+        std::vector<std::array<uint32_t, 2>> walls;
+    };
+    std::vector<strip_result> results(strips);
+    std::vector<uint8_t> seam(n, 0);
+
+    parallel_for(strips, [&](size_t s) {
+        const uint32_t* global = by_x.data() + bounds[s];
+        uint32_t count = static_cast<uint32_t>(bounds[s + 1] - bounds[s]);
+        double left = s == 0 ? -std::numeric_limits<double>::infinity() : strip_max[s - 1];
+        double right = s + 1 == strips ? std::numeric_limits<double>::infinity() : strip_min[s + 1];
+
+        std::vector<PointR2> local_points;
+        local_points.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            local_points.emplace_back(coords[2 * global[i]], coords[2 * global[i] + 1]);
+        }
+        Delaunay local;
+        local.triangulate(local_points);
+
+        // Local vertices map to global points through the strip's positions
+        const auto& lc = local.corners;
+        auto to_global = [&](uint32_t v) { return global[local.input_index[v]]; };
+        uint32_t triangle_count = static_cast<uint32_t>(lc.size() / 3);
+        std::vector<uint8_t> is_final(triangle_count, 0);
+        for (uint32_t t = 0; t < triangle_count; ++t) {
+            if (local.is_ghost(t)) continue;
+            const double* a = &local.coords[2 * lc[3 * t]];
+            const double* b = &local.coords[2 * lc[3 * t + 1]];
+            const double* c = &local.coords[2 * lc[3 * t + 2]];
+            is_final[t] = circle_between(a[0], a[1], b[0], b[1], c[0], c[1], left, right);
+        }
+
+        std::vector<uint8_t> touched(count, 0);
+        auto& result = results[s];
+        for (uint32_t t = 0; t < triangle_count; ++t) {
+            for (uint32_t e = 3 * t; e < 3 * t + 3; ++e) {
+                if (lc[e] == GHOST) continue;
+                touched[lc[e]] = 1;
+                if (!is_final[t]) seam[to_global(lc[e])] = 1;
+            }
+            if (!is_final[t]) continue;
+            result.final.push_back({to_global(lc[3 * t]), to_global(lc[3 * t + 1]), to_global(lc[3 * t + 2])});
+            for (uint32_t e = 3 * t; e < 3 * t + 3; ++e) {
+                if (!is_final[local.adjacent[e] / 3]) {
+                    result.walls.push_back({to_global(lc[e]), to_global(lc[next_edge(e)])});
+                }
+            }
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t v = local.vertex_of[i];
+            if (local.input_index[v] != i) {
+                vertex_of[global[i]] = to_global(v);
+            } else if (!touched[v]) {
+                // Points of a strip too degenerate to triangulate
+                seam[global[i]] = 1;
+            }
+        }
+    }, threads);
+
+    // Triangulate the seams
+    std::vector<uint32_t> seam_points, seam_index(n, NONE);
+    for (uint32_t i = 0; i < n; ++i) {
+        if (!seam[i]) continue;
+        seam_index[i] = static_cast<uint32_t>(seam_points.size());
+        seam_points.push_back(i);
+    }
+    std::vector<PointR2> merged_points;
+    merged_points.reserve(seam_points.size());
+    for (uint32_t p : seam_points) merged_points.emplace_back(coords[2 * p], coords[2 * p + 1]);
+
+    Delaunay merged;
+    merged.triangulate(merged_points);
+    for (const auto& result : results) {
+        for (const auto& wall : result.walls) {
+            merged.add_constraint(seam_index[wall[0]], seam_index[wall[1]]);
+        }
+    }
+
+    // Flood the seam triangulation from the far side of every wall
+    uint32_t merged_count = static_cast<uint32_t>(merged.corners.size() / 3);
+    std::vector<uint8_t> taken(merged_count, 0);
+    std::vector<uint32_t> queue;
+    bool any_wall = false;
+    for (const auto& result : results) {
+        for (const auto& wall : result.walls) {
+            any_wall = true;
+            uint32_t e = merged.find_edge(merged.vertex_of[seam_index[wall[1]]], merged.vertex_of[seam_index[wall[0]]]);
+            if (e == NONE) {
+                throw std::runtime_error("Strip seams are inconsistent");
+            }
+            uint32_t t = e / 3;
+            if (merged.is_ghost(t) || taken[t]) continue;
+            taken[t] = 1;
+            queue.push_back(t);
+        }
+    }
+    if (!any_wall) {
+        for (uint32_t t = 0; t < merged_count; ++t) taken[t] = !merged.is_ghost(t);
+    }
+    for (size_t i = 0; i < queue.size(); ++i) {
+        uint32_t t = queue[i];
+        for (uint32_t e = 3 * t; e < 3 * t + 3; ++e) {
+            if (merged.constrained[e]) continue;
+            uint32_t neighbor = merged.adjacent[e] / 3;
+            if (taken[neighbor] || merged.is_ghost(neighbor)) continue;
+            taken[neighbor] = 1;
+            queue.push_back(neighbor);
+        }
+    }
+
+    // Assemble the final strip triangles and the flooded seam triangles
+    size_t total = 0;
+    for (const auto& result : results) total += result.final.size();
+    corners.reserve(3 * (total + merged_count) + 6);
+    for (auto& result : results) {
+        for (const auto& t : result.final) corners.insert(corners.end(), t.begin(), t.end());
+        result = strip_result();
+    }
+    for (uint32_t t = 0; t < merged_count; ++t) {
+        if (!taken[t]) continue;
+        for (uint32_t k = 0; k < 3; ++k) {
+            corners.push_back(seam_points[merged.input_index[merged.corners[3 * t + k]]]);
+        }
+    }
+
+    rebuild_adjacency(threads);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Point.hpp"
+#include "Polygon.hpp"
+#include "Triangulation.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace GeomCore {
+
+    // Incremental Delaunay triangulation of a planar point set.
+    //
+    // Points are inserted in biased randomized insertion order (BRIO): random
+    // rounds of doubling size, each sorted along a Hilbert curve, so that
+    // consecutive points are close together. Each point is located by a walk
+    // from the previous insertion and added with the Bowyer-Watson cavity
+    // step. The hull is closed with ghost triangles sharing a vertex at
+    // infinity, so points outside the current hull need no special case.
+    //
+    // The mesh is a flat triangle array: triangle t owns the half-edges
+    // 3t, 3t + 1 and 3t + 2, half-edge e runs from corner e to the next
+    // corner, and each half-edge stores its twin. All orientation and
+    // in-circle decisions use the exact predicates, so the result is
+    // Delaunay for any input, including duplicate and cocircular points.
+    class Delaunay {
+        public:
+            static constexpr uint32_t NONE = UINT32_MAX;
+
+            // Triangulate points[0..n). Duplicate points are triangulated once.
+            // Fewer than three non-collinear points give no triangles.
+            void triangulate(const PointR2* points, size_t n);
+            void triangulate(const std::vector<PointR2>& points) { triangulate(points.data(), points.size()); }
+
+            // Same result, computed by triangulating vertical strips on separate
+            // threads and retriangulating only the points near the strip seams.
+            // threads = 0 uses the hardware concurrency.
+            void triangulate_parallel(const PointR2* points, size_t n, unsigned threads = 0);
+
+            // Constrained Delaunay triangulation of a simple polygon and optional
+            // points inside it. Vertices are numbered boundary first, then
+            // interior; triangles outside the polygon are dropped.
+            void triangulate(const PolygonR2& boundary, const std::vector<PointR2>& interior = {});
+
+            // Force the segment between points a and b into the triangulation.
+            // A segment through other vertices is split at them. Throws
+            // std::out_of_range for unknown points and std::invalid_argument if
+            // it crosses an earlier constraint.
+            void add_constraint(uint32_t a, uint32_t b);
+
+            // Counter-clockwise triangles, as indices into the input points
+            std::vector<IndexTriangle> triangles() const;
+
+            // neighbors()[i][k] is the triangle across the edge from corner k
+            // to corner k + 1 of triangles()[i], or NONE on the boundary
+            std::vector<std::array<uint32_t, 3>> neighbors() const;
+
+        private:
+            void load(const PointR2* points, size_t n, bool spatial_order);
+            void clear_mesh();
+            void build();
+            void rebuild_adjacency(unsigned threads);
+
+            uint32_t add_triangle(uint32_t a, uint32_t b, uint32_t c);
+            void link(uint32_t e, uint32_t f) { adjacent[e] = f; adjacent[f] = e; }
+            bool is_ghost(uint32_t t) const;
+            void constrain(uint32_t a, uint32_t b);
+
+            uint32_t locate(uint32_t p);
+            bool in_circle(uint32_t t, uint32_t p) const;
+            void insert(uint32_t p);
+
+            double orient(uint32_t a, uint32_t b, uint32_t c) const;
+            uint32_t find_edge(uint32_t u, uint32_t w) const;
+            void flip(uint32_t e);
+            void index_vertices();
+            void remove_exterior();
+
+            // Vertices are numbered in insertion order, so that points inserted
+            // one after another are also close in memory
+            std::vector<double> coords;          // interleaved x, y per vertex
+            std::vector<uint32_t> input_index;   // vertex -> input point
+            std::vector<uint32_t> vertex_of;     // input point -> vertex of its first copy
+
+            // Mesh: corners, twin half-edges, constrained half-edges
+            std::vector<uint32_t> corners;
+            std::vector<uint32_t> adjacent;
+            std::vector<uint8_t> constrained;
+            std::vector<uint8_t> exterior;
+            // One triangle around each vertex, built on demand for constraints
+            std::vector<uint32_t> vertex_triangle;
+
+            // Insertion scratch
+            struct cavity_edge { uint32_t from, to, twin; };
+            uint32_t last = 0;
+            uint32_t walk_step = 0;
+            uint32_t epoch = 0;
+            std::vector<uint32_t> stamp;
+            std::vector<uint32_t> cavity;
+            std::vector<cavity_edge> boundary;
+            std::vector<uint32_t> fan;
+    };
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Floating-point expansion arithmetic after Shewchuk (1997), shared by the
+// robust predicates and the other modules that need exact signs of
+// polynomials in double coordinates.
+
+namespace GeomCore::exact_arithmetic {
+
+    // Error-free transformations: each returns the rounded result x and the
+    // rounding error y, so that x + y is exact.
+
+    inline void two_sum(double a, double b, double& x, double& y) {
+        x = a + b;
+        double b_virtual = x - a;
+        double a_virtual = x - b_virtual;
+        y = (a - a_virtual) + (b - b_virtual);
+    }
+
+    // Requires |a| >= |b|
+    inline void fast_two_sum(double a, double b, double& x, double& y) {
+        x = a + b;
+        y = b - (x - a);
+    }
+
+    inline double two_diff_tail(double a, double b, double x) {
+        double b_virtual = a - x;
+        double a_virtual = x + b_virtual;
+        return (a - a_virtual) + (b_virtual - b);
+    }
+
+    inline void two_product(double a, double b, double& x, double& y) {
+        x = a * b;
+#ifdef FP_FAST_FMA
+        y = std::fma(a, b, -x);
+#else
+        // Dekker's product: split each factor into two 26-bit halves
+        constexpr double splitter = 134217729.0;  // 2^27 + 1
+        double c = splitter * a;
+        double a_hi = c - (c - a), a_lo = a - a_hi;
+        c = splitter * b;
+        double b_hi = c - (c - b), b_lo = b - b_hi;
+        y = a_lo * b_lo - (((x - a_hi * b_hi) - a_lo * b_hi) - a_hi * b_lo);
+#endif
+    }
+
+    // Expansion arithmetic. An expansion is a sum of nonoverlapping doubles
+    // stored in increasing order of magnitude; zero components are dropped.
+
+    inline size_t expansion_sum(size_t elen, const double* e, size_t flen, const double* f, double* h) {
+        if (elen == 0) { std::copy(f, f + flen, h); return flen; }
+        if (flen == 0) { std::copy(e, e + elen, h); return elen; }
+
+        size_t ei = 0, fi = 0, hi = 0;
+        double e_now = e[0], f_now = f[0], q, q_new, hh;
+        auto next_e = [&] { e_now = ++ei < elen ? e[ei] : 0.0; };
+        auto next_f = [&] { f_now = ++fi < flen ? f[fi] : 0.0; };
+
+        if ((f_now > e_now) == (f_now > -e_now)) { q = e_now; next_e(); }
+        else { q = f_now; next_f(); }
+
+        if (ei < elen && fi < flen) {
+            if ((f_now > e_now) == (f_now > -e_now)) { fast_two_sum(e_now, q, q_new, hh); next_e(); }
+            else { fast_two_sum(f_now, q, q_new, hh); next_f(); }
+            q = q_new;
+            if (hh != 0.0) h[hi++] = hh;
+            while (ei < elen && fi < flen) {
+                if ((f_now > e_now) == (f_now > -e_now)) { two_sum(q, e_now, q_new, hh); next_e(); }
+                else { two_sum(q, f_now, q_new, hh); next_f(); }
+                q = q_new;
+                if (hh != 0.0) h[hi++] = hh;
+            }
+        }
+        while (ei < elen) {
+            two_sum(q, e_now, q_new, hh);
+            next_e();
+            q = q_new;
+            if (hh != 0.0) h[hi++] = hh;
+        }
+        while (fi < flen) {
+            two_sum(q, f_now, q_new, hh);
+            next_f();
+            q = q_new;
+            if (hh != 0.0) h[hi++] = hh;
+        }
+        if (q != 0.0 || hi == 0) h[hi++] = q;
+        return hi;
+    }
+
+    inline size_t scale_expansion(size_t elen, const double* e, double b, double* h) {
+        if (elen == 0) return 0;
+
+        size_t hi = 0;
+        double q, hh, product1, product0, sum;
+        two_product(e[0], b, q, hh);
+        if (hh != 0.0) h[hi++] = hh;
+        for (size_t i = 1; i < elen; ++i) {
+            two_product(e[i], b, product1, product0);
+            two_sum(q, product0, sum, hh);
+            if (hh != 0.0) h[hi++] = hh;
+            fast_two_sum(product1, sum, q, hh);
+            if (hh != 0.0) h[hi++] = hh;
+        }
+        if (q != 0.0 || hi == 0) h[hi++] = q;
+        return hi;
+    }
+
+    // Expansion of at most N components on the stack, for the adaptive
+    // stages whose sizes are known at compile time
+    template<size_t N>
+    struct expansion {
+        double c[N];
+        size_t n = 0;
+
+        // Approximate value, used against error bounds
+        double estimate() const {
+            double sum = 0.0;
+            for (size_t i = 0; i < n; ++i) sum += c[i];
+            return sum;
+        }
+
+        // Most significant component; carries the exact sign
+        double value() const { return n ? c[n - 1] : 0.0; }
+    };
+
+    inline expansion<1> single(double a) {
+        expansion<1> e;
+        e.c[0] = a;
+        e.n = 1;
+        return e;
+    }
+
+    inline expansion<2> product(double a, double b) {
+        expansion<2> e;
+        double x, y;
+        two_product(a, b, x, y);
+        if (y != 0.0) e.c[e.n++] = y;
+        e.c[e.n++] = x;
+        return e;
+    }
+
+    template<size_t A, size_t B>
+    expansion<A + B> operator+(const expansion<A>& e, const expansion<B>& f) {
+        expansion<A + B> h;
+        h.n = expansion_sum(e.n, e.c, f.n, f.c, h.c);
+        return h;
+    }
+
+    template<size_t A, size_t B>
+    expansion<A + B> operator-(const expansion<A>& e, const expansion<B>& f) {
+        expansion<B> g = f;
+        for (size_t i = 0; i < g.n; ++i) g.c[i] = -g.c[i];
+        return e + g;
+    }
+
+    template<size_t A, size_t B>
+    expansion<2 * A * B> operator*(const expansion<A>& e, const expansion<B>& f) {
+        expansion<2 * A * B> h, t;
+        double scaled[2 * A];
+        double *acc = h.c, *next = t.c;
+        size_t len = 0;
+        for (size_t j = 0; j < f.n; ++j) {
+            size_t slen = scale_expansion(e.n, e.c, f.c[j], scaled);
+            len = expansion_sum(len, acc, slen, scaled, next);
+            std::swap(acc, next);
+        }
+        if (acc != h.c) std::copy(acc, acc + len, h.c);
+        h.n = len;
+        return h;
+    }
+
+    // Heap-backed expansion for the fully exact evaluations, which only run
+    // when the adaptive stages cannot decide
+    struct exact {
+        std::vector<double> c;
+
+        double value() const { return c.empty() ? 0.0 : c.back(); }
+    };
+
+    // a - b as an exact two-component expansion
+    inline exact difference(double a, double b) {
+        double x = a - b, y = two_diff_tail(a, b, x);
+        exact e;
+        if (y != 0.0) e.c.push_back(y);
+        if (x != 0.0) e.c.push_back(x);
+        return e;
+    }
+
+    inline exact operator+(const exact& e, const exact& f) {
+        exact h;
+        h.c.resize(e.c.size() + f.c.size());
+        h.c.resize(expansion_sum(e.c.size(), e.c.data(), f.c.size(), f.c.data(), h.c.data()));
+        return h;
+    }
+
+    inline exact operator-(const exact& e, const exact& f) {
+        exact g = f;
+        for (double& x : g.c) x = -x;
+        return e + g;
+    }
+
+    inline exact operator*(const exact& e, const exact& f) {
+        std::vector<double> acc, next, scaled(2 * e.c.size());
+        for (double b : f.c) {
+            size_t slen = scale_expansion(e.c.size(), e.c.data(), b, scaled.data());
+            next.resize(acc.size() + slen);
+            next.resize(expansion_sum(acc.size(), acc.data(), slen, scaled.data(), next.data()));
+            std::swap(acc, next);
+        }
+        return exact{std::move(acc)};
+    }
+}
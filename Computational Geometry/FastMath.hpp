@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Simd.hpp"
+
+#include <cstddef>
+
+// Elementary functions on simd::vdouble, built from the operations in
+// Simd.hpp only: range reduction by selects, then a rational or polynomial
+// approximation. Every lane takes the same path, so there are no branches,
+// and results match the standard library to within a few ulps.
+
+namespace GeomCore::simd {
+
+    namespace detail {
+        constexpr double pi = 3.14159265358979323846;
+
+        // Low bits of pi / 4 that a double cannot hold, added back after
+        // the reduction around pi / 4
+        constexpr double pi_4_low = 3.061616997868382943065e-17;
+
+        // ln 2 split into a part with few significant bits, so that n times
+        // it is exact, and the remainder
+        constexpr double ln2_high = 0.693359375;
+        constexpr double ln2_low = -2.121944400546905827679e-4;
+
+        // Horner evaluation of c[0] x^(N-1) + ... + c[N-1]
+        template<size_t N>
+        inline vdouble polynomial(vdouble x, const double (&c)[N]) {
+            vdouble r = broadcast(c[0]);
+            for (size_t i = 1; i < N; ++i) r = fmadd(r, x, broadcast(c[i]));
+            return r;
+        }
+    }
+
+    // atan(x) for 0 <= x <= 1. Arguments above tan(pi / 8) are reduced by
+    // atan(x) = pi / 4 + atan((x - 1) / (x + 1)); the reduced argument is
+    // fed to the rational approximation of the Cephes library.
+    inline vdouble atan_unit(vdouble x) {
+        static constexpr double p[] = {-8.750608600031904122785e-1, -1.615753718733365076637e1,
+                                       -7.500855792314704667340e1, -1.228866684490136173410e2,
+                                       -6.485021904942025371773e1};
+        static constexpr double q[] = {1.0, 2.485846490142306297962e1, 1.650270098316988542046e2,
+                                       4.328810604912902668951e2, 4.853903996359136964868e2,
+                                       1.945506571482613964425e2};
+
+        vmask reduce = less(broadcast(0.4142135623730950488), x);
+        vdouble one = broadcast(1.0);
+        x = select(reduce, div(sub(x, one), add(x, one)), x);
+
+        vdouble z = mul(x, x);
+        vdouble r = div(mul(z, detail::polynomial(z, p)), detail::polynomial(z, q));
+        r = fmadd(x, r, x);
+        vdouble zero = broadcast(0.0);
+        r = add(r, select(reduce, broadcast(detail::pi_4_low), zero));
+        return add(r, select(reduce, broadcast(detail::pi / 4), zero));
+    }
+
+    // atan2(y, x) in [-pi, pi]. The smaller of |x| and |y| over the larger
+    // stays in [0, 1]; the octant is restored from the signs and the order
+    // of |x| and |y|. atan2(0, 0) is 0.
+    inline vdouble atan2(vdouble y, vdouble x) {
+        vdouble zero = broadcast(0.0);
+        vdouble ax = abs(x), ay = abs(y);
+        vdouble lo = min(ax, ay), hi = max(ax, ay);
+        vdouble ratio = select(less(zero, hi), div(lo, hi), zero);
+
+        vdouble a = atan_unit(ratio);
+        a = select(less(ax, ay), sub(broadcast(detail::pi / 2), a), a);
+        a = select(less(x, zero), sub(broadcast(detail::pi), a), a);
+        return select(less(y, zero), sub(zero, a), a);
+    }
+
+    // Angle between two vectors, atan2(|a x b|, a . b): accurate for nearly
+    // parallel and nearly opposite vectors alike, and independent of their
+    // lengths, so the inputs need not be normalized
+    inline vdouble angle(vdouble ax, vdouble ay, vdouble az, vdouble bx, vdouble by, vdouble bz) {
+        vdouble cx = fmsub(ay, bz, mul(az, by));
+        vdouble cy = fmsub(az, bx, mul(ax, bz));
+        vdouble cz = fmsub(ax, by, mul(ay, bx));
+        vdouble cross = sqrt(fmadd(cx, cx, fmadd(cy, cy, mul(cz, cz))));
+        vdouble dot = fmadd(ax, bx, fmadd(ay, by, mul(az, bz)));
+        return atan2(cross, dot);
+    }
+
+    // Natural logarithm of positive normal x: x = m * 2^e with m in
+    // [sqrt(1/2), sqrt(2)), then the Cephes rational approximation of
+    // log(1 + f), f = m - 1.
+    inline vdouble log(vdouble x) {
+        static constexpr double p[] = {1.01875663804580931796e-4, 4.97494994976747001425e-1,
+                                       4.70579119878881725854e0, 1.44989225341610930846e1,
+                                       1.79368678507819816313e1, 7.70838733755885391666e0};
+        static constexpr double q[] = {1.0, 1.12873587189167450590e1, 4.52279145837532221105e1,
+                                       8.29875266912776603211e1, 7.11544750618563894466e1,
+                                       2.31251620126765340583e1};
+
+        vdouble e = exponent(x), m = mantissa(x);
+        vmask high = less(broadcast(1.41421356237309504880), m);
+        m = select(high, mul(m, broadcast(0.5)), m);
+        e = select(high, add(e, broadcast(1.0)), e);
+
+        vdouble f = sub(m, broadcast(1.0));
+        vdouble z = mul(f, f);
+        vdouble y = mul(f, div(mul(z, detail::polynomial(f, p)), detail::polynomial(f, q)));
+        y = fmadd(e, broadcast(detail::ln2_low), y);
+        y = fmadd(z, broadcast(-0.5), y);
+        return fmadd(e, broadcast(detail::ln2_high), add(f, y));
+    }
+
+    // log(1 + x) for x > -1, accurate for small x: the rounding error of
+    // u = 1 + x is corrected to first order
+    inline vdouble log1p(vdouble x) {
+        vdouble u = add(broadcast(1.0), x);
+        vdouble lost = sub(sub(u, broadcast(1.0)), x);
+        return sub(log(u), div(lost, u));
+    }
+
+    // acosh(x) for x >= 1 as log1p(t + sqrt(t (t + 2))), t = x - 1, which
+    // keeps its precision near 1; large x use log(x) + log(2)
+    inline vdouble acosh(vdouble x) {
+        vdouble t = sub(x, broadcast(1.0));
+        vdouble near = log1p(add(t, sqrt(mul(t, add(t, broadcast(2.0))))));
+        vdouble far = add(log(x), broadcast(0.69314718055994530942));
+        return select(less(broadcast(0x1p28), x), far, near);
+    }
+
+    // e^x with x = n log(2) + r, |r| <= log(2) / 2, and the Cephes Pade
+    // form of e^r; overflows to infinity and underflows to zero
+    inline vdouble exp(vdouble x) {
+        static constexpr double p[] = {1.26177193074810590878e-4, 3.02994407707441961300e-2,
+                                       9.99999999999999999910e-1};
+        static constexpr double q[] = {3.00198505138664455042e-6, 2.52448340349684104192e-3,
+                                       2.27265548208155028766e-1, 2.00000000000000000009e0};
+        static constexpr double ln2_c1 = 6.93145751953125e-1, ln2_c2 = 1.42860682030941723212e-6;
+
+        x = min(max(x, broadcast(-746.0)), broadcast(710.0));
+        vdouble n = round(mul(x, broadcast(1.44269504088896340736)));
+        x = fmadd(n, broadcast(-ln2_c1), x);
+        x = fmadd(n, broadcast(-ln2_c2), x);
+
+        vdouble z = mul(x, x);
+        vdouble px = mul(x, detail::polynomial(z, p));
+        vdouble r = div(px, sub(detail::polynomial(z, q), px));
+        return ldexp(fmadd(r, broadcast(2.0), broadcast(1.0)), n);
+    }
+
+    // sinh(x): the Taylor series below |x| = 1/2, where (e^x - e^-x) / 2
+    // would cancel, and that formula above
+    inline vdouble sinh(vdouble x) {
+        static constexpr double c[] = {1.0 / 1307674368000.0, 1.0 / 6227020800.0, 1.0 / 39916800.0,
+                                       1.0 / 362880.0, 1.0 / 5040.0, 1.0 / 120.0, 1.0 / 6.0};
+        vdouble a = abs(x);
+        vdouble z = mul(x, x);
+        vdouble series = fmadd(mul(x, z), detail::polynomial(z, c), x);
+
+        vdouble e = exp(a);
+        vdouble half = broadcast(0.5);
+        vdouble large = fmsub(e, half, div(half, e));
+        large = select(less(x, broadcast(0.0)), sub(broadcast(0.0), large), large);
+        return select(less(a, half), series, large);
+    }
+
+    inline vdouble cosh(vdouble x) {
+        vdouble e = exp(abs(x));
+        vdouble half = broadcast(0.5);
+        return fmadd(e, half, div(half, e));
+    }
+}
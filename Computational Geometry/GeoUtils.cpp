@@ -1,5 +1,6 @@
 #include "GeoUtils.hpp"
 #include "Intersection.hpp"
+#include "Predicates.hpp"
 
 double GeomCore::area_triangle_2d(const PointR2 &a, const PointR2 &b, const PointR2 &c){
     auto AB = b - a;
@@ -10,13 +11,8 @@ double GeomCore::area_triangle_2d(const PointR2 &a, const PointR2 &b, const Poin
 }
 
 int GeomCore::orientation_R2(const PointR2& a, const PointR2& b, const PointR2& c) {
-    Vector2d ab = b - a;
-    Vector2d ac = c - a;
-
-    double det = cross_product_R2(ab, ac);
-
-    if (std::abs(det) < TOLERANCE)
-        det = 0.0;
+    // Exact sign; only exactly collinear points fall through
+    double det = orient2d(a, b, c);
 
     if (det > 0.0)
         return LEFT;
@@ -24,6 +20,9 @@ int GeomCore::orientation_R2(const PointR2& a, const PointR2& b, const PointR2&
     if (det < 0.0)
         return RIGHT;
 
+    Vector2d ab = b - a;
+    Vector2d ac = c - a;
+
     double dot = ab[X] * ac[X] + ab[Y] * ac[Y];
 
     if (dot < 0.0)
@@ -102,14 +101,11 @@ bool GeomCore::collinear(const PointR3& a, const PointR3& b, const PointR3& c){
  * (box product) vanishes:
  *     [a, b, c] = a · (b × c) = 0
  *
- * This is equivalent to the vectors being linearly dependent in ℝ³.
- * The function delegates to scaler_triple_product(), which must compute
- * the determinant of the matrix formed by the three vectors.
+ * This is equivalent to the vectors being linearly dependent in ℝ³, i.e. to
+ * the tetrahedron (0, a, b, c) being flat, which orient3d decides exactly.
  */
-
 bool GeomCore::coplaner(const Vector3d& a, const Vector3d& b, const Vector3d& c){
-    float value = scaler_triple_product(a, b, c);
-    return is_equal_1D(value, 0.0f);
+    return orient3d(Vector3d(), a, b, c) == 0.0;
 }
 
 /**
@@ -118,16 +114,12 @@ bool GeomCore::coplaner(const Vector3d& a, const Vector3d& b, const Vector3d& c)
  * Four points are coplanar iff the vectors AB, AC, AD are coplanar, i.e.
  *     [AB, AC, AD] = AB · (AC × AD) = 0
  *
- * This condition is equivalent to the scalar triple product of the three
- * direction vectors from A being zero, or equivalently, the volume of the
- * tetrahedron formed by the four points being zero.
+ * This condition is equivalent to the volume of the tetrahedron formed by
+ * the four points being zero. orient3d evaluates it on the points
+ * themselves, so no rounding from forming AB, AC, AD is introduced.
  */
 bool GeomCore::coplaner(const PointR3& a, const PointR3& b, const PointR3& c, const PointR3& d){
-    auto AB = b - a;
-    auto AC = c - a;
-    auto AD = d - a;
-
-    return coplaner(AB, AC, AD);
+    return orient3d(a, b, c, d) == 0.0;
 }
 
 static bool interior_check(const VertexR2 *v1, const VertexR2 *v2) {
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Manifold.hpp"
+#include "Point.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace GeomCore {
+
+    // Geodesic distance, interpolation and angle on a StaticManifold, with
+    // the formulas picked at compile time from the manifold's kind:
+    //
+    //   Euclidean    points of R3, joined by straight segments
+    //   Spherical    directions from the centre, measured on the sphere of
+    //                the manifold's radius, as the spherical_* functions
+    //   Hyperbolic   points on the hyperboloid x^2 + y^2 - z^2 = -R^2,
+    //                z > 0, as the hyperbolic_* functions
+    //
+    // None of them checks the kind or throws, and they use only the cached
+    // radius, so they can sit in loops over many points.
+
+    namespace detail {
+        constexpr double minkowski_form(const PointR3& a, const PointR3& b) {
+            return a.unchecked(X) * b.unchecked(X) + a.unchecked(Y) * b.unchecked(Y) - a.unchecked(Z) * b.unchecked(Z);
+        }
+
+        // Angle between two vectors, stable for nearly parallel and nearly
+        // opposite ones
+        inline double vector_angle(const PointR3& a, const PointR3& b) {
+            return std::atan2(cross_product_R3(a, b).magnitude(), dot_product(a, b));
+        }
+
+        // Weights of a and b for the point at parameter t of a geodesic that
+        // subtends omega, sin-like ratios f((1 - t) omega) / f(omega) and
+        // f(t omega) / f(omega); the limits 1 - t and t when f(omega) = 0
+        template<class Function>
+        std::pair<double, double> interpolation_weights(Function f, double omega, double t) {
+            double whole = f(omega);
+            if (whole == 0.0) return {1.0 - t, t};
+            return {f((1.0 - t) * omega) / whole, f(t * omega) / whole};
+        }
+    }
+
+    template<GeometryKind K, typename T>
+    requires Real<T>
+    T geodesic_distance([[maybe_unused]] const StaticManifold<K, T>& manifold, const PointR3& p1, const PointR3& p2) {
+        if constexpr (K == GeometryKind::Euclidean) {
+            return static_cast<T>((p2 - p1).magnitude());
+        } else if constexpr (K == GeometryKind::Spherical) {
+            return manifold.radius * static_cast<T>(detail::vector_angle(p1, p2));
+        } else {
+            T ratio = manifold.inverse_radius * manifold.inverse_radius;
+            T arg = -static_cast<T>(detail::minkowski_form(p1, p2)) * ratio;
+            return manifold.radius * std::acosh(std::max(arg, T{1}));
+        }
+    }
+
+    // Point at parameter t of the geodesic from p1 (t = 0) to p2 (t = 1):
+    // on the sphere and the hyperboloid of the manifold's radius for the
+    // curved kinds
+    template<GeometryKind K, typename T>
+    requires Real<T>
+    PointR3 geodesic_point([[maybe_unused]] const StaticManifold<K, T>& manifold, const PointR3& p1, const PointR3& p2, T t) {
+        double s = static_cast<double>(t);
+        if constexpr (K == GeometryKind::Euclidean) {
+            return linear_combination(p1, 1.0 - s, p2, s);
+        } else if constexpr (K == GeometryKind::Spherical) {
+            PointR3 a = p1 * (1.0 / p1.magnitude()), b = p2 * (1.0 / p2.magnitude());
+            auto [w1, w2] = detail::interpolation_weights([](double x) { return std::sin(x); },
+                                                          detail::vector_angle(a, b), s);
+            PointR3 result = linear_combination(a, w1, b, w2);
+            return result * (static_cast<double>(manifold.radius) / result.magnitude());
+        } else {
+            double ratio = static_cast<double>(manifold.inverse_radius * manifold.inverse_radius);
+            double omega = std::acosh(std::max(-detail::minkowski_form(p1, p2) * ratio, 1.0));
+            auto [w1, w2] = detail::interpolation_weights([](double x) { return std::sinh(x); }, omega, s);
+            PointR3 result = linear_combination(p1, w1, p2, w2);
+            return result * (static_cast<double>(manifold.radius) / std::sqrt(-detail::minkowski_form(result, result)));
+        }
+    }
+
+    // Interior angle at p2 between the geodesics to p1 and to p3, in radians
+    template<GeometryKind K, typename T>
+    requires Real<T>
+    T angle([[maybe_unused]] const StaticManifold<K, T>& manifold, const PointR3& p1, const PointR3& p2, const PointR3& p3) {
+        if constexpr (K == GeometryKind::Euclidean) {
+            return static_cast<T>(detail::vector_angle(p1 - p2, p3 - p2));
+        } else if constexpr (K == GeometryKind::Spherical) {
+            // Between the normals of the great circles through p2
+            return static_cast<T>(detail::vector_angle(cross_product_R3(p2, p1), cross_product_R3(p2, p3)));
+        } else {
+            // Between the tangent vectors at p2, p + <p, p2> / R^2 p2, in
+            // the Minkowski inner product
+            double ratio = static_cast<double>(manifold.inverse_radius * manifold.inverse_radius);
+            PointR3 u = scale_add(p2, detail::minkowski_form(p1, p2) * ratio, p1);
+            PointR3 v = scale_add(p2, detail::minkowski_form(p3, p2) * ratio, p3);
+            double norms = std::sqrt(detail::minkowski_form(u, u) * detail::minkowski_form(v, v));
+            return static_cast<T>(std::acos(std::clamp(detail::minkowski_form(u, v) / norms, -1.0, 1.0)));
+        }
+    }
+}
@@ -0,0 +1,246 @@
+#include "GeodesicSampling.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using GeomCore::GeometryKind;
+
+// Points between exact re-anchorings of the rotation recurrence
+static constexpr size_t anchor_interval = 32;
+
+/**
+ * @brief Weights of the start and the tangent for the point at angle theta:
+ *        (cos, sin), (cosh, sinh), or (1, theta) for the Euclidean kind.
+ */
+template<GeometryKind K>
+static std::pair<double, double> rotation(double theta) {
+    if constexpr (K == GeometryKind::Spherical) {
+        return {std::cos(theta), std::sin(theta)};
+    } else if constexpr (K == GeometryKind::Hyperbolic) {
+        return {std::cosh(theta), std::sinh(theta)};
+    } else {
+        return {1.0, theta};
+    }
+}
+
+/**
+ * @brief Advances the weights (c, s) at angle theta to those at
+ *        theta + step, given the weights (cs, ss) of step itself.
+ */
+template<GeometryKind K>
+static void advance(double& c, double& s, double cs, double ss) {
+    double next_c = c;
+    if constexpr (K == GeometryKind::Spherical) {
+        next_c = c * cs - s * ss;
+        s = s * cs + c * ss;
+    } else if constexpr (K == GeometryKind::Hyperbolic) {
+        next_c = c * cs + s * ss;
+        s = s * cs + c * ss;
+    } else {
+        s += ss;
+    }
+    c = next_c;
+}
+
+/**
+ * @brief A unit vector orthogonal to the unit vector a, across its smallest
+ *        coordinate.
+ */
+static GeomCore::PointR3 any_orthogonal(const GeomCore::PointR3& a) {
+    GeomCore::PointR3 axis(0.0, 0.0, 0.0);
+    if (std::fabs(a[X]) <= std::fabs(a[Y]) && std::fabs(a[X]) <= std::fabs(a[Z])) {
+        axis[X] = 1.0;
+    } else if (std::fabs(a[Y]) <= std::fabs(a[Z])) {
+        axis[Y] = 1.0;
+    } else {
+        axis[Z] = 1.0;
+    }
+    GeomCore::PointR3 u = cross_product_R3(a, axis);
+    return u * (1.0 / u.magnitude());
+}
+
+template<GeometryKind K>
+GeomCore::GeodesicFrame<K>::GeodesicFrame(const StaticManifold<K, double>& manifold, const PointR3& p1,
+                                          const PointR3& p2)
+    : radius(manifold.radius), omega(0.0), start(p1), tangent(0.0, 0.0, 0.0), end(p2) {
+    if constexpr (K == GeometryKind::Euclidean) {
+        PointR3 d = p2 - p1;
+        omega = d.magnitude();
+        if (omega > 0.0) tangent = d * (1.0 / omega);
+    } else if constexpr (K == GeometryKind::Spherical) {
+        PointR3 a = p1 * (1.0 / p1.magnitude()), b = p2 * (1.0 / p2.magnitude());
+        // (a x b) x a is b less its component along a, without the
+        // cancellation of forming that difference directly
+        PointR3 normal = cross_product_R3(a, b);
+        double sine = normal.magnitude();
+        omega = std::atan2(sine, dot_product(a, b));
+        PointR3 u(0.0, 0.0, 0.0);
+        if (sine > 0.0) {
+            u = cross_product_R3(normal, a) * (1.0 / sine);
+        } else if (omega > 0.0) {
+            u = any_orthogonal(a);
+        }
+        start = a * radius;
+        tangent = u * radius;
+        end = b * radius;
+    } else {
+        double ratio = manifold.inverse_radius * manifold.inverse_radius;
+        start = p1 * (radius / std::sqrt(-detail::minkowski_form(p1, p1)));
+        end = p2 * (radius / std::sqrt(-detail::minkowski_form(p2, p2)));
+        // The tangent at start towards end is end + <start, end> / R^2 start,
+        // Minkowski-orthogonal to start
+        double form = detail::minkowski_form(start, end);
+        omega = std::acosh(std::max(-form * ratio, 1.0));
+        PointR3 w = scale_add(start, form * ratio, end);
+        double norm = detail::minkowski_form(w, w);
+        if (omega > 0.0 && norm > 0.0) tangent = w * (radius / std::sqrt(norm));
+    }
+}
+
+template<GeometryKind K>
+GeomCore::PointR3 GeomCore::GeodesicFrame<K>::point(double t) const {
+    auto [c, s] = rotation<K>(t * omega);
+    return linear_combination(start, c, tangent, s);
+}
+
+template<GeometryKind K>
+void GeomCore::GeodesicFrame<K>::sample(size_t count, double* x, double* y, double* z) const {
+    if (count == 0) return;
+
+    size_t steps = count - 1;
+    double step = steps > 0 ? omega / static_cast<double>(steps) : 0.0;
+    auto [cs, ss] = rotation<K>(step);
+    double c = 1.0, s = 0.0;
+    for (size_t k = 0; k < steps; ++k) {
+        if (k % anchor_interval == 0) {
+            auto anchor = rotation<K>(static_cast<double>(k) * step);
+            c = anchor.first;
+            s = anchor.second;
+        }
+        x[k] = c * start[X] + s * tangent[X];
+        y[k] = c * start[Y] + s * tangent[Y];
+        z[k] = c * start[Z] + s * tangent[Z];
+        advance<K>(c, s, cs, ss);
+    }
+
+    const PointR3& tail = steps > 0 ? end : start;
+    x[steps] = tail[X];
+    y[steps] = tail[Y];
+    z[steps] = tail[Z];
+}
+
+template<GeometryKind K>
+void GeomCore::GeodesicFrame<K>::sample(size_t count, PointCloud3& out) const {
+    out.resize(count);
+    sample(count, out.x(), out.y(), out.z());
+}
+
+/**
+ * @brief Appends the interior points and the end of one hyperbolic segment,
+ *        halving pieces until the chord of each strays at most tolerance
+ *        from its arc. At half-angle h around the point m, the chord's
+ *        middle is cosh(h) m, (cosh(h) - 1) |m| away.
+ */
+static void bisect(const GeomCore::GeodesicFrame<GeometryKind::Hyperbolic>& frame, double tolerance,
+                   std::vector<std::pair<double, double>>& pending, GeomCore::PointCloud3& out) {
+    constexpr int max_depth = 48;
+    pending.assign(1, {0.0, 1.0});
+    while (!pending.empty()) {
+        auto [a, b] = pending.back();
+        pending.pop_back();
+        double half = 0.5 * (b - a);
+        double middle = a + half;
+        bool deep = b - a <= std::ldexp(1.0, -max_depth);
+        if (deep || (std::cosh(half * frame.angle()) - 1.0) * frame.point(middle).magnitude() <= tolerance) {
+            out.push_back(b == 1.0 ? frame.last() : frame.point(b));
+            continue;
+        }
+        pending.push_back({middle, b});
+        pending.push_back({a, middle});
+    }
+}
+
+/**
+ * @brief Throws unless a segment's pieces can be counted in 32 bits.
+ */
+static void check_piece_count(double pieces) {
+    if (pieces > static_cast<double>(std::numeric_limits<uint32_t>::max())) {
+        throw std::length_error("densify_geodesic: too many points");
+    }
+}
+
+static bool is_finite(const GeomCore::PointR3& p) {
+    return std::isfinite(p[X]) && std::isfinite(p[Y]) && std::isfinite(p[Z]);
+}
+
+template<GeometryKind K>
+void GeomCore::densify_geodesic(const StaticManifold<K, double>& manifold, const PointCloud3& polyline,
+                                double tolerance, PointCloud3& out) {
+    if (!(tolerance > 0.0)) {
+        throw std::invalid_argument("densify_geodesic: tolerance must be positive");
+    }
+    out.clear();
+    if (polyline.empty()) return;
+    if (polyline.size() == 1) {
+        out.push_back(GeodesicFrame<K>(manifold, polyline[0], polyline[0]).first());
+        return;
+    }
+
+    // Largest angle whose arc strays at most tolerance from its chord,
+    // R (1 - cos(angle / 2)) on the sphere
+    [[maybe_unused]] double max_angle = std::numeric_limits<double>::infinity();
+    if constexpr (K == GeometryKind::Spherical) {
+        max_angle = tolerance < manifold.radius ? 2.0 * std::acos(1.0 - tolerance * manifold.inverse_radius)
+                                                : std::numbers::pi;
+    }
+
+    std::vector<std::pair<double, double>> pending;
+    for (size_t i = 0; i + 1 < polyline.size(); ++i) {
+        GeodesicFrame<K> frame(manifold, polyline[i], polyline[i + 1]);
+        // A zero vector on the sphere or a point off the hyperboloid's
+        // sheet has no projection onto the manifold
+        if (!std::isfinite(frame.angle()) || !is_finite(frame.first()) || !is_finite(frame.last())) {
+            throw std::invalid_argument("densify_geodesic: vertex not on the manifold");
+        }
+        if (i == 0) out.push_back(frame.first());
+        if constexpr (K == GeometryKind::Hyperbolic) {
+            // Points are furthest out at an end of the segment, so bisection
+            // stops no later than equal pieces sized for the farther end,
+            // with under twice as many pieces
+            double reach = std::max(frame.first().magnitude(), frame.last().magnitude());
+            check_piece_count(2.0 * std::ceil(frame.angle() / (2.0 * std::acosh(1.0 + tolerance / reach))));
+            bisect(frame, tolerance, pending, out);
+        } else {
+            double pieces = std::max(1.0, std::ceil(frame.angle() / max_angle));
+            check_piece_count(pieces);
+            // Overwrite the shared vertex, which the frame reproduces exactly
+            size_t base = out.size() - 1, count = static_cast<size_t>(pieces) + 1;
+            out.resize(base + count);
+            frame.sample(count, out.x() + base, out.y() + base, out.z() + base);
+        }
+    }
+}
+
+void GeomCore::geodesic_samples(const Manifold<double>& manifold, const PointR3& p1, const PointR3& p2, size_t count,
+                                PointCloud3& out) {
+    visit_manifold(manifold, [&](const auto& m) { GeodesicFrame(m, p1, p2).sample(count, out); });
+}
+
+void GeomCore::densify_geodesic(const Manifold<double>& manifold, const PointCloud3& polyline, double tolerance,
+                                PointCloud3& out) {
+    visit_manifold(manifold, [&](const auto& m) { densify_geodesic(m, polyline, tolerance, out); });
+}
+
+template class GeomCore::GeodesicFrame<GeometryKind::Euclidean>;
+template class GeomCore::GeodesicFrame<GeometryKind::Spherical>;
+template class GeomCore::GeodesicFrame<GeometryKind::Hyperbolic>;
+
+template void GeomCore::densify_geodesic(const EuclideanManifold<double>&, const PointCloud3&, double, PointCloud3&);
+template void GeomCore::densify_geodesic(const SphericalManifold<double>&, const PointCloud3&, double, PointCloud3&);
+template void GeomCore::densify_geodesic(const HyperbolicManifold<double>&, const PointCloud3&, double, PointCloud3&);
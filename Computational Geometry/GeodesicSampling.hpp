@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Geodesic.hpp"
+#include "PointCloud.hpp"
+
+#include <cstddef>
+
+namespace GeomCore {
+
+    // One geodesic segment set up for sampling many points along it.
+    //
+    // geodesic_point() finds the angle the segment subtends and evaluates
+    // three sines or hyperbolic sines for every t. A GeodesicFrame does the
+    // first part once: it keeps the start a, the unit tangent u there and
+    // the angle omega, so the point at angle theta along the segment is
+    //
+    //   Euclidean    a + theta u                 (omega is the length)
+    //   Spherical    R (cos theta a + sin theta u)
+    //   Hyperbolic   cosh theta a + sinh theta R u
+    //
+    // Evenly spaced points then follow by repeatedly rotating (on the
+    // hyperboloid, boosting) by the step angle, re-anchored to exact sines
+    // every few dozen points so rounding does not build up.
+    //
+    // Points are taken as by geodesic_point: any nonzero vectors on the
+    // sphere, points on the hyperboloid x^2 + y^2 - z^2 = -R^2 for the
+    // hyperbolic kind. The ends are projected onto the manifold and
+    // reproduced exactly by sample(). Between antipodal points some great
+    // semicircle is chosen.
+    template<GeometryKind K>
+    class GeodesicFrame {
+        public:
+            GeodesicFrame(const StaticManifold<K, double>& manifold, const PointR3& p1, const PointR3& p2);
+
+            // Angle the segment subtends at the centre; its length for the
+            // Euclidean kind
+            double angle() const { return omega; }
+            double length() const { return K == GeometryKind::Euclidean ? omega : radius * omega; }
+
+            const PointR3& first() const { return start; }
+            const PointR3& last() const { return end; }
+
+            // Point at parameter t, from first() at t = 0 to last() at t = 1
+            PointR3 point(double t) const;
+
+            // count points at t = k / (count - 1), written to x[k], y[k],
+            // z[k]; first() alone for count = 1
+            void sample(size_t count, double* x, double* y, double* z) const;
+
+            // The same into out, resized to count
+            void sample(size_t count, PointCloud3& out) const;
+
+        private:
+            double radius;
+            double omega;
+            PointR3 start, tangent, end;   // tangent scaled so theta = 1 adds it once
+    };
+
+    // count evenly spaced points from p1 to p2 into out, as
+    // GeodesicFrame::sample() for the manifold's kind
+    void geodesic_samples(const Manifold<double>& manifold, const PointR3& p1, const PointR3& p2, size_t count,
+                          PointCloud3& out);
+
+    // The polyline through the given vertices with points added along its
+    // geodesics until every chord lies within tolerance of the arc it stands
+    // for, measured in the model's R3 coordinates at the middle of the arc.
+    // Spherical segments are cut into the fewest equal pieces; on the
+    // hyperboloid, where the same angle strays further the further out it
+    // is, pieces are halved until they pass. Euclidean segments need no
+    // points. The vertices are all kept, projected onto the manifold.
+    // out is overwritten. Throws std::invalid_argument unless tolerance is
+    // positive and every vertex projects onto the manifold, and
+    // std::length_error if a segment would need more than 2^32 pieces.
+    template<GeometryKind K>
+    void densify_geodesic(const StaticManifold<K, double>& manifold, const PointCloud3& polyline, double tolerance,
+                          PointCloud3& out);
+    void densify_geodesic(const Manifold<double>& manifold, const PointCloud3& polyline, double tolerance,
+                          PointCloud3& out);
+}
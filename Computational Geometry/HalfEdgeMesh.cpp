@@ -0,0 +1,233 @@
+#include "HalfEdgeMesh.hpp"
+#include "Intersection.hpp"
+#include "Predicates.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+// The subdivision is built as in de Berg et al., "Computational Geometry:
+// Algorithms and Applications", section 2.3: half-edges are sorted around
+// their origin to link the boundary cycles, a cycle turning left at its
+// lowest leftmost vertex is the outer boundary of a bounded face, and every
+// other cycle is a hole of the face hit by a ray cast west from that
+// vertex.
+
+static bool same_point(const GeomCore::PointR2& a, const GeomCore::PointR2& b) {
+    return a[X] == b[X] && a[Y] == b[Y];
+}
+
+static bool lower_left(const GeomCore::PointR2& a, const GeomCore::PointR2& b) {
+    return a[X] < b[X] || (a[X] == b[X] && a[Y] < b[Y]);
+}
+
+GeomCore::HalfEdgeMesh::HalfEdgeMesh(std::pmr::memory_resource* resource)
+    : vertices(resource), half_edges(resource), faces(resource), hole_edges(resource) {
+    faces.push_back({NONE, 0, 0});
+}
+
+void GeomCore::HalfEdgeMesh::clear() {
+    vertices.clear();
+    half_edges.clear();
+    faces.clear();
+    hole_edges.clear();
+    faces.push_back({NONE, 0, 0});
+}
+
+void GeomCore::HalfEdgeMesh::build(const PointR2* points, size_t n, const Edge* edges, size_t m) {
+    if (n >= NONE || m >= NONE / 2) {
+        throw std::length_error("HalfEdgeMesh: too many vertices or edges");
+    }
+    clear();
+    std::pmr::memory_resource* memory = resource();
+    uint32_t count = static_cast<uint32_t>(2 * m);
+
+    vertices.resize(n);
+    for (size_t i = 0; i < n; ++i) vertices[i] = {points[i], NONE};
+    half_edges.resize(count);
+    for (size_t e = 0; e < m; ++e) {
+        uint32_t a = edges[e][0], b = edges[e][1];
+        if (a >= n || b >= n) throw std::out_of_range("HalfEdgeMesh: edge endpoint out of range");
+        if (same_point(points[a], points[b])) throw std::invalid_argument("HalfEdgeMesh: edge of zero length");
+        half_edges[2 * e].origin = a;
+        half_edges[2 * e + 1].origin = b;
+    }
+
+    // Outgoing half-edges of each vertex, counter-clockwise from due east
+    std::pmr::vector<uint32_t> first(n + 1, 0, memory), order(count, memory), position(count, memory);
+    for (uint32_t h = 0; h < count; ++h) ++first[origin(h) + 1];
+    for (size_t v = 0; v < n; ++v) first[v + 1] += first[v];
+    std::pmr::vector<uint32_t> cursor(first.begin(), first.end() - 1, memory);
+    for (uint32_t h = 0; h < count; ++h) order[cursor[origin(h)]++] = h;
+
+    auto lower_half = [this](uint32_t h) {
+        double dx = point(target(h))[X] - point(origin(h))[X], dy = point(target(h))[Y] - point(origin(h))[Y];
+        return dy < 0.0 || (dy == 0.0 && dx < 0.0);
+    };
+    auto turn = [this](uint32_t a, uint32_t b) {
+        return orient2d(point(origin(a)), point(target(a)), point(target(b)));
+    };
+    for (size_t v = 0; v < n; ++v) {
+        auto begin = order.begin() + first[v], end = order.begin() + first[v + 1];
+        std::sort(begin, end, [&](uint32_t a, uint32_t b) {
+            bool la = lower_half(a), lb = lower_half(b);
+            if (la != lb) return lb;
+            return turn(a, b) > 0.0;
+        });
+        for (auto it = begin; it != end; ++it) {
+            auto following = it + 1 == end ? begin : it + 1;
+            if (following != it && lower_half(*it) == lower_half(*following) && turn(*it, *following) == 0.0) {
+                throw std::invalid_argument("HalfEdgeMesh: overlapping edges");
+            }
+        }
+        if (begin != end) vertices[v].edge = *begin;
+    }
+    for (uint32_t p = 0; p < count; ++p) position[order[p]] = p;
+
+    // The face left of u -> w continues along the half-edge leaving w just
+    // clockwise of w -> u
+    for (uint32_t h = 0; h < count; ++h) {
+        uint32_t w = target(h), p = position[h ^ 1];
+        uint32_t following = order[(p == first[w] ? first[w + 1] : p) - 1];
+        half_edges[h].next = following;
+        half_edges[following].prev = h;
+    }
+
+    // Boundary cycles, each with a half-edge leaving its lowest leftmost
+    // vertex
+    std::pmr::vector<uint32_t> cycle(count, NONE, memory), leftmost(memory);
+    for (uint32_t h = 0; h < count; ++h) {
+        if (cycle[h] != NONE) continue;
+        uint32_t c = static_cast<uint32_t>(leftmost.size()), best = h, current = h;
+        do {
+            cycle[current] = c;
+            if (lower_left(point(origin(current)), point(origin(best)))) best = current;
+            current = next(current);
+        } while (current != h);
+        leftmost.push_back(best);
+    }
+
+    // Left turns there bound faces; the rest, including the two sides of
+    // a dangling edge, are holes
+    uint32_t cycles = static_cast<uint32_t>(leftmost.size());
+    std::pmr::vector<uint32_t> cycle_face(cycles, NONE, memory), hole_cycles(memory);
+    for (uint32_t c = 0; c < cycles; ++c) {
+        uint32_t h = leftmost[c];
+        if (orient2d(point(origin(prev(h))), point(origin(h)), point(target(h))) > 0.0) {
+            cycle_face[c] = static_cast<uint32_t>(faces.size());
+            faces.push_back({h, 0, 0});
+        } else {
+            hole_cycles.push_back(c);
+        }
+    }
+
+    // The ray from a hole's leftmost vertex, nudged up, meets only edges
+    // that span its height, and those never cross; the nearest is the one
+    // furthest east, and the face is on the left of its downward half-edge.
+    // A hit cycle is further west than the hole, so holes taken west to
+    // east find it already placed.
+    auto upper = [this](uint32_t d) -> const PointR2& { return point(origin(d)); };
+    auto lower = [this](uint32_t d) -> const PointR2& { return point(target(d)); };
+    auto above = [](const PointR2& a, const PointR2& b) { return a[Y] > b[Y] || (a[Y] == b[Y] && a[X] < b[X]); };
+    auto west_of = [&](uint32_t e, uint32_t f) {
+        if (!above(upper(e), upper(f))) {
+            double o = orient2d(upper(f), lower(f), upper(e));
+            if (o == 0.0) o = orient2d(upper(f), lower(f), lower(e));
+            return o < 0.0;
+        }
+        double o = orient2d(upper(e), lower(e), upper(f));
+        if (o == 0.0) o = orient2d(upper(e), lower(e), lower(f));
+        return o > 0.0;
+    };
+
+    std::sort(hole_cycles.begin(), hole_cycles.end(), [&](uint32_t a, uint32_t b) {
+        return lower_left(point(origin(leftmost[a])), point(origin(leftmost[b])));
+    });
+    for (uint32_t c : hole_cycles) {
+        const PointR2& v = point(origin(leftmost[c]));
+        uint32_t hit = NONE;
+        for (uint32_t h = 0; h < count; h += 2) {
+            uint32_t d = point(origin(h))[Y] > point(target(h))[Y] ? h : h + 1;
+            if (!(upper(d)[Y] > v[Y] && lower(d)[Y] <= v[Y])) continue;
+            if (orient2d(lower(d), upper(d), v) >= 0.0) continue;
+            if (hit == NONE || west_of(hit, d)) hit = d;
+        }
+        cycle_face[c] = hit == NONE ? unbounded_face : cycle_face[cycle[hit]];
+        ++faces[cycle_face[c]].hole_count;
+    }
+
+    uint32_t offset = 0;
+    for (face& f : faces) {
+        f.first_hole = offset;
+        offset += f.hole_count;
+        f.hole_count = 0;
+    }
+    hole_edges.resize(offset);
+    for (uint32_t c : hole_cycles) {
+        face& f = faces[cycle_face[c]];
+        hole_edges[f.first_hole + f.hole_count++] = leftmost[c];
+    }
+    for (uint32_t h = 0; h < count; ++h) half_edges[h].face = cycle_face[cycle[h]];
+}
+
+uint32_t GeomCore::HalfEdgeMesh::build_polygon(const std::vector<PointR2>& outer,
+                                               const std::vector<std::vector<PointR2>>& holes) {
+    std::pmr::vector<PointR2> points(resource());
+    std::pmr::vector<Edge> edges(resource());
+    auto add_ring = [&](const std::vector<PointR2>& ring) {
+        if (ring.size() < 3) throw std::invalid_argument("HalfEdgeMesh: ring with fewer than three vertices");
+        uint32_t base = static_cast<uint32_t>(points.size()), k = static_cast<uint32_t>(ring.size());
+        points.insert(points.end(), ring.begin(), ring.end());
+        for (uint32_t i = 0; i < k; ++i) edges.push_back({base + i, base + (i + 1) % k});
+    };
+    add_ring(outer);
+    for (const auto& ring : holes) add_ring(ring);
+
+    build(points.data(), points.size(), edges.data(), edges.size());
+    // One side of the first edge is the unbounded face
+    return incident_face(0) != unbounded_face ? incident_face(0) : incident_face(1);
+}
+
+bool GeomCore::HalfEdgeMesh::is_convex(uint32_t h) const {
+    return orient2d(point(origin(h)), point(target(h)), point(target(next(h)))) > 0.0;
+}
+
+/**
+ * @brief Tests whether q lies strictly inside the wedge of the face left of h
+ *        at origin(h), between prev(h) coming in and h going out.
+ *
+ * A convex corner keeps q left of both sides; a reflex one only excludes the
+ * wedge on the other side (O'Rourke, "Computational Geometry in C", 1.6).
+ */
+static bool in_cone(const GeomCore::HalfEdgeMesh& mesh, uint32_t h, const GeomCore::PointR2& q) {
+    const GeomCore::PointR2& v = mesh.point(mesh.origin(h));
+    const GeomCore::PointR2& before = mesh.point(mesh.origin(mesh.prev(h)));
+    const GeomCore::PointR2& after = mesh.point(mesh.target(h));
+    if (GeomCore::orient2d(before, v, after) >= 0.0) {
+        return GeomCore::orient2d(v, q, before) > 0.0 && GeomCore::orient2d(q, v, after) > 0.0;
+    }
+    return !(GeomCore::orient2d(v, q, after) >= 0.0 && GeomCore::orient2d(q, v, before) >= 0.0);
+}
+
+bool GeomCore::HalfEdgeMesh::is_diagonal(uint32_t a, uint32_t b) const {
+    uint32_t f = incident_face(a);
+    if (incident_face(b) != f) return false;
+    uint32_t u = origin(a), w = origin(b);
+    const PointR2 &p = point(u), &q = point(w);
+    if (same_point(p, q) || !in_cone(*this, a, q) || !in_cone(*this, b, p)) return false;
+
+    // Sides not ending at u or w must keep clear of the segment
+    auto blocked = [&](uint32_t start) {
+        uint32_t h = start;
+        do {
+            uint32_t c = origin(h), d = target(h);
+            if (c != u && c != w && d != u && d != w && intersection(p, q, point(c), point(d))) return true;
+            h = next(h);
+        } while (h != start);
+        return false;
+    };
+    if (outer(f) != NONE && blocked(outer(f))) return false;
+    for (uint32_t h : holes(f)) {
+        if (blocked(h)) return false;
+    }
+    return true;
+}
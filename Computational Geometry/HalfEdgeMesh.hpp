@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Point.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace GeomCore {
+
+    // Planar subdivision as a doubly connected edge list with indices for
+    // links.
+    //
+    // Vertices, half-edges and faces live in three flat arrays, all drawn
+    // from one std::pmr::memory_resource: pass a monotonic_buffer_resource
+    // to build a mesh in an arena and free it in one go. Half-edges come in
+    // twin pairs 2e and 2e + 1, so twin(h) is h ^ 1. Every half-edge has its
+    // face on the left: the outer boundary of a bounded face runs counter-
+    // clockwise, the boundaries of its holes clockwise. Face 0 is the
+    // unbounded face, which has holes but no outer boundary.
+    class HalfEdgeMesh {
+        public:
+            static constexpr uint32_t NONE = UINT32_MAX;
+            static constexpr uint32_t unbounded_face = 0;
+
+            using Edge = std::array<uint32_t, 2>;
+
+            struct vertex {
+                PointR2 point;
+                uint32_t edge;   // an outgoing half-edge, NONE if isolated
+            };
+
+            struct half_edge {
+                uint32_t origin, next, prev, face;
+            };
+
+            struct face {
+                uint32_t outer;                  // a half-edge of the outer boundary
+                uint32_t first_hole, hole_count; // range of hole_edges
+            };
+
+            explicit HalfEdgeMesh(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+            // Subdivision cut out by the segments edges[0..m) between
+            // points[0..n). Edges may share endpoints but must not cross or
+            // overlap, which is not checked. Throws std::out_of_range for an
+            // endpoint index past n and std::invalid_argument for a zero
+            // length edge or two edges leaving a vertex in the same
+            // direction.
+            void build(const PointR2* points, size_t n, const Edge* edges, size_t m);
+            void build(const std::vector<PointR2>& points, const std::vector<Edge>& edges) {
+                build(points.data(), points.size(), edges.data(), edges.size());
+            }
+
+            // Polygon with holes, each ring in either orientation; vertices
+            // are numbered ring after ring, outer ring first. Returns the
+            // face between the outer ring and the holes. The rings must be
+            // simple and disjoint apart from shared vertices.
+            uint32_t build_polygon(const std::vector<PointR2>& outer,
+                                   const std::vector<std::vector<PointR2>>& holes = {});
+
+            void clear();
+
+            size_t vertex_count() const { return vertices.size(); }
+            size_t half_edge_count() const { return half_edges.size(); }
+            size_t face_count() const { return faces.size(); }
+            std::pmr::memory_resource* resource() const { return vertices.get_allocator().resource(); }
+
+            const PointR2& point(uint32_t v) const { return vertices[v].point; }
+            uint32_t edge(uint32_t v) const { return vertices[v].edge; }
+
+            uint32_t origin(uint32_t h) const { return half_edges[h].origin; }
+            uint32_t target(uint32_t h) const { return half_edges[h ^ 1].origin; }
+            uint32_t twin(uint32_t h) const { return h ^ 1; }
+            uint32_t next(uint32_t h) const { return half_edges[h].next; }
+            uint32_t prev(uint32_t h) const { return half_edges[h].prev; }
+            uint32_t incident_face(uint32_t h) const { return half_edges[h].face; }
+
+            // Outer boundary half-edge of face f, NONE for the unbounded
+            // face, and one half-edge on each of its holes
+            uint32_t outer(uint32_t f) const { return faces[f].outer; }
+            std::span<const uint32_t> holes(uint32_t f) const {
+                return {hole_edges.data() + faces[f].first_hole, faces[f].hole_count};
+            }
+
+            // True if the boundary turns left where h meets next(h)
+            bool is_convex(uint32_t h) const;
+
+            // True if the open segment from origin(a) to origin(b) runs
+            // through the interior of their common face without touching
+            // its boundary; a and b must border the same face
+            bool is_diagonal(uint32_t a, uint32_t b) const;
+
+        private:
+            std::pmr::vector<vertex> vertices;
+            std::pmr::vector<half_edge> half_edges;
+            std::pmr::vector<face> faces;
+            std::pmr::vector<uint32_t> hole_edges;
+    };
+}
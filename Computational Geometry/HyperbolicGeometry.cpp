@@ -1,6 +1,11 @@
 #include "HyperbolicGeometry.hpp"
+#include "FastMath.hpp"
+#include "Geodesic.hpp"
+#include "Parallel.hpp"
 #include <cmath>
 #include <algorithm>
+#include <array>
+#include <limits>
 #include <stdexcept>
 
 namespace GeomCore {
@@ -17,7 +22,8 @@ namespace GeomCore {
     template<typename T>
     requires Real<T>
     T minkowski_bilinear_form(const PointR3& p1, const PointR3& p2) {
-        return static_cast<T>(p1[X] * p2[X] + p1[Y] * p2[Y] - p1[Z] * p2[Z]);
+        return static_cast<T>(p1.unchecked(X) * p2.unchecked(X) + p1.unchecked(Y) * p2.unchecked(Y) -
+                              p1.unchecked(Z) * p2.unchecked(Z));
     }
 
     template<typename T>
@@ -31,13 +37,7 @@ namespace GeomCore {
     template<typename T>
     requires Real<T>
     T hyperbolic_distance(const Manifold<T>& manifold, const PointR3& p1, const PointR3& p2) {
-        T radius = hyperboloid_radius(manifold);
-
-        T form = minkowski_bilinear_form<T>(p1, p2);
-        T arg = -form / (radius * radius);
-        arg = std::max(arg, T{1});
-
-        return radius * std::acosh(arg);
+        return geodesic_distance(HyperbolicManifold<T>(hyperboloid_radius(manifold)), p1, p2);
     }
 
     template<typename T>
@@ -100,6 +100,189 @@ namespace GeomCore {
         return PointR3(p[X] / denom, p[Y] / denom, 0.0);
     }
 
+    // Batch kernels: kernel(in, out) maps simd::width lanes of the N input
+    // arrays to M outputs. The last n % width elements are copied into
+    // buffers padded with the last element, so every result comes from the
+    // same code and the padding lanes see valid input.
+
+    static void check_sizes(size_t a, size_t b) {
+        if (a != b) {
+            throw std::invalid_argument("Point clouds must have the same size");
+        }
+    }
+
+    template<size_t N, size_t M, class Kernel>
+    static void lanes(size_t begin, size_t end, const std::array<const double*, N>& in,
+                      const std::array<double*, M>& out, Kernel&& kernel) {
+        simd::vdouble v[N], r[M];
+        size_t i = begin;
+        for (; i + simd::width <= end; i += simd::width) {
+            for (size_t k = 0; k < N; ++k) v[k] = simd::load(in[k] + i);
+            kernel(v, r);
+            for (size_t k = 0; k < M; ++k) simd::store(out[k] + i, r[k]);
+        }
+        if (i == end) return;
+
+        double buffer[N][simd::width], result[simd::width];
+        for (size_t k = 0; k < N; ++k) {
+            std::fill(std::copy(in[k] + i, in[k] + end, buffer[k]), buffer[k] + simd::width, in[k][end - 1]);
+            v[k] = simd::load(buffer[k]);
+        }
+        kernel(v, r);
+        for (size_t k = 0; k < M; ++k) {
+            simd::store(result, r[k]);
+            std::copy(result, result + (end - i), out[k] + i);
+        }
+    }
+
+    /**
+     * @brief R * acosh(max(1, -<a, b> / R^2)) per lane, <a, b> the Minkowski form.
+     */
+    static simd::vdouble distance_lanes(simd::vdouble ax, simd::vdouble ay, simd::vdouble az, simd::vdouble bx,
+                                        simd::vdouble by, simd::vdouble bz, double radius) {
+        simd::vdouble negative_form = simd::fmsub(az, bz, simd::fmadd(ay, by, simd::mul(ax, bx)));
+        simd::vdouble arg = simd::mul(negative_form, simd::broadcast(1.0 / (radius * radius)));
+        arg = simd::max(arg, simd::broadcast(1.0));
+        return simd::mul(simd::acosh(arg), simd::broadcast(radius));
+    }
+
+    /**
+     * @brief Geodesic point c1 a + c2 b, scaled back onto the hyperboloid.
+     *
+     * With omega = acosh(-<a, b> / R^2), c1 = sinh((1 - t) omega) / sinh(omega)
+     * and c2 = sinh(t omega) / sinh(omega); coincident points take the limits
+     * 1 - t and t.
+     */
+    static void geodesic_lanes(const simd::vdouble a[3], const simd::vdouble b[3], simd::vdouble omega,
+                               simd::vdouble t, double radius, simd::vdouble out[3]) {
+        simd::vdouble one = simd::broadcast(1.0), zero = simd::broadcast(0.0);
+        simd::vdouble s = simd::sinh(omega);
+        simd::vdouble s1 = simd::sinh(simd::mul(simd::sub(one, t), omega));
+        simd::vdouble s2 = simd::sinh(simd::mul(t, omega));
+        simd::vmask apart = simd::less(zero, s);
+        simd::vdouble c1 = simd::select(apart, simd::div(s1, s), simd::sub(one, t));
+        simd::vdouble c2 = simd::select(apart, simd::div(s2, s), t);
+
+        for (size_t k = 0; k < 3; ++k) out[k] = simd::fmadd(c1, a[k], simd::mul(c2, b[k]));
+        simd::vdouble negative_norm =
+            simd::fmsub(out[2], out[2], simd::fmadd(out[1], out[1], simd::mul(out[0], out[0])));
+        simd::vdouble scale = simd::div(simd::broadcast(radius), simd::sqrt(negative_norm));
+        for (size_t k = 0; k < 3; ++k) out[k] = simd::mul(out[k], scale);
+    }
+
+    void hyperbolic_distance(const Manifold<double>& manifold, const PointR3& from, const PointCloud3& to,
+                             std::vector<double>& out, unsigned threads) {
+        double radius = hyperboloid_radius(manifold);
+        auto qx = simd::broadcast(from[X]), qy = simd::broadcast(from[Y]), qz = simd::broadcast(from[Z]);
+        out.resize(to.size());
+        parallel_blocks(to.size(), 1 << 14, threads, [&](size_t begin, size_t end, unsigned) {
+            lanes<3, 1>(begin, end, {to.x(), to.y(), to.z()}, {out.data()},
+                        [&](const simd::vdouble* p, simd::vdouble* r) {
+                            r[0] = distance_lanes(qx, qy, qz, p[0], p[1], p[2], radius);
+                        });
+        });
+    }
+
+    void hyperbolic_distance(const Manifold<double>& manifold, const PointCloud3& a, const PointCloud3& b,
+                             std::vector<double>& out, unsigned threads) {
+        check_sizes(a.size(), b.size());
+        double radius = hyperboloid_radius(manifold);
+        out.resize(a.size());
+        parallel_blocks(a.size(), 1 << 14, threads, [&](size_t begin, size_t end, unsigned) {
+            lanes<6, 1>(begin, end, {a.x(), a.y(), a.z(), b.x(), b.y(), b.z()}, {out.data()},
+                        [&](const simd::vdouble* p, simd::vdouble* r) {
+                            r[0] = distance_lanes(p[0], p[1], p[2], p[3], p[4], p[5], radius);
+                        });
+        });
+    }
+
+    void hyperbolic_distance_matrix(const Manifold<double>& manifold, const PointCloud3& rows,
+                                    const PointCloud3& columns, std::vector<double>& out, unsigned threads) {
+        // A tile of columns is 3 * 2048 doubles, 48 KiB, reused by every row
+        // of a block before the next tile is loaded
+        constexpr size_t row_block = 16, column_tile = 2048;
+
+        double radius = hyperboloid_radius(manifold);
+        size_t n = rows.size(), m = columns.size();
+        if (m != 0 && n > std::numeric_limits<size_t>::max() / m) {
+            throw std::length_error("Hyperbolic distance matrix is too large");
+        }
+        out.resize(n * m);
+
+        parallel_blocks(n, row_block, threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t tile = 0; tile < m; tile += column_tile) {
+                size_t tile_end = std::min(m, tile + column_tile);
+                for (size_t i = begin; i < end; ++i) {
+                    auto qx = simd::broadcast(rows.x()[i]), qy = simd::broadcast(rows.y()[i]);
+                    auto qz = simd::broadcast(rows.z()[i]);
+                    double* row = out.data() + i * m;
+                    lanes<3, 1>(tile, tile_end, {columns.x(), columns.y(), columns.z()}, {row},
+                                [&](const simd::vdouble* p, simd::vdouble* r) {
+                                    r[0] = distance_lanes(qx, qy, qz, p[0], p[1], p[2], radius);
+                                });
+                }
+            }
+        });
+    }
+
+    void hyperbolic_geodesic_point(const Manifold<double>& manifold, const PointR3& p1, const PointR3& p2,
+                                   const std::vector<double>& t, PointCloud3& out, unsigned threads) {
+        double radius = hyperboloid_radius(manifold);
+        double omega = std::acosh(std::max(-minkowski_bilinear_form<double>(p1, p2) / (radius * radius), 1.0));
+        const simd::vdouble a[3] = {simd::broadcast(p1[X]), simd::broadcast(p1[Y]), simd::broadcast(p1[Z])};
+        const simd::vdouble b[3] = {simd::broadcast(p2[X]), simd::broadcast(p2[Y]), simd::broadcast(p2[Z])};
+        auto vomega = simd::broadcast(omega);
+
+        out.resize(t.size());
+        parallel_blocks(t.size(), 1 << 14, threads, [&](size_t begin, size_t end, unsigned) {
+            lanes<1, 3>(begin, end, {t.data()}, {out.x(), out.y(), out.z()},
+                        [&](const simd::vdouble* p, simd::vdouble* r) {
+                            geodesic_lanes(a, b, vomega, p[0], radius, r);
+                        });
+        });
+    }
+
+    void hyperbolic_geodesic_point(const Manifold<double>& manifold, const PointCloud3& a, const PointCloud3& b,
+                                   double t, PointCloud3& out, unsigned threads) {
+        check_sizes(a.size(), b.size());
+        double radius = hyperboloid_radius(manifold);
+        auto vt = simd::broadcast(t);
+
+        out.resize(a.size());
+        parallel_blocks(a.size(), 1 << 14, threads, [&](size_t begin, size_t end, unsigned) {
+            lanes<6, 3>(begin, end, {a.x(), a.y(), a.z(), b.x(), b.y(), b.z()}, {out.x(), out.y(), out.z()},
+                        [&](const simd::vdouble* p, simd::vdouble* r) {
+                            simd::vdouble omega = simd::div(distance_lanes(p[0], p[1], p[2], p[3], p[4], p[5], radius),
+                                                            simd::broadcast(radius));
+                            geodesic_lanes(p, p + 3, omega, vt, radius, r);
+                        });
+        });
+    }
+
+    void poincare_disk_projection(const Manifold<double>& manifold, const PointCloud3& points, PointCloud2& out,
+                                  unsigned threads) {
+        double radius = hyperboloid_radius(manifold);
+        auto vradius = simd::broadcast(radius);
+
+        out.resize(points.size());
+        parallel_blocks(points.size(), 1 << 14, threads, [&](size_t begin, size_t end, unsigned) {
+            auto smallest = simd::broadcast(std::numeric_limits<double>::infinity());
+            lanes<3, 2>(begin, end, {points.x(), points.y(), points.z()}, {out.x(), out.y()},
+                        [&](const simd::vdouble* p, simd::vdouble* r) {
+                            simd::vdouble denom = simd::add(p[2], vradius);
+                            smallest = simd::min(smallest, simd::abs(denom));
+                            r[0] = simd::div(p[0], denom);
+                            r[1] = simd::div(p[1], denom);
+                        });
+
+            double lanes_smallest[simd::width];
+            simd::store(lanes_smallest, smallest);
+            if (*std::min_element(lanes_smallest, lanes_smallest + simd::width) < TOLERANCE) {
+                throw std::runtime_error("Degenerate projection: point too close to boundary");
+            }
+        });
+    }
+
     template double minkowski_bilinear_form<double>(const PointR3&, const PointR3&);
     template bool is_on_hyperboloid<double>(const Manifold<double>&, const PointR3&, double);
     template double hyperbolic_distance<double>(const Manifold<double>&, const PointR3&, const PointR3&);
@@ -3,6 +3,9 @@
 #include "Core.hpp"
 #include "Manifold.hpp"
 #include "Point.hpp"
+#include "PointCloud.hpp"
+
+#include <vector>
 
 namespace GeomCore {
 
@@ -30,4 +33,40 @@ namespace GeomCore {
     requires Real<T>
     PointR3 poincare_disk_projection(const Manifold<T>& manifold, const PointR3& p);
 
-}
\ No newline at end of file
+    // Batch kernels on the hyperboloid model: points are (x, y, z) with
+    // x^2 + y^2 - z^2 = -R^2, z > 0, for the manifold's radius R. Minkowski
+    // forms are evaluated simd::width pairs at a time and followed by
+    // vectorized acosh, sinh and cosh from FastMath.hpp. The radius is
+    // derived once per call; like the single-pair functions, they throw
+    // std::invalid_argument for a non-hyperbolic manifold. Output vectors
+    // are resized to fit; threads = 0 uses the hardware concurrency.
+
+    // out[i] = distance from `from` to to[i]
+    void hyperbolic_distance(const Manifold<double>& manifold, const PointR3& from, const PointCloud3& to,
+                             std::vector<double>& out, unsigned threads = 0);
+
+    // out[i] = distance from a[i] to b[i]; a and b must have equal size
+    void hyperbolic_distance(const Manifold<double>& manifold, const PointCloud3& a, const PointCloud3& b,
+                             std::vector<double>& out, unsigned threads = 0);
+
+    // All pairs, row-major: out[i * columns.size() + j] = distance from
+    // rows[i] to columns[j]. The Minkowski products are formed like a matrix
+    // product rows * J * columns^T, J = diag(1, 1, -1), with blocks of rows
+    // on separate threads sweeping the columns in cache-sized tiles.
+    void hyperbolic_distance_matrix(const Manifold<double>& manifold, const PointCloud3& rows,
+                                    const PointCloud3& columns, std::vector<double>& out, unsigned threads = 0);
+
+    // Point at parameter t[i] along the geodesic from p1 (t = 0) to p2
+    // (t = 1), for every i
+    void hyperbolic_geodesic_point(const Manifold<double>& manifold, const PointR3& p1, const PointR3& p2,
+                                   const std::vector<double>& t, PointCloud3& out, unsigned threads = 0);
+
+    // out[i] = point at parameter t along the geodesic from a[i] to b[i]
+    void hyperbolic_geodesic_point(const Manifold<double>& manifold, const PointCloud3& a, const PointCloud3& b,
+                                   double t, PointCloud3& out, unsigned threads = 0);
+
+    // Poincare disk coordinates of every point; the single-point function's
+    // z = 0 is left out. Throws std::runtime_error under the same condition.
+    void poincare_disk_projection(const Manifold<double>& manifold, const PointCloud3& points, PointCloud2& out,
+                                  unsigned threads = 0);
+}
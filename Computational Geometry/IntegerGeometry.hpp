@@ -0,0 +1,235 @@
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cstdint>
+#include <utility>
+
+#include "Point.hpp"
+
+#if !defined(__SIZEOF_INT128__)
+#error "IntegerGeometry.hpp needs a compiler with 128-bit integers (GCC or Clang)"
+#endif
+
+// Exact geometry on integer grids.
+//
+// Points with int64_t coordinates of magnitude at most
+// integer_coordinate_limit = 2^61 need no floating-point filter and no
+// expansion arithmetic: the orient2d determinant of such points fits a
+// 128-bit integer and the incircle and orient3d determinants fit 256 bits,
+// so every predicate here returns the exact determinant, not just its sign.
+// Segment intersections come back as rational points. Everything is
+// constexpr; nothing checks the coordinate range, in_integer_range() does.
+
+namespace GeomCore {
+
+    __extension__ typedef __int128 Int128;
+    __extension__ typedef unsigned __int128 UInt128;
+
+    using PointZ2 = Vector<int64_t, R2>;
+    using PointZ3 = Vector<int64_t, R3>;
+
+    constexpr int64_t integer_coordinate_limit = int64_t{1} << 61;
+
+    template<size_t dimension>
+    constexpr bool in_integer_range(const Vector<int64_t, dimension>& p) {
+        for (size_t i = 0; i < dimension; ++i) {
+            if (p.unchecked(i) < -integer_coordinate_limit || p.unchecked(i) > integer_coordinate_limit) return false;
+        }
+        return true;
+    }
+
+    // Two's complement 256-bit integer, just wide enough for the
+    // determinants below: sums, differences and 128 x 128-bit products
+    class Int256 {
+        std::array<uint64_t, 4> limbs{};   // least significant first
+
+        public:
+            constexpr Int256() = default;
+            constexpr Int256(Int128 value) {
+                UInt128 bits = static_cast<UInt128>(value);
+                uint64_t fill = value < 0 ? ~uint64_t{0} : 0;
+                limbs = {static_cast<uint64_t>(bits), static_cast<uint64_t>(bits >> 64), fill, fill};
+            }
+
+            static constexpr Int256 product(Int128 a, Int128 b) {
+                UInt128 x = a < 0 ? -static_cast<UInt128>(a) : static_cast<UInt128>(a);
+                UInt128 y = b < 0 ? -static_cast<UInt128>(b) : static_cast<UInt128>(b);
+                uint64_t x0 = static_cast<uint64_t>(x), x1 = static_cast<uint64_t>(x >> 64);
+                uint64_t y0 = static_cast<uint64_t>(y), y1 = static_cast<uint64_t>(y >> 64);
+
+                UInt128 low = static_cast<UInt128>(x0) * y0, high = static_cast<UInt128>(x1) * y1;
+                UInt128 cross1 = static_cast<UInt128>(x0) * y1, cross2 = static_cast<UInt128>(x1) * y0;
+                UInt128 middle = (low >> 64) + static_cast<uint64_t>(cross1) + static_cast<uint64_t>(cross2);
+                UInt128 upper = (middle >> 64) + (cross1 >> 64) + (cross2 >> 64) + static_cast<uint64_t>(high);
+
+                Int256 result;
+                result.limbs = {static_cast<uint64_t>(low), static_cast<uint64_t>(middle), static_cast<uint64_t>(upper),
+                                static_cast<uint64_t>(upper >> 64) + static_cast<uint64_t>(high >> 64)};
+                return (a < 0) != (b < 0) ? -result : result;
+            }
+
+            constexpr Int256 operator+(const Int256& other) const {
+                Int256 result;
+                uint64_t carry = 0;
+                for (size_t i = 0; i < 4; ++i) {
+                    UInt128 sum = static_cast<UInt128>(limbs[i]) + other.limbs[i] + carry;
+                    result.limbs[i] = static_cast<uint64_t>(sum);
+                    carry = static_cast<uint64_t>(sum >> 64);
+                }
+                return result;
+            }
+
+            constexpr Int256 operator-() const {
+                Int256 result;
+                uint64_t carry = 1;
+                for (size_t i = 0; i < 4; ++i) {
+                    UInt128 sum = static_cast<UInt128>(~limbs[i]) + carry;
+                    result.limbs[i] = static_cast<uint64_t>(sum);
+                    carry = static_cast<uint64_t>(sum >> 64);
+                }
+                return result;
+            }
+
+            constexpr Int256 operator-(const Int256& other) const { return *this + -other; }
+
+            // -1, 0 or 1
+            constexpr int sign() const {
+                if (limbs[3] >> 63) return -1;
+                return (limbs[0] | limbs[1] | limbs[2] | limbs[3]) != 0 ? 1 : 0;
+            }
+
+            constexpr bool operator==(const Int256& other) const = default;
+            constexpr std::strong_ordering operator<=>(const Int256& other) const {
+                return (*this - other).sign() <=> 0;
+            }
+
+            // Nearest double, give or take an ulp
+            constexpr double to_double() const {
+                if (sign() < 0) return -(-*this).to_double();
+                double value = 0.0;
+                for (size_t i = 4; i-- > 0;) value = value * 0x1p64 + static_cast<double>(limbs[i]);
+                return value;
+            }
+    };
+
+    // Products and sums that overflow int64_t, kept exact
+    constexpr Int128 wide_dot_product(const PointZ2& a, const PointZ2& b) {
+        return static_cast<Int128>(a[X]) * b[X] + static_cast<Int128>(a[Y]) * b[Y];
+    }
+
+    constexpr Int128 wide_cross_product(const PointZ2& a, const PointZ2& b) {
+        return static_cast<Int128>(a[X]) * b[Y] - static_cast<Int128>(a[Y]) * b[X];
+    }
+
+    constexpr Int128 squared_distance(const PointZ2& a, const PointZ2& b) {
+        PointZ2 d = b - a;
+        return wide_dot_product(d, d);
+    }
+
+    // Twice the signed area of abc: positive if counterclockwise, negative
+    // if clockwise, zero if collinear, as the floating-point orient2d
+    constexpr Int128 orient2d(const PointZ2& a, const PointZ2& b, const PointZ2& c) {
+        return wide_cross_product(b - a, c - a);
+    }
+
+    // Six times the signed volume of abcd, positive if d lies below the
+    // plane through a, b, c seen counterclockwise from above
+    constexpr Int256 orient3d(const PointZ3& a, const PointZ3& b, const PointZ3& c, const PointZ3& d) {
+        PointZ3 ad = a - d, bd = b - d, cd = c - d;
+        auto minor = [](const PointZ3& p, const PointZ3& q, size_t i, size_t j) {
+            return static_cast<Int128>(p[i]) * q[j] - static_cast<Int128>(p[j]) * q[i];
+        };
+        return Int256::product(ad[Z], minor(bd, cd, X, Y)) + Int256::product(bd[Z], minor(cd, ad, X, Y)) +
+               Int256::product(cd[Z], minor(ad, bd, X, Y));
+    }
+
+    // Positive if d lies inside the circle through counterclockwise a, b, c,
+    // negative if outside, zero if cocircular; the sign flips for clockwise
+    // a, b, c
+    constexpr Int256 incircle(const PointZ2& a, const PointZ2& b, const PointZ2& c, const PointZ2& d) {
+        PointZ2 ad = a - d, bd = b - d, cd = c - d;
+        return Int256::product(wide_dot_product(ad, ad), wide_cross_product(bd, cd)) +
+               Int256::product(wide_dot_product(bd, bd), wide_cross_product(cd, ad)) +
+               Int256::product(wide_dot_product(cd, cd), wide_cross_product(ad, bd));
+    }
+
+    // The point (x / denominator, y / denominator), denominator > 0
+    struct RationalPoint2 {
+        Int256 x, y;
+        Int128 denominator = 1;
+
+        constexpr PointR2 approximate() const {
+            double d = static_cast<double>(denominator);
+            return PointR2(x.to_double() / d, y.to_double() / d);
+        }
+    };
+
+    enum class SegmentContact : uint8_t { None, Point, Overlap };
+
+    // Where two closed segments meet: at `point`, or along the piece from
+    // first to last when they overlap
+    struct IntegerSegmentIntersection {
+        SegmentContact contact = SegmentContact::None;
+        RationalPoint2 point;
+        PointZ2 first, last;
+    };
+
+    namespace detail {
+        constexpr bool lexicographic_less(const PointZ2& a, const PointZ2& b) {
+            return a[X] < b[X] || (a[X] == b[X] && a[Y] < b[Y]);
+        }
+    }
+
+    // Exact intersection of the closed segments ab and cd. A crossing point
+    // is a + t (b - a) with t = orient2d(c, d, a) / (orient2d(c, d, a) -
+    // orient2d(c, d, b)), so its coordinates are rationals with 256-bit
+    // numerators over a 128-bit denominator. Collinear segments meet along
+    // the lexicographic overlap of their ends; a segment may be a point.
+    constexpr IntegerSegmentIntersection segment_intersection(const PointZ2& a, const PointZ2& b, const PointZ2& c,
+                                                              const PointZ2& d) {
+        Int128 ab_c = orient2d(a, b, c), ab_d = orient2d(a, b, d);
+        Int128 cd_a = orient2d(c, d, a), cd_b = orient2d(c, d, b);
+        IntegerSegmentIntersection result;
+
+        if (ab_c == 0 && ab_d == 0 && cd_a == 0 && cd_b == 0) {
+            auto [lo1, hi1] = detail::lexicographic_less(b, a) ? std::pair(b, a) : std::pair(a, b);
+            auto [lo2, hi2] = detail::lexicographic_less(d, c) ? std::pair(d, c) : std::pair(c, d);
+            PointZ2 first = detail::lexicographic_less(lo1, lo2) ? lo2 : lo1;
+            PointZ2 last = detail::lexicographic_less(hi1, hi2) ? hi1 : hi2;
+            if (detail::lexicographic_less(last, first)) return result;
+            result.first = first;
+            result.last = last;
+            if (first == last) {
+                result.contact = SegmentContact::Point;
+                result.point = {Int128{first[X]}, Int128{first[Y]}, 1};
+            } else {
+                result.contact = SegmentContact::Overlap;
+            }
+            return result;
+        }
+
+        if ((ab_c > 0 && ab_d > 0) || (ab_c < 0 && ab_d < 0) || (cd_a > 0 && cd_b > 0) || (cd_a < 0 && cd_b < 0)) {
+            return result;
+        }
+
+        // Not all collinear and neither straddles the other's line from one
+        // side, so the lines cross and the denominator is nonzero
+        Int128 numerator = cd_a, denominator = cd_a - cd_b;
+        if (denominator < 0) {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+        PointZ2 direction = b - a;
+        result.contact = SegmentContact::Point;
+        result.point.x = Int256::product(a[X], denominator) + Int256::product(numerator, direction[X]);
+        result.point.y = Int256::product(a[Y], denominator) + Int256::product(numerator, direction[Y]);
+        result.point.denominator = denominator;
+        return result;
+    }
+
+    // Whether the closed segments ab and cd meet
+    constexpr bool intersection(const PointZ2& a, const PointZ2& b, const PointZ2& c, const PointZ2& d) {
+        return segment_intersection(a, b, c, d).contact != SegmentContact::None;
+    }
+}
@@ -1,15 +1,21 @@
 #include "Core.hpp"
 #include "Intersection.hpp"
 #include "GeoUtils.hpp"
+#include "Predicates.hpp"
+
+#include <algorithm>
 
 /**
  * @brief Determines whether two line segments AB and CD intersect (properly or improperly).
  *
  * This function implements the classic orientation-based line segment intersection test.
  * Two segments intersect if and only if:
- *  1. The endpoints of each segment lie on opposite sides (or on) the line defined by the other segment, OR
+ *  1. The endpoints of each segment lie strictly on opposite sides of the line defined by the other segment, OR
  *  2. At least one endpoint lies on the other segment (degenerate/collinear cases).
  *
+ * The orientations come from the exact orient2d predicate, so a zero really
+ * means collinear and nearly parallel segments are never misclassified.
+ *
  * @param a, b   Endpoints of the first segment AB
  * @param c, d   Endpoints of the second segment CD
  * @return true  if the segments intersect (including touching at endpoints or overlapping), false otherwise
@@ -17,33 +23,30 @@
 bool GeomCore::intersection(const PointR2& a, const PointR2& b,
                             const PointR2& c, const PointR2& d)
 {
-    // Compute the oriented position (orientation) of points C and D with respect to directed line AB
-    auto ab_c = GeomCore::orientation_R2(a, b, c);   // ccw(a,b,c) ∈ {LEFT, RIGHT, BETWEEN, ORIGIN, DESTINATION}
-    auto ab_d = GeomCore::orientation_R2(a, b, d);
-
-    // Compute the oriented position of points A and B with respect to directed line CD
-    auto cd_a = GeomCore::orientation_R2(c, d, a);
-    auto cd_b = GeomCore::orientation_R2(c, d, b);
-
-    // Degenerate cases: any endpoint lies on the other segment.
-    // BETWEEN  → point is strictly inside the segment (not including endpoints)
-    // ORIGIN   → point coincides with the segment's start
-    // DESTINATION → point coincides with the segment's end
-    // These cases are considered intersections in most geometric engines (touching/overlapping).
-    if (ab_c == BETWEEN || ab_c == ORIGIN || ab_c == DESTINATION ||
-        ab_d == BETWEEN || ab_d == ORIGIN || ab_d == DESTINATION ||
-        cd_a == BETWEEN || cd_a == ORIGIN || cd_a == DESTINATION ||
-        cd_b == BETWEEN || cd_b == ORIGIN || cd_b == DESTINATION)
+    // Signs of C and D with respect to directed line AB, and of A and B with respect to CD
+    double ab_c = orient2d(a, b, c);
+    double ab_d = orient2d(a, b, d);
+    double cd_a = orient2d(c, d, a);
+    double cd_b = orient2d(c, d, b);
+
+    // Proper intersection: each segment straddles the other's line
+    if (((ab_c > 0.0 && ab_d < 0.0) || (ab_c < 0.0 && ab_d > 0.0)) &&
+        ((cd_a > 0.0 && cd_b < 0.0) || (cd_a < 0.0 && cd_b > 0.0)))
     {
-        return true;   // At least one endpoint lies on the opposite segment → intersection
+        return true;
     }
 
-    // Proper intersection test (non-collinear case):
-    // The segments straddle each other iff the orientations of C and D w.r.t. AB differ,
-    // and the orientations of A and B w.r.t. CD differ.
-    // Using XOR on the predicate "is strictly left of the directed line" captures exactly this condition.
-    return _xor(ab_c == LEFT, ab_d == LEFT) &&      // C and D are on opposite sides of line AB
-           _xor(cd_a == LEFT, cd_b == LEFT);       // A and B are on opposite sides of line CD
+    // Degenerate cases: an endpoint collinear with the other segment touches it
+    // iff it lies within that segment's bounding box.
+    auto on_segment = [](const PointR2& p, const PointR2& q, const PointR2& r) {
+        return std::min(p[X], q[X]) <= r[X] && r[X] <= std::max(p[X], q[X]) &&
+               std::min(p[Y], q[Y]) <= r[Y] && r[Y] <= std::max(p[Y], q[Y]);
+    };
+
+    return (ab_c == 0.0 && on_segment(a, b, c)) ||
+           (ab_d == 0.0 && on_segment(a, b, d)) ||
+           (cd_a == 0.0 && on_segment(c, d, a)) ||
+           (cd_b == 0.0 && on_segment(c, d, b));
 }
 
 /**
@@ -127,18 +130,15 @@ bool GeomCore::intersection(const Line2d& l1, const Line2d& l2,
 }
 
 bool GeomCore::intersection(const Line3d& line, const Plane_d& plane, PointR3& point) {
-    auto n = plane.get_normal();
-    auto D = plane.get_d();
-    auto d = line.get_direction();
-    auto p = line.get_point();   
+    const auto& n = plane.get_normal();
+    const auto& d = line.get_direction();
+    const auto& p = line.get_point();
 
     auto nd = dot_product(n, d);
 
     if(!is_equal_1D(nd, 0.0)){
-        auto t = (-1 * dot_product(n, p) + D) / nd;
-        point.assign(X, p[X] + t * d[X]);
-        point.assign(Y, p[Y] + t * d[Y]);
-        point.assign(Z, p[Z] + t * d[Z]);
+        auto t = (plane.get_d() - dot_product(n, p)) / nd;
+        point = scale_add(d, t, p);
 
         return true;
     } else {
@@ -147,8 +147,8 @@ bool GeomCore::intersection(const Line3d& line, const Plane_d& plane, PointR3& p
 }
 
 bool GeomCore::intersection(const Plane_d& p1, const Plane_d& p2, Line3d& l){
-    Vector3d n1 = p1.get_normal();
-    Vector3d n2 = p2.get_normal();
+    const Vector3d& n1 = p1.get_normal();
+    const Vector3d& n2 = p2.get_normal();
     
     double d1 = p1.get_d();
     double d2 = p2.get_d();
@@ -165,7 +165,7 @@ bool GeomCore::intersection(const Plane_d& p1, const Plane_d& p2, Line3d& l){
     auto a = (d2 * n1n2 - d1)/(n1n2_2 - 1);
     auto b = (d1 * n1n2 - d2)/(n1n2_2 - 1);
 
-    auto point = n1 * a + n2 * b;
+    auto point = linear_combination(n1, a, n2, b);
 
     l.set_point(point);
     direction.normalize();
@@ -0,0 +1,511 @@
+#pragma once
+
+#include "Manifold.hpp"
+#include "Parallel.hpp"
+#include "Point.hpp"
+#include "PointCloud.hpp"
+#include "SpaceFillingCurve.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace GeomCore {
+
+    // Metrics for KDTree. A metric embeds points into R3, where the tree is
+    // built, and ranks pairs of embedded points by a key computed from their
+    // coordinate differences; the distance must grow with the key. The
+    // search prunes a subtree when a key lower bound built from per-axis gaps
+    // exceeds the current worst key:
+    //
+    //   embed(p)                 coordinates the tree is built over
+    //   key(dx, dy, dz)          ranking key of a coordinate difference
+    //   axis_key(d)              key of a gap d along one axis
+    //   combine(key, old, now)   bound after one axis gap grows from old to now
+    //   distance(key), key_of(distance)   conversions, monotone
+
+    // Straight-line distance; the key is its square
+    struct EuclideanMetric {
+        PointR3 embed(const PointR3& p) const { return p; }
+        double key(double dx, double dy, double dz) const { return dx * dx + dy * dy + dz * dz; }
+        double axis_key(double d) const { return d * d; }
+        double combine(double key, double old, double now) const { return key - old + now; }
+        double distance(double key) const { return std::sqrt(key); }
+        double key_of(double distance) const { return distance * distance; }
+    };
+
+    // Sum of coordinate differences (L1)
+    struct ManhattanMetric {
+        PointR3 embed(const PointR3& p) const { return p; }
+        double key(double dx, double dy, double dz) const { return std::abs(dx) + std::abs(dy) + std::abs(dz); }
+        double axis_key(double d) const { return std::abs(d); }
+        double combine(double key, double old, double now) const { return key - old + now; }
+        double distance(double key) const { return key; }
+        double key_of(double distance) const { return distance; }
+    };
+
+    // Largest coordinate difference (L-infinity)
+    struct ChebyshevMetric {
+        PointR3 embed(const PointR3& p) const { return p; }
+        double key(double dx, double dy, double dz) const { return std::max({std::abs(dx), std::abs(dy), std::abs(dz)}); }
+        double axis_key(double d) const { return std::abs(d); }
+        double combine(double key, double, double now) const { return std::max(key, now); }
+        double distance(double key) const { return key; }
+        double key_of(double distance) const { return distance; }
+    };
+
+    // Great-circle distance of spherical_distance: points are taken as
+    // directions from the origin and measured along a sphere of the
+    // manifold's radius. The tree holds unit vectors, ranked by squared
+    // chord length, which is converted to arc length only for results.
+    struct SphericalMetric {
+        double radius = 1.0;
+
+        SphericalMetric() = default;
+        explicit SphericalMetric(double radius) : radius(radius) {}
+        explicit SphericalMetric(const Manifold<double>& manifold) {
+            if (manifold.kind() != GeometryKind::Spherical) {
+                throw std::invalid_argument("Manifold is not spherical");
+            }
+            radius = 1.0 / std::sqrt(manifold.curvature.value);
+        }
+
+        PointR3 embed(const PointR3& p) const {
+            double m = std::sqrt(p[X] * p[X] + p[Y] * p[Y] + p[Z] * p[Z]);
+            return m > 0.0 ? PointR3(p[X] / m, p[Y] / m, p[Z] / m) : p;
+        }
+        double key(double dx, double dy, double dz) const { return dx * dx + dy * dy + dz * dz; }
+        double axis_key(double d) const { return d * d; }
+        double combine(double key, double old, double now) const { return key - old + now; }
+        double distance(double key) const { return 2.0 * radius * std::asin(std::min(1.0, 0.5 * std::sqrt(key))); }
+        double key_of(double distance) const {
+            if (distance >= std::numbers::pi * radius) return std::numeric_limits<double>::infinity();
+            double chord = 2.0 * std::sin(0.5 * distance / radius);
+            return chord * chord;
+        }
+    };
+
+    // Neighbour found by a KDTree query: input index and metric distance
+    struct KDNeighbor {
+        uint32_t index;
+        double distance;
+    };
+
+    // Static KD-tree over a point cloud for nearest-neighbour and radius
+    // queries under a pluggable metric.
+    //
+    // Each node splits its points at the median of the axis with the widest
+    // spread (nth_element partitioning), down to buckets of at most
+    // bucket_size points. Nodes are one flat array in depth-first order, the
+    // left child directly after its parent, and the points are stored struct
+    // of arrays in bucket order, so a leaf scan reads contiguous memory.
+    // Searches descend to the nearer side first and prune far sides with
+    // incremental per-axis distance bounds.
+    template<class Metric = EuclideanMetric>
+    class KDTree {
+        public:
+            static constexpr uint32_t NONE = UINT32_MAX;
+            static constexpr uint32_t bucket_size = 16;
+
+            explicit KDTree(Metric metric = Metric()) : metric(metric) {}
+            explicit KDTree(const std::vector<PointR3>& points, Metric metric = Metric(), unsigned threads = 0)
+                : metric(metric) {
+                build(points, threads);
+            }
+
+            // Subtrees below the top levels are built on separate threads;
+            // threads = 0 uses the hardware concurrency. The tree does not
+            // depend on the thread count.
+            void build(const PointR3* points, size_t n, unsigned threads = 0);
+            void build(const std::vector<PointR3>& points, unsigned threads = 0) { build(points.data(), points.size(), threads); }
+            void build(const PointCloud3& points, unsigned threads = 0);
+
+            size_t size() const { return ids.size(); }
+            bool empty() const { return ids.empty(); }
+            const Metric& get_metric() const { return metric; }
+
+            // Closest point to q, or {NONE, infinity} for an empty tree
+            KDNeighbor nearest(const PointR3& q) const;
+
+            // The min(k, size()) closest points to q, nearest first
+            void nearest(const PointR3& q, size_t k, std::vector<KDNeighbor>& out) const;
+
+            // All points within distance r of q, nearest first if sorted
+            void radius(const PointR3& q, double r, std::vector<KDNeighbor>& out, bool sorted = false) const;
+
+            // Batched forms, with blocks of spatially sorted queries on
+            // separate threads. k-nearest writes k entries per query to
+            // out[i * k..], padded with {NONE, infinity}; radius gathers the
+            // neighbours of query i into out[offsets[i]..offsets[i + 1]).
+            void nearest(const PointR3* queries, size_t m, size_t k, std::vector<KDNeighbor>& out, unsigned threads = 0) const;
+            void radius(const PointR3* queries, size_t m, double r, std::vector<uint32_t>& offsets,
+                        std::vector<KDNeighbor>& out, unsigned threads = 0) const;
+
+        private:
+            struct node {
+                double split;
+                uint32_t first;   // leaf: first bucket slot; inner: right child
+                uint16_t count;   // points in a leaf, 0 for an inner node
+                uint16_t axis;
+            };
+
+            struct record {
+                std::array<double, 3> c;
+                uint32_t index;
+            };
+
+            struct task {
+                size_t begin, end;
+                std::vector<node> nodes;
+            };
+
+            static constexpr uint16_t placeholder = UINT16_MAX;
+
+            void build_records(std::vector<record>& records, unsigned threads);
+            uint32_t build_range(std::vector<node>& out, record* records, size_t begin, size_t end,
+                                 std::vector<task>* tasks, size_t cutoff) const;
+
+            // Visit the points that may beat bound(): scan(key, slot) per point
+            template<class Scan, class Bound>
+            void descend(uint32_t n, const std::array<double, 3>& q, double rd, std::array<double, 3>& gap,
+                         Scan& scan, Bound& bound) const;
+
+            void k_nearest(const std::array<double, 3>& q, size_t k, std::vector<std::pair<double, uint32_t>>& heap) const;
+            void within(const std::array<double, 3>& q, double key, std::vector<std::pair<double, uint32_t>>& found) const;
+
+            std::vector<uint32_t> spatial_order(const PointR3* queries, size_t m, unsigned threads) const;
+
+            std::array<double, 3> embedded(const PointR3& p) const {
+                PointR3 e = metric.embed(p);
+                return {e[X], e[Y], e[Z]};
+            }
+
+            Metric metric;
+            std::vector<node> nodes;
+            std::vector<double> xs, ys, zs;   // embedded points in bucket order
+            std::vector<uint32_t> ids;        // input index of each slot
+            std::array<double, 3> lo{}, hi{};
+    };
+
+    template<class Metric>
+    void KDTree<Metric>::build(const PointR3* points, size_t n, unsigned threads) {
+        if (n >= NONE) {
+            throw std::length_error("KDTree: too many points");
+        }
+        std::vector<record> records(n);
+        parallel_for(n, [&](size_t i) { records[i] = {embedded(points[i]), static_cast<uint32_t>(i)}; }, threads, 4096);
+        build_records(records, threads);
+    }
+
+    template<class Metric>
+    void KDTree<Metric>::build(const PointCloud3& points, unsigned threads) {
+        size_t n = points.size();
+        if (n >= NONE) {
+            throw std::length_error("KDTree: too many points");
+        }
+        std::vector<record> records(n);
+        parallel_for(n, [&](size_t i) {
+            records[i] = {embedded(PointR3(points.x()[i], points.y()[i], points.z()[i])), static_cast<uint32_t>(i)};
+        }, threads, 4096);
+        build_records(records, threads);
+    }
+
+    template<class Metric>
+    void KDTree<Metric>::build_records(std::vector<record>& records, unsigned threads) {
+        size_t n = records.size();
+        if (threads == 0) threads = default_thread_count();
+        nodes.clear();
+        nodes.reserve(2 * (n / (bucket_size / 2) + 1));
+
+        if (threads == 1 || n < 65536) {
+            build_range(nodes, records.data(), 0, n, nullptr, 0);
+        } else {
+            // Split the top levels here, build the subtrees below them on
+            // workers, then splice them into the depth-first layout
+            std::vector<node> top;
+            std::vector<task> tasks;
+            build_range(top, records.data(), 0, n, &tasks, std::max<size_t>(n / (8 * threads), 16384));
+
+            parallel_for(tasks.size(), [&](size_t t) {
+                build_range(tasks[t].nodes, records.data(), tasks[t].begin, tasks[t].end, nullptr, 0);
+            }, threads);
+
+            auto emit = [&](auto& self, uint32_t i) -> uint32_t {
+                uint32_t index = static_cast<uint32_t>(nodes.size());
+                const node& t = top[i];
+                if (t.count == placeholder) {
+                    for (node subtree_node : tasks[t.first].nodes) {
+                        if (subtree_node.count == 0) subtree_node.first += index;
+                        nodes.push_back(subtree_node);
+                    }
+                    return index;
+                }
+                nodes.push_back(t);
+                if (t.count == 0) {
+                    self(self, i + 1);
+                    uint32_t right = self(self, t.first);
+                    nodes[index].first = right;
+                }
+                return index;
+            };
+            if (n > 0) emit(emit, 0);
+        }
+
+        xs.resize(n);
+        ys.resize(n);
+        zs.resize(n);
+        ids.resize(n);
+        parallel_for(n, [&](size_t i) {
+            xs[i] = records[i].c[0];
+            ys[i] = records[i].c[1];
+            zs[i] = records[i].c[2];
+            ids[i] = records[i].index;
+        }, threads, 4096);
+
+        lo.fill(std::numeric_limits<double>::infinity());
+        hi.fill(-std::numeric_limits<double>::infinity());
+        for (const record& r : records) {
+            for (size_t k = 0; k < 3; ++k) {
+                lo[k] = std::min(lo[k], r.c[k]);
+                hi[k] = std::max(hi[k], r.c[k]);
+            }
+        }
+    }
+
+    template<class Metric>
+    uint32_t KDTree<Metric>::build_range(std::vector<node>& out, record* records, size_t begin, size_t end,
+                                         std::vector<task>* tasks, size_t cutoff) const {
+        if (begin == end) return NONE;
+
+        uint32_t index = static_cast<uint32_t>(out.size());
+        out.push_back({});
+        size_t count = end - begin;
+
+        if (tasks && count <= cutoff) {
+            out[index].first = static_cast<uint32_t>(tasks->size());
+            out[index].count = placeholder;
+            tasks->push_back({begin, end, {}});
+            return index;
+        }
+        if (count <= bucket_size) {
+            out[index].first = static_cast<uint32_t>(begin);
+            out[index].count = static_cast<uint16_t>(count);
+            return index;
+        }
+
+        std::array<double, 3> low = records[begin].c, high = records[begin].c;
+        for (size_t i = begin + 1; i < end; ++i) {
+            for (size_t k = 0; k < 3; ++k) {
+                low[k] = std::min(low[k], records[i].c[k]);
+                high[k] = std::max(high[k], records[i].c[k]);
+            }
+        }
+        uint16_t axis = 0;
+        for (uint16_t k = 1; k < 3; ++k) {
+            if (high[k] - low[k] > high[axis] - low[axis]) axis = k;
+        }
+
+        // Equal coordinates may fall on either side; the search bounds only
+        // assume left <= split <= right
+        size_t mid = begin + count / 2;
+        std::nth_element(records + begin, records + mid, records + end, [axis](const record& a, const record& b) {
+            return a.c[axis] < b.c[axis];
+        });
+        out[index].split = records[mid].c[axis];
+        out[index].axis = axis;
+        out[index].count = 0;
+
+        build_range(out, records, begin, mid, tasks, cutoff);
+        uint32_t right = build_range(out, records, mid, end, tasks, cutoff);
+        out[index].first = right;
+        return index;
+    }
+
+    template<class Metric>
+    template<class Scan, class Bound>
+    void KDTree<Metric>::descend(uint32_t n, const std::array<double, 3>& q, double rd, std::array<double, 3>& gap,
+                                 Scan& scan, Bound& bound) const {
+        const node& nd = nodes[n];
+        if (nd.count != 0) {
+            for (uint32_t s = nd.first; s < nd.first + nd.count; ++s) {
+                scan(metric.key(xs[s] - q[0], ys[s] - q[1], zs[s] - q[2]), s);
+            }
+            return;
+        }
+
+        double diff = q[nd.axis] - nd.split;
+        uint32_t near = diff <= 0.0 ? n + 1 : nd.first;
+        uint32_t far = diff <= 0.0 ? nd.first : n + 1;
+        descend(near, q, rd, gap, scan, bound);
+
+        double old = gap[nd.axis];
+        double now = metric.axis_key(diff);
+        double far_rd = metric.combine(rd, old, now);
+        if (far_rd <= bound()) {
+            gap[nd.axis] = now;
+            descend(far, q, far_rd, gap, scan, bound);
+            gap[nd.axis] = old;
+        }
+    }
+
+    template<class Metric>
+    KDNeighbor KDTree<Metric>::nearest(const PointR3& p) const {
+        double best = std::numeric_limits<double>::infinity();
+        uint32_t slot = NONE;
+        if (nodes.empty()) return {NONE, best};
+
+        auto q = embedded(p);
+        std::array<double, 3> gap{};
+        auto scan = [&](double key, uint32_t s) {
+            if (key < best) {
+                best = key;
+                slot = s;
+            }
+        };
+        auto bound = [&] { return best; };
+        descend(0, q, 0.0, gap, scan, bound);
+        return {ids[slot], metric.distance(best)};
+    }
+
+    template<class Metric>
+    void KDTree<Metric>::k_nearest(const std::array<double, 3>& q, size_t k,
+                                   std::vector<std::pair<double, uint32_t>>& heap) const {
+        heap.clear();
+        if (nodes.empty() || k == 0) return;
+
+        // Max-heap on key of the best k so far
+        auto scan = [&](double key, uint32_t s) {
+            if (heap.size() < k) {
+                heap.push_back({key, s});
+                std::push_heap(heap.begin(), heap.end());
+            } else if (key < heap.front().first) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = {key, s};
+                std::push_heap(heap.begin(), heap.end());
+            }
+        };
+        auto bound = [&] {
+            return heap.size() < k ? std::numeric_limits<double>::infinity() : heap.front().first;
+        };
+        std::array<double, 3> gap{};
+        descend(0, q, 0.0, gap, scan, bound);
+        std::sort_heap(heap.begin(), heap.end());
+    }
+
+    template<class Metric>
+    void KDTree<Metric>::within(const std::array<double, 3>& q, double key,
+                                std::vector<std::pair<double, uint32_t>>& found) const {
+        found.clear();
+        if (nodes.empty()) return;
+
+        auto scan = [&](double k, uint32_t s) {
+            if (k <= key) found.push_back({k, s});
+        };
+        auto bound = [&] { return key; };
+        std::array<double, 3> gap{};
+        descend(0, q, 0.0, gap, scan, bound);
+    }
+
+    template<class Metric>
+    void KDTree<Metric>::nearest(const PointR3& q, size_t k, std::vector<KDNeighbor>& out) const {
+        std::vector<std::pair<double, uint32_t>> heap;
+        k_nearest(embedded(q), k, heap);
+        out.clear();
+        for (const auto& [key, s] : heap) out.push_back({ids[s], metric.distance(key)});
+    }
+
+    template<class Metric>
+    void KDTree<Metric>::radius(const PointR3& q, double r, std::vector<KDNeighbor>& out, bool sorted) const {
+        std::vector<std::pair<double, uint32_t>> found;
+        within(embedded(q), metric.key_of(r), found);
+        if (sorted) std::sort(found.begin(), found.end());
+        out.clear();
+        for (const auto& [key, s] : found) out.push_back({ids[s], metric.distance(key)});
+    }
+
+    // Query indices sorted along a Morton curve over the tree bounds, so
+    // that consecutive queries in a block walk mostly the same nodes
+    template<class Metric>
+    std::vector<uint32_t> KDTree<Metric>::spatial_order(const PointR3* queries, size_t m, unsigned threads) const {
+        if (m >= NONE) {
+            throw std::length_error("KDTree: too many queries");
+        }
+
+        std::vector<std::pair<uint64_t, uint32_t>> keyed(m);
+        parallel_for(m, [&](size_t i) {
+            keyed[i] = {morton_code<3>(embedded(queries[i]), lo, hi), static_cast<uint32_t>(i)};
+        }, threads, 4096);
+        std::sort(keyed.begin(), keyed.end());
+
+        std::vector<uint32_t> order(m);
+        for (size_t j = 0; j < m; ++j) order[j] = keyed[j].second;
+        return order;
+    }
+
+    template<class Metric>
+    void KDTree<Metric>::nearest(const PointR3* queries, size_t m, size_t k, std::vector<KDNeighbor>& out,
+                                 unsigned threads) const {
+        out.assign(m * k, {NONE, std::numeric_limits<double>::infinity()});
+        std::vector<uint32_t> order = spatial_order(queries, m, threads);
+
+        parallel_blocks(m, 256, threads, [&](size_t begin, size_t end, unsigned) {
+            std::vector<std::pair<double, uint32_t>> heap;
+            for (size_t j = begin; j < end; ++j) {
+                uint32_t i = order[j];
+                k_nearest(embedded(queries[i]), k, heap);
+                KDNeighbor* row = out.data() + static_cast<size_t>(i) * k;
+                for (size_t h = 0; h < heap.size(); ++h) row[h] = {ids[heap[h].second], metric.distance(heap[h].first)};
+            }
+        });
+    }
+
+    template<class Metric>
+    void KDTree<Metric>::radius(const PointR3* queries, size_t m, double r, std::vector<uint32_t>& offsets,
+                                std::vector<KDNeighbor>& out, unsigned threads) const {
+        double key = metric.key_of(r);
+        std::vector<uint32_t> order = spatial_order(queries, m, threads);
+
+        // Each block gathers its results locally; they are scattered back to
+        // query order once the offsets are known
+        constexpr size_t grain = 256;
+        std::vector<std::vector<KDNeighbor>> found((m + grain - 1) / grain);
+        offsets.assign(m + 1, 0);
+        parallel_blocks(m, grain, threads, [&](size_t begin, size_t end, unsigned) {
+            std::vector<std::pair<double, uint32_t>> scratch;
+            auto& block = found[begin / grain];
+            for (size_t j = begin; j < end; ++j) {
+                uint32_t i = order[j];
+                within(embedded(queries[i]), key, scratch);
+                for (const auto& [k, s] : scratch) block.push_back({ids[s], metric.distance(k)});
+                offsets[i + 1] = static_cast<uint32_t>(scratch.size());
+            }
+        });
+
+        size_t total = 0;
+        for (size_t i = 0; i < m; ++i) {
+            total += offsets[i + 1];
+            if (total >= NONE) {
+                throw std::length_error("KDTree: too many query results");
+            }
+            offsets[i + 1] = static_cast<uint32_t>(total);
+        }
+
+        out.resize(total);
+        parallel_for(found.size(), [&](size_t b) {
+            const KDNeighbor* from = found[b].data();
+            size_t end = std::min(m, (b + 1) * grain);
+            for (size_t j = b * grain; j < end; ++j) {
+                uint32_t i = order[j];
+                uint32_t count = offsets[i + 1] - offsets[i];
+                std::copy(from, from + count, out.begin() + offsets[i]);
+                from += count;
+            }
+        }, threads);
+    }
+}
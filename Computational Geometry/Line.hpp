@@ -16,8 +16,8 @@ namespace GeomCore{
                 point = p1;
             }
 
-            Vector<coord_type, dim> get_point() const ;
-            Vector<coord_type, dim> get_direction() const;
+            const Vector<coord_type, dim>& get_point() const;
+            const Vector<coord_type, dim>& get_direction() const;
 
             void set_direction(Vector<coord_type, dim>& _dir);
             void set_point(Vector<coord_type, dim>& _point);
@@ -27,12 +27,12 @@ namespace GeomCore{
     typedef Line<double, R3> Line3d;
     
     template <class coord_type, size_t dim>
-    inline Vector<coord_type, dim> Line<coord_type, dim>::get_point() const{
+    inline const Vector<coord_type, dim>& Line<coord_type, dim>::get_point() const{
         return point;
     }
 
     template <class coord_type, size_t dim>
-    inline Vector<coord_type, dim> Line<coord_type, dim>::get_direction() const{
+    inline const Vector<coord_type, dim>& Line<coord_type, dim>::get_direction() const{
         return dir;
     }
 
@@ -2,6 +2,11 @@
 
 #include "Core.hpp"
 
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
 namespace GeomCore {
 
     enum class GeometryKind {
@@ -54,4 +59,65 @@ namespace GeomCore {
         return Manifold<T>(Curvature<T>(-T{1} / (radius * radius)));
     }
 
-}
\ No newline at end of file
+    // Manifold whose kind is a template parameter, with the radius
+    // 1 / sqrt(|curvature|) and its inverse computed once. Functions taking
+    // one select their formulas with if constexpr, so loops over points
+    // carry no kind checks, square roots or throws; the kind is checked
+    // once, when it is made from a Manifold. Euclidean space has infinite
+    // radius and zero inverse radius.
+    template<GeometryKind K, typename T = double>
+    requires Real<T>
+    struct StaticManifold {
+        T radius = K == GeometryKind::Euclidean ? std::numeric_limits<T>::infinity() : T{1};
+        T inverse_radius = K == GeometryKind::Euclidean ? T{0} : T{1};
+
+        constexpr StaticManifold() = default;
+
+        // Sphere or hyperboloid of the given radius
+        constexpr explicit StaticManifold(T r) requires (K != GeometryKind::Euclidean)
+            : radius(r), inverse_radius(T{1} / r) {}
+
+        // Throws std::invalid_argument if the manifold is of another kind
+        explicit StaticManifold(const Manifold<T>& manifold) {
+            if (manifold.kind() != K) {
+                throw std::invalid_argument("Manifold is of a different geometry kind");
+            }
+            if constexpr (K != GeometryKind::Euclidean) {
+                inverse_radius = std::sqrt(std::abs(manifold.curvature.value));
+                radius = T{1} / inverse_radius;
+            }
+        }
+
+        static constexpr GeometryKind kind() { return K; }
+
+        constexpr T curvature() const {
+            if constexpr (K == GeometryKind::Euclidean) return T{0};
+            T k = inverse_radius * inverse_radius;
+            return K == GeometryKind::Spherical ? k : -k;
+        }
+
+        constexpr Manifold<T> manifold() const { return Manifold<T>(Curvature<T>(curvature())); }
+    };
+
+    template<typename T = double>
+    using EuclideanManifold = StaticManifold<GeometryKind::Euclidean, T>;
+    template<typename T = double>
+    using SphericalManifold = StaticManifold<GeometryKind::Spherical, T>;
+    template<typename T = double>
+    using HyperbolicManifold = StaticManifold<GeometryKind::Hyperbolic, T>;
+
+    // Call f with the StaticManifold matching the runtime manifold, so that
+    // generic code branches on the kind once and not inside its loops
+    template<typename T, class Function>
+    requires Real<T>
+    decltype(auto) visit_manifold(const Manifold<T>& manifold, Function&& f) {
+        switch (manifold.kind()) {
+            case GeometryKind::Spherical:
+                return std::forward<Function>(f)(SphericalManifold<T>(manifold));
+            case GeometryKind::Hyperbolic:
+                return std::forward<Function>(f)(HyperbolicManifold<T>(manifold));
+            default:
+                return std::forward<Function>(f)(EuclideanManifold<T>(manifold));
+        }
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// The thread pool helpers are shared with the graph code; this header only
+// brings them into GeomCore.
+#include "../Graph Theory/parallel.hpp"
+
+namespace GeomCore {
+    using ::default_thread_count;
+    using ::parallel_blocks;
+    using ::parallel_for;
+}
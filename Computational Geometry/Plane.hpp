@@ -24,7 +24,7 @@ namespace GeomCore{
                 d = dot_product(normal, _p1);
             }
 
-            Vector3d get_normal() const {
+            const Vector3d& get_normal() const {
                 return normal;
             }
 
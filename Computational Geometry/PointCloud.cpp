@@ -0,0 +1,258 @@
+#include "PointCloud.hpp"
+#include "GeoUtils.hpp"
+#include "Predicates.hpp"
+#include "Simd.hpp"
+
+#include <stdexcept>
+
+using namespace GeomCore;
+
+// Every kernel runs its body on simd::width points at a time and finishes
+// the remaining n % width points with the same formula on plain doubles.
+
+static void check_sizes(size_t a, size_t b) {
+    if (a != b) {
+        throw std::invalid_argument("Point clouds must have the same size");
+    }
+}
+
+static size_t vector_end(size_t n) {
+    return n - n % simd::width;
+}
+
+GeomCore::PointCloud2::PointCloud2(const std::vector<PointR2>& points) {
+    reserve(points.size());
+    for (const auto& p : points) push_back(p);
+}
+
+std::vector<PointR2> GeomCore::PointCloud2::to_points() const {
+    std::vector<PointR2> points;
+    points.reserve(size());
+    for (size_t i = 0; i < size(); ++i) points.push_back((*this)[i]);
+    return points;
+}
+
+GeomCore::PointCloud3::PointCloud3(const std::vector<PointR3>& points) {
+    reserve(points.size());
+    for (const auto& p : points) push_back(p);
+}
+
+std::vector<PointR3> GeomCore::PointCloud3::to_points() const {
+    std::vector<PointR3> points;
+    points.reserve(size());
+    for (size_t i = 0; i < size(); ++i) points.push_back((*this)[i]);
+    return points;
+}
+
+void GeomCore::dot_product(const PointCloud2& a, const PointCloud2& b, std::vector<double>& out) {
+    check_sizes(a.size(), b.size());
+    size_t n = a.size(), end = vector_end(n);
+    out.resize(n);
+    const double *ax = a.x(), *ay = a.y(), *bx = b.x(), *by = b.y();
+
+    for (size_t i = 0; i < end; i += simd::width) {
+        auto r = simd::mul(simd::load(ax + i), simd::load(bx + i));
+        r = simd::fmadd(simd::load(ay + i), simd::load(by + i), r);
+        simd::store(out.data() + i, r);
+    }
+    for (size_t i = end; i < n; ++i) {
+        out[i] = ax[i] * bx[i] + ay[i] * by[i];
+    }
+}
+
+void GeomCore::dot_product(const PointCloud3& a, const PointCloud3& b, std::vector<double>& out) {
+    check_sizes(a.size(), b.size());
+    size_t n = a.size(), end = vector_end(n);
+    out.resize(n);
+    const double *ax = a.x(), *ay = a.y(), *az = a.z();
+    const double *bx = b.x(), *by = b.y(), *bz = b.z();
+
+    for (size_t i = 0; i < end; i += simd::width) {
+        auto r = simd::mul(simd::load(ax + i), simd::load(bx + i));
+        r = simd::fmadd(simd::load(ay + i), simd::load(by + i), r);
+        r = simd::fmadd(simd::load(az + i), simd::load(bz + i), r);
+        simd::store(out.data() + i, r);
+    }
+    for (size_t i = end; i < n; ++i) {
+        out[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+    }
+}
+
+void GeomCore::dot_product(const PointCloud3& a, const Vector3d& v, std::vector<double>& out) {
+    size_t n = a.size(), end = vector_end(n);
+    out.resize(n);
+    const double *ax = a.x(), *ay = a.y(), *az = a.z();
+    double vx = v[X], vy = v[Y], vz = v[Z];
+    auto wx = simd::broadcast(vx), wy = simd::broadcast(vy), wz = simd::broadcast(vz);
+
+    for (size_t i = 0; i < end; i += simd::width) {
+        auto r = simd::mul(simd::load(ax + i), wx);
+        r = simd::fmadd(simd::load(ay + i), wy, r);
+        r = simd::fmadd(simd::load(az + i), wz, r);
+        simd::store(out.data() + i, r);
+    }
+    for (size_t i = end; i < n; ++i) {
+        out[i] = ax[i] * vx + ay[i] * vy + az[i] * vz;
+    }
+}
+
+void GeomCore::cross_product_R2(const PointCloud2& a, const PointCloud2& b, std::vector<double>& out) {
+    check_sizes(a.size(), b.size());
+    size_t n = a.size(), end = vector_end(n);
+    out.resize(n);
+    const double *ax = a.x(), *ay = a.y(), *bx = b.x(), *by = b.y();
+
+    for (size_t i = 0; i < end; i += simd::width) {
+        auto r = simd::mul(simd::load(ay + i), simd::load(bx + i));
+        r = simd::fmsub(simd::load(ax + i), simd::load(by + i), r);
+        simd::store(out.data() + i, r);
+    }
+    for (size_t i = end; i < n; ++i) {
+        out[i] = ax[i] * by[i] - ay[i] * bx[i];
+    }
+}
+
+void GeomCore::cross_product_R3(const PointCloud3& a, const PointCloud3& b, PointCloud3& out) {
+    check_sizes(a.size(), b.size());
+    size_t n = a.size(), end = vector_end(n);
+    out.resize(n);
+    const double *ax = a.x(), *ay = a.y(), *az = a.z();
+    const double *bx = b.x(), *by = b.y(), *bz = b.z();
+    double *ox = out.x(), *oy = out.y(), *oz = out.z();
+
+    for (size_t i = 0; i < end; i += simd::width) {
+        auto x1 = simd::load(ax + i), y1 = simd::load(ay + i), z1 = simd::load(az + i);
+        auto x2 = simd::load(bx + i), y2 = simd::load(by + i), z2 = simd::load(bz + i);
+        simd::store(ox + i, simd::fmsub(y1, z2, simd::mul(z1, y2)));
+        simd::store(oy + i, simd::fmsub(z1, x2, simd::mul(x1, z2)));
+        simd::store(oz + i, simd::fmsub(x1, y2, simd::mul(y1, x2)));
+    }
+    for (size_t i = end; i < n; ++i) {
+        double x = ay[i] * bz[i] - az[i] * by[i];
+        double y = az[i] * bx[i] - ax[i] * bz[i];
+        double z = ax[i] * by[i] - ay[i] * bx[i];
+        ox[i] = x;
+        oy[i] = y;
+        oz[i] = z;
+    }
+}
+
+void GeomCore::magnitude(const PointCloud2& a, std::vector<double>& out) {
+    dot_product(a, a, out);
+    size_t n = out.size(), end = vector_end(n);
+    for (size_t i = 0; i < end; i += simd::width) {
+        simd::store(out.data() + i, simd::sqrt(simd::load(out.data() + i)));
+    }
+    for (size_t i = end; i < n; ++i) {
+        out[i] = std::sqrt(out[i]);
+    }
+}
+
+void GeomCore::magnitude(const PointCloud3& a, std::vector<double>& out) {
+    dot_product(a, a, out);
+    size_t n = out.size(), end = vector_end(n);
+    for (size_t i = 0; i < end; i += simd::width) {
+        simd::store(out.data() + i, simd::sqrt(simd::load(out.data() + i)));
+    }
+    for (size_t i = end; i < n; ++i) {
+        out[i] = std::sqrt(out[i]);
+    }
+}
+
+void GeomCore::normalize(PointCloud2& a) {
+    size_t n = a.size(), end = vector_end(n);
+    double *ax = a.x(), *ay = a.y();
+    auto tolerance = simd::broadcast(TOLERANCE), one = simd::broadcast(1.0);
+
+    for (size_t i = 0; i < end; i += simd::width) {
+        auto x = simd::load(ax + i), y = simd::load(ay + i);
+        auto mag = simd::sqrt(simd::fmadd(x, x, simd::mul(y, y)));
+        // Short vectors are scaled by 1, i.e. left unchanged
+        auto scale = simd::select_greater(mag, tolerance, simd::div(one, mag), one);
+        simd::store(ax + i, simd::mul(x, scale));
+        simd::store(ay + i, simd::mul(y, scale));
+    }
+    for (size_t i = end; i < n; ++i) {
+        double mag = std::sqrt(ax[i] * ax[i] + ay[i] * ay[i]);
+        if (mag > TOLERANCE) {
+            ax[i] /= mag;
+            ay[i] /= mag;
+        }
+    }
+}
+
+void GeomCore::normalize(PointCloud3& a) {
+    size_t n = a.size(), end = vector_end(n);
+    double *ax = a.x(), *ay = a.y(), *az = a.z();
+    auto tolerance = simd::broadcast(TOLERANCE), one = simd::broadcast(1.0);
+
+    for (size_t i = 0; i < end; i += simd::width) {
+        auto x = simd::load(ax + i), y = simd::load(ay + i), z = simd::load(az + i);
+        auto mag = simd::sqrt(simd::fmadd(x, x, simd::fmadd(y, y, simd::mul(z, z))));
+        auto scale = simd::select_greater(mag, tolerance, simd::div(one, mag), one);
+        simd::store(ax + i, simd::mul(x, scale));
+        simd::store(ay + i, simd::mul(y, scale));
+        simd::store(az + i, simd::mul(z, scale));
+    }
+    for (size_t i = end; i < n; ++i) {
+        double mag = std::sqrt(ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i]);
+        if (mag > TOLERANCE) {
+            ax[i] /= mag;
+            ay[i] /= mag;
+            az[i] /= mag;
+        }
+    }
+}
+
+void GeomCore::orientation_R2(const PointR2& a, const PointR2& b, const PointCloud2& c, std::vector<int>& out) {
+    size_t n = c.size(), end = vector_end(n);
+    out.resize(n);
+    const double *cx = c.x(), *cy = c.y();
+    double abx = b[X] - a[X], aby = b[Y] - a[Y];
+
+    // A determinant whose magnitude exceeds orient2d's static error bound
+    // has a certain sign and decides LEFT/RIGHT directly; the rest go through
+    // the scalar test, which evaluates them exactly and also tells
+    // BEHIND/BEYOND/BETWEEN apart for collinear points.
+    auto classify = [&](size_t i, double det, double detsum) {
+        double errbound = orient2d_error_bound * detsum;
+        if (det > errbound) {
+            out[i] = LEFT;
+        } else if (-det > errbound) {
+            out[i] = RIGHT;
+        } else {
+            out[i] = GeomCore::orientation_R2(a, b, c[i]);
+        }
+    };
+
+    double det[simd::width], detsum[simd::width];
+    auto vax = simd::broadcast(a[X]), vay = simd::broadcast(a[Y]);
+    auto vabx = simd::broadcast(abx), vaby = simd::broadcast(aby);
+    for (size_t i = 0; i < end; i += simd::width) {
+        auto acx = simd::sub(simd::load(cx + i), vax);
+        auto acy = simd::sub(simd::load(cy + i), vay);
+        auto left = simd::mul(vabx, acy), right = simd::mul(vaby, acx);
+        simd::store(det, simd::sub(left, right));
+        simd::store(detsum, simd::add(simd::abs(left), simd::abs(right)));
+        for (size_t lane = 0; lane < simd::width; ++lane) {
+            classify(i + lane, det[lane], detsum[lane]);
+        }
+    }
+    for (size_t i = end; i < n; ++i) {
+        double left = abx * (cy[i] - a[Y]), right = aby * (cx[i] - a[X]);
+        classify(i, left - right, std::abs(left) + std::abs(right));
+    }
+}
+
+void GeomCore::signed_distance(const Plane_d& plane, const PointCloud3& points, std::vector<double>& out) {
+    dot_product(points, plane.get_normal(), out);
+    size_t n = out.size(), end = vector_end(n);
+    double d = plane.get_d();
+    auto vd = simd::broadcast(d);
+    for (size_t i = 0; i < end; i += simd::width) {
+        simd::store(out.data() + i, simd::sub(simd::load(out.data() + i), vd));
+    }
+    for (size_t i = end; i < n; ++i) {
+        out[i] -= d;
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+
+#include "Point.hpp"
+#include "Plane.hpp"
+
+namespace GeomCore {
+
+    // Points stored as one contiguous array per coordinate (struct of arrays),
+    // so batch kernels can load several points per instruction.
+    class PointCloud2 {
+            std::vector<double> xs;
+            std::vector<double> ys;
+
+        public:
+            PointCloud2() {}
+            explicit PointCloud2(size_t n) : xs(n), ys(n) {}
+            PointCloud2(const std::vector<PointR2>& points);
+
+            size_t size() const { return xs.size(); }
+            bool empty() const { return xs.empty(); }
+
+            void reserve(size_t n) { xs.reserve(n); ys.reserve(n); }
+            void resize(size_t n) { xs.resize(n); ys.resize(n); }
+            void clear() { xs.clear(); ys.clear(); }
+
+            void push_back(const PointR2& p) {
+                xs.push_back(p[X]);
+                ys.push_back(p[Y]);
+            }
+
+            PointR2 operator[](size_t i) const { return PointR2(xs[i], ys[i]); }
+
+            void set(size_t i, const PointR2& p) {
+                xs[i] = p[X];
+                ys[i] = p[Y];
+            }
+
+            double* x() { return xs.data(); }
+            double* y() { return ys.data(); }
+            const double* x() const { return xs.data(); }
+            const double* y() const { return ys.data(); }
+
+            std::vector<PointR2> to_points() const;
+    };
+
+    class PointCloud3 {
+            std::vector<double> xs;
+            std::vector<double> ys;
+            std::vector<double> zs;
+
+        public:
+            PointCloud3() {}
+            explicit PointCloud3(size_t n) : xs(n), ys(n), zs(n) {}
+            PointCloud3(const std::vector<PointR3>& points);
+
+            size_t size() const { return xs.size(); }
+            bool empty() const { return xs.empty(); }
+
+            void reserve(size_t n) { xs.reserve(n); ys.reserve(n); zs.reserve(n); }
+            void resize(size_t n) { xs.resize(n); ys.resize(n); zs.resize(n); }
+            void clear() { xs.clear(); ys.clear(); zs.clear(); }
+
+            void push_back(const PointR3& p) {
+                xs.push_back(p[X]);
+                ys.push_back(p[Y]);
+                zs.push_back(p[Z]);
+            }
+
+            PointR3 operator[](size_t i) const { return PointR3(xs[i], ys[i], zs[i]); }
+
+            void set(size_t i, const PointR3& p) {
+                xs[i] = p[X];
+                ys[i] = p[Y];
+                zs[i] = p[Z];
+            }
+
+            double* x() { return xs.data(); }
+            double* y() { return ys.data(); }
+            double* z() { return zs.data(); }
+            const double* x() const { return xs.data(); }
+            const double* y() const { return ys.data(); }
+            const double* z() const { return zs.data(); }
+
+            std::vector<PointR3> to_points() const;
+    };
+
+    // Batch kernels. Each computes, for every index i, the same quantity as
+    // the single-vector function of the same name and writes it to out[i];
+    // output vectors are resized to fit. Paired inputs must have equal size.
+
+    void dot_product(const PointCloud2& a, const PointCloud2& b, std::vector<double>& out);
+    void dot_product(const PointCloud3& a, const PointCloud3& b, std::vector<double>& out);
+    void dot_product(const PointCloud3& a, const Vector3d& v, std::vector<double>& out);
+
+    void cross_product_R2(const PointCloud2& a, const PointCloud2& b, std::vector<double>& out);
+    void cross_product_R3(const PointCloud3& a, const PointCloud3& b, PointCloud3& out);
+
+    void magnitude(const PointCloud2& a, std::vector<double>& out);
+    void magnitude(const PointCloud3& a, std::vector<double>& out);
+
+    // In place; vectors shorter than TOLERANCE are left unchanged
+    void normalize(PointCloud2& a);
+    void normalize(PointCloud3& a);
+
+    // orientation_R2(a, b, c[i]) for every point of c
+    void orientation_R2(const PointR2& a, const PointR2& b, const PointCloud2& c, std::vector<int>& out);
+
+    // Signed distance of every point to the plane, n . p - d
+    void signed_distance(const Plane_d& plane, const PointCloud3& points, std::vector<double>& out);
+}
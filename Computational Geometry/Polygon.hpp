@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Vector.hpp"
+#include "Predicates.hpp"
 
 #include <list>
 #include <vector>
@@ -66,28 +67,19 @@ class Polygon {
         }
 };
 
+using VertexR2 = Vertex<double, 2>;
+using VertexR3 = Vertex<double, 3>; 
+
+using PolygonR2 = Polygon<double, 2>;
+using PolygonR3 = Polygon<double, 3>;
+
 // bool collinear(const PointR3& a, const PointR3& b, const PointR3& c);
-bool is_convex(const std::shared_ptr<VertexR2>& a,
+inline bool is_convex(const std::shared_ptr<VertexR2>& a,
                const std::shared_ptr<VertexR2>& b,
                const std::shared_ptr<VertexR2>& c)
 {
-    const auto& pa = a->point;
-    const auto& pb = b->point;
-    const auto& pc = c->point;
-
-    // Compute 2D cross product:
-    // (b - a) x (c - b)
-    double cross =
-        (pb[0] - pa[0]) * (pc[1] - pb[1]) -
-        (pb[1] - pa[1]) * (pc[0] - pb[0]);
-
+    // Turn a -> b -> c, i.e. the sign of (b - a) x (c - b), decided exactly.
     // For counter-clockwise polygons:
-    // cross > 0 => convex
-    return cross > 0.0;
-}
-
-using VertexR2 = Vertex<double, 2>;
-using VertexR3 = Vertex<double, 3>; 
-
-using PolygonR2 = Polygon<double, 2>;
-using PolygonR3 = Polygon<double, 3>;
\ No newline at end of file
+    // left turn => convex
+    return GeomCore::orient2d(a->point, b->point, c->point) > 0.0;
+}
\ No newline at end of file
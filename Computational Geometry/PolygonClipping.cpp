@@ -0,0 +1,257 @@
+#include "PolygonClipping.hpp"
+#include "Parallel.hpp"
+#include "Predicates.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+static bool same_point(const GeomCore::PointR2& a, const GeomCore::PointR2& b) {
+    return a[X] == b[X] && a[Y] == b[Y];
+}
+
+static bool lexicographic(const GeomCore::PointR2& a, const GeomCore::PointR2& b) {
+    return a[X] < b[X] || (a[X] == b[X] && a[Y] < b[Y]);
+}
+
+/**
+ * @brief Bounding box of all ring points as min x, min y, max x, max y;
+ *        inverted for an empty set.
+ */
+static std::array<double, 4> bounds(const GeomCore::RingSet& rings) {
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    std::array<double, 4> box{infinity, infinity, -infinity, -infinity};
+    for (const GeomCore::PointR2& p : rings.points) {
+        box[0] = std::min(box[0], p[X]);
+        box[1] = std::min(box[1], p[Y]);
+        box[2] = std::max(box[2], p[X]);
+        box[3] = std::max(box[3], p[Y]);
+    }
+    return box;
+}
+
+static bool selected(GeomCore::BooleanOperation op, uint8_t side) {
+    bool in_a = side & 1, in_b = side & 2;
+    switch (op) {
+        case GeomCore::BooleanOperation::Union: return in_a || in_b;
+        case GeomCore::BooleanOperation::Intersection: return in_a && in_b;
+        case GeomCore::BooleanOperation::Difference: return in_a && !in_b;
+        case GeomCore::BooleanOperation::SymmetricDifference: return in_a != in_b;
+    }
+    return false;
+}
+
+/**
+ * @brief Finishes the ring traced into out.points[base..): drops vertices
+ *        where the boundary goes straight on, across the seam as well, and
+ *        the whole ring if fewer than three vertices are left.
+ */
+static void close_ring(GeomCore::RingSet& out, size_t base) {
+    auto& points = out.points;
+    size_t last = base;
+    for (size_t i = base; i < points.size(); ++i) {
+        GeomCore::PointR2 p = points[i];
+        while (last - base >= 2 && GeomCore::orient2d(points[last - 2], points[last - 1], p) == 0.0) --last;
+        points[last++] = p;
+    }
+
+    size_t first = base;
+    while (last - first >= 3) {
+        if (GeomCore::orient2d(points[last - 2], points[last - 1], points[first]) == 0.0) {
+            --last;
+        } else if (GeomCore::orient2d(points[last - 1], points[first], points[first + 1]) == 0.0) {
+            ++first;
+        } else {
+            break;
+        }
+    }
+
+    if (last - first < 3) {
+        points.resize(base);
+        return;
+    }
+    std::copy(points.begin() + first, points.begin() + last, points.begin() + base);
+    points.resize(base + (last - first));
+    out.offsets.push_back(static_cast<uint32_t>(points.size()));
+}
+
+void GeomCore::PolygonClipper::add_operand(const RingSet& rings, uint8_t side) {
+    for (size_t k = 0; k < rings.ring_count(); ++k) {
+        const PointR2* ring = rings.ring(k);
+        size_t n = rings.ring_size(k);
+        for (size_t i = 0; i < n; ++i) {
+            const PointR2& p = ring[i];
+            const PointR2& q = ring[i + 1 == n ? 0 : i + 1];
+            if (same_point(p, q)) continue;
+            segments.push_back({p, q});
+            segment_side.push_back(side);
+        }
+    }
+}
+
+GeomCore::RingSet GeomCore::PolygonClipper::compute(const RingSet& a, const RingSet& b, BooleanOperation op) {
+    RingSet out;
+    compute(a, b, op, out);
+    return out;
+}
+
+void GeomCore::PolygonClipper::compute(const RingSet& a, const RingSet& b, BooleanOperation op, RingSet& out) {
+    // Operands with disjoint boxes share no edges and no area
+    auto box_a = bounds(a), box_b = bounds(b);
+    bool apart = box_a[2] < box_b[0] || box_b[2] < box_a[0] || box_a[3] < box_b[1] || box_b[3] < box_a[1];
+    if (apart && op == BooleanOperation::Intersection) return;
+
+    segments.clear();
+    segment_side.clear();
+    add_operand(a, 1);
+    if (!apart || op != BooleanOperation::Difference) add_operand(b, 2);
+    if (segments.empty()) return;
+    if (segments.size() >= HalfEdgeMesh::NONE / 4) {
+        throw std::length_error("PolygonClipper: too many edges");
+    }
+
+    overlay();
+    trace(op, out);
+}
+
+// Split the segments where they meet, merge pieces that coincide, and find
+// the sides covering each face of the resulting subdivision
+void GeomCore::PolygonClipper::overlay() {
+    crossings.clear();
+    crossing_offsets.clear();
+    crossing_segments.clear();
+    sweep.intersections(segments.data(), segments.size(), crossings, crossing_offsets, crossing_segments);
+
+    vertices.clear();
+    for (const SegmentR2& s : segments) {
+        vertices.push_back(s[0]);
+        vertices.push_back(s[1]);
+    }
+    vertices.insert(vertices.end(), crossings.begin(), crossings.end());
+    std::sort(vertices.begin(), vertices.end(), lexicographic);
+    vertices.erase(std::unique(vertices.begin(), vertices.end(), same_point), vertices.end());
+    auto vertex_of = [this](const PointR2& p) {
+        return static_cast<uint32_t>(std::lower_bound(vertices.begin(), vertices.end(), p, lexicographic) -
+                                     vertices.begin());
+    };
+
+    // Points on each segment, ordered by their projection onto it
+    auto along = [this](uint32_t s, const PointR2& p) {
+        const SegmentR2& g = segments[s];
+        return (p[X] - g[0][X]) * (g[1][X] - g[0][X]) + (p[Y] - g[0][Y]) * (g[1][Y] - g[0][Y]);
+    };
+    cuts.clear();
+    for (uint32_t s = 0; s < segments.size(); ++s) {
+        cuts.push_back({s, vertex_of(segments[s][0]), 0.0});
+        cuts.push_back({s, vertex_of(segments[s][1]), along(s, segments[s][1])});
+    }
+    for (size_t k = 0; k + 1 < crossing_offsets.size(); ++k) {
+        uint32_t v = vertex_of(crossings[k]);
+        for (uint32_t j = crossing_offsets[k]; j < crossing_offsets[k + 1]; ++j) {
+            uint32_t s = crossing_segments[j];
+            cuts.push_back({s, v, along(s, crossings[k])});
+        }
+    }
+    std::sort(cuts.begin(), cuts.end(), [](const cut& p, const cut& q) {
+        return p.segment != q.segment ? p.segment < q.segment : p.along < q.along;
+    });
+
+    pieces.clear();
+    for (size_t i = 1; i < cuts.size(); ++i) {
+        const cut &p = cuts[i - 1], &q = cuts[i];
+        if (p.segment != q.segment || p.vertex == q.vertex) continue;
+        pieces.push_back({std::min(p.vertex, q.vertex), std::max(p.vertex, q.vertex), segment_side[p.segment]});
+    }
+    std::sort(pieces.begin(), pieces.end());
+
+    // An edge covered twice by the same operand separates nothing
+    edges.clear();
+    edge_side.clear();
+    for (size_t i = 0; i < pieces.size();) {
+        uint32_t side = 0;
+        size_t j = i;
+        for (; j < pieces.size() && pieces[j][0] == pieces[i][0] && pieces[j][1] == pieces[i][1]; ++j) {
+            side ^= pieces[j][2];
+        }
+        if (side != 0) {
+            edges.push_back({pieces[i][0], pieces[i][1]});
+            edge_side.push_back(static_cast<uint8_t>(side));
+        }
+        i = j;
+    }
+    mesh.build(vertices.data(), vertices.size(), edges.data(), edges.size());
+
+    // Walk out from the unbounded face, which lies in neither operand
+    size_t faces = mesh.face_count();
+    face_side.assign(faces, 0);
+    face_seen.assign(faces, 0);
+    queue.assign(1, HalfEdgeMesh::unbounded_face);
+    face_seen[HalfEdgeMesh::unbounded_face] = 1;
+    for (size_t i = 0; i < queue.size(); ++i) {
+        uint32_t f = queue[i];
+        auto spread = [&](uint32_t start) {
+            uint32_t h = start;
+            do {
+                uint32_t g = mesh.incident_face(h ^ 1);
+                if (!face_seen[g]) {
+                    face_seen[g] = 1;
+                    face_side[g] = face_side[f] ^ edge_side[h >> 1];
+                    queue.push_back(g);
+                }
+                h = mesh.next(h);
+            } while (h != start);
+        };
+        if (mesh.outer(f) != HalfEdgeMesh::NONE) spread(mesh.outer(f));
+        for (uint32_t h : mesh.holes(f)) spread(h);
+    }
+}
+
+// A half-edge is on the result's boundary if its face is selected and its
+// twin's is not. From the end of one, turn clockwise through selected
+// faces until the next.
+void GeomCore::PolygonClipper::trace(BooleanOperation op, RingSet& out) {
+    for (size_t f = 0; f < face_side.size(); ++f) face_seen[f] = selected(op, face_side[f]);
+    auto boundary = [this](uint32_t h) {
+        return face_seen[mesh.incident_face(h)] && !face_seen[mesh.incident_face(h ^ 1)];
+    };
+
+    uint32_t count = static_cast<uint32_t>(mesh.half_edge_count());
+    half_edge_used.assign(count, 0);
+    for (uint32_t h = 0; h < count; ++h) {
+        if (half_edge_used[h] || !boundary(h)) continue;
+        size_t base = out.points.size();
+        uint32_t current = h;
+        do {
+            half_edge_used[current] = 1;
+            out.points.push_back(mesh.point(mesh.origin(current)));
+            uint32_t g = mesh.next(current);
+            while (!boundary(g)) g = mesh.next(g ^ 1);
+            current = g;
+        } while (current != h);
+        close_ring(out, base);
+    }
+}
+
+void GeomCore::boolean_operation(const RingSet* a, const RingSet* b, size_t n, BooleanOperation op,
+                                 std::vector<RingSet>& out, unsigned threads) {
+    constexpr size_t grain = 64;
+    if (threads == 0) threads = default_thread_count();
+    size_t workers = std::min<size_t>(threads, (n + grain - 1) / grain);
+
+    out.resize(n);
+    std::vector<PolygonClipper> clippers(std::max<size_t>(workers, 1));
+    parallel_blocks(n, grain, threads, [&](size_t begin, size_t end, unsigned worker) {
+        for (size_t i = begin; i < end; ++i) {
+            out[i].clear();
+            clippers[worker].compute(a[i], b[i], op, out[i]);
+        }
+    });
+}
+
+void GeomCore::boolean_operation(const std::vector<RingSet>& a, const std::vector<RingSet>& b, BooleanOperation op,
+                                 std::vector<RingSet>& out, unsigned threads) {
+    if (a.size() != b.size()) {
+        throw std::invalid_argument("boolean_operation: operand lists must have the same size");
+    }
+    boolean_operation(a.data(), b.data(), a.size(), op, out, threads);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "HalfEdgeMesh.hpp"
+#include "RingSet.hpp"
+#include "SegmentIntersection.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace GeomCore {
+
+    enum class BooleanOperation : uint8_t { Union, Intersection, Difference, SymmetricDifference };
+
+    // Boolean operations on polygons with holes, by overlaying them.
+    //
+    // The edges of both operands go through one SegmentSweep, are split
+    // wherever they meet, and form a HalfEdgeMesh. Each face of the overlay
+    // learns whether it lies in either operand by walking out from the
+    // unbounded face and flipping at every edge of that operand. The result
+    // is traced along the edges where selected faces meet the rest.
+    //
+    // Operands are RingSets under the even-odd rule, so rings may run
+    // either way and holes are just further rings; rings must not cross
+    // themselves or each other. Result rings run counter-clockwise around
+    // the result and clockwise around its holes, without vertices where the
+    // boundary goes straight on. Crossing points are rounded to doubles as
+    // in SegmentSweep; everything else is decided with exact predicates.
+    // Scratch memory is kept between calls, so one PolygonClipper per
+    // thread serves any number of polygon pairs.
+    class PolygonClipper {
+        public:
+            PolygonClipper() = default;
+            PolygonClipper(const PolygonClipper&) = delete;
+            PolygonClipper& operator=(const PolygonClipper&) = delete;
+
+            // Appends the rings of op(a, b) to out
+            void compute(const RingSet& a, const RingSet& b, BooleanOperation op, RingSet& out);
+            RingSet compute(const RingSet& a, const RingSet& b, BooleanOperation op);
+
+        private:
+            void add_operand(const RingSet& rings, uint8_t side);
+            void overlay();
+            void trace(BooleanOperation op, RingSet& out);
+
+            // Edges of both operands, with bit 0 or 1 for a or b
+            std::vector<SegmentR2> segments;
+            std::vector<uint8_t> segment_side;
+
+            SegmentSweep sweep;
+            std::vector<PointR2> crossings;
+            std::vector<uint32_t> crossing_offsets, crossing_segments;
+
+            // Pieces of segments between the points where they meet; a
+            // piece keeps the sides that cover it an odd number of times
+            struct cut {
+                uint32_t segment, vertex;
+                double along;
+            };
+            std::vector<PointR2> vertices;
+            std::vector<cut> cuts;
+            std::vector<std::array<uint32_t, 3>> pieces;
+            std::vector<HalfEdgeMesh::Edge> edges;
+            std::vector<uint8_t> edge_side;
+
+            std::pmr::unsynchronized_pool_resource pool;
+            HalfEdgeMesh mesh{&pool};
+            std::vector<uint8_t> face_side, face_seen, half_edge_used;
+            std::vector<uint32_t> queue;
+    };
+
+    // out[i] = op(a[i], b[i]) for i < n, the pairs split over threads with
+    // a PolygonClipper each; threads = 0 uses the hardware concurrency
+    void boolean_operation(const RingSet* a, const RingSet* b, size_t n, BooleanOperation op,
+                           std::vector<RingSet>& out, unsigned threads = 0);
+    void boolean_operation(const std::vector<RingSet>& a, const std::vector<RingSet>& b, BooleanOperation op,
+                           std::vector<RingSet>& out, unsigned threads = 0);
+}
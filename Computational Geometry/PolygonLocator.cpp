@@ -0,0 +1,274 @@
+#include "PolygonLocator.hpp"
+#include "Parallel.hpp"
+#include "Predicates.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+static constexpr double epsilon = std::numeric_limits<double>::epsilon();
+
+// Grid cells per edge, and the most cells along either axis
+static constexpr double cells_per_edge = 2.0;
+static constexpr uint32_t max_cells_per_axis = 1u << 14;
+
+/**
+ * @brief Cell along one axis that holds value, clamped to the grid.
+ */
+static uint32_t bin(double value, double origin, double scale, uint32_t count) {
+    double c = std::floor((value - origin) * scale);
+    if (!(c > 0.0)) return 0;
+    return c >= count ? count - 1 : static_cast<uint32_t>(c);
+}
+
+/**
+ * @brief Cells [first, last] along one axis covering [lo, hi], widened by
+ *        slack cells on both sides.
+ */
+static std::pair<uint32_t, uint32_t> bin_range(double lo, double hi, double origin, double scale,
+                                               double slack, uint32_t count) {
+    double first = std::floor((lo - origin) * scale - slack), last = std::floor((hi - origin) * scale + slack);
+    auto clamp = [count](double c) {
+        return c <= 0.0 ? 0u : c >= count ? count - 1 : static_cast<uint32_t>(c);
+    };
+    return {clamp(first), clamp(last)};
+}
+
+void GeomCore::PolygonLocator::build(const PointR2* points, size_t n) {
+    edges.clear();
+    add_ring(points, n);
+    index();
+}
+
+void GeomCore::PolygonLocator::build(const std::vector<std::vector<PointR2>>& rings) {
+    edges.clear();
+    for (const auto& ring : rings) add_ring(ring.data(), ring.size());
+    index();
+}
+
+void GeomCore::PolygonLocator::add_ring(const PointR2* points, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        const PointR2& a = points[i];
+        const PointR2& b = points[i + 1 == n ? 0 : i + 1];
+        if (a[X] == b[X] && a[Y] == b[Y]) continue;
+        edges.push_back({a[X], a[Y], b[X], b[Y]});
+    }
+}
+
+void GeomCore::PolygonLocator::index() {
+    if (edges.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("PolygonLocator: too many edges");
+    }
+    columns = rows = 0;
+    cell_first.clear();
+    cell_edges.clear();
+    row_first.clear();
+    row_edges.clear();
+    center_inside.clear();
+    if (edges.empty()) return;
+
+    min_x = max_x = edges[0].ax;
+    min_y = max_y = edges[0].ay;
+    for (const edge& e : edges) {
+        min_x = std::min(min_x, e.ax);
+        max_x = std::max(max_x, e.ax);
+        min_y = std::min(min_y, e.ay);
+        max_y = std::max(max_y, e.ay);
+    }
+
+    // Cells about as wide as they are high, unless the box is flat
+    double width = max_x - min_x, height = max_y - min_y;
+    double target = std::min(cells_per_edge * static_cast<double>(edges.size()),
+                             static_cast<double>(max_cells_per_axis) * max_cells_per_axis);
+    double across = width > 0.0 && height > 0.0 ? std::round(std::sqrt(target * width / height))
+                  : width > 0.0 ? target : 1.0;
+    columns = static_cast<uint32_t>(std::clamp(across, 1.0, static_cast<double>(max_cells_per_axis)));
+    rows = height > 0.0 ? static_cast<uint32_t>(std::clamp(std::ceil(target / columns), 1.0,
+                                                           static_cast<double>(max_cells_per_axis)))
+                        : 1;
+    cell_width = width / columns;
+    cell_height = height / rows;
+    scale_x = width > 0.0 ? columns / width : 0.0;
+    scale_y = height > 0.0 ? rows / height : 0.0;
+
+    // Edges are binned with a little slack, so that rounding in bin() never
+    // sends a point to a cell or row that misses an edge through it
+    double magnitude_x = std::max(std::abs(min_x), std::abs(max_x));
+    double magnitude_y = std::max(std::abs(min_y), std::abs(max_y));
+    double slack_x = 1e-6 + 64.0 * epsilon * magnitude_x * scale_x;
+    double slack_y = 1e-6 + 64.0 * epsilon * magnitude_y * scale_y;
+
+    // Calls f(row, first column, last column) for the cells of each row
+    // that e passes through
+    auto visit = [&](const edge& e, auto&& f) {
+        auto [first_row, last_row] = bin_range(std::min(e.ay, e.by), std::max(e.ay, e.by), min_y, scale_y,
+                                               slack_y, rows);
+        for (uint32_t r = first_row; r <= last_row; ++r) {
+            double lo = std::min(e.ax, e.bx), hi = std::max(e.ax, e.bx);
+            if (e.ay != e.by && first_row != last_row) {
+                // Part of the edge inside the widened row
+                auto x_at = [&](double y) {
+                    double t = std::clamp((y - e.ay) / (e.by - e.ay), 0.0, 1.0);
+                    return e.ax + t * (e.bx - e.ax);
+                };
+                double x0 = x_at(min_y + (r - slack_y) * cell_height);
+                double x1 = x_at(min_y + (r + 1 + slack_y) * cell_height);
+                lo = std::min(x0, x1);
+                hi = std::max(x0, x1);
+            }
+            auto [first_column, last_column] = bin_range(lo, hi, min_x, scale_x, slack_x, columns);
+            f(r, first_column, last_column);
+        }
+    };
+
+    size_t cells = static_cast<size_t>(columns) * rows;
+    cell_first.assign(cells + 1, 0);
+    row_first.assign(rows + 1, 0);
+    for (const edge& e : edges) {
+        visit(e, [&](uint32_t r, uint32_t first, uint32_t last) {
+            ++row_first[r + 1];
+            for (uint32_t c = first; c <= last; ++c) ++cell_first[static_cast<size_t>(r) * columns + c + 1];
+        });
+    }
+    for (size_t c = 0; c < cells; ++c) cell_first[c + 1] += cell_first[c];
+    for (uint32_t r = 0; r < rows; ++r) row_first[r + 1] += row_first[r];
+
+    cell_edges.resize(cell_first[cells]);
+    row_edges.resize(row_first[rows]);
+    std::vector<uint32_t> cell_cursor(cell_first.begin(), cell_first.end() - 1);
+    std::vector<uint32_t> row_cursor(row_first.begin(), row_first.end() - 1);
+    for (uint32_t i = 0; i < edges.size(); ++i) {
+        visit(edges[i], [&](uint32_t r, uint32_t first, uint32_t last) {
+            row_edges[row_cursor[r]++] = i;
+            for (uint32_t c = first; c <= last; ++c) cell_edges[cell_cursor[static_cast<size_t>(r) * columns + c]++] = i;
+        });
+    }
+
+    // Centres of a row, west to east, against the edges crossing their
+    // height sorted by where they cross. Crossings computed within
+    // rounding of a centre are settled by orient2d.
+    center_inside.resize(cells);
+    double tolerance = 32.0 * epsilon * magnitude_x + std::numeric_limits<double>::min();
+    std::vector<std::pair<double, uint32_t>> crossings;
+    for (uint32_t r = 0; r < rows; ++r) {
+        double cy = min_y + (r + 0.5) * cell_height;
+        crossings.clear();
+        for (uint32_t k = row_first[r]; k < row_first[r + 1]; ++k) {
+            const edge& e = edges[row_edges[k]];
+            if ((e.ay > cy) == (e.by > cy)) continue;
+            crossings.emplace_back(e.ax + (cy - e.ay) / (e.by - e.ay) * (e.bx - e.ax), row_edges[k]);
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        size_t near = 0, far = 0;
+        for (uint32_t c = 0; c < columns; ++c) {
+            double cx = min_x + (c + 0.5) * cell_width;
+            while (near < crossings.size() && crossings[near].first < cx - tolerance) ++near;
+            while (far < crossings.size() && crossings[far].first <= cx + tolerance) ++far;
+            size_t east = crossings.size() - far;
+            for (size_t k = near; k < far; ++k) {
+                const edge& e = edges[crossings[k].second];
+                double o = orient2d(e.ax, e.ay, e.bx, e.by, cx, cy);
+                if (e.ay > e.by ? o < 0.0 : o > 0.0) ++east;
+            }
+            center_inside[static_cast<size_t>(r) * columns + c] = east & 1;
+        }
+    }
+}
+
+bool GeomCore::PolygonLocator::contains(const PointR2& q) const {
+    return locate(q[X], q[Y]);
+}
+
+void GeomCore::PolygonLocator::contains(const PointCloud2& points, std::vector<uint8_t>& inside,
+                                        unsigned threads) const {
+    inside.resize(points.size());
+    const double *x = points.x(), *y = points.y();
+    parallel_blocks(points.size(), 4096, threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) inside[i] = locate(x[i], y[i]);
+    });
+}
+
+bool GeomCore::PolygonLocator::locate(double x, double y) const {
+    if (edges.empty() || !(min_x <= x && x <= max_x && min_y <= y && y <= max_y)) return false;
+
+    uint32_t r = bin(y, min_y, scale_y, rows), c = bin(x, min_x, scale_x, columns);
+    size_t cell = static_cast<size_t>(r) * columns + c;
+    double cx = min_x + (c + 0.5) * cell_width, cy = min_y + (r + 0.5) * cell_height;
+
+    bool inside = center_inside[cell];
+    for (uint32_t k = cell_first[cell]; k < cell_first[cell + 1]; ++k) {
+        const edge& e = edges[cell_edges[k]];
+        double d1 = orient2d(cx, cy, x, y, e.ax, e.ay), d2 = orient2d(cx, cy, x, y, e.bx, e.by);
+        if ((d1 > 0.0 && d2 > 0.0) || (d1 < 0.0 && d2 < 0.0)) continue;
+        double d3 = orient2d(e.ax, e.ay, e.bx, e.by, cx, cy), d4 = orient2d(e.ax, e.ay, e.bx, e.by, x, y);
+        if ((d3 > 0.0 && d4 > 0.0) || (d3 < 0.0 && d4 < 0.0)) continue;
+        // Touching at a vertex, or the query on the boundary
+        if (d1 == 0.0 || d2 == 0.0 || d3 == 0.0 || d4 == 0.0) return row_parity(x, y, r);
+        inside = !inside;
+    }
+    return inside;
+}
+
+// Edges crossing the line through (x, y) in the half-open sense of the
+// usual crossing-number test, counted if they pass strictly east of it
+bool GeomCore::PolygonLocator::row_parity(double x, double y, uint32_t row) const {
+    bool inside = false;
+    for (uint32_t k = row_first[row]; k < row_first[row + 1]; ++k) {
+        const edge& e = edges[row_edges[k]];
+        if ((e.ay > y) == (e.by > y)) continue;
+        double o = orient2d(e.ax, e.ay, e.bx, e.by, x, y);
+        if (e.ay > e.by ? o < 0.0 : o > 0.0) inside = !inside;
+    }
+    return inside;
+}
+
+void GeomCore::points_in_polygon(const PointR2* polygon, size_t n, const PointCloud2& points,
+                                 std::vector<uint8_t>& inside, unsigned threads) {
+    // Non-horizontal edges as their span of heights, one endpoint and the
+    // change of x per unit of y
+    struct span {
+        double lo, hi, x, y, slope;
+    };
+    std::vector<span> spans;
+    spans.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        const PointR2& a = polygon[i];
+        const PointR2& b = polygon[i + 1 == n ? 0 : i + 1];
+        if (a[Y] == b[Y]) continue;
+        spans.push_back({std::min(a[Y], b[Y]), std::max(a[Y], b[Y]), a[X], a[Y], (b[X] - a[X]) / (b[Y] - a[Y])});
+    }
+
+    size_t count = points.size();
+    inside.resize(count);
+    const double *px = points.x(), *py = points.y();
+    parallel_blocks(count, 4096, threads, [&](size_t begin, size_t end, unsigned) {
+        size_t vector_end = end - (end - begin) % simd::width;
+        double parity[simd::width];
+        auto zero = simd::broadcast(0.0), one = simd::broadcast(1.0);
+        for (size_t i = begin; i < vector_end; i += simd::width) {
+            auto x = simd::load(px + i), y = simd::load(py + i);
+            auto odd = zero;
+            for (const span& s : spans) {
+                auto cross = simd::fmadd(simd::sub(y, simd::broadcast(s.y)), simd::broadcast(s.slope),
+                                         simd::broadcast(s.x));
+                auto hit = simd::both(simd::both(simd::less_equal(simd::broadcast(s.lo), y),
+                                                 simd::less(y, simd::broadcast(s.hi))),
+                                      simd::less(x, cross));
+                odd = simd::select(hit, simd::sub(one, odd), odd);
+            }
+            simd::store(parity, odd);
+            for (size_t k = 0; k < simd::width; ++k) inside[i + k] = parity[k] != 0.0;
+        }
+        for (size_t i = vector_end; i < end; ++i) {
+            bool odd = false;
+            for (const span& s : spans) {
+                if (s.lo <= py[i] && py[i] < s.hi && px[i] < s.x + (py[i] - s.y) * s.slope) odd = !odd;
+            }
+            inside[i] = odd;
+        }
+    });
+}
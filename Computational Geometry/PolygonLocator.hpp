@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Point.hpp"
+#include "PointCloud.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace GeomCore {
+
+    // Point-in-polygon queries against a fixed polygon, after linear
+    // preprocessing.
+    //
+    // The polygon's bounding box is cut into a uniform grid of about two
+    // cells per edge. Each cell keeps the edges that touch it and whether its
+    // centre is inside; a query flips the centre's answer once for every
+    // edge properly crossing the segment from the centre to the query point,
+    // so it costs O(1) expected time when the edges are spread evenly. All
+    // tests use orient2d. If that segment touches an edge instead, the query
+    // counts crossings along its grid row.
+    //
+    // The polygon is a set of rings under the even-odd rule: holes are just
+    // further rings, and rings may run either way but must not cross. A
+    // point on the boundary gets the answer of the points just to its right,
+    // or just above it on a horizontal side.
+    class PolygonLocator {
+        public:
+            PolygonLocator() = default;
+            PolygonLocator(const PointR2* points, size_t n) { build(points, n); }
+            explicit PolygonLocator(const std::vector<std::vector<PointR2>>& rings) { build(rings); }
+
+            // The ring points[0..n) or the given rings; repeated consecutive
+            // vertices are skipped
+            void build(const PointR2* points, size_t n);
+            void build(const std::vector<std::vector<PointR2>>& rings);
+
+            bool contains(const PointR2& q) const;
+
+            // contains() for every point, 1 inside and 0 outside, split over
+            // threads; threads = 0 uses the hardware concurrency
+            void contains(const PointCloud2& points, std::vector<uint8_t>& inside, unsigned threads = 0) const;
+
+            size_t edge_count() const { return edges.size(); }
+            size_t cell_count() const { return static_cast<size_t>(columns) * rows; }
+
+        private:
+            struct edge {
+                double ax, ay, bx, by;
+            };
+
+            void add_ring(const PointR2* points, size_t n);
+            void index();
+
+            bool locate(double x, double y) const;
+
+            // Crossing-number parity of (x, y) over the edges of its row
+            bool row_parity(double x, double y, uint32_t row) const;
+
+            std::vector<edge> edges;
+            double min_x = 0.0, min_y = 0.0, max_x = 0.0, max_y = 0.0;
+            double cell_width = 0.0, cell_height = 0.0;   // zero for a flat box
+            double scale_x = 0.0, scale_y = 0.0;          // cells per unit
+            uint32_t columns = 0, rows = 0;
+
+            // Edge indices touching each cell and each row, in compressed
+            // rows: those of cell c are cell_edges[cell_first[c]..cell_first[c + 1])
+            std::vector<uint32_t> cell_first, cell_edges;
+            std::vector<uint32_t> row_first, row_edges;
+            std::vector<uint8_t> center_inside;
+    };
+
+    // Crossing-number test of every point against the ring polygon[0..n),
+    // 1 inside and 0 outside, with no preprocessing. Points are tested
+    // simd::width at a time against one edge after another, which beats a
+    // PolygonLocator for polygons of a few dozen edges. Crossings are found
+    // in floating point, so points within rounding of the boundary may go
+    // either way.
+    void points_in_polygon(const PointR2* polygon, size_t n, const PointCloud2& points,
+                           std::vector<uint8_t>& inside, unsigned threads = 0);
+}
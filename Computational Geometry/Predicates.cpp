@@ -0,0 +1,286 @@
+#include "Predicates.hpp"
+#include "Expansion.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace GeomCore;
+using namespace GeomCore::exact_arithmetic;
+
+namespace {
+
+    constexpr double eps = predicate_epsilon;
+
+    // Error bounds from Shewchuk's predicates.c. "A" bounds certify the plain
+    // floating-point determinant; "B" bounds certify the determinant of the
+    // rounded coordinate differences, evaluated exactly.
+    constexpr double result_error_bound = (3.0 + 8.0 * eps) * eps;
+    constexpr double ccw_error_bound_b = (2.0 + 12.0 * eps) * eps;
+    constexpr double ccw_error_bound_c = (9.0 + 64.0 * eps) * eps * eps;
+    constexpr double o3d_error_bound_a = (7.0 + 56.0 * eps) * eps;
+    constexpr double o3d_error_bound_b = (3.0 + 28.0 * eps) * eps;
+    constexpr double icc_error_bound_a = (10.0 + 96.0 * eps) * eps;
+    constexpr double icc_error_bound_b = (4.0 + 48.0 * eps) * eps;
+    constexpr double isp_error_bound_a = (16.0 + 224.0 * eps) * eps;
+    constexpr double isp_error_bound_b = (5.0 + 72.0 * eps) * eps;
+
+    // Determinants written once over any expansion type, in terms of the
+    // coordinate differences to the last point
+
+    template<class E>
+    auto orient3d_det(const E& adx, const E& ady, const E& adz,
+                      const E& bdx, const E& bdy, const E& bdz,
+                      const E& cdx, const E& cdy, const E& cdz) {
+        return adz * (bdx * cdy - cdx * bdy) + bdz * (cdx * ady - adx * cdy) + cdz * (adx * bdy - bdx * ady);
+    }
+
+    template<class E>
+    auto incircle_det(const E& adx, const E& ady, const E& bdx, const E& bdy, const E& cdx, const E& cdy) {
+        auto alift = adx * adx + ady * ady;
+        auto blift = bdx * bdx + bdy * bdy;
+        auto clift = cdx * cdx + cdy * cdy;
+        return alift * (bdx * cdy - cdx * bdy) + blift * (cdx * ady - adx * cdy) + clift * (adx * bdy - bdx * ady);
+    }
+
+    template<class E>
+    auto insphere_det(const E& aex, const E& aey, const E& aez,
+                      const E& bex, const E& bey, const E& bez,
+                      const E& cex, const E& cey, const E& cez,
+                      const E& dex, const E& dey, const E& dez) {
+        auto ab = aex * bey - bex * aey;
+        auto bc = bex * cey - cex * bey;
+        auto cd = cex * dey - dex * cey;
+        auto da = dex * aey - aex * dey;
+        auto ac = aex * cey - cex * aey;
+        auto bd = bex * dey - dex * bey;
+
+        auto abc = aez * bc - bez * ac + cez * ab;
+        auto bcd = bez * cd - cez * bd + dez * bc;
+        auto cda = cez * da + dez * ac + aez * cd;
+        auto dab = dez * ab + aez * bd + bez * da;
+
+        auto alift = aex * aex + aey * aey + aez * aez;
+        auto blift = bex * bex + bey * bey + bez * bez;
+        auto clift = cex * cex + cey * cey + cez * cez;
+        auto dlift = dex * dex + dey * dey + dez * dez;
+
+        return (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+    }
+
+    double orient2d_adapt(double ax, double ay, double bx, double by, double cx, double cy, double detsum) {
+        double acx = ax - cx, bcx = bx - cx;
+        double acy = ay - cy, bcy = by - cy;
+
+        auto B = product(acx, bcy) - product(acy, bcx);
+        double det = B.estimate();
+        double errbound = ccw_error_bound_b * detsum;
+        if (det >= errbound || -det >= errbound) return det;
+
+        double acx_tail = two_diff_tail(ax, cx, acx);
+        double bcx_tail = two_diff_tail(bx, cx, bcx);
+        double acy_tail = two_diff_tail(ay, cy, acy);
+        double bcy_tail = two_diff_tail(by, cy, bcy);
+        if (acx_tail == 0.0 && acy_tail == 0.0 && bcx_tail == 0.0 && bcy_tail == 0.0) {
+            return B.value();
+        }
+
+        errbound = ccw_error_bound_c * detsum + result_error_bound * std::abs(det);
+        det += (acx * bcy_tail + bcy * acx_tail) - (acy * bcx_tail + bcx * acy_tail);
+        if (det >= errbound || -det >= errbound) return det;
+
+        auto C1 = B + (product(acx_tail, bcy) - product(acy_tail, bcx));
+        auto C2 = C1 + (product(acx, bcy_tail) - product(acy, bcx_tail));
+        auto D = C2 + (product(acx_tail, bcy_tail) - product(acy_tail, bcx_tail));
+        return D.value();
+    }
+
+    bool all_zero(std::initializer_list<double> tails) {
+        return std::all_of(tails.begin(), tails.end(), [](double t) { return t == 0.0; });
+    }
+}
+
+/**
+ * @brief Orientation of c relative to the directed line ab.
+ *
+ * det = (a − c) × (b − c). The plain product is returned when
+ * |det| > ccwerrboundA · (|l| + |r|); otherwise the adaptive stages of
+ * Shewchuk's orient2dadapt refine it until the sign is certain.
+ */
+double GeomCore::orient2d(const PointR2& a, const PointR2& b, const PointR2& c) {
+    return orient2d(a[X], a[Y], b[X], b[Y], c[X], c[Y]);
+}
+
+double GeomCore::orient2d(double ax, double ay, double bx, double by, double cx, double cy) {
+    double detleft = (ax - cx) * (by - cy);
+    double detright = (ay - cy) * (bx - cx);
+    double det = detleft - detright;
+    double detsum;
+
+    // Terms of opposite sign cannot cancel, so the sign is already right
+    if (detleft > 0.0) {
+        if (detright <= 0.0) return det;
+        detsum = detleft + detright;
+    } else if (detleft < 0.0) {
+        if (detright >= 0.0) return det;
+        detsum = -detleft - detright;
+    } else {
+        return det;
+    }
+
+    double errbound = orient2d_error_bound * detsum;
+    if (det >= errbound || -det >= errbound) return det;
+
+    return orient2d_adapt(ax, ay, bx, by, cx, cy, detsum);
+}
+
+/**
+ * @brief Orientation of d relative to the plane through a, b and c.
+ *
+ * Evaluates the 3x3 determinant of a − d, b − d, c − d. When the floating
+ * point filter fails, the determinant of the rounded differences is formed
+ * exactly; if the differences themselves were exact that is the answer,
+ * otherwise the exact differences are used.
+ */
+double GeomCore::orient3d(const PointR3& a, const PointR3& b, const PointR3& c, const PointR3& d) {
+    double adx = a[X] - d[X], bdx = b[X] - d[X], cdx = c[X] - d[X];
+    double ady = a[Y] - d[Y], bdy = b[Y] - d[Y], cdy = c[Y] - d[Y];
+    double adz = a[Z] - d[Z], bdz = b[Z] - d[Z], cdz = c[Z] - d[Z];
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+    double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz)
+                     + (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz)
+                     + (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+    double errbound = o3d_error_bound_a * permanent;
+    if (det > errbound || -det > errbound) return det;
+
+    auto B = orient3d_det(single(adx), single(ady), single(adz),
+                          single(bdx), single(bdy), single(bdz),
+                          single(cdx), single(cdy), single(cdz));
+    det = B.estimate();
+    errbound = o3d_error_bound_b * permanent;
+    if (det >= errbound || -det >= errbound) return det;
+
+    if (all_zero({two_diff_tail(a[X], d[X], adx), two_diff_tail(b[X], d[X], bdx), two_diff_tail(c[X], d[X], cdx),
+                  two_diff_tail(a[Y], d[Y], ady), two_diff_tail(b[Y], d[Y], bdy), two_diff_tail(c[Y], d[Y], cdy),
+                  two_diff_tail(a[Z], d[Z], adz), two_diff_tail(b[Z], d[Z], bdz), two_diff_tail(c[Z], d[Z], cdz)})) {
+        return B.value();
+    }
+
+    return orient3d_det(difference(a[X], d[X]), difference(a[Y], d[Y]), difference(a[Z], d[Z]),
+                        difference(b[X], d[X]), difference(b[Y], d[Y]), difference(b[Z], d[Z]),
+                        difference(c[X], d[X]), difference(c[Y], d[Y]), difference(c[Z], d[Z])).value();
+}
+
+/**
+ * @brief Position of d relative to the circle through a, b and c.
+ *
+ * Evaluates the lifted 3x3 determinant of a − d, b − d, c − d with the
+ * same filter, rounded-difference and exact stages as orient3d.
+ */
+double GeomCore::incircle(const PointR2& a, const PointR2& b, const PointR2& c, const PointR2& d) {
+    return incircle(a[X], a[Y], b[X], b[Y], c[X], c[Y], d[X], d[Y]);
+}
+
+double GeomCore::incircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy) {
+    double adx = ax - dx, bdx = bx - dx, cdx = cx - dx;
+    double ady = ay - dy, bdy = by - dy, cdy = cy - dy;
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+    double alift = adx * adx + ady * ady;
+    double blift = bdx * bdx + bdy * bdy;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift
+                     + (std::abs(cdxady) + std::abs(adxcdy)) * blift
+                     + (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+    double errbound = icc_error_bound_a * permanent;
+    if (det > errbound || -det > errbound) return det;
+
+    auto B = incircle_det(single(adx), single(ady), single(bdx), single(bdy), single(cdx), single(cdy));
+    det = B.estimate();
+    errbound = icc_error_bound_b * permanent;
+    if (det >= errbound || -det >= errbound) return det;
+
+    if (all_zero({two_diff_tail(ax, dx, adx), two_diff_tail(bx, dx, bdx), two_diff_tail(cx, dx, cdx),
+                  two_diff_tail(ay, dy, ady), two_diff_tail(by, dy, bdy), two_diff_tail(cy, dy, cdy)})) {
+        return B.value();
+    }
+
+    return incircle_det(difference(ax, dx), difference(ay, dy),
+                        difference(bx, dx), difference(by, dy),
+                        difference(cx, dx), difference(cy, dy)).value();
+}
+
+/**
+ * @brief Position of e relative to the sphere through a, b, c and d.
+ *
+ * Evaluates the lifted 4x4 determinant of a − e, …, d − e with the same
+ * filter, rounded-difference and exact stages as orient3d.
+ */
+double GeomCore::insphere(const PointR3& a, const PointR3& b, const PointR3& c, const PointR3& d, const PointR3& e) {
+    double aex = a[X] - e[X], bex = b[X] - e[X], cex = c[X] - e[X], dex = d[X] - e[X];
+    double aey = a[Y] - e[Y], bey = b[Y] - e[Y], cey = c[Y] - e[Y], dey = d[Y] - e[Y];
+    double aez = a[Z] - e[Z], bez = b[Z] - e[Z], cez = c[Z] - e[Z], dez = d[Z] - e[Z];
+
+    double aexbey = aex * bey, bexaey = bex * aey;
+    double bexcey = bex * cey, cexbey = cex * bey;
+    double cexdey = cex * dey, dexcey = dex * cey;
+    double dexaey = dex * aey, aexdey = aex * dey;
+    double aexcey = aex * cey, cexaey = cex * aey;
+    double bexdey = bex * dey, dexbey = dex * bey;
+
+    double ab = aexbey - bexaey, bc = bexcey - cexbey, cd = cexdey - dexcey;
+    double da = dexaey - aexdey, ac = aexcey - cexaey, bd = bexdey - dexbey;
+
+    double abc = aez * bc - bez * ac + cez * ab;
+    double bcd = bez * cd - cez * bd + dez * bc;
+    double cda = cez * da + dez * ac + aez * cd;
+    double dab = dez * ab + aez * bd + bez * da;
+
+    double alift = aex * aex + aey * aey + aez * aez;
+    double blift = bex * bex + bey * bey + bez * bez;
+    double clift = cex * cex + cey * cey + cez * cez;
+    double dlift = dex * dex + dey * dey + dez * dez;
+
+    double det = (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+
+    double aezp = std::abs(aez), bezp = std::abs(bez), cezp = std::abs(cez), dezp = std::abs(dez);
+    double abp = std::abs(aexbey) + std::abs(bexaey), bcp = std::abs(bexcey) + std::abs(cexbey);
+    double cdp = std::abs(cexdey) + std::abs(dexcey), dap = std::abs(dexaey) + std::abs(aexdey);
+    double acp = std::abs(aexcey) + std::abs(cexaey), bdp = std::abs(bexdey) + std::abs(dexbey);
+    double permanent = (cdp * bezp + bdp * cezp + bcp * dezp) * alift
+                     + (dap * cezp + acp * dezp + cdp * aezp) * blift
+                     + (abp * dezp + bdp * aezp + dap * bezp) * clift
+                     + (bcp * aezp + acp * bezp + abp * cezp) * dlift;
+    double errbound = isp_error_bound_a * permanent;
+    if (det > errbound || -det > errbound) return det;
+
+    auto B = insphere_det(single(aex), single(aey), single(aez), single(bex), single(bey), single(bez),
+                          single(cex), single(cey), single(cez), single(dex), single(dey), single(dez));
+    det = B.estimate();
+    errbound = isp_error_bound_b * permanent;
+    if (det >= errbound || -det >= errbound) return det;
+
+    if (all_zero({two_diff_tail(a[X], e[X], aex), two_diff_tail(b[X], e[X], bex),
+                  two_diff_tail(c[X], e[X], cex), two_diff_tail(d[X], e[X], dex),
+                  two_diff_tail(a[Y], e[Y], aey), two_diff_tail(b[Y], e[Y], bey),
+                  two_diff_tail(c[Y], e[Y], cey), two_diff_tail(d[Y], e[Y], dey),
+                  two_diff_tail(a[Z], e[Z], aez), two_diff_tail(b[Z], e[Z], bez),
+                  two_diff_tail(c[Z], e[Z], cez), two_diff_tail(d[Z], e[Z], dez)})) {
+        return B.value();
+    }
+
+    return insphere_det(difference(a[X], e[X]), difference(a[Y], e[Y]), difference(a[Z], e[Z]),
+                        difference(b[X], e[X]), difference(b[Y], e[Y]), difference(b[Z], e[Z]),
+                        difference(c[X], e[X]), difference(c[Y], e[Y]), difference(c[Z], e[Z]),
+                        difference(d[X], e[X]), difference(d[Y], e[Y]), difference(d[Z], e[Z])).value();
+}
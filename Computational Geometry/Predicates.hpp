@@ -0,0 +1,42 @@
+#pragma once
+
+#include <limits>
+
+#include "Point.hpp"
+
+// Robust geometric predicates after Shewchuk, "Adaptive Precision
+// Floating-Point Arithmetic and Fast Robust Geometric Predicates" (1997).
+//
+// Each predicate first evaluates its determinant in plain floating point and
+// returns at once if a static error bound proves the sign correct. Otherwise
+// it re-evaluates the determinant as an exact floating-point expansion, so the
+// returned sign is always exact; only its magnitude is approximate.
+
+namespace GeomCore {
+
+    // Half an ulp of 1.0: the relative rounding error of one operation
+    constexpr double predicate_epsilon = std::numeric_limits<double>::epsilon() / 2;
+
+    // Relative error bound of the plain floating-point orient2d determinant.
+    // If |det| exceeds this times (|l| + |r|), where det = l - r, its sign is right.
+    constexpr double orient2d_error_bound = (3.0 + 16.0 * predicate_epsilon) * predicate_epsilon;
+
+    // Positive if a, b, c are in counterclockwise order, negative if clockwise,
+    // zero if collinear. The magnitude approximates twice the triangle's area.
+    double orient2d(const PointR2& a, const PointR2& b, const PointR2& c);
+    double orient2d(double ax, double ay, double bx, double by, double cx, double cy);
+
+    // Positive if d lies below the plane through a, b, c, where "below" means
+    // a, b, c appear counterclockwise when seen from above; negative if above;
+    // zero if coplanar. The magnitude approximates six times the volume.
+    double orient3d(const PointR3& a, const PointR3& b, const PointR3& c, const PointR3& d);
+
+    // Positive if d lies inside the circle through a, b, c (counterclockwise),
+    // negative if outside, zero if cocircular. The sign flips for clockwise a, b, c.
+    double incircle(const PointR2& a, const PointR2& b, const PointR2& c, const PointR2& d);
+    double incircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy);
+
+    // Positive if e lies inside the sphere through a, b, c, d, where
+    // orient3d(a, b, c, d) is positive; negative if outside, zero if cospherical.
+    double insphere(const PointR3& a, const PointR3& b, const PointR3& c, const PointR3& d, const PointR3& e);
+}
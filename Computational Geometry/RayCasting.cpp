@@ -0,0 +1,184 @@
+#include "RayCasting.hpp"
+#include "Parallel.hpp"
+#include "Simd.hpp"
+
+#include <stdexcept>
+
+using namespace GeomCore;
+
+// Like the point cloud kernels, the batch kernels run simd::width rays at a
+// time and finish the remaining n % width rays with the same formula on
+// plain doubles.
+
+static void check_sizes(size_t a, size_t b) {
+    if (a != b) {
+        throw std::invalid_argument("Ray origins and directions must have the same size");
+    }
+}
+
+static size_t vector_end(size_t n) {
+    return n - n % simd::width;
+}
+
+/**
+ * @brief Moller-Trumbore ray-triangle test on plain doubles.
+ *
+ * With p = d x ac and det = ab . p, the hit is at barycentrics
+ * u = (o - a) . p / det and v = d . q / det, where q = (o - a) x ab, and at
+ * parameter t = ac . q / det. A ray in the triangle's plane has det = 0,
+ * which turns u into an infinity or NaN and fails the range tests.
+ *
+ * @return true if 0 <= u, 0 <= v, u + v <= 1 and 0 <= t <= t_max
+ */
+static bool moller_trumbore(const double o[3], const double d[3], const double a[3], const double ab[3],
+                            const double ac[3], double t_max, double& t, double& u, double& v) {
+    double px = d[1] * ac[2] - d[2] * ac[1];
+    double py = d[2] * ac[0] - d[0] * ac[2];
+    double pz = d[0] * ac[1] - d[1] * ac[0];
+    double inverse = 1.0 / (ab[0] * px + ab[1] * py + ab[2] * pz);
+
+    double sx = o[0] - a[0], sy = o[1] - a[1], sz = o[2] - a[2];
+    u = (sx * px + sy * py + sz * pz) * inverse;
+
+    double qx = sy * ab[2] - sz * ab[1];
+    double qy = sz * ab[0] - sx * ab[2];
+    double qz = sx * ab[1] - sy * ab[0];
+    v = (d[0] * qx + d[1] * qy + d[2] * qz) * inverse;
+    t = (ac[0] * qx + ac[1] * qy + ac[2] * qz) * inverse;
+
+    return 0.0 <= u && 0.0 <= v && u + v <= 1.0 && 0.0 <= t && t <= t_max;
+}
+
+void GeomCore::ray_plane_intersection(const PointCloud3& origins, const PointCloud3& directions, const Plane_d& plane,
+                                      std::vector<double>& t) {
+    check_sizes(origins.size(), directions.size());
+    size_t n = origins.size(), end = vector_end(n);
+    t.resize(n);
+    const double *ox = origins.x(), *oy = origins.y(), *oz = origins.z();
+    const double *dx = directions.x(), *dy = directions.y(), *dz = directions.z();
+    const Vector3d& normal = plane.get_normal();
+    double nx = normal[X], ny = normal[Y], nz = normal[Z], offset = plane.get_d();
+
+    auto vnx = simd::broadcast(nx), vny = simd::broadcast(ny), vnz = simd::broadcast(nz);
+    auto voffset = simd::broadcast(offset);
+    for (size_t i = 0; i < end; i += simd::width) {
+        auto along = simd::mul(simd::load(dx + i), vnx);
+        along = simd::fmadd(simd::load(dy + i), vny, along);
+        along = simd::fmadd(simd::load(dz + i), vnz, along);
+        auto height = simd::mul(simd::load(ox + i), vnx);
+        height = simd::fmadd(simd::load(oy + i), vny, height);
+        height = simd::fmadd(simd::load(oz + i), vnz, height);
+        simd::store(t.data() + i, simd::div(simd::sub(voffset, height), along));
+    }
+    for (size_t i = end; i < n; ++i) {
+        double along = dx[i] * nx + dy[i] * ny + dz[i] * nz;
+        double height = ox[i] * nx + oy[i] * ny + oz[i] * nz;
+        t[i] = (offset - height) / along;
+    }
+}
+
+void GeomCore::ray_triangle_intersection(const PointCloud3& origins, const PointCloud3& directions,
+                                         const PointR3& a, const PointR3& b, const PointR3& c,
+                                         std::vector<double>& t, std::vector<double>& u, std::vector<double>& v,
+                                         double t_max) {
+    check_sizes(origins.size(), directions.size());
+    size_t n = origins.size(), end = vector_end(n);
+    t.resize(n);
+    u.resize(n);
+    v.resize(n);
+    const double *ox = origins.x(), *oy = origins.y(), *oz = origins.z();
+    const double *dx = directions.x(), *dy = directions.y(), *dz = directions.z();
+
+    const double corner[3] = {a[X], a[Y], a[Z]};
+    const double ab[3] = {b[X] - a[X], b[Y] - a[Y], b[Z] - a[Z]};
+    const double ac[3] = {c[X] - a[X], c[Y] - a[Y], c[Z] - a[Z]};
+    constexpr double miss = std::numeric_limits<double>::infinity();
+
+    simd::vdouble va[3], vab[3], vac[3];
+    for (size_t k = 0; k < 3; ++k) {
+        va[k] = simd::broadcast(corner[k]);
+        vab[k] = simd::broadcast(ab[k]);
+        vac[k] = simd::broadcast(ac[k]);
+    }
+    auto zero = simd::broadcast(0.0), one = simd::broadcast(1.0);
+    auto limit = simd::broadcast(t_max), none = simd::broadcast(miss);
+
+    for (size_t i = 0; i < end; i += simd::width) {
+        auto rx = simd::load(dx + i), ry = simd::load(dy + i), rz = simd::load(dz + i);
+        auto px = simd::fmsub(ry, vac[2], simd::mul(rz, vac[1]));
+        auto py = simd::fmsub(rz, vac[0], simd::mul(rx, vac[2]));
+        auto pz = simd::fmsub(rx, vac[1], simd::mul(ry, vac[0]));
+        auto det = simd::fmadd(vab[2], pz, simd::fmadd(vab[1], py, simd::mul(vab[0], px)));
+        auto inverse = simd::div(one, det);
+
+        auto sx = simd::sub(simd::load(ox + i), va[0]);
+        auto sy = simd::sub(simd::load(oy + i), va[1]);
+        auto sz = simd::sub(simd::load(oz + i), va[2]);
+        auto vu = simd::mul(simd::fmadd(sz, pz, simd::fmadd(sy, py, simd::mul(sx, px))), inverse);
+
+        auto qx = simd::fmsub(sy, vab[2], simd::mul(sz, vab[1]));
+        auto qy = simd::fmsub(sz, vab[0], simd::mul(sx, vab[2]));
+        auto qz = simd::fmsub(sx, vab[1], simd::mul(sy, vab[0]));
+        auto vv = simd::mul(simd::fmadd(rz, qz, simd::fmadd(ry, qy, simd::mul(rx, qx))), inverse);
+        auto vt = simd::mul(simd::fmadd(vac[2], qz, simd::fmadd(vac[1], qy, simd::mul(vac[0], qx))), inverse);
+
+        auto hit = simd::both(simd::both(simd::less_equal(zero, vu), simd::less_equal(zero, vv)),
+                              simd::both(simd::less_equal(simd::add(vu, vv), one),
+                                         simd::both(simd::less_equal(zero, vt), simd::less_equal(vt, limit))));
+        simd::store(t.data() + i, simd::select(hit, vt, none));
+        simd::store(u.data() + i, vu);
+        simd::store(v.data() + i, vv);
+    }
+    for (size_t i = end; i < n; ++i) {
+        const double o[3] = {ox[i], oy[i], oz[i]}, d[3] = {dx[i], dy[i], dz[i]};
+        double ti;
+        if (!moller_trumbore(o, d, corner, ab, ac, t_max, ti, u[i], v[i])) ti = miss;
+        t[i] = ti;
+    }
+}
+
+void GeomCore::TriangleRaycaster::build(const PointR3* vertices, size_t n, const IndexTriangle* input, size_t m,
+                                        unsigned threads) {
+    if (m >= RayHit::NONE) {
+        throw std::length_error("TriangleRaycaster: too many triangles");
+    }
+    triangles.resize(m);
+    std::vector<BoxR3> boxes(m);
+    parallel_for(m, [&](size_t i) {
+        for (uint32_t corner : input[i]) {
+            if (corner >= n) throw std::out_of_range("TriangleRaycaster: triangle corner out of range");
+            boxes[i].expand(vertices[corner]);
+        }
+        const PointR3& a = vertices[input[i][0]];
+        triangles[i] = {a, vertices[input[i][1]] - a, vertices[input[i][2]] - a};
+    }, threads, 4096);
+    bvh.build(boxes, threads);
+}
+
+GeomCore::RayHit GeomCore::TriangleRaycaster::closest_hit(const PointR3& origin, const PointR3& direction,
+                                                          double t_max) const {
+    RayHit hit;
+    const double o[3] = {origin[X], origin[Y], origin[Z]}, d[3] = {direction[X], direction[Y], direction[Z]};
+    hit.primitive = bvh.closest_hit(origin, direction, t_max, [&](uint32_t i, double& limit) {
+        const triangle& f = triangles[i];
+        double t, u, v;
+        if (!moller_trumbore(o, d, f.a.data(), f.ab.data(), f.ac.data(), limit, t, u, v)) return false;
+        limit = t;
+        hit.u = u;
+        hit.v = v;
+        return true;
+    });
+    if (hit.primitive != RayHit::NONE) hit.t = t_max;
+    return hit;
+}
+
+void GeomCore::TriangleRaycaster::closest_hit(const PointCloud3& origins, const PointCloud3& directions,
+                                              std::vector<RayHit>& hits, double t_max, unsigned threads) const {
+    check_sizes(origins.size(), directions.size());
+    hits.resize(origins.size());
+    parallel_blocks(origins.size(), 1024, threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            hits[i] = closest_hit(origins[i], directions[i], t_max);
+        }
+    });
+}
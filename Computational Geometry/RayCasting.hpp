@@ -0,0 +1,83 @@
+#pragma once
+
+#include "BVH.hpp"
+#include "Plane.hpp"
+#include "Point.hpp"
+#include "PointCloud.hpp"
+#include "Triangulation.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace GeomCore {
+
+    // Where a ray origin + t * direction meets a triangle (a, b, c): the
+    // parameter t and the barycentric coordinates of the hit point
+    // a + u (b - a) + v (c - a). A miss has t = infinity and primitive NONE.
+    struct RayHit {
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        double t = std::numeric_limits<double>::infinity();
+        double u = 0.0, v = 0.0;
+        uint32_t primitive = NONE;
+    };
+
+    // Batch kernels over the rays origins[i] + t * directions[i]. Each
+    // processes simd::width rays per instruction and writes one result per
+    // ray; output vectors are resized to fit and inputs must have equal size.
+
+    // Parameter t where each ray's line meets the plane. Lines parallel to
+    // the plane give an infinity or NaN; rays keep only t >= 0.
+    void ray_plane_intersection(const PointCloud3& origins, const PointCloud3& directions, const Plane_d& plane,
+                                std::vector<double>& t);
+
+    // Moller-Trumbore test of every ray against the triangle (a, b, c) from
+    // either side: t is the hit parameter in [0, t_max], or infinity on a
+    // miss; u and v are the barycentric coordinates, meaningful on hits only.
+    void ray_triangle_intersection(const PointCloud3& origins, const PointCloud3& directions,
+                                   const PointR3& a, const PointR3& b, const PointR3& c,
+                                   std::vector<double>& t, std::vector<double>& u, std::vector<double>& v,
+                                   double t_max = std::numeric_limits<double>::infinity());
+
+    // Closest-hit ray casting against a triangle mesh. The triangles are
+    // indexed by a BVH; each ray walks it near to far, testing the
+    // triangles of the leaves it reaches and cutting off everything beyond
+    // the closest hit so far.
+    class TriangleRaycaster {
+        public:
+            TriangleRaycaster() = default;
+            TriangleRaycaster(const std::vector<PointR3>& vertices, const std::vector<IndexTriangle>& triangles,
+                              unsigned threads = 0) {
+                build(vertices, triangles, threads);
+            }
+
+            // Index triangles[0..m) over vertices. Throws std::out_of_range
+            // for triangles with corners outside vertices[0..n).
+            void build(const PointR3* vertices, size_t n, const IndexTriangle* triangles, size_t m, unsigned threads = 0);
+            void build(const std::vector<PointR3>& vertices, const std::vector<IndexTriangle>& triangles, unsigned threads = 0) {
+                build(vertices.data(), vertices.size(), triangles.data(), triangles.size(), threads);
+            }
+
+            // Closest triangle hit by origin + t * direction, 0 <= t <= t_max;
+            // primitive is the index of the triangle
+            RayHit closest_hit(const PointR3& origin, const PointR3& direction,
+                               double t_max = std::numeric_limits<double>::infinity()) const;
+
+            // Same for a batch of rays, blocks of them on separate threads
+            void closest_hit(const PointCloud3& origins, const PointCloud3& directions, std::vector<RayHit>& hits,
+                             double t_max = std::numeric_limits<double>::infinity(), unsigned threads = 0) const;
+
+            size_t size() const { return triangles.size(); }
+            const BVH3& hierarchy() const { return bvh; }
+
+        private:
+            // Corner a and edges b - a and c - a, as Moller-Trumbore uses them
+            struct triangle {
+                PointR3 a, ab, ac;
+            };
+
+            BVH3 bvh;
+            std::vector<triangle> triangles;
+    };
+}
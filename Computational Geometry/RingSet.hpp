@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Point.hpp"
+#include "Polygon.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace GeomCore {
+
+    // Closed rings stored back to back: ring k is
+    // points[offsets[k]..offsets[k + 1]), its last point joined to its
+    // first. One RingSet holds a polygon with holes, or several polygons,
+    // in two allocations however many vertices it has.
+    struct RingSet {
+        std::vector<PointR2> points;
+        std::vector<uint32_t> offsets{0};
+
+        size_t ring_count() const { return offsets.size() - 1; }
+        bool empty() const { return offsets.size() == 1; }
+
+        const PointR2* ring(size_t k) const { return points.data() + offsets[k]; }
+        size_t ring_size(size_t k) const { return offsets[k + 1] - offsets[k]; }
+
+        void add_ring(const PointR2* ring, size_t n) {
+            points.insert(points.end(), ring, ring + n);
+            offsets.push_back(static_cast<uint32_t>(points.size()));
+        }
+        void add_ring(const std::vector<PointR2>& ring) { add_ring(ring.data(), ring.size()); }
+        void add_ring(const PolygonR2& polygon) {
+            for (const auto& v : polygon.get_vertices()) points.push_back(v->point);
+            offsets.push_back(static_cast<uint32_t>(points.size()));
+        }
+
+        void clear() {
+            points.clear();
+            offsets.assign(1, 0);
+        }
+    };
+}
@@ -0,0 +1,457 @@
+#include "SegmentIntersection.hpp"
+#include "Expansion.hpp"
+#include "Predicates.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <stdexcept>
+
+using namespace GeomCore;
+using namespace GeomCore::exact_arithmetic;
+
+namespace {
+
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+
+    // Closed interval with outward rounding: every operation moves its
+    // rounded bounds out by one ulp, so the exact result stays enclosed
+    struct interval {
+        double lo, hi;
+    };
+
+    inline interval point(double a) { return {a, a}; }
+
+    inline interval widen(double lo, double hi) {
+        return {std::nextafter(lo, -infinity), std::nextafter(hi, infinity)};
+    }
+
+    inline interval operator+(interval a, interval b) { return widen(a.lo + b.lo, a.hi + b.hi); }
+    inline interval operator-(interval a, interval b) { return widen(a.lo - b.hi, a.hi - b.lo); }
+
+    inline interval operator*(interval a, interval b) {
+        auto [lo, hi] = std::minmax({a.lo * b.lo, a.lo * b.hi, a.hi * b.lo, a.hi * b.hi});
+        return widen(lo, hi);
+    }
+
+    // Unbounded when the divisor may be zero
+    inline interval operator/(interval a, interval b) {
+        if (b.lo <= 0.0 && b.hi >= 0.0) return {-infinity, infinity};
+        auto [lo, hi] = std::minmax({a.lo / b.lo, a.lo / b.hi, a.hi / b.lo, a.hi / b.hi});
+        return widen(lo, hi);
+    }
+
+    inline bool bounded(double lo, double hi) { return std::isfinite(lo) && std::isfinite(hi); }
+
+    // Order of two intervals: -1 or 1 if they are disjoint, 0 if both are
+    // the same single value, 2 if undecided
+    inline int order(double a_lo, double a_hi, double b_lo, double b_hi) {
+        if (a_hi < b_lo) return -1;
+        if (a_lo > b_hi) return 1;
+        if (a_lo == a_hi && b_lo == b_hi) return 0;
+        return 2;
+    }
+
+    inline exact constant(double a) {
+        exact e;
+        if (a != 0.0) e.c.push_back(a);
+        return e;
+    }
+
+    inline int sign(double a) { return (a > 0.0) - (a < 0.0); }
+    inline int sign(const exact& e) { return sign(e.value()); }
+
+    // Homogeneous point (x / w, y / w) with w > 0, held exactly
+    struct homogeneous {
+        exact x, y, w;
+    };
+
+    homogeneous exact_point(double x, double y) {
+        return {constant(x), constant(y), constant(1.0)};
+    }
+
+    // Crossing of the lines through segments g and h, each given as x0, y0,
+    // x1, y1. With a = orient(h, g0) and b = orient(h, g1), it is
+    // (a g1 - b g0) / (a - b).
+    homogeneous exact_crossing(const std::array<double, 4>& g, const std::array<double, 4>& h) {
+        auto orient = [&](double x, double y) {
+            return difference(h[0], x) * difference(h[3], y) - difference(h[1], y) * difference(h[2], x);
+        };
+        exact a = orient(g[0], g[1]), b = orient(g[2], g[3]);
+        homogeneous p{a * constant(g[2]) - b * constant(g[0]), a * constant(g[3]) - b * constant(g[1]), a - b};
+        if (sign(p.w) < 0) {
+            for (exact* e : {&p.x, &p.y, &p.w}) {
+                for (double& c : e->c) c = -c;
+            }
+        }
+        return p;
+    }
+}
+
+/**
+ * @brief Strict order of two segments in the status, valid for the pairs the
+ *        tree compares while the current event is processed.
+ *
+ * Segments inserted at this event all pass through the event point and are
+ * ordered by where they go next: b lies above a if its right endpoint is left
+ * of a's direction. A vertical segment ends up on top, and collinear ones
+ * are ordered by index. A segment from an earlier event does not pass through
+ * the event point, so its side of the point places it against a new one.
+ */
+bool SegmentSweep::status_order::operator()(uint32_t a, uint32_t b) const {
+    bool a_new = sweep->inserted_at[a] == sweep->stamp;
+    bool b_new = sweep->inserted_at[b] == sweep->stamp;
+
+    if (a_new && b_new) {
+        const auto& g = sweep->segments[a];
+        const auto& h = sweep->segments[b];
+        double o = orient2d(g[0], g[1], g[2], g[3], h[2], h[3]);
+        return o > 0.0 || (o == 0.0 && a < b);
+    }
+    if (a_new) return sweep->side(b) < 0;
+    if (b_new) return sweep->side(a) > 0;
+    return false;
+}
+
+// Segments below the event point come before it, segments through it are equivalent
+bool SegmentSweep::status_order::operator()(uint32_t a, current_event) const {
+    return sweep->side(a) > 0;
+}
+
+bool SegmentSweep::status_order::operator()(current_event, uint32_t a) const {
+    return sweep->side(a) < 0;
+}
+
+/**
+ * @brief Side of segment s on which the current event point lies: 1 above
+ *        (left of its direction), -1 below, 0 on its line.
+ *
+ * Endpoint events use orient2d. A crossing point is first bracketed with its
+ * intervals and only evaluated exactly when they straddle the line.
+ */
+int SegmentSweep::side(uint32_t s) const {
+    if (s == current.s || s == current.t) return 0;
+
+    const auto& g = segments[s];
+    if (current.s == NONE) {
+        return sign(orient2d(g[0], g[1], g[2], g[3], current.x, current.y));
+    }
+
+    if (bounded(current.x_lo, current.x_hi) && bounded(current.y_lo, current.y_hi)) {
+        interval d = (point(g[2]) - point(g[0])) * (interval{current.y_lo, current.y_hi} - point(g[1]))
+                   - (point(g[3]) - point(g[1])) * (interval{current.x_lo, current.x_hi} - point(g[0]));
+        if (d.lo > 0.0) return 1;
+        if (d.hi < 0.0) return -1;
+    }
+
+    homogeneous p = exact_crossing(segments[current.s], segments[current.t]);
+    return sign(difference(g[2], g[0]) * (p.y - constant(g[1]) * p.w)
+              - difference(g[3], g[1]) * (p.x - constant(g[0]) * p.w));
+}
+
+/**
+ * @brief Lexicographic order of two event points, x first: -1, 0 or 1.
+ */
+int SegmentSweep::compare(const event& p, const event& q) const {
+    if (p.s == NONE && q.s == NONE) {
+        if (p.x != q.x) return p.x < q.x ? -1 : 1;
+        if (p.y != q.y) return p.y < q.y ? -1 : 1;
+        return 0;
+    }
+
+    int by_x = order(p.x_lo, p.x_hi, q.x_lo, q.x_hi);
+    if (by_x == -1 || by_x == 1) return by_x;
+    int by_y = order(p.y_lo, p.y_hi, q.y_lo, q.y_hi);
+    if (by_x == 0 && by_y != 2) return by_y;
+
+    auto exact_of = [this](const event& e) {
+        return e.s == NONE ? exact_point(e.x, e.y) : exact_crossing(segments[e.s], segments[e.t]);
+    };
+    homogeneous a = exact_of(p), b = exact_of(q);
+
+    if (by_x == 2) {
+        by_x = sign(a.x * b.w - b.x * a.w);
+        if (by_x != 0) return by_x;
+    }
+    if (by_y == 2) by_y = sign(a.y * b.w - b.y * a.w);
+    return by_y;
+}
+
+/**
+ * @brief Crossing event of segments a and b, whose interiors are known to cross.
+ */
+SegmentSweep::event SegmentSweep::crossing(uint32_t a, uint32_t b) const {
+    const auto& g = segments[a];
+    const auto& h = segments[b];
+
+    interval px = point(g[0]), py = point(g[1]), qx = point(g[2]), qy = point(g[3]);
+    interval cx = point(h[0]), cy = point(h[1]), dx = point(h[2]), dy = point(h[3]);
+    interval op = (cx - px) * (dy - py) - (cy - py) * (dx - px);
+    interval oq = (cx - qx) * (dy - qy) - (cy - qy) * (dx - qx);
+    interval w = op - oq;
+    interval x = (op * qx - oq * px) / w;
+    interval y = (op * qy - oq * py) / w;
+
+    event e;
+    e.s = a;
+    e.t = b;
+    e.x_lo = x.lo;
+    e.x_hi = x.hi;
+    e.y_lo = y.lo;
+    e.y_hi = y.hi;
+
+    if (bounded(x.lo, x.hi) && bounded(y.lo, y.hi)) {
+        e.x = x.lo + (x.hi - x.lo) / 2;
+        e.y = y.lo + (y.hi - y.lo) / 2;
+    } else {
+        homogeneous p = exact_crossing(g, h);
+        e.x = p.x.value() / p.w.value();
+        e.y = p.y.value() / p.w.value();
+    }
+    return e;
+}
+
+void SegmentSweep::push(const event& e) {
+    queue.push_back(e);
+    std::push_heap(queue.begin(), queue.end(), [this](const event& p, const event& q) { return compare(p, q) > 0; });
+}
+
+void SegmentSweep::pop() {
+    std::pop_heap(queue.begin(), queue.end(), [this](const event& p, const event& q) { return compare(p, q) > 0; });
+    queue.pop_back();
+}
+
+void SegmentSweep::load(const SegmentR2* input, size_t n) {
+    if (n >= NONE) {
+        throw std::length_error("SegmentSweep: too many segments");
+    }
+
+    segments.resize(n);
+    endpoints.clear();
+    endpoints.reserve(2 * n);
+    for (uint32_t i = 0; i < n; ++i) {
+        const PointR2* a = &input[i][0];
+        const PointR2* b = &input[i][1];
+        if ((*b)[X] < (*a)[X] || ((*b)[X] == (*a)[X] && (*b)[Y] < (*a)[Y])) std::swap(a, b);
+
+        segments[i] = {(*a)[X], (*a)[Y], (*b)[X], (*b)[Y]};
+        endpoints.push_back({(*a)[X], (*a)[Y], i, true});
+        if ((*a)[X] != (*b)[X] || (*a)[Y] != (*b)[Y]) endpoints.push_back({(*b)[X], (*b)[Y], i, false});
+    }
+    std::sort(endpoints.begin(), endpoints.end(), [](const endpoint& p, const endpoint& q) {
+        return p.x < q.x || (p.x == q.x && p.y < q.y);
+    });
+
+    queue.clear();
+    inserted_at.assign(n, 0);
+    stamp = 0;
+    found = {NONE, NONE};
+}
+
+/**
+ * @brief Runs the sweep; returns true if it stopped early at an intersection.
+ *
+ * At each event point p the segments through p are one contiguous run of the
+ * status. The run is removed, the segments starting at p and the ones that
+ * continue past it are inserted again in their order after p, and the two
+ * new neighbour pairs at the ends of the run are tested for crossings.
+ */
+bool SegmentSweep::run() {
+    using current_event = status_order::current_event;
+    std::set<uint32_t, status_order> status(status_order{this});
+
+    size_t next = 0;
+    while (next < endpoints.size() || !queue.empty()) {
+        if (next < endpoints.size()) {
+            const endpoint& e = endpoints[next];
+            event p;
+            p.x = p.x_lo = p.x_hi = e.x;
+            p.y = p.y_lo = p.y_hi = e.y;
+            current = queue.empty() || compare(p, queue.front()) <= 0 ? p : queue.front();
+        } else {
+            current = queue.front();
+        }
+
+        starting.clear();
+        while (current.s == NONE && next < endpoints.size() &&
+               endpoints[next].x == current.x && endpoints[next].y == current.y) {
+            if (endpoints[next].left) starting.push_back(endpoints[next].segment);
+            ++next;
+        }
+        while (!queue.empty() && compare(queue.front(), current) == 0) pop();
+
+        // Segments through p, less those ending there
+        auto [first, last] = status.equal_range(current_event{});
+        involved.clear();
+        passing.clear();
+        for (auto it = first; it != last; ++it) {
+            const auto& g = segments[*it];
+            involved.push_back(*it);
+            if (current.s != NONE || g[2] != current.x || g[3] != current.y) passing.push_back(*it);
+        }
+        status.erase(first, last);
+
+        ++stamp;
+        for (uint32_t s : starting) {
+            const auto& g = segments[s];
+            involved.push_back(s);
+            if (g[0] != g[2] || g[1] != g[3]) passing.push_back(s);
+        }
+        if (involved.size() >= 2 && report(involved)) return true;
+
+        auto above = status.lower_bound(current_event{});
+        if (passing.empty()) {
+            if (above != status.begin() && above != status.end() && check(*std::prev(above), *above)) return true;
+            continue;
+        }
+
+        for (uint32_t s : passing) inserted_at[s] = stamp;
+        std::sort(passing.begin(), passing.end(), status.key_comp());
+
+        auto lowest = status.emplace_hint(above, passing.front());
+        auto highest = lowest;
+        for (size_t i = 1; i < passing.size(); ++i) highest = status.emplace_hint(above, passing[i]);
+
+        if (lowest != status.begin() && check(*std::prev(lowest), *lowest)) return true;
+        if (above != status.end() && check(*highest, *above)) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Handles the segments meeting at the current event; returns true to stop.
+ */
+bool SegmentSweep::report(std::vector<uint32_t>& meeting) {
+    std::sort(meeting.begin(), meeting.end());
+
+    if (task == mode::all) {
+        if (out) {
+            out->push_back({PointR2(current.x, current.y), meeting});
+        } else {
+            flat_points->push_back(PointR2(current.x, current.y));
+            flat_meeting->insert(flat_meeting->end(), meeting.begin(), meeting.end());
+            flat_offsets->push_back(static_cast<uint32_t>(flat_meeting->size()));
+        }
+        return false;
+    }
+
+    if (task == mode::simple_polygon && meeting.size() == 2 && current.s == NONE) {
+        // Consecutive edges may share their common vertex
+        uint32_t a = meeting[0], b = meeting[1];
+        uint32_t n = static_cast<uint32_t>(segments.size());
+        uint32_t shared = b == a + 1 ? b : (a == 0 && b == n - 1 ? 0 : NONE);
+        if (shared != NONE && ring[shared][X] == current.x && ring[shared][Y] == current.y) return false;
+    }
+
+    found = {meeting[0], meeting[1]};
+    return true;
+}
+
+/**
+ * @brief Tests neighbours a (below) and b (above) for a crossing of their
+ *        interiors; returns true to stop.
+ *
+ * Touching at an endpoint needs no event of its own, since every endpoint is
+ * already one. A crossing behind the sweep line has been reported before.
+ */
+bool SegmentSweep::check(uint32_t a, uint32_t b) {
+    const auto& g = segments[a];
+    const auto& h = segments[b];
+
+    auto opposite = [](double u, double v) { return (u > 0.0 && v < 0.0) || (u < 0.0 && v > 0.0); };
+    if (!opposite(orient2d(g[0], g[1], g[2], g[3], h[0], h[1]), orient2d(g[0], g[1], g[2], g[3], h[2], h[3]))) return false;
+    if (!opposite(orient2d(h[0], h[1], h[2], h[3], g[0], g[1]), orient2d(h[0], h[1], h[2], h[3], g[2], g[3]))) return false;
+
+    if (task != mode::all) {
+        found = {std::min(a, b), std::max(a, b)};
+        return true;
+    }
+
+    event e = crossing(a, b);
+    if (compare(e, current) > 0) push(e);
+    return false;
+}
+
+void SegmentSweep::intersections(const SegmentR2* input, size_t n, std::vector<SegmentIntersection>& result) {
+    load(input, n);
+    task = mode::all;
+    out = &result;
+    run();
+    out = nullptr;
+}
+
+void SegmentSweep::intersections(const SegmentR2* input, size_t n, std::vector<PointR2>& points,
+                                 std::vector<uint32_t>& offsets, std::vector<uint32_t>& meeting) {
+    if (offsets.empty()) offsets.push_back(static_cast<uint32_t>(meeting.size()));
+    load(input, n);
+    task = mode::all;
+    flat_points = &points;
+    flat_offsets = &offsets;
+    flat_meeting = &meeting;
+    run();
+    flat_points = nullptr;
+    flat_offsets = nullptr;
+    flat_meeting = nullptr;
+}
+
+std::vector<SegmentIntersection> SegmentSweep::intersections(const std::vector<SegmentR2>& input) {
+    std::vector<SegmentIntersection> result;
+    intersections(input.data(), input.size(), result);
+    return result;
+}
+
+bool SegmentSweep::any_intersection(const SegmentR2* input, size_t n, std::array<uint32_t, 2>* witness) {
+    load(input, n);
+    task = mode::any;
+    bool hit = run();
+    if (witness) *witness = found;
+    return hit;
+}
+
+bool SegmentSweep::is_simple_polygon(const PointR2* points, size_t n) {
+    if (n < 3) return false;
+
+    std::vector<SegmentR2> edges(n);
+    for (size_t i = 0; i < n; ++i) {
+        edges[i] = {points[i], points[(i + 1) % n]};
+    }
+
+    load(edges.data(), n);
+    task = mode::simple_polygon;
+    ring = points;
+    bool hit = run();
+    ring = nullptr;
+    return !hit;
+}
+
+/**
+ * @brief All intersection points of a batch of segments, in sweep order.
+ */
+std::vector<SegmentIntersection> GeomCore::segment_intersections(const std::vector<SegmentR2>& segments) {
+    SegmentSweep sweep;
+    return sweep.intersections(segments);
+}
+
+/**
+ * @brief Early-exit test for any shared point among the segments.
+ */
+bool GeomCore::any_segment_intersection(const std::vector<SegmentR2>& segments, std::array<uint32_t, 2>* witness) {
+    SegmentSweep sweep;
+    return sweep.any_intersection(segments.data(), segments.size(), witness);
+}
+
+bool GeomCore::is_simple_polygon(const std::vector<PointR2>& points) {
+    SegmentSweep sweep;
+    return sweep.is_simple_polygon(points.data(), points.size());
+}
+
+bool GeomCore::is_simple_polygon(const PolygonR2& polygon) {
+    std::vector<PointR2> points;
+    points.reserve(polygon.size());
+    for (const auto& v : polygon.get_vertices()) {
+        points.push_back(v->point);
+    }
+    return is_simple_polygon(points);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Point.hpp"
+#include "Polygon.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace GeomCore {
+    // Closed segment between two points
+    using SegmentR2 = std::array<PointR2, 2>;
+
+    // A point shared by two or more segments, with their indices ascending
+    struct SegmentIntersection {
+        PointR2 point;
+        std::vector<uint32_t> segments;
+    };
+
+    // Bentley-Ottmann sweep over a batch of segments.
+    //
+    // A line sweeps from left to right (ties broken bottom to top) over an
+    // event queue of segment endpoints and crossings found so far; the
+    // segments cut by the line are kept in order in a balanced tree, and only
+    // segments that become neighbours there are tested against each other.
+    // All k intersection points are found in O((n + k) log n).
+    //
+    // Crossing points are not representable in doubles, so events carry the
+    // two segments that define them: their coordinates are bracketed by
+    // intervals, and comparisons the intervals cannot decide are evaluated
+    // exactly. Orientation tests use the exact predicates, so touching,
+    // collinear and concurrent segments are all handled. Scratch memory is
+    // kept between calls.
+    class SegmentSweep {
+        public:
+            static constexpr uint32_t NONE = UINT32_MAX;
+
+            // All points where two or more of segments[0..n) meet. Collinear
+            // overlapping segments are reported at the overlap's endpoints.
+            // Crossing points are rounded; endpoints are exact.
+            void intersections(const SegmentR2* segments, size_t n, std::vector<SegmentIntersection>& out);
+            std::vector<SegmentIntersection> intersections(const std::vector<SegmentR2>& segments);
+
+            // Same, flattened so that no point needs a vector of its own:
+            // appends each point to points and its segments to meeting,
+            // where point k has meeting[offsets[k]..offsets[k + 1]); an
+            // empty offsets is started at meeting.size()
+            void intersections(const SegmentR2* segments, size_t n, std::vector<PointR2>& points,
+                               std::vector<uint32_t>& offsets, std::vector<uint32_t>& meeting);
+
+            // True if any two of segments[0..n) share a point. Stops at the
+            // first intersection found and stores its segments in witness.
+            bool any_intersection(const SegmentR2* segments, size_t n, std::array<uint32_t, 2>* witness = nullptr);
+
+            // True if the closed polygon points[0..n) has at least three
+            // vertices and no edges meeting other than consecutive edges at
+            // their shared vertex. Stops at the first violation.
+            bool is_simple_polygon(const PointR2* points, size_t n);
+
+        private:
+            enum class mode : uint8_t { all, any, simple_polygon };
+
+            // Event point: an endpoint, exact in x and y, or the crossing of
+            // segments s and t, rounded in x and y and enclosed by the
+            // intervals [x_lo, x_hi] and [y_lo, y_hi]
+            struct event {
+                double x, y;
+                double x_lo, x_hi, y_lo, y_hi;
+                uint32_t s = NONE, t = NONE;
+            };
+
+            struct endpoint {
+                double x, y;
+                uint32_t segment;
+                bool left;
+            };
+
+            // Status order of the segments cut by the sweep line, bottom to
+            // top, just after the current event; also compares segments with
+            // the current event point
+            struct status_order {
+                using is_transparent = void;
+                struct current_event {};
+
+                const SegmentSweep* sweep;
+                bool operator()(uint32_t a, uint32_t b) const;
+                bool operator()(uint32_t a, current_event) const;
+                bool operator()(current_event, uint32_t a) const;
+            };
+
+            void load(const SegmentR2* segments, size_t n);
+            bool run();
+            bool report(std::vector<uint32_t>& segments);
+            bool check(uint32_t a, uint32_t b);
+
+            event crossing(uint32_t a, uint32_t b) const;
+            int compare(const event& p, const event& q) const;
+            int side(uint32_t s) const;
+            void push(const event& e);
+            void pop();
+
+            // Segments with the lexicographically smaller endpoint first
+            std::vector<std::array<double, 4>> segments;
+            // Endpoints sorted along the sweep, and crossing events as a heap
+            std::vector<endpoint> endpoints;
+            std::vector<event> queue;
+
+            // Segments inserted into the status at the current event carry
+            // its stamp; they all pass through the event point
+            std::vector<uint32_t> inserted_at;
+            uint32_t stamp = 0;
+            event current;
+
+            std::vector<uint32_t> starting, passing, involved;
+
+            mode task = mode::all;
+            const PointR2* ring = nullptr;
+            std::vector<SegmentIntersection>* out = nullptr;
+            std::vector<PointR2>* flat_points = nullptr;
+            std::vector<uint32_t>* flat_offsets = nullptr;
+            std::vector<uint32_t>* flat_meeting = nullptr;
+            std::array<uint32_t, 2> found{NONE, NONE};
+    };
+
+    // All intersection points of a batch of segments
+    std::vector<SegmentIntersection> segment_intersections(const std::vector<SegmentR2>& segments);
+
+    // True if any two segments share a point
+    bool any_segment_intersection(const std::vector<SegmentR2>& segments, std::array<uint32_t, 2>* witness = nullptr);
+
+    // True if the polygon does not touch or cross itself
+    bool is_simple_polygon(const std::vector<PointR2>& points);
+    bool is_simple_polygon(const PolygonR2& polygon);
+}
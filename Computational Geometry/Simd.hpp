@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+// Instruction set used by the batch kernels. The widest set the compiler
+// targets wins. SSE2, part of every x86-64 target, is the baseline, so the
+// default build runs two lanes; GEOMCORE_ENABLE_NATIVE_ARCH picks up AVX2 or
+// AVX-512 on the build machine. Elsewhere the kernels run the same code on
+// plain doubles and leave vectorization to the compiler.
+//
+// Measured against a loop over std::vector<PointR2> at -O2 (GCC 12), the
+// point cloud kernels gain far less than the lane count suggests. A 2D
+// dot_product over 4096 points runs 1.3x faster with SSE2 and 1.2x with
+// AVX-512: it is bound by loads and stores, and GCC already vectorizes the
+// AoS loop. The batch orientation_R2 runs 5.9x (SSE2) and 7.2x (AVX-512)
+// faster, mostly because its filter spares the per-point predicate call;
+// at 65536 points, out of cache, that falls to 2.4x and 3.0x.
+#if defined(__AVX512F__)
+    #define GEOMCORE_AVX512 1
+#elif defined(__AVX2__) && defined(__FMA__)
+    #define GEOMCORE_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+    #define GEOMCORE_SSE2 1
+#endif
+
+#if defined(GEOMCORE_AVX512) || defined(GEOMCORE_AVX2)
+    #include <immintrin.h>
+#elif defined(GEOMCORE_SSE2)
+    #include <emmintrin.h>
+#endif
+
+namespace GeomCore::simd {
+
+#if defined(GEOMCORE_AVX512)
+
+    using vdouble = __m512d;
+    constexpr size_t width = 8;
+
+    inline vdouble load(const double* p) { return _mm512_loadu_pd(p); }
+    inline void store(double* p, vdouble v) { _mm512_storeu_pd(p, v); }
+    inline vdouble broadcast(double x) { return _mm512_set1_pd(x); }
+
+    inline vdouble add(vdouble a, vdouble b) { return _mm512_add_pd(a, b); }
+    inline vdouble sub(vdouble a, vdouble b) { return _mm512_sub_pd(a, b); }
+    inline vdouble mul(vdouble a, vdouble b) { return _mm512_mul_pd(a, b); }
+    inline vdouble div(vdouble a, vdouble b) { return _mm512_div_pd(a, b); }
+    // The unmasked forms of several AVX-512 intrinsics pass an undefined
+    // register as the merge source, which GCC 12 reports as maybe
+    // uninitialized wherever they are inlined; the zero-masking forms with
+    // every lane selected compute the same and start from zero.
+    constexpr __mmask8 all_lanes = 0xFF;
+
+    inline vdouble sqrt(vdouble a) { return _mm512_maskz_sqrt_pd(all_lanes, a); }
+    inline vdouble min(vdouble a, vdouble b) { return _mm512_maskz_min_pd(all_lanes, a, b); }
+    inline vdouble max(vdouble a, vdouble b) { return _mm512_maskz_max_pd(all_lanes, a, b); }
+    inline vdouble abs(vdouble a) { return _mm512_abs_pd(a); }
+
+    // a * b + c and a * b - c
+    inline vdouble fmadd(vdouble a, vdouble b, vdouble c) { return _mm512_fmadd_pd(a, b, c); }
+    inline vdouble fmsub(vdouble a, vdouble b, vdouble c) { return _mm512_fmsub_pd(a, b, c); }
+
+    // x > threshold ? if_true : if_false, per lane
+    inline vdouble select_greater(vdouble x, vdouble threshold, vdouble if_true, vdouble if_false) {
+        __mmask8 m = _mm512_cmp_pd_mask(x, threshold, _CMP_GT_OQ);
+        return _mm512_mask_blend_pd(m, if_false, if_true);
+    }
+
+    // Per-lane conditions; comparisons with NaN are false
+    using vmask = __mmask8;
+
+    inline vmask less(vdouble a, vdouble b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    inline vmask less_equal(vdouble a, vdouble b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    inline vmask both(vmask a, vmask b) { return static_cast<vmask>(a & b); }
+    inline vdouble select(vmask m, vdouble if_true, vdouble if_false) { return _mm512_mask_blend_pd(m, if_false, if_true); }
+
+    // Rounding and exponent access for FastMath.hpp. For positive normal x,
+    // x = mantissa(x) * 2^exponent(x) with the mantissa in [1, 2);
+    // ldexp(x, n) = x * 2^n for integral n with |n| <= 2044.
+    inline vdouble round(vdouble a) {
+        return _mm512_maskz_roundscale_pd(all_lanes, a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+    inline vdouble exponent(vdouble a) { return _mm512_maskz_getexp_pd(all_lanes, a); }
+    inline vdouble mantissa(vdouble a) {
+        return _mm512_maskz_getmant_pd(all_lanes, a, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero);
+    }
+    inline vdouble ldexp(vdouble a, vdouble n) { return _mm512_maskz_scalef_pd(all_lanes, a, n); }
+
+#elif defined(GEOMCORE_AVX2)
+
+    using vdouble = __m256d;
+    constexpr size_t width = 4;
+
+    inline vdouble load(const double* p) { return _mm256_loadu_pd(p); }
+    inline void store(double* p, vdouble v) { _mm256_storeu_pd(p, v); }
+    inline vdouble broadcast(double x) { return _mm256_set1_pd(x); }
+
+    inline vdouble add(vdouble a, vdouble b) { return _mm256_add_pd(a, b); }
+    inline vdouble sub(vdouble a, vdouble b) { return _mm256_sub_pd(a, b); }
+    inline vdouble mul(vdouble a, vdouble b) { return _mm256_mul_pd(a, b); }
+    inline vdouble div(vdouble a, vdouble b) { return _mm256_div_pd(a, b); }
+    inline vdouble sqrt(vdouble a) { return _mm256_sqrt_pd(a); }
+    inline vdouble min(vdouble a, vdouble b) { return _mm256_min_pd(a, b); }
+    inline vdouble max(vdouble a, vdouble b) { return _mm256_max_pd(a, b); }
+    inline vdouble abs(vdouble a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+
+    inline vdouble fmadd(vdouble a, vdouble b, vdouble c) { return _mm256_fmadd_pd(a, b, c); }
+    inline vdouble fmsub(vdouble a, vdouble b, vdouble c) { return _mm256_fmsub_pd(a, b, c); }
+
+    inline vdouble select_greater(vdouble x, vdouble threshold, vdouble if_true, vdouble if_false) {
+        return _mm256_blendv_pd(if_false, if_true, _mm256_cmp_pd(x, threshold, _CMP_GT_OQ));
+    }
+
+    using vmask = __m256d;
+
+    inline vmask less(vdouble a, vdouble b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    inline vmask less_equal(vdouble a, vdouble b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    inline vmask both(vmask a, vmask b) { return _mm256_and_pd(a, b); }
+    inline vdouble select(vmask m, vdouble if_true, vdouble if_false) { return _mm256_blendv_pd(if_false, if_true, m); }
+
+    inline vdouble round(vdouble a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    // The biased exponent field, read as an integer by adding it to the
+    // mantissa bits of 2^52
+    inline vdouble exponent(vdouble a) {
+        __m256i field = _mm256_srli_epi64(_mm256_castpd_si256(a), 52);
+        __m256d shifted = _mm256_castsi256_pd(_mm256_or_si256(field, _mm256_castpd_si256(_mm256_set1_pd(0x1p52))));
+        return _mm256_sub_pd(shifted, _mm256_set1_pd(0x1p52 + 1023));
+    }
+    inline vdouble mantissa(vdouble a) {
+        __m256d bits = _mm256_castsi256_pd(_mm256_set1_epi64x(0x000fffffffffffffLL));
+        return _mm256_or_pd(_mm256_and_pd(a, bits), _mm256_set1_pd(1.0));
+    }
+
+    // 2^n built in the exponent field, in two halves so that each stays a
+    // normal number
+    inline vdouble ldexp(vdouble a, vdouble n) {
+        auto power = [](__m256d k) {
+            __m256i biased = _mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(0x1p52 + 1023)));
+            return _mm256_castsi256_pd(_mm256_slli_epi64(biased, 52));
+        };
+        __m256d half = round(_mm256_mul_pd(n, _mm256_set1_pd(0.5)));
+        return _mm256_mul_pd(_mm256_mul_pd(a, power(half)), power(_mm256_sub_pd(n, half)));
+    }
+
+#elif defined(GEOMCORE_SSE2)
+
+    using vdouble = __m128d;
+    constexpr size_t width = 2;
+
+    inline vdouble load(const double* p) { return _mm_loadu_pd(p); }
+    inline void store(double* p, vdouble v) { _mm_storeu_pd(p, v); }
+    inline vdouble broadcast(double x) { return _mm_set1_pd(x); }
+
+    inline vdouble add(vdouble a, vdouble b) { return _mm_add_pd(a, b); }
+    inline vdouble sub(vdouble a, vdouble b) { return _mm_sub_pd(a, b); }
+    inline vdouble mul(vdouble a, vdouble b) { return _mm_mul_pd(a, b); }
+    inline vdouble div(vdouble a, vdouble b) { return _mm_div_pd(a, b); }
+    inline vdouble sqrt(vdouble a) { return _mm_sqrt_pd(a); }
+    inline vdouble min(vdouble a, vdouble b) { return _mm_min_pd(a, b); }
+    inline vdouble max(vdouble a, vdouble b) { return _mm_max_pd(a, b); }
+    inline vdouble abs(vdouble a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+
+    // No FMA before AVX2: two roundings, as on the scalar path
+    inline vdouble fmadd(vdouble a, vdouble b, vdouble c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    inline vdouble fmsub(vdouble a, vdouble b, vdouble c) { return _mm_sub_pd(_mm_mul_pd(a, b), c); }
+
+    using vmask = __m128d;
+
+    // Blends by bitwise masks; blendv needs SSE4.1
+    inline vdouble select(vmask m, vdouble if_true, vdouble if_false) {
+        return _mm_or_pd(_mm_and_pd(m, if_true), _mm_andnot_pd(m, if_false));
+    }
+
+    inline vdouble select_greater(vdouble x, vdouble threshold, vdouble if_true, vdouble if_false) {
+        return select(_mm_cmpgt_pd(x, threshold), if_true, if_false);
+    }
+
+    inline vmask less(vdouble a, vdouble b) { return _mm_cmplt_pd(a, b); }
+    inline vmask less_equal(vdouble a, vdouble b) { return _mm_cmple_pd(a, b); }
+    inline vmask both(vmask a, vmask b) { return _mm_and_pd(a, b); }
+
+    // Adding and subtracting 2^52 with a's sign rounds to nearest even;
+    // from 2^52 up every double is already an integer
+    inline vdouble round(vdouble a) {
+        __m128d big = _mm_set1_pd(0x1p52);
+        __m128d sign = _mm_and_pd(a, _mm_set1_pd(-0.0));
+        __m128d shift = _mm_or_pd(big, sign);
+        __m128d rounded = _mm_sub_pd(_mm_add_pd(a, shift), shift);
+        return select(_mm_cmplt_pd(abs(a), big), _mm_or_pd(rounded, sign), a);
+    }
+
+    // As in the AVX2 path
+    inline vdouble exponent(vdouble a) {
+        __m128i field = _mm_srli_epi64(_mm_castpd_si128(a), 52);
+        __m128d shifted = _mm_castsi128_pd(_mm_or_si128(field, _mm_castpd_si128(_mm_set1_pd(0x1p52))));
+        return _mm_sub_pd(shifted, _mm_set1_pd(0x1p52 + 1023));
+    }
+    inline vdouble mantissa(vdouble a) {
+        __m128d bits = _mm_castsi128_pd(_mm_set1_epi64x(0x000fffffffffffffLL));
+        return _mm_or_pd(_mm_and_pd(a, bits), _mm_set1_pd(1.0));
+    }
+    inline vdouble ldexp(vdouble a, vdouble n) {
+        auto power = [](__m128d k) {
+            __m128i biased = _mm_castpd_si128(_mm_add_pd(k, _mm_set1_pd(0x1p52 + 1023)));
+            return _mm_castsi128_pd(_mm_slli_epi64(biased, 52));
+        };
+        __m128d half = round(_mm_mul_pd(n, _mm_set1_pd(0.5)));
+        return _mm_mul_pd(_mm_mul_pd(a, power(half)), power(_mm_sub_pd(n, half)));
+    }
+
+#else
+
+    using vdouble = double;
+    constexpr size_t width = 1;
+
+    inline vdouble load(const double* p) { return *p; }
+    inline void store(double* p, vdouble v) { *p = v; }
+    inline vdouble broadcast(double x) { return x; }
+
+    inline vdouble add(vdouble a, vdouble b) { return a + b; }
+    inline vdouble sub(vdouble a, vdouble b) { return a - b; }
+    inline vdouble mul(vdouble a, vdouble b) { return a * b; }
+    inline vdouble div(vdouble a, vdouble b) { return a / b; }
+    inline vdouble sqrt(vdouble a) { return std::sqrt(a); }
+    inline vdouble min(vdouble a, vdouble b) { return b < a ? b : a; }
+    inline vdouble max(vdouble a, vdouble b) { return a < b ? b : a; }
+    inline vdouble abs(vdouble a) { return a < 0.0 ? -a : a; }
+
+    inline vdouble fmadd(vdouble a, vdouble b, vdouble c) { return a * b + c; }
+    inline vdouble fmsub(vdouble a, vdouble b, vdouble c) { return a * b - c; }
+
+    inline vdouble select_greater(vdouble x, vdouble threshold, vdouble if_true, vdouble if_false) {
+        return x > threshold ? if_true : if_false;
+    }
+
+    using vmask = bool;
+
+    inline vmask less(vdouble a, vdouble b) { return a < b; }
+    inline vmask less_equal(vdouble a, vdouble b) { return a <= b; }
+    inline vmask both(vmask a, vmask b) { return a && b; }
+    inline vdouble select(vmask m, vdouble if_true, vdouble if_false) { return m ? if_true : if_false; }
+
+    inline vdouble round(vdouble a) { return std::nearbyint(a); }
+    inline vdouble exponent(vdouble a) { return std::ilogb(a); }
+    inline vdouble mantissa(vdouble a) { return std::scalbn(a, -std::ilogb(a)); }
+    inline vdouble ldexp(vdouble a, vdouble n) { return std::ldexp(a, static_cast<int>(n)); }
+
+#endif
+
+}
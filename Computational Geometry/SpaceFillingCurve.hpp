@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace GeomCore {
+
+    // Spread the low bits of v so that dim - 1 zero bits follow each one:
+    // 32 bits for dim = 2, 21 bits for dim = 3
+    template<size_t dim>
+    constexpr uint64_t spread_bits(uint64_t v) {
+        static_assert(dim == 2 || dim == 3, "Morton codes are defined for 2 and 3 dimensions");
+        if constexpr (dim == 2) {
+            v &= 0xffffffffULL;
+            v = (v | (v << 16)) & 0x0000ffff0000ffffULL;
+            v = (v | (v << 8)) & 0x00ff00ff00ff00ffULL;
+            v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+            v = (v | (v << 2)) & 0x3333333333333333ULL;
+            v = (v | (v << 1)) & 0x5555555555555555ULL;
+        } else {
+            v &= 0x1fffffULL;
+            v = (v | (v << 32)) & 0x001f00000000ffffULL;
+            v = (v | (v << 16)) & 0x001f0000ff0000ffULL;
+            v = (v | (v << 8)) & 0x100f00f00f00f00fULL;
+            v = (v | (v << 4)) & 0x10c30c30c30c30c3ULL;
+            v = (v | (v << 2)) & 0x1249249249249249ULL;
+        }
+        return v;
+    }
+
+    // Position of p on a Morton (Z-order) curve over the box [lo, hi].
+    // Sorting by it puts points that are close in space mostly close in
+    // order, which batched queries use to keep the nodes they walk in cache.
+    template<size_t dim>
+    uint64_t morton_code(const std::array<double, dim>& p, const std::array<double, dim>& lo,
+                         const std::array<double, dim>& hi) {
+        constexpr unsigned bits = dim == 2 ? 32 : 21;
+        constexpr double cells = static_cast<double>(1ULL << bits);
+        uint64_t code = 0;
+        for (size_t k = 0; k < dim; ++k) {
+            double extent = hi[k] - lo[k];
+            double t = extent > 0.0 ? (p[k] - lo[k]) / extent : 0.0;
+            double cell = std::clamp(t * cells, 0.0, cells - 1.0);
+            code |= spread_bits<dim>(static_cast<uint64_t>(cell)) << k;
+        }
+        return code;
+    }
+
+    // Position of cell (x, y) of a 2^order by 2^order grid along the Hilbert
+    // curve, order <= 32. Consecutive positions are always adjacent cells,
+    // and the top 2k bits of a position are the position of the cell's
+    // ancestor (x >> (order - k), y >> (order - k)) on the order k curve.
+    constexpr uint64_t hilbert_code(uint32_t x, uint32_t y, unsigned order) {
+        uint64_t d = 0;
+        for (unsigned level = order; level-- > 0;) {
+            uint32_t s = uint32_t{1} << level;
+            uint32_t rx = (x & s) ? 1 : 0, ry = (y & s) ? 1 : 0;
+            d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+            x &= s - 1;
+            y &= s - 1;
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = s - 1 - x;
+                    y = s - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+
+    // Inverse of hilbert_code: the cell at position d of the order curve
+    constexpr std::array<uint32_t, 2> hilbert_cell(uint64_t d, unsigned order) {
+        uint32_t x = 0, y = 0;
+        for (unsigned level = 0; level < order; ++level, d >>= 2) {
+            uint32_t s = uint32_t{1} << level;
+            uint32_t rx = 1 & static_cast<uint32_t>(d >> 1), ry = 1 & static_cast<uint32_t>(d ^ rx);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = s - 1 - x;
+                    y = s - 1 - y;
+                }
+                std::swap(x, y);
+            }
+            x += s * rx;
+            y += s * ry;
+        }
+        return {x, y};
+    }
+}
@@ -0,0 +1,389 @@
+#include "SphericalCell.hpp"
+#include "Parallel.hpp"
+#include "SpaceFillingCurve.hpp"
+#include "SphericalGeometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <queue>
+#include <stdexcept>
+
+using namespace GeomCore;
+
+namespace {
+
+    constexpr uint32_t leaf_cells = uint32_t{1} << SphericalCell::max_level;
+
+    // Added to every cell bound, in radians: far above the rounding error
+    // of the face projection, far below the size of a leaf cell
+    constexpr double bound_slack = 1e-12;
+
+    // Leaves hold at most this many points before a search scans them
+    // instead of descending further
+    constexpr size_t scan_size = 16;
+
+    enum class overlap { disjoint, partial, inside };
+
+    // Cube face coordinates (u, v) in [-1, 1] of face f to a direction, and
+    // back. Each face's (u, v) axes are right-handed about its outward normal.
+    PointR3 face_uv_to_xyz(int face, double u, double v) {
+        switch (face) {
+            case 0: return PointR3(1.0, u, v);
+            case 1: return PointR3(-u, 1.0, v);
+            case 2: return PointR3(-u, -v, 1.0);
+            case 3: return PointR3(-1.0, -v, -u);
+            case 4: return PointR3(v, -1.0, -u);
+            default: return PointR3(v, u, -1.0);
+        }
+    }
+
+    int xyz_to_face_uv(const PointR3& p, double& u, double& v) {
+        double ax = std::abs(p[X]), ay = std::abs(p[Y]), az = std::abs(p[Z]);
+        int axis = ax >= ay && ax >= az ? 0 : (ay >= az ? 1 : 2);
+        int face = axis + (p[axis] < 0.0 ? 3 : 0);
+        switch (face) {
+            case 0: u = p[Y] / p[X]; v = p[Z] / p[X]; break;
+            case 1: u = -p[X] / p[Y]; v = p[Z] / p[Y]; break;
+            case 2: u = -p[X] / p[Z]; v = -p[Y] / p[Z]; break;
+            case 3: u = p[Z] / p[X]; v = p[Y] / p[X]; break;
+            case 4: u = p[Z] / p[Y]; v = -p[X] / p[Y]; break;
+            default: u = -p[Y] / p[Z]; v = -p[X] / p[Z]; break;
+        }
+        return face;
+    }
+
+    // Tangent projection between grid coordinates s in [0, 1] and u in [-1, 1]
+    double st_to_uv(double s) {
+        return std::tan(std::numbers::pi / 2 * (s - 0.5));
+    }
+
+    double uv_to_st(double u) {
+        return std::atan(u) * (2 / std::numbers::pi) + 0.5;
+    }
+
+    PointR3 unit(const PointR3& p) {
+        double m = p.magnitude();
+        return PointR3(p[X] / m, p[Y] / m, p[Z] / m);
+    }
+
+    double angle(const PointR3& a, const PointR3& b) {
+        return std::atan2(cross_product_R3(a, b).magnitude(), dot_product(a, b));
+    }
+
+    // Grid square [i, i + size) x [j, j + size) of leaf cells that a cell spans
+    void cell_square(SphericalCell cell, uint32_t& i, uint32_t& j, uint32_t& size) {
+        int level = cell.level();
+        int shift = 2 * (SphericalCell::max_level - level) + 1;
+        uint64_t position = (cell.id() & ((uint64_t{1} << 61) - 1)) >> shift;
+        auto [x, y] = hilbert_cell(position, static_cast<unsigned>(level));
+        size = uint32_t{1} << (SphericalCell::max_level - level);
+        i = x * size;
+        j = y * size;
+    }
+
+    PointR3 grid_point(int face, double i, double j) {
+        return unit(face_uv_to_xyz(face, st_to_uv(i / leaf_cells), st_to_uv(j / leaf_cells)));
+    }
+
+    void check_level(int level) {
+        if (level < 0 || level > SphericalCell::max_level) {
+            throw std::invalid_argument("Cell level must be between 0 and 30");
+        }
+    }
+
+    double radius_of(const Manifold<double>& manifold) {
+        if (manifold.kind() != GeometryKind::Spherical) {
+            throw std::invalid_argument("Manifold is not spherical");
+        }
+        return 1.0 / std::sqrt(manifold.curvature.value);
+    }
+
+    /**
+     * @brief Covering of the region that classify(cell) describes.
+     *
+     * Partial cells wait in a queue that stays sorted by level, since
+     * children are appended behind their parents. A cell is replaced by its
+     * children that meet the region if the total stays within max_cells;
+     * otherwise it is kept whole.
+     */
+    template<class Classify>
+    void cover(Classify&& classify, std::vector<SphericalCell>& out, size_t max_cells, int max_level) {
+        check_level(max_level);
+        out.clear();
+        std::vector<SphericalCell> queue;
+        for (int f = 0; f < SphericalCell::face_count; ++f) {
+            SphericalCell face = SphericalCell::from_face(f);
+            overlap o = classify(face);
+            if (o == overlap::inside) out.push_back(face);
+            if (o == overlap::partial) queue.push_back(face);
+        }
+
+        std::vector<SphericalCell> inside, partial;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            SphericalCell cell = queue[head];
+            if (cell.level() < max_level) {
+                inside.clear();
+                partial.clear();
+                for (int k = 0; k < 4; ++k) {
+                    SphericalCell child = cell.child(k);
+                    overlap o = classify(child);
+                    if (o == overlap::inside) inside.push_back(child);
+                    if (o == overlap::partial) partial.push_back(child);
+                }
+                size_t pending = out.size() + queue.size() - head - 1;
+                if (pending + inside.size() + partial.size() <= max_cells) {
+                    out.insert(out.end(), inside.begin(), inside.end());
+                    queue.insert(queue.end(), partial.begin(), partial.end());
+                    continue;
+                }
+            }
+            out.push_back(cell);
+        }
+        std::sort(out.begin(), out.end());
+    }
+
+    // Spherical polygon in an open hemisphere. Containment is decided in
+    // the gnomonic projection onto the plane tangent at the hemisphere's
+    // pole, which maps great-circle arcs to segments.
+    class spherical_polygon {
+        public:
+            explicit spherical_polygon(const std::vector<PointR3>& polygon) {
+                if (polygon.size() < 3) {
+                    throw std::invalid_argument("A spherical polygon needs at least three vertices");
+                }
+                PointR3 sum(0.0, 0.0, 0.0);
+                for (const PointR3& p : polygon) {
+                    vertices.push_back(unit(p));
+                    sum += vertices.back();
+                }
+                double m = sum.magnitude();
+                for (const PointR3& p : vertices) {
+                    if (!(m > 0.0) || !(dot_product(p, sum) > 0.0)) {
+                        throw std::invalid_argument("Spherical polygon must lie within an open hemisphere");
+                    }
+                }
+                pole = unit(sum);
+                PointR3 helper = std::abs(pole[X]) < 0.5 ? PointR3(1.0, 0.0, 0.0) : PointR3(0.0, 1.0, 0.0);
+                e1 = unit(cross_product_R3(pole, helper));
+                e2 = cross_product_R3(pole, e1);
+                for (const PointR3& p : vertices) plane.push_back(project(p));
+            }
+
+            bool contains(const PointR3& p) const {
+                if (!(dot_product(p, pole) > 0.0)) return false;
+                PointR2 q = project(p);
+                bool in = false;
+                for (size_t i = 0, j = plane.size() - 1; i < plane.size(); j = i++) {
+                    const PointR2 &a = plane[i], &b = plane[j];
+                    if ((a[Y] > q[Y]) != (b[Y] > q[Y]) &&
+                        q[X] < (b[X] - a[X]) * (q[Y] - a[Y]) / (b[Y] - a[Y]) + a[X]) {
+                        in = !in;
+                    }
+                }
+                return in;
+            }
+
+            // Angle from the unit vector p to the nearest point of the boundary
+            double boundary_angle(const PointR3& p) const {
+                double best = std::numbers::pi;
+                for (size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
+                    const PointR3 &a = vertices[j], &b = vertices[i];
+                    PointR3 n = cross_product_R3(a, b);
+                    double d;
+                    if (dot_product(cross_product_R3(a, p), n) >= 0.0 && dot_product(cross_product_R3(p, b), n) >= 0.0) {
+                        d = std::asin(std::min(1.0, std::abs(dot_product(p, n)) / n.magnitude()));
+                    } else {
+                        d = std::min(angle(p, a), angle(p, b));
+                    }
+                    best = std::min(best, d);
+                }
+                return best;
+            }
+
+        private:
+            PointR2 project(const PointR3& p) const {
+                double w = dot_product(p, pole);
+                return PointR2(dot_product(p, e1) / w, dot_product(p, e2) / w);
+            }
+
+            std::vector<PointR3> vertices;
+            std::vector<PointR2> plane;
+            PointR3 pole, e1, e2;
+    };
+}
+
+SphericalCell GeomCore::SphericalCell::from_point(const PointR3& p, int level) {
+    check_level(level);
+    if (p[X] == 0.0 && p[Y] == 0.0 && p[Z] == 0.0) {
+        throw std::invalid_argument("The zero vector has no cell");
+    }
+    double u, v;
+    int face = xyz_to_face_uv(p, u, v);
+    auto grid = [](double u) {
+        double s = std::floor(uv_to_st(u) * leaf_cells);
+        return static_cast<uint32_t>(std::clamp(s, 0.0, static_cast<double>(leaf_cells - 1)));
+    };
+    uint64_t position = hilbert_code(grid(u), grid(v), max_level);
+    SphericalCell leaf((static_cast<uint64_t>(face) << 61) | (position << 1) | 1);
+    return leaf.parent(level);
+}
+
+SphericalCell GeomCore::SphericalCell::from_face(int face) {
+    if (face < 0 || face >= face_count) {
+        throw std::invalid_argument("Cube face must be between 0 and 5");
+    }
+    return SphericalCell((static_cast<uint64_t>(face) << 61) | (uint64_t{1} << 60));
+}
+
+PointR3 GeomCore::SphericalCell::center() const {
+    uint32_t i, j, size;
+    cell_square(*this, i, j, size);
+    return grid_point(face(), i + 0.5 * size, j + 0.5 * size);
+}
+
+std::array<PointR3, 4> GeomCore::SphericalCell::vertices() const {
+    uint32_t i, j, size;
+    cell_square(*this, i, j, size);
+    double i1 = static_cast<double>(i) + size, j1 = static_cast<double>(j) + size;
+    return {grid_point(face(), i, j), grid_point(face(), i1, j),
+            grid_point(face(), i1, j1), grid_point(face(), i, j1)};
+}
+
+double GeomCore::SphericalCell::bound_angle() const {
+    // The cell is convex and smaller than a hemisphere, so its farthest
+    // point from the centre is a corner
+    PointR3 c = center();
+    double bound = 0.0;
+    for (const PointR3& v : vertices()) bound = std::max(bound, angle(c, v));
+    return bound + bound_slack;
+}
+
+void GeomCore::cap_covering(const Manifold<double>& manifold, const PointR3& center, double r,
+                            std::vector<SphericalCell>& out, size_t max_cells, int max_level) {
+    double cap = r * (1.0 / radius_of(manifold));
+    cover([&](SphericalCell cell) {
+        double d = angle(center, cell.center()), bound = cell.bound_angle();
+        if (d - bound > cap) return overlap::disjoint;
+        return d + bound <= cap ? overlap::inside : overlap::partial;
+    }, out, max_cells, max_level);
+}
+
+void GeomCore::polygon_covering(const std::vector<PointR3>& polygon, std::vector<SphericalCell>& out,
+                                size_t max_cells, int max_level) {
+    spherical_polygon region(polygon);
+    cover([&](SphericalCell cell) {
+        PointR3 c = cell.center();
+        if (region.boundary_angle(c) <= cell.bound_angle()) return overlap::partial;
+        return region.contains(c) ? overlap::inside : overlap::disjoint;
+    }, out, max_cells, max_level);
+}
+
+GeomCore::SphericalCellIndex::SphericalCellIndex(const Manifold<double>& manifold)
+    : manifold(manifold), sphere_radius(radius_of(manifold)) {}
+
+void GeomCore::SphericalCellIndex::build(const PointR3* input, size_t n, unsigned threads) {
+    if (n >= NONE) {
+        throw std::length_error("SphericalCellIndex: too many points");
+    }
+    std::vector<std::pair<uint64_t, uint32_t>> records(n);
+    parallel_for(n, [&](size_t i) {
+        records[i] = {SphericalCell::from_point(input[i]).id(), static_cast<uint32_t>(i)};
+    }, threads, 4096);
+    std::sort(records.begin(), records.end());
+
+    cells.resize(n);
+    points.resize(n);
+    ids.resize(n);
+    parallel_for(n, [&](size_t s) {
+        cells[s] = records[s].first;
+        ids[s] = records[s].second;
+        points[s] = input[ids[s]];
+    }, threads, 4096);
+}
+
+void GeomCore::SphericalCellIndex::build(const PointCloud3& input, unsigned threads) {
+    build(input.to_points(), threads);
+}
+
+std::pair<size_t, size_t> GeomCore::SphericalCellIndex::cell_range(SphericalCell cell) const {
+    auto begin = std::lower_bound(cells.begin(), cells.end(), cell.range_min());
+    auto end = std::upper_bound(begin, cells.end(), cell.range_max());
+    return {static_cast<size_t>(begin - cells.begin()), static_cast<size_t>(end - cells.begin())};
+}
+
+void GeomCore::SphericalCellIndex::nearest(const PointR3& q, size_t k, std::vector<SphericalNeighbor>& out) const {
+    out.clear();
+    if (empty() || k == 0) return;
+
+    // Best k so far as a max-heap on distance, and cells still to visit as
+    // a min-heap on the lower bound of their distance to q
+    std::vector<std::pair<double, uint32_t>> best;
+    using entry = std::pair<double, uint64_t>;
+    std::priority_queue<entry, std::vector<entry>, std::greater<>> pending;
+
+    PointR3 p = unit(q);
+    auto push = [&](SphericalCell cell) {
+        double gap = std::max(0.0, angle(p, cell.center()) - cell.bound_angle());
+        pending.push({gap * sphere_radius, cell.id()});
+    };
+    for (int f = 0; f < SphericalCell::face_count; ++f) push(SphericalCell::from_face(f));
+
+    while (!pending.empty()) {
+        auto [bound, id] = pending.top();
+        pending.pop();
+        if (best.size() == k && bound > best.front().first) break;
+
+        SphericalCell cell(id);
+        auto [begin, end] = cell_range(cell);
+        if (begin == end) continue;
+        if (end - begin > scan_size && !cell.is_leaf()) {
+            for (int c = 0; c < 4; ++c) push(cell.child(c));
+            continue;
+        }
+        for (size_t s = begin; s < end; ++s) {
+            double d = spherical_distance(manifold, q, points[s]);
+            if (best.size() < k) {
+                best.push_back({d, static_cast<uint32_t>(s)});
+                std::push_heap(best.begin(), best.end());
+            } else if (d < best.front().first) {
+                std::pop_heap(best.begin(), best.end());
+                best.back() = {d, static_cast<uint32_t>(s)};
+                std::push_heap(best.begin(), best.end());
+            }
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    for (const auto& [d, s] : best) out.push_back({ids[s], d});
+}
+
+void GeomCore::SphericalCellIndex::radius(const PointR3& q, double r, std::vector<SphericalNeighbor>& out,
+                                          bool sorted) const {
+    out.clear();
+    if (empty() || !(r >= 0.0)) return;
+
+    // Refine no further than cells about as wide as the cap: finer cells
+    // would cost more to classify than their points cost to check
+    double cap = r / sphere_radius;
+    int level = SphericalCell::max_level;
+    if (cap > 0.0) {
+        double fit = std::floor(std::log2(std::numbers::pi / 2 / cap)) + 1.0;
+        level = static_cast<int>(std::clamp(fit, 0.0, static_cast<double>(SphericalCell::max_level)));
+    }
+    std::vector<SphericalCell> covering;
+    cap_covering(manifold, q, r, covering, 16, level);
+
+    for (SphericalCell cell : covering) {
+        auto [begin, end] = cell_range(cell);
+        for (size_t s = begin; s < end; ++s) {
+            double d = spherical_distance(manifold, q, points[s]);
+            if (d <= r) out.push_back({ids[s], d});
+        }
+    }
+    if (sorted) {
+        std::sort(out.begin(), out.end(), [](const SphericalNeighbor& a, const SphericalNeighbor& b) {
+            return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+        });
+    }
+}
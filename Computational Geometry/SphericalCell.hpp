@@ -0,0 +1,163 @@
+#pragma once
+
+#include "Manifold.hpp"
+#include "Point.hpp"
+#include "PointCloud.hpp"
+
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace GeomCore {
+
+    // Hierarchical cells on the sphere, laid out like S2 cells.
+    //
+    // The sphere is projected from its centre onto the six faces of the cube
+    // [-1, 1]^3; each face is split into a quadtree 30 levels deep. A face
+    // coordinate u = tan(pi / 4 * s), s in [-1, 1], is split at equal steps
+    // of s, which keeps the areas of the cells of one level within a factor
+    // of 1.5 of each other. Cell edges are great-circle arcs, so every cell
+    // is a convex spherical quadrilateral.
+    //
+    // A cell id packs the face into the top 3 bits and the cell's position
+    // along the face's Hilbert curve into the bits below, followed by a
+    // single marker bit: a cell of level L has its lowest set bit at
+    // position 2 (30 - L). Ids therefore sort along the curve, a parent
+    // sorts between its children, and the leaf cells inside a cell are
+    // exactly the ids in [range_min(), range_max()].
+    class SphericalCell {
+        public:
+            static constexpr int max_level = 30;
+            static constexpr int face_count = 6;
+
+            constexpr SphericalCell() = default;
+            constexpr explicit SphericalCell(uint64_t id) : cell(id) {}
+
+            // Cell of the given level that contains the direction p; p need
+            // not have unit length but must not be zero
+            static SphericalCell from_point(const PointR3& p, int level = max_level);
+            static SphericalCell from_face(int face);
+
+            constexpr uint64_t id() const { return cell; }
+            constexpr int face() const { return static_cast<int>(cell >> 61); }
+            constexpr int level() const { return max_level - std::countr_zero(cell) / 2; }
+            constexpr bool is_leaf() const { return (cell & 1) != 0; }
+
+            // Face below 6, marker bit at an even position
+            constexpr bool is_valid() const {
+                return cell != 0 && face() < face_count && std::countr_zero(cell) % 2 == 0;
+            }
+
+            constexpr uint64_t range_min() const { return cell - (lowest_bit() - 1); }
+            constexpr uint64_t range_max() const { return cell + (lowest_bit() - 1); }
+            constexpr bool contains(SphericalCell other) const {
+                return range_min() <= other.cell && other.cell <= range_max();
+            }
+
+            // Ancestor at the given level, which must not exceed level()
+            constexpr SphericalCell parent(int level) const {
+                uint64_t bit = uint64_t{1} << (2 * (max_level - level));
+                return SphericalCell((cell & (~bit + 1)) | bit);
+            }
+            constexpr SphericalCell parent() const { return parent(level() - 1); }
+
+            // Child k in 0..3, in Hilbert curve order; not for leaves
+            constexpr SphericalCell child(int k) const {
+                uint64_t bit = lowest_bit() >> 2;
+                return SphericalCell(cell - lowest_bit() + bit * (2 * static_cast<uint64_t>(k) + 1));
+            }
+
+            // Unit vectors to the centre and the four corners of the cell,
+            // corners counter-clockwise seen from outside
+            PointR3 center() const;
+            std::array<PointR3, 4> vertices() const;
+
+            // Angle from center() within which the whole cell lies. It is
+            // rounded up slightly, so points assigned to the cell by
+            // from_point are inside it despite rounding.
+            double bound_angle() const;
+
+            constexpr auto operator<=>(const SphericalCell&) const = default;
+
+        private:
+            constexpr uint64_t lowest_bit() const { return cell & (~cell + 1); }
+
+            uint64_t cell = 0;
+    };
+
+    // Coverings: sorted, disjoint sets of cells whose union contains a
+    // region. Cells are refined coarsest first while the count stays within
+    // max_cells and the level within max_level; a cell is refined only if
+    // the region crosses it. Cells wholly inside the region are kept as is.
+
+    // Cells covering the points within distance r of center on the sphere
+    // of the manifold. Throws std::invalid_argument if the manifold is not
+    // spherical.
+    void cap_covering(const Manifold<double>& manifold, const PointR3& center, double r,
+                      std::vector<SphericalCell>& out, size_t max_cells = 16,
+                      int max_level = SphericalCell::max_level);
+
+    // Cells covering the simple spherical polygon with the given vertices,
+    // joined by great-circle arcs. The polygon must lie within the open
+    // hemisphere centred on the mean of its vertices; std::invalid_argument
+    // is thrown otherwise, or for fewer than three vertices.
+    void polygon_covering(const std::vector<PointR3>& polygon, std::vector<SphericalCell>& out,
+                          size_t max_cells = 16, int max_level = SphericalCell::max_level);
+
+    // Neighbour found by a SphericalCellIndex query: input index and
+    // great-circle distance
+    struct SphericalNeighbor {
+        uint32_t index;
+        double distance;
+    };
+
+    // Points on the sphere of a manifold, sorted by leaf cell id.
+    //
+    // The cell ids are one sorted array, so the points inside any cell are a
+    // contiguous run found by two binary searches. Radius queries scan the
+    // runs of a cap covering; nearest-neighbour queries walk the cells best
+    // first by their distance bound. Candidates are confirmed with
+    // spherical_distance.
+    class SphericalCellIndex {
+        public:
+            static constexpr uint32_t NONE = UINT32_MAX;
+
+            // Throws std::invalid_argument if the manifold is not spherical
+            explicit SphericalCellIndex(const Manifold<double>& manifold);
+            SphericalCellIndex(const Manifold<double>& manifold, const std::vector<PointR3>& points,
+                               unsigned threads = 0)
+                : SphericalCellIndex(manifold) {
+                build(points, threads);
+            }
+
+            // Points are taken as directions from the centre of the sphere;
+            // cell ids are computed on separate threads, threads = 0 uses the
+            // hardware concurrency
+            void build(const PointR3* points, size_t n, unsigned threads = 0);
+            void build(const std::vector<PointR3>& points, unsigned threads = 0) { build(points.data(), points.size(), threads); }
+            void build(const PointCloud3& points, unsigned threads = 0);
+
+            size_t size() const { return ids.size(); }
+            bool empty() const { return ids.empty(); }
+            const Manifold<double>& get_manifold() const { return manifold; }
+
+            // Points inside the cell, as a range of positions in cell order
+            std::pair<size_t, size_t> cell_range(SphericalCell cell) const;
+
+            // The min(k, size()) closest points to q, nearest first
+            void nearest(const PointR3& q, size_t k, std::vector<SphericalNeighbor>& out) const;
+
+            // All points within distance r of q, nearest first if sorted
+            void radius(const PointR3& q, double r, std::vector<SphericalNeighbor>& out, bool sorted = false) const;
+
+        private:
+            Manifold<double> manifold;
+            double sphere_radius;
+            std::vector<uint64_t> cells;   // leaf cell id of each slot, ascending
+            std::vector<PointR3> points;   // input points in cell order
+            std::vector<uint32_t> ids;     // input index of each slot
+    };
+}
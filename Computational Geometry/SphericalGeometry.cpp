@@ -1,6 +1,10 @@
 #include "SphericalGeometry.hpp"
+#include "Geodesic.hpp"
+#include "FastMath.hpp"
+#include "Parallel.hpp"
 #include <cmath>
 #include <algorithm>
+#include <limits>
 #include <stdexcept>
 
 namespace GeomCore {
@@ -17,16 +21,7 @@ namespace GeomCore {
     template<typename T>
     requires Real<T>
     T spherical_distance(const Manifold<T>& manifold, const PointR3& p1, const PointR3& p2) {
-        T radius = sphere_radius(manifold);
-
-        T dot = static_cast<T>(dot_product(p1, p2));
-        T mag1 = static_cast<T>(p1.magnitude());
-        T mag2 = static_cast<T>(p2.magnitude());
-
-        T cos_theta = dot / (mag1 * mag2);
-        cos_theta = std::clamp(cos_theta, T{-1}, T{1});
-
-        return radius * std::acos(cos_theta);
+        return geodesic_distance(SphericalManifold<T>(sphere_radius(manifold)), p1, p2);
     }
 
     template<typename T>
@@ -78,6 +73,124 @@ namespace GeomCore {
         return std::fabs(mag - radius) <= tolerance;
     }
 
+    // Batch kernels: the full simd::width groups go straight from the
+    // arrays, the last n % width points are copied into zero-padded buffers
+    // and run through the same code, so every result uses one formula.
+
+    static void check_sizes(size_t a, size_t b) {
+        if (a != b) {
+            throw std::invalid_argument("Point clouds must have the same size");
+        }
+    }
+
+    /**
+     * @brief out[j] = radius * angle(a, b[j]) for j in [0, n), with a fixed.
+     */
+    static void scaled_angles(const double a[3], const double* bx, const double* by, const double* bz, size_t n,
+                              double radius, double* out) {
+        auto ax = simd::broadcast(a[0]), ay = simd::broadcast(a[1]), az = simd::broadcast(a[2]);
+        auto scale = simd::broadcast(radius);
+        size_t end = n - n % simd::width;
+        for (size_t j = 0; j < end; j += simd::width) {
+            auto angle = simd::angle(ax, ay, az, simd::load(bx + j), simd::load(by + j), simd::load(bz + j));
+            simd::store(out + j, simd::mul(angle, scale));
+        }
+        if (end == n) return;
+
+        double px[simd::width] = {}, py[simd::width] = {}, pz[simd::width] = {}, result[simd::width];
+        std::copy(bx + end, bx + n, px);
+        std::copy(by + end, by + n, py);
+        std::copy(bz + end, bz + n, pz);
+        auto angle = simd::angle(ax, ay, az, simd::load(px), simd::load(py), simd::load(pz));
+        simd::store(result, simd::mul(angle, scale));
+        std::copy(result, result + (n - end), out + end);
+    }
+
+    /**
+     * @brief out[i] = radius * angle(a[i], b[i]) for i in [begin, end).
+     */
+    static void scaled_angles(const PointCloud3& a, const PointCloud3& b, size_t begin, size_t end, double radius,
+                              double* out) {
+        const double *ax = a.x(), *ay = a.y(), *az = a.z();
+        const double *bx = b.x(), *by = b.y(), *bz = b.z();
+        auto scale = simd::broadcast(radius);
+        size_t i = begin;
+        for (; i + simd::width <= end; i += simd::width) {
+            auto angle = simd::angle(simd::load(ax + i), simd::load(ay + i), simd::load(az + i),
+                                     simd::load(bx + i), simd::load(by + i), simd::load(bz + i));
+            simd::store(out + i, simd::mul(angle, scale));
+        }
+        if (i == end) return;
+
+        double p[6][simd::width] = {}, result[simd::width];
+        const double* sources[6] = {ax, ay, az, bx, by, bz};
+        for (size_t k = 0; k < 6; ++k) std::copy(sources[k] + i, sources[k] + end, p[k]);
+        auto angle = simd::angle(simd::load(p[0]), simd::load(p[1]), simd::load(p[2]),
+                                 simd::load(p[3]), simd::load(p[4]), simd::load(p[5]));
+        simd::store(result, simd::mul(angle, scale));
+        std::copy(result, result + (end - i), out + i);
+    }
+
+    void spherical_distance(const Manifold<double>& manifold, const PointR3& from, const PointCloud3& to,
+                            std::vector<double>& out, unsigned threads) {
+        double radius = sphere_radius(manifold);
+        const double a[3] = {from[X], from[Y], from[Z]};
+        out.resize(to.size());
+        parallel_blocks(to.size(), 1 << 14, threads, [&](size_t begin, size_t end, unsigned) {
+            scaled_angles(a, to.x() + begin, to.y() + begin, to.z() + begin, end - begin, radius, out.data() + begin);
+        });
+    }
+
+    void spherical_distance(const Manifold<double>& manifold, const PointCloud3& a, const PointCloud3& b,
+                            std::vector<double>& out, unsigned threads) {
+        check_sizes(a.size(), b.size());
+        double radius = sphere_radius(manifold);
+        out.resize(a.size());
+        parallel_blocks(a.size(), 1 << 14, threads, [&](size_t begin, size_t end, unsigned) {
+            scaled_angles(a, b, begin, end, radius, out.data());
+        });
+    }
+
+    void spherical_distance_matrix(const Manifold<double>& manifold, const PointCloud3& rows,
+                                   const PointCloud3& columns, std::vector<double>& out, unsigned threads) {
+        // A tile of columns is 3 * 2048 doubles, 48 KiB, reused by every row
+        // of a block before the next tile is loaded
+        constexpr size_t row_block = 16, column_tile = 2048;
+
+        double radius = sphere_radius(manifold);
+        size_t n = rows.size(), m = columns.size();
+        if (m != 0 && n > std::numeric_limits<size_t>::max() / m) {
+            throw std::length_error("Spherical distance matrix is too large");
+        }
+        out.resize(n * m);
+
+        parallel_blocks(n, row_block, threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t tile = 0; tile < m; tile += column_tile) {
+                size_t count = std::min(column_tile, m - tile);
+                for (size_t i = begin; i < end; ++i) {
+                    const double a[3] = {rows.x()[i], rows.y()[i], rows.z()[i]};
+                    scaled_angles(a, columns.x() + tile, columns.y() + tile, columns.z() + tile, count, radius,
+                                  out.data() + i * m + tile);
+                }
+            }
+        });
+    }
+
+    void unit_vectors_from_lat_long(const std::vector<double>& latitude, const std::vector<double>& longitude,
+                                    PointCloud3& out, unsigned threads) {
+        if (latitude.size() != longitude.size()) {
+            throw std::invalid_argument("Latitudes and longitudes must have the same size");
+        }
+        out.resize(latitude.size());
+        double *x = out.x(), *y = out.y(), *z = out.z();
+        parallel_for(latitude.size(), [&](size_t i) {
+            double c = std::cos(latitude[i]);
+            x[i] = c * std::cos(longitude[i]);
+            y[i] = c * std::sin(longitude[i]);
+            z[i] = std::sin(latitude[i]);
+        }, threads, 1 << 14);
+    }
+
     template double spherical_distance<double>(const Manifold<double>&, const PointR3&, const PointR3&);
     template double spherical_angle<double>(const Manifold<double>&, const PointR3&, const PointR3&, const PointR3&);
     template PointR3 spherical_geodesic_point<double>(const Manifold<double>&, const PointR3&, const PointR3&, double);
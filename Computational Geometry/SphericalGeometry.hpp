@@ -3,6 +3,9 @@
 #include "Core.hpp"
 #include "Manifold.hpp"
 #include "Point.hpp"
+#include "PointCloud.hpp"
+
+#include <vector>
 
 namespace GeomCore {
 
@@ -22,4 +25,32 @@ namespace GeomCore {
     requires Real<T>
     bool is_on_sphere(const Manifold<T>& manifold, const PointR3& p, T tolerance = static_cast<T>(TOLERANCE));
 
+    // Batch great-circle distances. Points are directions from the centre of
+    // the sphere and need not be normalized: every kernel takes the angle as
+    // atan2(|a x b|, a . b), which ignores lengths and stays accurate for
+    // nearby and antipodal points, and evaluates it simd::width pairs at a
+    // time. The radius is derived once per call; like the single-pair
+    // function, they throw std::invalid_argument for a non-spherical
+    // manifold. Output vectors are resized to fit; threads = 0 uses the
+    // hardware concurrency.
+
+    // out[i] = distance from `from` to to[i]
+    void spherical_distance(const Manifold<double>& manifold, const PointR3& from, const PointCloud3& to,
+                            std::vector<double>& out, unsigned threads = 0);
+
+    // out[i] = distance from a[i] to b[i]; a and b must have equal size
+    void spherical_distance(const Manifold<double>& manifold, const PointCloud3& a, const PointCloud3& b,
+                            std::vector<double>& out, unsigned threads = 0);
+
+    // All pairs, row-major: out[i * columns.size() + j] = distance from
+    // rows[i] to columns[j]. Blocks of rows run on separate threads and
+    // sweep the columns in tiles that stay in cache across the block.
+    void spherical_distance_matrix(const Manifold<double>& manifold, const PointCloud3& rows,
+                                   const PointCloud3& columns, std::vector<double>& out, unsigned threads = 0);
+
+    // Unit vectors for latitude[i] and longitude[i], in radians, with the
+    // z axis through the north pole and the x axis through longitude 0
+    void unit_vectors_from_lat_long(const std::vector<double>& latitude, const std::vector<double>& longitude,
+                                    PointCloud3& out, unsigned threads = 0);
+
 }
\ No newline at end of file
@@ -1,48 +1,504 @@
 #include "Triangulation.hpp"
+#include "Predicates.hpp"
+#include "Parallel.hpp"
 
-void GeomCore::initialize_eart_status(PolygonR2 *polygon) {
-    std::shared_ptr<VertexR2> v0, v1, v2;
-    auto vertices = polygon -> get_vertices();
-    v1 = vertices[0];
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
 
-    do {
-        v0 = v1 -> prev.lock();
-        v2 = v1 -> next;
+// Monotone partition followed by a stack walk over each monotone piece, as in
+// de Berg et al., "Computational Geometry: Algorithms and Applications",
+// chapter 3. Vertices are swept top to bottom with ties broken left to right,
+// so no two vertices are ever at the same height and horizontal edges need no
+// special cases.
 
-        if(is_convex(v0, v1, v2))
-            v1 -> is_ear = is_diagonal(v0, v2);
-        v1 = v1 -> next;
-    } while(v1 != vertices[0]);
+static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+[[noreturn]] static void not_simple() {
+    throw std::invalid_argument("Polygon is not simple");
+}
+
+void GeomCore::Triangulator::triangulate(const PointR2* points, size_t n, std::vector<IndexTriangle>& triangles) {
+    run(n, [points](size_t i) { return std::pair<double, double>(points[i][X], points[i][Y]); }, triangles);
+}
+
+void GeomCore::Triangulator::triangulate(const double* coords, size_t n, std::vector<IndexTriangle>& triangles) {
+    run(n, [coords](size_t i) { return std::pair<double, double>(coords[2 * i], coords[2 * i + 1]); }, triangles);
+}
+
+std::vector<GeomCore::IndexTriangle> GeomCore::Triangulator::triangulate(const std::vector<PointR2>& points) {
+    std::vector<IndexTriangle> triangles;
+    triangulate(points.data(), points.size(), triangles);
+    return triangles;
+}
+
+template<class Coordinates>
+void GeomCore::Triangulator::run(size_t n, Coordinates coordinates, std::vector<IndexTriangle>& triangles) {
+    if (n < 3) return;
+    // Half-edges for the sides and up to n - 3 diagonals must stay indexable
+    if (n >= NONE / 4) {
+        throw std::length_error("Polygon has too many vertices");
+    }
+
+    // Load the ring, dropping repeated consecutive vertices
+    xs.clear();
+    ys.clear();
+    input_index.clear();
+    for (size_t i = 0; i < n; ++i) {
+        auto [x, y] = coordinates(i);
+        if (!xs.empty() && x == xs.back() && y == ys.back()) continue;
+        xs.push_back(x);
+        ys.push_back(y);
+        input_index.push_back(static_cast<uint32_t>(i));
+    }
+    while (xs.size() > 1 && xs.front() == xs.back() && ys.front() == ys.back()) {
+        xs.pop_back();
+        ys.pop_back();
+        input_index.pop_back();
+    }
+
+    uint32_t m = static_cast<uint32_t>(xs.size());
+    if (m < 3) return;
+
+    // Link the ring counter-clockwise, so the interior is always on the left
+    double area = 0.0;
+    for (uint32_t i = 0, j = m - 1; i < m; j = i++) {
+        area += (xs[j] - xs[0]) * (ys[i] - ys[0]) - (xs[i] - xs[0]) * (ys[j] - ys[0]);
+    }
+    if (area == 0.0) {
+        // Only a ring on one line may have no area; a figure eight whose
+        // loops cancel is not simple
+        for (uint32_t i = 2; i < m; ++i) {
+            if (orient2d(xs[0], ys[0], xs[1], ys[1], xs[i], ys[i]) != 0.0) not_simple();
+        }
+        return;
+    }
+
+    next.resize(m);
+    prev.resize(m);
+    for (uint32_t i = 0; i < m; ++i) {
+        uint32_t succ = i + 1 == m ? 0 : i + 1;
+        uint32_t pred = i == 0 ? m - 1 : i - 1;
+        next[i] = area > 0.0 ? succ : pred;
+        prev[i] = area > 0.0 ? pred : succ;
+    }
+
+    sweep(m - 2, triangles);
+}
+
+void GeomCore::Triangulator::triangulate(const HalfEdgeMesh& mesh, uint32_t f, std::vector<IndexTriangle>& triangles) {
+    if (f >= mesh.face_count() || mesh.outer(f) == HalfEdgeMesh::NONE) {
+        throw std::invalid_argument("Triangulator: face has no outer boundary");
+    }
+
+    // The mesh keeps every face on the left of its boundary, outer ring
+    // counter-clockwise and holes clockwise, as the sweep expects
+    xs.clear();
+    ys.clear();
+    input_index.clear();
+    next.clear();
+    prev.clear();
+    auto load = [&](uint32_t start) {
+        uint32_t base = static_cast<uint32_t>(xs.size()), h = start;
+        do {
+            uint32_t v = mesh.origin(h), i = static_cast<uint32_t>(xs.size());
+            if (i >= NONE / 4) throw std::length_error("Polygon has too many vertices");
+            xs.push_back(mesh.point(v)[X]);
+            ys.push_back(mesh.point(v)[Y]);
+            input_index.push_back(v);
+            next.push_back(i + 1);
+            prev.push_back(i - 1);
+            h = mesh.next(h);
+        } while (h != start);
+        uint32_t last = static_cast<uint32_t>(xs.size()) - 1;
+        if (last - base < 2) not_simple();
+        next[last] = base;
+        prev[base] = last;
+    };
+    load(mesh.outer(f));
+    for (uint32_t h : mesh.holes(f)) load(h);
+
+    sweep(xs.size() + 2 * mesh.holes(f).size() - 2, triangles);
+}
+
+// Split the loaded rings into monotone pieces and triangulate those,
+// expecting count triangles
+void GeomCore::Triangulator::sweep(size_t count, std::vector<IndexTriangle>& triangles) {
+    triangles.reserve(triangles.size() + count);
+    out = &triangles;
+    make_monotone();
+    triangulate_pieces();
+    out = nullptr;
+}
+
+bool GeomCore::Triangulator::above(uint32_t a, uint32_t b) const {
+    if (ys[a] != ys[b]) return ys[a] > ys[b];
+    if (xs[a] != xs[b]) return xs[a] < xs[b];
+    return a < b;
+}
+
+double GeomCore::Triangulator::orient(uint32_t a, uint32_t b, uint32_t c) const {
+    return orient2d(xs[a], ys[a], xs[b], ys[b], xs[c], ys[c]);
+}
+
+// Edges in the status never cross, so testing the lower-starting edge's upper
+// endpoint against the other edge orders them. If that endpoint lies on the
+// other edge the two share it, and the lower endpoint decides instead.
+bool GeomCore::Triangulator::edge_order::operator()(uint32_t e, uint32_t f) const {
+    if (e == f) return false;
+    uint32_t eu = t->upper(e), el = t->lower(e);
+    uint32_t fu = t->upper(f), fl = t->lower(f);
+
+    if (!t->above(eu, fu)) {
+        double o = t->orient(fu, fl, eu);
+        if (o == 0.0) o = t->orient(fu, fl, el);
+        return o < 0.0;
+    }
+    double o = t->orient(eu, el, fu);
+    if (o == 0.0) o = t->orient(eu, el, fl);
+    return o > 0.0;
+}
+
+// An edge comes before every vertex east of it
+bool GeomCore::Triangulator::edge_order::operator()(uint32_t e, vertex p) const {
+    return t->orient(t->upper(e), t->lower(e), p.v) > 0.0;
+}
+
+bool GeomCore::Triangulator::edge_order::operator()(vertex p, uint32_t e) const {
+    return t->orient(t->upper(e), t->lower(e), p.v) < 0.0;
+}
+
+// Add diagonals at every split and merge vertex so that all pieces become
+// y-monotone. The status holds the edges crossing the sweep line that have
+// the interior to their east, each with its helper: the lowest vertex above
+// the sweep line that sees the edge horizontally.
+void GeomCore::Triangulator::make_monotone() {
+    uint32_t m = static_cast<uint32_t>(xs.size());
+
+    events.resize(m);
+    std::iota(events.begin(), events.end(), 0u);
+    std::sort(events.begin(), events.end(), [this](uint32_t a, uint32_t b) { return above(a, b); });
+
+    kinds.resize(m);
+    for (uint32_t v = 0; v < m; ++v) {
+        bool prev_below = above(v, prev[v]), next_below = above(v, next[v]);
+        bool convex = orient(prev[v], v, next[v]) >= 0.0;
+        if (prev_below && next_below) {
+            kinds[v] = convex ? vertex_kind::start : vertex_kind::split;
+        } else if (!prev_below && !next_below) {
+            kinds[v] = convex ? vertex_kind::end : vertex_kind::merge;
+        } else {
+            kinds[v] = vertex_kind::regular;
+        }
+    }
+
+    helper.assign(m, NONE);
+    status_entry.resize(m);
+    diagonals.clear();
+    std::set<uint32_t, edge_order> status(edge_order{this});
+
+    auto insert = [&](uint32_t e, uint32_t v) {
+        auto [it, inserted] = status.insert(e);
+        if (!inserted) not_simple();
+        status_entry[e] = it;
+        helper[e] = v;
+    };
+    // Remove edge e, which ends at v
+    auto erase = [&](uint32_t e, uint32_t v) {
+        if (helper[e] == NONE) not_simple();
+        if (kinds[helper[e]] == vertex_kind::merge) diagonals.push_back({v, helper[e]});
+        status.erase(status_entry[e]);
+        helper[e] = NONE;
+    };
+    // The status edge directly west of v
+    auto left_of = [&](uint32_t v) {
+        auto it = status.lower_bound(edge_order::vertex{v});
+        if (it == status.begin()) not_simple();
+        return *--it;
+    };
+
+    for (uint32_t v : events) {
+        switch (kinds[v]) {
+            case vertex_kind::start:
+                insert(v, v);
+                break;
+            case vertex_kind::end:
+                erase(prev[v], v);
+                break;
+            case vertex_kind::split: {
+                uint32_t e = left_of(v);
+                diagonals.push_back({v, helper[e]});
+                helper[e] = v;
+                insert(v, v);
+                break;
+            }
+            case vertex_kind::merge: {
+                erase(prev[v], v);
+                uint32_t e = left_of(v);
+                if (kinds[helper[e]] == vertex_kind::merge) diagonals.push_back({v, helper[e]});
+                helper[e] = v;
+                break;
+            }
+            case vertex_kind::regular:
+                if (above(prev[v], v)) {
+                    // Descending the boundary: the interior is to the east
+                    erase(prev[v], v);
+                    insert(v, v);
+                } else {
+                    uint32_t e = left_of(v);
+                    if (kinds[helper[e]] == vertex_kind::merge) diagonals.push_back({v, helper[e]});
+                    helper[e] = v;
+                }
+                break;
+        }
+    }
+}
+
+// Walk the faces cut out by the diagonals. Half-edges come in twin pairs and
+// are sorted counter-clockwise around their origin; the face left of u -> w
+// continues along the half-edge leaving w just clockwise of w -> u.
+void GeomCore::Triangulator::triangulate_pieces() {
+    uint32_t m = static_cast<uint32_t>(xs.size());
+    uint32_t count = 2 * (m + static_cast<uint32_t>(diagonals.size()));
+
+    half_from.resize(count);
+    half_to.resize(count);
+    for (uint32_t v = 0; v < m; ++v) {
+        half_from[2 * v] = half_to[2 * v + 1] = v;
+        half_to[2 * v] = half_from[2 * v + 1] = next[v];
+    }
+    for (size_t d = 0; d < diagonals.size(); ++d) {
+        uint32_t h = 2 * (m + static_cast<uint32_t>(d));
+        half_from[h] = half_to[h + 1] = diagonals[d][0];
+        half_to[h] = half_from[h + 1] = diagonals[d][1];
+    }
+
+    // Directions in the upper half-plane (due east included) sort first
+    auto lower_half = [this](uint32_t h) {
+        double dx = xs[half_to[h]] - xs[half_from[h]], dy = ys[half_to[h]] - ys[half_from[h]];
+        return dy < 0.0 || (dy == 0.0 && dx < 0.0);
+    };
+    half_order.resize(count);
+    std::iota(half_order.begin(), half_order.end(), 0u);
+    std::sort(half_order.begin(), half_order.end(), [&](uint32_t a, uint32_t b) {
+        if (half_from[a] != half_from[b]) return half_from[a] < half_from[b];
+        bool la = lower_half(a), lb = lower_half(b);
+        if (la != lb) return lb;
+        return orient(half_from[a], half_to[a], half_to[b]) > 0.0;
+    });
+
+    half_position.resize(count);
+    first_half.assign(m + 1, 0);
+    for (uint32_t p = 0; p < count; ++p) {
+        half_position[half_order[p]] = p;
+        ++first_half[half_from[half_order[p]] + 1];
+    }
+    for (uint32_t v = 0; v < m; ++v) first_half[v + 1] += first_half[v];
+
+    // Reversed sides bound the exterior
+    half_used.assign(count, 0);
+    for (uint32_t v = 0; v < m; ++v) half_used[2 * v + 1] = 1;
+
+    for (uint32_t h = 0; h < count; ++h) {
+        if (half_used[h]) continue;
+
+        piece.clear();
+        uint32_t current = h;
+        do {
+            if (half_used[current]) not_simple();
+            half_used[current] = 1;
+            piece.push_back(half_from[current]);
+
+            uint32_t w = half_to[current];
+            uint32_t p = half_position[current ^ 1];
+            current = half_order[(p == first_half[w] ? first_half[w + 1] : p) - 1];
+        } while (current != h);
+
+        triangulate_monotone();
+    }
+}
+
+// Triangulate the y-monotone piece stored counter-clockwise in piece
+void GeomCore::Triangulator::triangulate_monotone() {
+    size_t k = piece.size();
+    if (k < 3) not_simple();
+
+    auto emit = [this](uint32_t a, uint32_t b, uint32_t c) {
+        if (orient(a, b, c) < 0.0) std::swap(b, c);
+        out->push_back({input_index[a], input_index[b], input_index[c]});
+    };
+
+    if (k == 3) {
+        emit(piece[0], piece[1], piece[2]);
+        return;
+    }
+
+    size_t top = 0, bottom = 0;
+    for (size_t i = 1; i < k; ++i) {
+        if (above(piece[i], piece[top])) top = i;
+        if (above(piece[bottom], piece[i])) bottom = i;
+    }
+
+    // Counter-clockwise from the top runs down the left chain, clockwise
+    // down the right one; merge both into sweep order
+    sorted.clear();
+    on_right_chain.clear();
+    sorted.push_back(piece[top]);
+    on_right_chain.push_back(0);
+    size_t l = (top + 1) % k, r = (top + k - 1) % k;
+    while (l != bottom || r != bottom) {
+        if (r == bottom || (l != bottom && above(piece[l], piece[r]))) {
+            sorted.push_back(piece[l]);
+            on_right_chain.push_back(0);
+            l = (l + 1) % k;
+        } else {
+            sorted.push_back(piece[r]);
+            on_right_chain.push_back(1);
+            r = (r + k - 1) % k;
+        }
+    }
+    sorted.push_back(piece[bottom]);
+    on_right_chain.push_back(0);
+
+    // The stack holds positions in sorted forming a reflex chain not yet cut
+    stack.clear();
+    stack.push_back(0);
+    stack.push_back(1);
+    for (uint32_t j = 2; j + 1 < k; ++j) {
+        uint32_t u = sorted[j];
+        if (on_right_chain[j] != on_right_chain[stack.back()]) {
+            // Opposite chain: u sees the whole stack
+            for (size_t s = 0; s + 1 < stack.size(); ++s) {
+                emit(u, sorted[stack[s]], sorted[stack[s + 1]]);
+            }
+            stack.clear();
+            stack.push_back(j - 1);
+            stack.push_back(j);
+        } else {
+            // Same chain: cut while the diagonal stays inside
+            uint32_t s = stack.back();
+            stack.pop_back();
+            while (!stack.empty()) {
+                uint32_t t = stack.back();
+                double o = orient(sorted[t], sorted[s], u);
+                if (on_right_chain[j] ? o >= 0.0 : o <= 0.0) break;
+                emit(sorted[t], sorted[s], u);
+                s = t;
+                stack.pop_back();
+            }
+            stack.push_back(s);
+            stack.push_back(j);
+        }
+    }
+
+    uint32_t last = sorted[k - 1];
+    for (size_t s = 0; s + 1 < stack.size(); ++s) {
+        emit(sorted[stack[s]], sorted[stack[s + 1]], last);
+    }
+}
+
+std::vector<GeomCore::IndexTriangle> GeomCore::triangulate_polygon(const std::vector<PointR2>& points) {
+    return Triangulator().triangulate(points);
+}
+
+void GeomCore::triangulate_polygons(const PointR2* points, const uint32_t* offsets, size_t count,
+                                    std::vector<IndexTriangle>& triangles, std::vector<uint32_t>& triangle_offsets,
+                                    unsigned threads) {
+    // Room for n - 2 triangles per polygon; dropped repeated vertices can
+    // only make fewer
+    triangle_offsets.resize(count + 1);
+    size_t total = 0;
+    for (size_t k = 0; k < count; ++k) {
+        triangle_offsets[k] = static_cast<uint32_t>(total);
+        size_t n = offsets[k + 1] - offsets[k];
+        total += n >= 3 ? n - 2 : 0;
+        if (total >= NONE) {
+            throw std::length_error("triangulate_polygons: too many triangles");
+        }
+    }
+    triangle_offsets[count] = static_cast<uint32_t>(total);
+    triangles.resize(total);
+
+    constexpr size_t grain = 256;
+    if (threads == 0) threads = default_thread_count();
+    size_t workers = std::min<size_t>(threads, (count + grain - 1) / grain);
+
+    std::vector<Triangulator> triangulators(std::max<size_t>(workers, 1));
+    std::vector<std::vector<IndexTriangle>> scratch(triangulators.size());
+    std::vector<uint32_t> produced(count);
+    parallel_blocks(count, grain, threads, [&](size_t begin, size_t end, unsigned worker) {
+        std::vector<IndexTriangle>& local = scratch[worker];
+        for (size_t k = begin; k < end; ++k) {
+            local.clear();
+            try {
+                triangulators[worker].triangulate(points + offsets[k], offsets[k + 1] - offsets[k], local);
+            } catch (const std::invalid_argument& e) {
+                throw std::invalid_argument("triangulate_polygons: polygon " + std::to_string(k) + ": " + e.what());
+            }
+            IndexTriangle* slot = triangles.data() + triangle_offsets[k];
+            for (const IndexTriangle& t : local) {
+                *slot++ = {t[0] + offsets[k], t[1] + offsets[k], t[2] + offsets[k]};
+            }
+            produced[k] = static_cast<uint32_t>(local.size());
+        }
+    });
+
+    uint32_t filled = 0;
+    for (size_t k = 0; k < count; ++k) {
+        uint32_t start = triangle_offsets[k];
+        if (filled != start) {
+            std::copy(triangles.begin() + start, triangles.begin() + start + produced[k], triangles.begin() + filled);
+        }
+        triangle_offsets[k] = filled;
+        filled += produced[k];
+    }
+    triangle_offsets[count] = filled;
+    triangles.resize(filled);
+}
+
+void GeomCore::triangulate_polygons(const RingSet& polygons, std::vector<IndexTriangle>& triangles,
+                                    std::vector<uint32_t>& triangle_offsets, unsigned threads) {
+    triangulate_polygons(polygons.points.data(), polygons.offsets.data(), polygons.ring_count(), triangles,
+                         triangle_offsets, threads);
 }
 
 void GeomCore::triangulate_earclipping(PolygonR2 *poly, std::vector<EdgeR2> &edge_list) {
-    initialize_eart_status(poly);
-    auto vertex_list = poly -> get_vertices();
-    int no_vertex_to_process = vertex_list.size();
-
-    std::shared_ptr<VertexR2> v0, v1, v2, v3, v4;
-
-    while(no_vertex_to_process < 3) {
-        for(size_t i = 0; i < vertex_list.size(); i++) {
-            v2 = vertex_list[i];
-            if(v2 -> is_ear && !v2 -> is_processed) {
-                v3 = v2 -> next;
-                v4 = v3 -> next;
-                v1 = v2 -> prev.lock();
-                v0 = v2 -> prev.lock();
-
-                edge_list.push_back(EdgeR2(v1, v3));
-                v2 -> is_processed = true;
-
-                v1 -> next = v3;
-                v3 -> prev = v1;
-
-                if(is_convex(v1 -> prev.lock(), v1, v1 -> next)) 
-                    v1 -> is_ear = is_diagonal(v0, v3, nullptr);
-                if(is_convex(v3 -> prev.lock(), v3, v3 -> next))
-                    v3 -> is_ear = is_diagonal(v0, v3, nullptr);
-                        
+    const auto& vertices = poly -> get_vertices();
+
+    std::vector<PointR2> points;
+    points.reserve(vertices.size());
+    for (const auto& v : vertices) points.push_back(v -> point);
+
+    auto triangles = triangulate_polygon(points);
+
+    // Ring position of each vertex the triangulator keeps, dropping repeated
+    // consecutive vertices as it does; triangles use only kept vertices
+    size_t n = points.size();
+    std::vector<uint32_t> position(n, NONE);
+    uint32_t m = 0, last = NONE;
+    for (uint32_t i = 0; i < n; ++i) {
+        if (last != NONE && points[i][X] == points[last][X] && points[i][Y] == points[last][Y]) continue;
+        position[i] = m++;
+        last = i;
+    }
+    for (uint32_t i = last; m > 1 && points[i][X] == points[0][X] && points[i][Y] == points[0][Y];) {
+        position[i] = NONE;
+        --m;
+        do --i; while (position[i] == NONE);
+    }
+
+    // Every diagonal borders two triangles and appears once in each
+    // direction; polygon sides, between neighbours on the ring, only once
+    for (const auto& t : triangles) {
+        for (size_t k = 0; k < 3; ++k) {
+            uint32_t a = t[k], b = t[(k + 1) % 3];
+            uint32_t pa = position[a], pb = position[b];
+            bool side = (pa + 1) % m == pb || (pb + 1) % m == pa;
+            if (!side && a < b) {
+                edge_list.push_back(EdgeR2(vertices[a], vertices[b]));
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -1,8 +1,119 @@
+#pragma once
+
 #include "Polygon.hpp"
 #include "GeoUtils.hpp"
 #include "Edge.hpp"
+#include "HalfEdgeMesh.hpp"
+#include "RingSet.hpp"
+
+#include <array>
+#include <cstdint>
+#include <set>
+#include <vector>
 
 namespace GeomCore {
-    static void initialize_eart_status(PolygonR2 *polygon);
+    // Triangle as three indices into the triangulated point array
+    using IndexTriangle = std::array<uint32_t, 3>;
+
+    // O(n log n) polygon triangulator over a flat vertex array.
+    //
+    // A sweep line from top to bottom splits the polygon into y-monotone
+    // pieces by adding diagonals at split and merge vertices; each piece is
+    // then triangulated in linear time with a stack. Rings are stored as
+    // prev/next index arrays and every orientation test uses the robust
+    // orient2d predicate. Scratch memory is kept between calls, so one
+    // Triangulator reused across many polygons mostly stops allocating.
+    class Triangulator {
+        public:
+            // Triangulate the simple polygon points[0..n) given in either
+            // orientation, appending counter-clockwise triangles. A polygon
+            // with n distinct consecutive vertices yields n - 2 triangles.
+            // Throws std::invalid_argument if the polygon is found to
+            // intersect itself.
+            void triangulate(const PointR2* points, size_t n, std::vector<IndexTriangle>& triangles);
+
+            // Same, for interleaved coordinates x0, y0, x1, y1, ...
+            void triangulate(const double* coords, size_t n, std::vector<IndexTriangle>& triangles);
+
+            std::vector<IndexTriangle> triangulate(const std::vector<PointR2>& points);
+
+            // Triangulate the bounded face f of mesh, holes included,
+            // appending counter-clockwise triangles of mesh vertex indices.
+            // A face with h holes and n vertices on all its rings together
+            // yields n + 2 h - 2 triangles. Throws
+            // std::invalid_argument for the unbounded face, or if the
+            // boundary is found not to be disjoint simple rings.
+            void triangulate(const HalfEdgeMesh& mesh, uint32_t f, std::vector<IndexTriangle>& triangles);
+
+        private:
+            enum class vertex_kind : uint8_t { start, end, split, merge, regular };
+
+            // Status-structure order of the edges crossing the sweep line,
+            // west to east; also compares edges with vertices
+            struct edge_order {
+                using is_transparent = void;
+                struct vertex { uint32_t v; };
+
+                const Triangulator* t;
+                bool operator()(uint32_t e, uint32_t f) const;
+                bool operator()(uint32_t e, vertex p) const;
+                bool operator()(vertex p, uint32_t e) const;
+            };
+
+            template<class Coordinates>
+            void run(size_t n, Coordinates coordinates, std::vector<IndexTriangle>& triangles);
+            void sweep(size_t count, std::vector<IndexTriangle>& triangles);
+
+            bool above(uint32_t a, uint32_t b) const;
+            double orient(uint32_t a, uint32_t b, uint32_t c) const;
+            uint32_t upper(uint32_t e) const { return above(e, next[e]) ? e : next[e]; }
+            uint32_t lower(uint32_t e) const { return above(e, next[e]) ? next[e] : e; }
+
+            void make_monotone();
+            void triangulate_pieces();
+            void triangulate_monotone();
+
+            // Ring storage
+            std::vector<double> xs, ys;
+            std::vector<uint32_t> input_index, next, prev;
+
+            // Sweep; an edge is named by its first vertex
+            std::vector<uint32_t> events;
+            std::vector<vertex_kind> kinds;
+            std::vector<uint32_t> helper;
+            std::vector<std::set<uint32_t, edge_order>::iterator> status_entry;
+            std::vector<std::array<uint32_t, 2>> diagonals;
+
+            // Pieces, as half-edges sorted around their origin
+            std::vector<uint32_t> half_from, half_to, half_order, half_position, first_half;
+            std::vector<uint8_t> half_used;
+
+            // Monotone triangulation
+            std::vector<uint32_t> piece, sorted, stack;
+            std::vector<uint8_t> on_right_chain;
+            std::vector<IndexTriangle>* out = nullptr;
+    };
+
+    // Triangles of a simple polygon, as indices into points
+    std::vector<IndexTriangle> triangulate_polygon(const std::vector<PointR2>& points);
+
+    // Triangulate many independent simple polygons, polygon k being
+    // points[offsets[k]..offsets[k + 1]) for k < count, into one buffer.
+    // Its triangles are triangles[triangle_offsets[k]..triangle_offsets[k + 1])
+    // and index points directly. Both vectors are sized up front from the
+    // n - 2 triangles of an n-gon and filled in place by polygons spread
+    // over threads, each keeping its own Triangulator; they are compacted
+    // afterwards only if some polygon had repeated vertices. threads = 0
+    // uses the hardware concurrency. Throws std::invalid_argument, naming
+    // the polygon, if one is found to intersect itself.
+    void triangulate_polygons(const PointR2* points, const uint32_t* offsets, size_t count,
+                              std::vector<IndexTriangle>& triangles, std::vector<uint32_t>& triangle_offsets,
+                              unsigned threads = 0);
+
+    // Same, one polygon per ring
+    void triangulate_polygons(const RingSet& polygons, std::vector<IndexTriangle>& triangles,
+                              std::vector<uint32_t>& triangle_offsets, unsigned threads = 0);
+
+    // Diagonals of a triangulation of poly, as edges between its vertices
     void triangulate_earclipping(PolygonR2 *poly, std::vector<EdgeR2> &edge_list);
-}
\ No newline at end of file
+}
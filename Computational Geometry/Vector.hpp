@@ -4,6 +4,7 @@
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <stdexcept>
 #include <type_traits>
 
 #include "Core.hpp"
@@ -17,6 +18,11 @@ namespace GeomCore {
 #define Y 1
 #define Z 2
 
+// Fixed-size vector. Everything is inline, so chained arithmetic such as
+// a * s + b * t is flattened by the compiler into one pass over the
+// coordinates, and every result keeps the full precision of
+// coordinate_type. All of it is constexpr except magnitude() and
+// normalize(), which need std::sqrt.
 template <class coordinate_type, size_t dimension = R3>
 class Vector {
     static_assert(std::is_arithmetic_v<coordinate_type>, "Vector class only supports arithmetic types (integers or floating-point numbers)");
@@ -24,43 +30,60 @@ class Vector {
 
     std::array<coordinate_type, dimension> coordinates;
 
-    friend coordinate_type dot_product(const Vector<coordinate_type, dimension>& v1, const Vector<coordinate_type, dimension>& v2);
-
 public:
-    Vector() : coordinates{} {}
-    Vector(std::array<coordinate_type, dimension> coords) : coordinates(coords) {}
-    
-    
-    Vector(coordinate_type x, coordinate_type y) {
+    constexpr Vector() : coordinates{} {}
+    constexpr Vector(std::array<coordinate_type, dimension> coords) : coordinates(coords) {}
+
+    constexpr Vector(coordinate_type x, coordinate_type y) : coordinates{x, y} {
         static_assert(dimension == 2, "This constructor is only for 2D vectors.");
-        coordinates = {x, y};
     }
 
-    Vector(coordinate_type x, coordinate_type y, coordinate_type z) {
+    constexpr Vector(coordinate_type x, coordinate_type y, coordinate_type z) : coordinates{x, y, z} {
         static_assert(dimension == 3, "This constructor is only for 3D vectors.");
-        coordinates = {x, y, z};
     }
 
     // Comparison operators
-    bool operator==(const Vector<coordinate_type, dimension>& other) const;
-    bool operator!=(const Vector<coordinate_type, dimension>& other) const;
+    constexpr bool operator==(const Vector<coordinate_type, dimension>& other) const;
+    constexpr bool operator!=(const Vector<coordinate_type, dimension>& other) const;
 
     // Arithmetic operators
-    Vector<coordinate_type, dimension> operator+(const Vector<coordinate_type, dimension>& other) const;
-    Vector<coordinate_type, dimension> operator-(const Vector<coordinate_type, dimension>& other) const;
-    Vector<coordinate_type, dimension> operator*(const Vector<coordinate_type, dimension>& other) const;
-    Vector<coordinate_type, dimension> operator*(coordinate_type scalar) const;
+    constexpr Vector<coordinate_type, dimension> operator+(const Vector<coordinate_type, dimension>& other) const;
+    constexpr Vector<coordinate_type, dimension> operator-(const Vector<coordinate_type, dimension>& other) const;
+    constexpr Vector<coordinate_type, dimension> operator*(const Vector<coordinate_type, dimension>& other) const;
+    constexpr Vector<coordinate_type, dimension> operator*(coordinate_type scalar) const;
+    constexpr Vector<coordinate_type, dimension> operator/(coordinate_type scalar) const;
+    constexpr Vector<coordinate_type, dimension> operator-() const;
+
+    friend constexpr Vector<coordinate_type, dimension> operator*(coordinate_type scalar, const Vector<coordinate_type, dimension>& v) {
+        return v * scalar;
+    }
+
+    // In-place arithmetic
+    constexpr Vector<coordinate_type, dimension>& operator+=(const Vector<coordinate_type, dimension>& other);
+    constexpr Vector<coordinate_type, dimension>& operator-=(const Vector<coordinate_type, dimension>& other);
+    constexpr Vector<coordinate_type, dimension>& operator*=(coordinate_type scalar);
+    constexpr Vector<coordinate_type, dimension>& operator/=(coordinate_type scalar);
 
     // Boolean operators
-    bool operator<(const Vector<coordinate_type, dimension>& other) const;
-    bool operator>(const Vector<coordinate_type, dimension>& other) const;
+    constexpr bool operator<(const Vector<coordinate_type, dimension>& other) const;
+    constexpr bool operator>(const Vector<coordinate_type, dimension>& other) const;
 
     // Indexing
-    coordinate_type operator[](size_t index) const;
-    coordinate_type& operator[](size_t index);
+    constexpr coordinate_type operator[](size_t index) const;
+    constexpr coordinate_type& operator[](size_t index);
+
+    // Indexing without the bounds check, for inner loops that already know
+    // the index is valid
+    constexpr coordinate_type unchecked(size_t index) const noexcept { return coordinates[index]; }
+    constexpr coordinate_type& unchecked(size_t index) noexcept { return coordinates[index]; }
+
+    constexpr const coordinate_type* data() const noexcept { return coordinates.data(); }
+    constexpr coordinate_type* data() noexcept { return coordinates.data(); }
+
+    static constexpr size_t size() noexcept { return dimension; }
 
     // Functions
-    void assign(size_t dim, coordinate_type value);
+    constexpr void assign(size_t dim, coordinate_type value);
 
     coordinate_type magnitude() const;
     void normalize();
@@ -71,13 +94,13 @@ using Vector3d = Vector<double, R3>;
 
 template <typename T>
 requires Real<T>
-inline bool is_equal_1D(T a, T b, T epsilon = 1e-5) {
+constexpr bool is_equal_1D(T a, T b, T epsilon = 1e-5) {
     return std::fabs(a - b) <= epsilon;
 }
 
 // Implementation of comparison operators
 template <class coordinate_type, size_t dimension>
-inline bool Vector<coordinate_type, dimension>::operator==(const Vector<coordinate_type, dimension>& other) const {
+constexpr bool Vector<coordinate_type, dimension>::operator==(const Vector<coordinate_type, dimension>& other) const {
     for (size_t i = 0; i < dimension; ++i) {
         if constexpr (std::is_floating_point_v<coordinate_type>) {
             if (!is_equal_1D(static_cast<double>(coordinates[i]), static_cast<double>(other.coordinates[i]))) {
@@ -93,51 +116,87 @@ inline bool Vector<coordinate_type, dimension>::operator==(const Vector<coordina
 }
 
 template <class coordinate_type, size_t dimension>
-inline bool Vector<coordinate_type, dimension>::operator!=(const Vector<coordinate_type, dimension>& other) const {
+constexpr bool Vector<coordinate_type, dimension>::operator!=(const Vector<coordinate_type, dimension>& other) const {
     return !(*this == other);
 }
 
 // Implementation of arithmetic operators
 template <class coordinate_type, size_t dimension>
-inline Vector<coordinate_type, dimension> Vector<coordinate_type, dimension>::operator+(const Vector<coordinate_type, dimension>& other) const {
-    std::array<coordinate_type, dimension> result;
-    for (size_t i = 0; i < dimension; ++i) {
-        result[i] = coordinates[i] + other.coordinates[i];
-    }
-    return Vector<coordinate_type, dimension>(result);
+constexpr Vector<coordinate_type, dimension> Vector<coordinate_type, dimension>::operator+(const Vector<coordinate_type, dimension>& other) const {
+    Vector result = *this;
+    return result += other;
 }
 
 template <class coordinate_type, size_t dimension>
-inline Vector<coordinate_type, dimension> Vector<coordinate_type, dimension>::operator-(const Vector<coordinate_type, dimension>& other) const {
-    std::array<coordinate_type, dimension> result;
+constexpr Vector<coordinate_type, dimension> Vector<coordinate_type, dimension>::operator-(const Vector<coordinate_type, dimension>& other) const {
+    Vector result = *this;
+    return result -= other;
+}
+
+template <class coordinate_type, size_t dimension>
+constexpr Vector<coordinate_type, dimension> Vector<coordinate_type, dimension>::operator*(const Vector<coordinate_type, dimension>& other) const {
+    Vector result;
     for (size_t i = 0; i < dimension; ++i) {
-        result[i] = coordinates[i] - other.coordinates[i];
+        result.coordinates[i] = coordinates[i] * other.coordinates[i];
     }
-    return Vector<coordinate_type, dimension>(result);
+    return result;
 }
 
+template <class coordinate_type, size_t dimension>
+constexpr Vector<coordinate_type, dimension> Vector<coordinate_type, dimension>::operator*(coordinate_type scalar) const {
+    Vector result = *this;
+    return result *= scalar;
+}
 
 template <class coordinate_type, size_t dimension>
-inline Vector<coordinate_type, dimension> Vector<coordinate_type, dimension>::operator*(const Vector<coordinate_type, dimension>& other) const {
+constexpr Vector<coordinate_type, dimension> Vector<coordinate_type, dimension>::operator/(coordinate_type scalar) const {
+    Vector result = *this;
+    return result /= scalar;
+}
+
+template <class coordinate_type, size_t dimension>
+constexpr Vector<coordinate_type, dimension> Vector<coordinate_type, dimension>::operator-() const {
     Vector result;
-    for(size_t i = 0; i < dimension; i++){
-        result.coordinates[i] = coordinates[i] * other[i];
+    for (size_t i = 0; i < dimension; ++i) {
+        result.coordinates[i] = -coordinates[i];
     }
     return result;
-    
 }
 
 template <class coordinate_type, size_t dimension>
-inline Vector<coordinate_type, dimension> Vector<coordinate_type, dimension>::operator*(coordinate_type scalar) const
-{
-    Vector<coordinate_type, dimension> result = *this;
-    for (size_t i = 0; i < dimension; ++i)
-        result.coordinates[i] *= scalar;
-    return result;
+constexpr Vector<coordinate_type, dimension>& Vector<coordinate_type, dimension>::operator+=(const Vector<coordinate_type, dimension>& other) {
+    for (size_t i = 0; i < dimension; ++i) {
+        coordinates[i] += other.coordinates[i];
+    }
+    return *this;
+}
+
+template <class coordinate_type, size_t dimension>
+constexpr Vector<coordinate_type, dimension>& Vector<coordinate_type, dimension>::operator-=(const Vector<coordinate_type, dimension>& other) {
+    for (size_t i = 0; i < dimension; ++i) {
+        coordinates[i] -= other.coordinates[i];
+    }
+    return *this;
+}
+
+template <class coordinate_type, size_t dimension>
+constexpr Vector<coordinate_type, dimension>& Vector<coordinate_type, dimension>::operator*=(coordinate_type scalar) {
+    for (size_t i = 0; i < dimension; ++i) {
+        coordinates[i] *= scalar;
+    }
+    return *this;
+}
+
+template <class coordinate_type, size_t dimension>
+constexpr Vector<coordinate_type, dimension>& Vector<coordinate_type, dimension>::operator/=(coordinate_type scalar) {
+    for (size_t i = 0; i < dimension; ++i) {
+        coordinates[i] /= scalar;
+    }
+    return *this;
 }
 
 template <class coordinate_type, size_t dimension>
-inline bool Vector<coordinate_type, dimension>::operator<(const Vector<coordinate_type, dimension>& other) const {
+constexpr bool Vector<coordinate_type, dimension>::operator<(const Vector<coordinate_type, dimension>& other) const {
     for (size_t i = 0; i < dimension; ++i) {
         if (coordinates[i] < other.coordinates[i]) return true;
         if (coordinates[i] > other.coordinates[i]) return false;
@@ -146,14 +205,14 @@ inline bool Vector<coordinate_type, dimension>::operator<(const Vector<coordinat
 }
 
 template <class coordinate_type, size_t dimension>
-inline bool Vector<coordinate_type, dimension>::operator>(const Vector<coordinate_type, dimension>& other) const {
+constexpr bool Vector<coordinate_type, dimension>::operator>(const Vector<coordinate_type, dimension>& other) const {
     if (*this == other) return false;
     return !(*this < other);
 }
 
 // Implementation of indexing operators
 template <class coordinate_type, size_t dimension>
-inline coordinate_type Vector<coordinate_type, dimension>::operator[](size_t index) const {
+constexpr coordinate_type Vector<coordinate_type, dimension>::operator[](size_t index) const {
     if (index >= dimension) {
         std::cerr << "Vector index out of bounds" << std::endl;
         return coordinate_type{};
@@ -162,7 +221,7 @@ inline coordinate_type Vector<coordinate_type, dimension>::operator[](size_t ind
 }
 
 template <class coordinate_type, size_t dimension>
-inline coordinate_type& Vector<coordinate_type, dimension>::operator[](size_t index) {
+constexpr coordinate_type& Vector<coordinate_type, dimension>::operator[](size_t index) {
     if (index >= dimension) {
         std::cerr << "Vector index out of bounds" << std::endl;
         throw std::out_of_range("Vector index out of bounds");
@@ -171,7 +230,7 @@ inline coordinate_type& Vector<coordinate_type, dimension>::operator[](size_t in
 }
 
 template <class coordinate_type, size_t dimension>
-inline void Vector<coordinate_type, dimension>::assign(size_t dim, coordinate_type value) {
+constexpr void Vector<coordinate_type, dimension>::assign(size_t dim, coordinate_type value) {
     if (dim >= dimension) {
         std::cerr << "Vector dimension out of bounds" << std::endl;
         return;
@@ -180,7 +239,7 @@ inline void Vector<coordinate_type, dimension>::assign(size_t dim, coordinate_ty
 }
 
 template <class coordinate_type, size_t dimension>
-inline coordinate_type Vector<coordinate_type, dimension>::magnitude() const {
+coordinate_type Vector<coordinate_type, dimension>::magnitude() const {
     coordinate_type value = coordinate_type{0};
 
     for (size_t i = 0; i < dimension; ++i) {
@@ -189,9 +248,10 @@ inline coordinate_type Vector<coordinate_type, dimension>::magnitude() const {
 
     return static_cast<coordinate_type>(std::sqrt(value));
 }
+
 template <class coordinate_type, size_t dimension>
-inline void Vector<coordinate_type, dimension>::normalize() {
-    float mag = magnitude();
+void Vector<coordinate_type, dimension>::normalize() {
+    coordinate_type mag = magnitude();
     if (mag > TOLERANCE) {
         for (size_t i = 0; i < dimension; ++i) {
             coordinates[i] = static_cast<coordinate_type>(coordinates[i] / mag);
@@ -200,25 +260,53 @@ inline void Vector<coordinate_type, dimension>::normalize() {
 }
 
 template <class coordinate_type, size_t dimension>
-inline coordinate_type dot_product(const Vector<coordinate_type, dimension>& v1, const Vector<coordinate_type, dimension>& v2) {
-    coordinate_type product = 0.0f;
-    for (size_t i = 0; i < dimension; ++i) {
-        product += static_cast<float>(v1.coordinates[i] * v2.coordinates[i]);
+constexpr coordinate_type dot_product(const Vector<coordinate_type, dimension>& v1, const Vector<coordinate_type, dimension>& v2) {
+    coordinate_type product = v1.unchecked(0) * v2.unchecked(0);
+    for (size_t i = 1; i < dimension; ++i) {
+        product += v1.unchecked(i) * v2.unchecked(i);
     }
     return product;
 }
 
-inline Vector3d cross_product_R3(const Vector3d& v1, const Vector3d& v2) {
-    float _x = v1[Y] * v2[Z] - v1[Z] * v2[Y];
-    float _y = v1[Z] * v2[X] - v1[X] * v2[Z];
-    float _z = v1[X] * v2[Y] - v1[Y] * v2[X];
-    return Vector3d(_x, _y, _z);
+// a * s + b * t in a single pass over the coordinates
+template <class coordinate_type, size_t dimension>
+constexpr Vector<coordinate_type, dimension> linear_combination(const Vector<coordinate_type, dimension>& a, std::type_identity_t<coordinate_type> s,
+                                                                const Vector<coordinate_type, dimension>& b, std::type_identity_t<coordinate_type> t) {
+    Vector<coordinate_type, dimension> result;
+    for (size_t i = 0; i < dimension; ++i) {
+        result.unchecked(i) = a.unchecked(i) * s + b.unchecked(i) * t;
+    }
+    return result;
 }
 
-// Cross product 
-float cross_product_R2(const Vector2d& v1, const Vector2d& v2);
-Vector3d cross_product_R3(const Vector3d& v1, const Vector3d& v2);
+// a * s + b in a single pass over the coordinates
+template <class coordinate_type, size_t dimension>
+constexpr Vector<coordinate_type, dimension> scale_add(const Vector<coordinate_type, dimension>& a, std::type_identity_t<coordinate_type> s,
+                                                       const Vector<coordinate_type, dimension>& b) {
+    Vector<coordinate_type, dimension> result;
+    for (size_t i = 0; i < dimension; ++i) {
+        result.unchecked(i) = a.unchecked(i) * s + b.unchecked(i);
+    }
+    return result;
+}
+
+// Cross product
+template <class coordinate_type>
+constexpr coordinate_type cross_product_R2(const Vector<coordinate_type, R2>& v1, const Vector<coordinate_type, R2>& v2) {
+    return v1.unchecked(X) * v2.unchecked(Y) - v1.unchecked(Y) * v2.unchecked(X);
+}
 
-float scaler_triple_product(const Vector3d& v1, const Vector3d& v2, const Vector3d& v3);
+template <class coordinate_type>
+constexpr Vector<coordinate_type, R3> cross_product_R3(const Vector<coordinate_type, R3>& v1, const Vector<coordinate_type, R3>& v2) {
+    return Vector<coordinate_type, R3>(v1.unchecked(Y) * v2.unchecked(Z) - v1.unchecked(Z) * v2.unchecked(Y),
+                                       v1.unchecked(Z) * v2.unchecked(X) - v1.unchecked(X) * v2.unchecked(Z),
+                                       v1.unchecked(X) * v2.unchecked(Y) - v1.unchecked(Y) * v2.unchecked(X));
+}
+
+template <class coordinate_type>
+constexpr coordinate_type scaler_triple_product(const Vector<coordinate_type, R3>& v1, const Vector<coordinate_type, R3>& v2,
+                                                const Vector<coordinate_type, R3>& v3) {
+    return dot_product(v1, cross_product_R3(v2, v3));
+}
 
-} // namespace GeomCore
\ No newline at end of file
+} // namespace GeomCore
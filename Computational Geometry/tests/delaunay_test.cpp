@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ConvexHull.hpp"
+#include "Delaunay.hpp"
+#include "Predicates.hpp"
+
+using namespace GeomCore;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+using edge_key = std::pair<uint32_t, uint32_t>;
+
+// Triangles rotated to start at their smallest index, then sorted
+static std::vector<IndexTriangle> canonical(std::vector<IndexTriangle> triangles) {
+    for (auto& t : triangles) {
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+static double signed_area(const std::vector<PointR2>& p, const std::vector<uint32_t>& ring) {
+    double area = 0.0;
+    for (size_t i = 0; i < ring.size(); ++i) {
+        const PointR2 &a = p[ring[i]], &b = p[ring[(i + 1) % ring.size()]];
+        area += a[X] * b[Y] - a[Y] * b[X];
+    }
+    return area / 2.0;
+}
+
+static double triangle_area(const std::vector<PointR2>& p, const IndexTriangle& t) {
+    return signed_area(p, {t[0], t[1], t[2]});
+}
+
+// Half-edges of a triangle list, each mapped to the corner opposite it
+static std::map<edge_key, uint32_t> half_edges(const std::vector<IndexTriangle>& triangles, bool& unique) {
+    std::map<edge_key, uint32_t> edges;
+    unique = true;
+    for (const auto& t : triangles) {
+        for (int k = 0; k < 3; ++k) {
+            unique = edges.emplace(edge_key{t[k], t[(k + 1) % 3]}, t[(k + 2) % 3]).second && unique;
+        }
+    }
+    return edges;
+}
+
+// Checks shared by every triangulation: counter-clockwise triangles, each
+// half-edge used once, and no unconstrained edge with its opposite corner
+// inside the circumcircle across it. For a triangulation of the whole point
+// set, every edge without a twin must be a hull edge and the triangles
+// must tile the convex hull.
+static void check_mesh(const std::vector<PointR2>& p, const std::vector<IndexTriangle>& triangles,
+                       const std::set<edge_key>& constraints, bool whole_hull, const char* what) {
+    bool ccw = true;
+    for (const auto& t : triangles) ccw = ccw && orient2d(p[t[0]], p[t[1]], p[t[2]]) > 0.0;
+    check(ccw, what);
+
+    bool unique = true;
+    auto edges = half_edges(triangles, unique);
+    check(unique, what);
+
+    bool locally_delaunay = true;
+    for (const auto& [e, c] : edges) {
+        auto twin = edges.find({e.second, e.first});
+        if (twin == edges.end()) continue;
+        if (constraints.count(e) || constraints.count({e.second, e.first})) continue;
+        locally_delaunay = locally_delaunay && incircle(p[e.first], p[e.second], p[c], p[twin->second]) <= 0.0;
+    }
+    check(locally_delaunay, what);
+
+    if (!whole_hull) return;
+    bool hull_edges = true;
+    for (const auto& [e, c] : edges) {
+        if (edges.count({e.second, e.first})) continue;
+        for (const auto& q : p) hull_edges = hull_edges && orient2d(p[e.first], p[e.second], q) >= 0.0;
+    }
+    check(hull_edges, what);
+
+    double area = 0.0;
+    for (const auto& t : triangles) area += triangle_area(p, t);
+    double hull = signed_area(p, convex_hull(p));
+    check(std::fabs(area - hull) <= 1e-9 * std::max(1.0, hull), what);
+}
+
+// Every triangle's circumcircle is empty of input points
+static void check_empty_circumcircles(const std::vector<PointR2>& p, const std::vector<IndexTriangle>& triangles,
+                                      const char* what) {
+    bool empty = true;
+    for (const auto& t : triangles) {
+        for (const auto& q : p) empty = empty && incircle(p[t[0]], p[t[1]], p[t[2]], q) <= 0.0;
+    }
+    check(empty, what);
+}
+
+// Every distinct point is a vertex, through the index of one of its copies
+static void check_vertices(const std::vector<PointR2>& p, const std::vector<IndexTriangle>& triangles,
+                           const char* what) {
+    std::set<uint32_t> used;
+    for (const auto& t : triangles) used.insert(t.begin(), t.end());
+    std::set<std::pair<double, double>> distinct, reached;
+    for (const auto& q : p) distinct.emplace(q[X], q[Y]);
+    for (uint32_t i : used) reached.emplace(p[i][X], p[i][Y]);
+    check(used.size() == distinct.size() && reached == distinct, what);
+}
+
+static void check_delaunay(const std::vector<PointR2>& p, const char* what) {
+    Delaunay serial;
+    serial.triangulate(p);
+    auto triangles = serial.triangles();
+    check(!triangles.empty(), what);
+    check_mesh(p, triangles, {}, true, what);
+    check_empty_circumcircles(p, triangles, what);
+    check_vertices(p, triangles, what);
+
+    for (unsigned threads : {2u, 4u, 7u}) {
+        Delaunay parallel;
+        parallel.triangulate_parallel(p.data(), p.size(), threads);
+        check(canonical(parallel.triangles()) == canonical(triangles), what);
+    }
+}
+
+static std::vector<PointR2> random_points(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+    std::vector<PointR2> p;
+    for (size_t i = 0; i < n; ++i) p.emplace_back(coordinate(rng), coordinate(rng));
+    return p;
+}
+
+static void random_inputs() {
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        check_delaunay(random_points(1500, seed), "random points triangulate to a Delaunay mesh");
+    }
+
+    // Duplicates of earlier points are triangulated once
+    auto p = random_points(600, 9);
+    for (size_t i = 0; i < 200; ++i) p.push_back(p[i * 3]);
+    check_delaunay(p, "points with duplicates triangulate once");
+}
+
+static void degenerate_inputs() {
+    // A grid is cocircular in every cell, and its rows and columns collinear
+    std::vector<PointR2> grid;
+    for (int x = 0; x < 30; ++x) {
+        for (int y = 0; y < 30; ++y) grid.emplace_back(x, y);
+    }
+    check_delaunay(grid, "grid triangulates to a Delaunay mesh");
+
+    // Points on one circle, exactly cocircular, plus its centre
+    std::vector<PointR2> circle{PointR2(0.0, 0.0)};
+    for (auto [x, y] : {std::pair(5.0, 0.0), {3.0, 4.0}, {0.0, 5.0}, {-3.0, 4.0}, {-4.0, 3.0}, {-5.0, 0.0},
+                        {-4.0, -3.0}, {0.0, -5.0}, {3.0, -4.0}, {4.0, -3.0}, {4.0, 3.0}, {-3.0, -4.0}}) {
+        circle.emplace_back(x, y);
+    }
+    check_delaunay(circle, "cocircular points triangulate to a Delaunay mesh");
+    circle.erase(circle.begin());
+    check_delaunay(circle, "cocircular points without centre triangulate to a Delaunay mesh");
+
+    // A line with one point off it
+    std::vector<PointR2> line;
+    for (int i = 0; i < 50; ++i) line.emplace_back(i, 2 * i);
+    Delaunay collinear;
+    collinear.triangulate(line);
+    check(collinear.triangles().empty(), "collinear points give no triangles");
+    Delaunay collinear_parallel;
+    collinear_parallel.triangulate_parallel(line.data(), line.size(), 4);
+    check(collinear_parallel.triangles().empty(), "collinear points give no triangles in parallel");
+    line.emplace_back(10.0, 0.0);
+    check_delaunay(line, "collinear points and one more triangulate to a Delaunay mesh");
+}
+
+// Whether the closed segments ab and cd share a point other than a common end
+static bool segments_touch(const PointR2& a, const PointR2& b, const PointR2& c, const PointR2& d) {
+    double abc = orient2d(a, b, c), abd = orient2d(a, b, d);
+    double cda = orient2d(c, d, a), cdb = orient2d(c, d, b);
+    if ((abc > 0 && abd > 0) || (abc < 0 && abd < 0) || (cda > 0 && cdb > 0) || (cda < 0 && cdb < 0)) return false;
+    bool shared_end = a == c || a == d || b == c || b == d;
+    if (abc == 0 && abd == 0) return true;   // collinear and overlapping in both projections
+    return !shared_end;
+}
+
+// A constraint is present if no mesh edge crosses it and its pieces, split
+// at the vertices on it, are all mesh edges
+static bool constraint_present(const std::vector<PointR2>& p, const std::map<edge_key, uint32_t>& edges,
+                               uint32_t a, uint32_t b) {
+    std::vector<std::pair<double, uint32_t>> on_segment;
+    PointR2 d = p[b] - p[a];
+    for (uint32_t i = 0; i < p.size(); ++i) {
+        if (orient2d(p[a], p[b], p[i]) != 0.0) continue;
+        double t = dot_product(p[i] - p[a], d);
+        if (t >= 0.0 && t <= dot_product(d, d)) on_segment.push_back({t, i});
+    }
+    std::sort(on_segment.begin(), on_segment.end());
+    for (size_t k = 0; k + 1 < on_segment.size(); ++k) {
+        uint32_t u = on_segment[k].second, w = on_segment[k + 1].second;
+        if (!edges.count({u, w}) && !edges.count({w, u})) return false;
+    }
+    return true;
+}
+
+// Constraint pieces between consecutive vertices on each segment
+static std::set<edge_key> constraint_pieces(const std::vector<PointR2>& p,
+                                            const std::vector<edge_key>& constraints) {
+    std::set<edge_key> pieces;
+    for (auto [a, b] : constraints) {
+        std::vector<std::pair<double, uint32_t>> on_segment;
+        PointR2 d = p[b] - p[a];
+        for (uint32_t i = 0; i < p.size(); ++i) {
+            if (orient2d(p[a], p[b], p[i]) != 0.0) continue;
+            double t = dot_product(p[i] - p[a], d);
+            if (t >= 0.0 && t <= dot_product(d, d)) on_segment.push_back({t, i});
+        }
+        std::sort(on_segment.begin(), on_segment.end());
+        for (size_t k = 0; k + 1 < on_segment.size(); ++k) {
+            pieces.insert({on_segment[k].second, on_segment[k + 1].second});
+        }
+    }
+    return pieces;
+}
+
+static void constrained_points() {
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        auto p = random_points(400, seed + 20);
+        // Add a column of points so that some constraints run through vertices
+        for (int i = 0; i < 9; ++i) p.emplace_back(0.25, -0.8 + 0.2 * i);
+
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(p.size() - 1));
+        std::vector<edge_key> constraints{{400, 408}};
+        while (constraints.size() < 25) {
+            uint32_t a = pick(rng), b = pick(rng);
+            if (a == b) continue;
+            bool clear = true;
+            for (auto [c, d] : constraints) clear = clear && !segments_touch(p[a], p[b], p[c], p[d]);
+            if (clear) constraints.push_back({a, b});
+        }
+
+        Delaunay mesh;
+        mesh.triangulate(p);
+        for (auto [a, b] : constraints) mesh.add_constraint(a, b);
+        auto triangles = mesh.triangles();
+
+        bool unique = true;
+        auto edges = half_edges(triangles, unique);
+        bool present = true;
+        for (auto [a, b] : constraints) present = present && constraint_present(p, edges, a, b);
+        check(present, "constraint edges are in the mesh");
+        check_mesh(p, triangles, constraint_pieces(p, constraints), true,
+                   "constrained mesh is Delaunay away from its constraints");
+    }
+
+    // A constraint crossing an earlier one is rejected
+    std::vector<PointR2> square{PointR2(0, 0), PointR2(1, 0), PointR2(1, 1), PointR2(0, 1)};
+    Delaunay mesh;
+    mesh.triangulate(square);
+    mesh.add_constraint(0, 2);
+    bool threw = false;
+    try {
+        mesh.add_constraint(1, 3);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    check(threw, "crossing constraint throws");
+}
+
+static void constrained_polygon() {
+    // A comb: a polygon with deep notches, and points inside its teeth
+    // Counter-clockwise, along the toothed bottom and back along the top
+    std::vector<PointR2> boundary;
+    for (int i = 0; i < 8; ++i) {
+        boundary.emplace_back(2.0 * i, 0.0);
+        boundary.emplace_back(2.0 * i + 1.0, 0.0);
+        boundary.emplace_back(2.0 * i + 1.0, 4.0);
+        boundary.emplace_back(2.0 * i + 2.0, 4.0);
+    }
+    boundary.back() = PointR2(16.0, 0.0);
+    boundary.emplace_back(16.0, 6.0);
+    boundary.emplace_back(0.0, 6.0);
+
+    std::vector<PointR2> interior;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> unit(0.05, 0.95);
+    for (int i = 0; i < 60; ++i) {
+        int tooth = i % 8;
+        interior.emplace_back(2.0 * tooth + unit(rng), 4.0 * unit(rng));
+    }
+
+    Delaunay mesh;
+    mesh.triangulate(PolygonR2(std::list<PointR2>(boundary.begin(), boundary.end())), interior);
+    auto triangles = mesh.triangles();
+
+    std::vector<PointR2> p = boundary;
+    p.insert(p.end(), interior.begin(), interior.end());
+    std::vector<uint32_t> ring_index(boundary.size());
+    for (uint32_t i = 0; i < ring_index.size(); ++i) ring_index[i] = i;
+
+    bool unique = true;
+    auto edges = half_edges(triangles, unique);
+    std::set<edge_key> sides;
+    bool present = true;
+    for (uint32_t i = 0; i < boundary.size(); ++i) {
+        uint32_t a = i, b = static_cast<uint32_t>((i + 1) % boundary.size());
+        present = present && (edges.count({a, b}) || edges.count({b, a}));
+        sides.insert({a, b});
+    }
+    check(present, "polygon sides are mesh edges");
+    check_mesh(p, triangles, sides, false, "polygon mesh is constrained Delaunay");
+
+    double area = 0.0;
+    for (const auto& t : triangles) area += triangle_area(p, t);
+    check(std::fabs(area - std::fabs(signed_area(p, ring_index))) < 1e-9, "polygon mesh tiles the polygon");
+    std::set<uint32_t> used;
+    for (const auto& t : triangles) used.insert(t.begin(), t.end());
+    check(used.size() == p.size(), "polygon mesh uses every boundary and interior point");
+}
+
+int main() {
+    random_inputs();
+    degenerate_inputs();
+    constrained_points();
+    constrained_polygon();
+    return failures == 0 ? 0 : 1;
+}
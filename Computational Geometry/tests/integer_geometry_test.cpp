@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "IntegerGeometry.hpp"
+#include "Predicates.hpp"
+
+using namespace GeomCore;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+template<typename T>
+static int sign(T value) {
+    return (value > 0) - (value < 0);
+}
+
+constexpr int64_t limit = integer_coordinate_limit;
+
+static PointR2 real(const PointZ2& p) {
+    return PointR2(static_cast<double>(p[X]), static_cast<double>(p[Y]));
+}
+
+static PointR3 real(const PointZ3& p) {
+    return PointR3(static_cast<double>(p[X]), static_cast<double>(p[Y]), static_cast<double>(p[Z]));
+}
+
+// Int256 against Int128 on operands small enough for Int128 to hold the
+// results, and on identities for wider ones
+static void wide_arithmetic() {
+    std::mt19937_64 rng(5);
+    std::uniform_int_distribution<int64_t> word(INT64_MIN, INT64_MAX);
+    bool products = true, sums = true, orders = true, doubles = true, identities = true;
+    for (int trial = 0; trial < 20000; ++trial) {
+        int shift = trial % 63;
+        Int128 a = word(rng) >> shift, b = word(rng) >> (62 - shift);
+        Int128 product = a * b;
+        products = products && Int256::product(a, b) == Int256(product);
+
+        Int128 c = static_cast<Int128>(word(rng)) << 40, d = static_cast<Int128>(word(rng)) << 40;
+        sums = sums && Int256(c) + Int256(d) == Int256(c + d) && Int256(c) - Int256(d) == Int256(c - d);
+        orders = orders && (Int256(c) <=> Int256(d)) == (c <=> d) && Int256(c - d).sign() == sign(c - d);
+        doubles = doubles && Int256(c).to_double() == static_cast<double>(c);
+
+        // Products of full 128-bit operands: (c + d) e = c e + d e, and
+        // negation commutes with the product
+        Int128 e = static_cast<Int128>(word(rng)) << 63;
+        identities = identities && Int256::product(c + d, e) == Int256::product(c, e) + Int256::product(d, e);
+        identities = identities && Int256::product(-c, e) == -Int256::product(c, e);
+        identities = identities && (Int256::product(c, e) - Int256::product(c, e)).sign() == 0;
+    }
+    check(products, "Int256 products match Int128");
+    check(sums, "Int256 sums and differences match Int128");
+    check(orders, "Int256 comparisons match Int128");
+    check(doubles, "Int256 to_double matches Int128");
+    check(identities, "Int256 products distribute over sums");
+
+    Int128 top = static_cast<Int128>(1) << 100;
+    check(Int256::product(top, top).to_double() == 0x1p200, "Int256 holds 2^200");
+    check(Int256::product(top, -top).to_double() == -0x1p200, "Int256 holds -2^200");
+    check(Int256::product(top, -top) < Int256::product(-top, -top), "Int256 orders wide values");
+}
+
+// Exact values against the same formulas in Int128 on small coordinates,
+// and signs against the floating-point predicates on large ones
+static void predicates() {
+    std::mt19937_64 rng(9);
+    bool small_values = true, signs2 = true, signs3 = true, circles = true;
+    for (int trial = 0; trial < 20000; ++trial) {
+        // Small grids give many collinear and cocircular quadruples
+        int64_t range = trial % 2 ? 4 : int64_t{1} << 20;
+        std::uniform_int_distribution<int64_t> small(-range, range);
+        PointZ2 a(small(rng), small(rng)), b(small(rng), small(rng)), c(small(rng), small(rng)),
+            d(small(rng), small(rng));
+        Int128 expected = static_cast<Int128>(b[X] - a[X]) * (c[Y] - a[Y]) -
+                          static_cast<Int128>(b[Y] - a[Y]) * (c[X] - a[X]);
+        small_values = small_values && orient2d(a, b, c) == expected;
+
+        auto lift = [&](const PointZ2& p) { return static_cast<Int128>(p[X] - d[X]) * (p[X] - d[X]) +
+                                                   static_cast<Int128>(p[Y] - d[Y]) * (p[Y] - d[Y]); };
+        auto cross = [&](const PointZ2& p, const PointZ2& q) {
+            return static_cast<Int128>(p[X] - d[X]) * (q[Y] - d[Y]) - static_cast<Int128>(p[Y] - d[Y]) * (q[X] - d[X]);
+        };
+        Int128 circle = lift(a) * cross(b, c) + lift(b) * cross(c, a) + lift(c) * cross(a, b);
+        small_values = small_values && incircle(a, b, c, d) == Int256(circle);
+        circles = circles && incircle(a, b, c, d).sign() == sign(incircle(real(a), real(b), real(c), real(d)));
+
+        // Coordinates up to 2^53 are exact doubles, so the collinear and
+        // coplanar points built from three draws stay below that
+        std::uniform_int_distribution<int64_t> large(-(int64_t{1} << 50), int64_t{1} << 50);
+        PointZ2 p(large(rng), large(rng)), q(large(rng), large(rng));
+        PointZ2 r = trial % 3 ? PointZ2(large(rng), large(rng)) : p + (q - p) * 2;
+        signs2 = signs2 && sign(orient2d(p, q, r)) == sign(orient2d(real(p), real(q), real(r)));
+        PointZ2 s(large(rng), large(rng));
+        circles = circles && incircle(p, q, r, s).sign() == sign(incircle(real(p), real(q), real(r), real(s)));
+
+        PointZ3 u(large(rng), large(rng), large(rng)), v(large(rng), large(rng), large(rng)),
+            w(large(rng), large(rng), large(rng));
+        PointZ3 x = trial % 3 ? PointZ3(large(rng), large(rng), large(rng)) : u + (v - u) * 2 - (w - u);
+        signs3 = signs3 && orient3d(u, v, w, x).sign() == sign(orient3d(real(u), real(v), real(w), real(x)));
+    }
+    check(small_values, "orient2d and incircle match Int128 on small coordinates");
+    check(signs2, "orient2d signs match the floating-point predicate");
+    check(signs3, "orient3d signs match the floating-point predicate");
+    check(circles, "incircle signs match the floating-point predicate");
+}
+
+// Points at the corners of the coordinate range
+static void extremes() {
+    PointZ2 a(-limit, -limit), b(limit, -limit), c(limit, limit), d(-limit, limit);
+    check(in_integer_range(a) && in_integer_range(c), "corners are in range");
+    check(!in_integer_range(PointZ2(limit + 1, 0)) && !in_integer_range(PointZ3(0, 0, -limit - 1)),
+          "points past the limit are out of range");
+
+    check(orient2d(a, b, c) == static_cast<Int128>(2 * limit) * (2 * limit), "orient2d at the limit is exact");
+    check(orient2d(a, c, b) == -orient2d(a, b, c), "orient2d flips with the order");
+    check(orient2d(a, c, PointZ2(0, 0)) == 0, "orient2d sees collinear points at the limit");
+    check(incircle(a, b, c, d).sign() == 0, "square corners are cocircular");
+    check(incircle(a, b, c, PointZ2(0, 0)).sign() > 0, "centre is inside the circle");
+    check(incircle(a, b, c, PointZ2(limit, limit - 1)).sign() > 0, "point just inside the circle");
+    check(incircle(a, c, b, PointZ2(0, 0)).sign() < 0, "incircle flips for clockwise points");
+    check(incircle(a, b, PointZ2(limit, limit - 1), PointZ2(-limit, limit)).sign() < 0,
+          "point just outside the circle");
+    check(squared_distance(a, c) == static_cast<Int128>(8) * limit * limit, "squared distance at the limit");
+
+    PointZ3 o(-limit, -limit, -limit), e(limit, -limit, -limit), f(-limit, limit, -limit), g(-limit, -limit, limit);
+    Int256 volume = orient3d(o, e, f, g);
+    check(volume.sign() == sign(orient3d(real(o), real(e), real(f), real(g))), "orient3d sign at the limit");
+    check(std::fabs(volume.to_double()) == 0x1p186, "orient3d at the limit is exact");
+    check(orient3d(o, e, f, PointZ3(limit, limit, -limit)).sign() == 0, "orient3d sees coplanar points");
+}
+
+// Substituting a rational point into a segment's line, and its position
+// between the segment's ends; exact in doubles for these small coordinates
+static bool on_segment(const RationalPoint2& p, const PointZ2& a, const PointZ2& b) {
+    double x = p.x.to_double(), y = p.y.to_double(), w = static_cast<double>(p.denominator);
+    double dx = static_cast<double>(b[X] - a[X]), dy = static_cast<double>(b[Y] - a[Y]);
+    bool line = dx * (y - a[Y] * w) == dy * (x - a[X] * w);
+    bool between = std::min(a[X], b[X]) * w <= x && x <= std::max(a[X], b[X]) * w &&
+                   std::min(a[Y], b[Y]) * w <= y && y <= std::max(a[Y], b[Y]) * w;
+    return p.denominator > 0 && line && between;
+}
+
+static bool on_segment(const PointZ2& p, const PointZ2& a, const PointZ2& b) {
+    return on_segment(RationalPoint2{Int128{p[X]}, Int128{p[Y]}, 1}, a, b);
+}
+
+// The crossing of ab and cd, worked out from cd's side: it must be the
+// same rational as segment_intersection found from ab's side
+static bool crosses_second(const IntegerSegmentIntersection& found, const PointZ2& a, const PointZ2& b,
+                           const PointZ2& c, const PointZ2& d) {
+    Int128 numerator = orient2d(a, b, c), denominator = numerator - orient2d(a, b, d);
+    if (denominator < 0) {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+    PointZ2 direction = d - c;
+    return denominator != 0 && found.point.denominator == denominator &&
+           found.point.x == Int256::product(c[X], denominator) + Int256::product(numerator, direction[X]) &&
+           found.point.y == Int256::product(c[Y], denominator) + Int256::product(numerator, direction[Y]);
+}
+
+// Whether the closed segments meet, by the floating-point predicates
+static bool meet(const PointZ2& a, const PointZ2& b, const PointZ2& c, const PointZ2& d) {
+    double o1 = orient2d(real(a), real(b), real(c)), o2 = orient2d(real(a), real(b), real(d));
+    double o3 = orient2d(real(c), real(d), real(a)), o4 = orient2d(real(c), real(d), real(b));
+    if (o1 * o2 < 0 && o3 * o4 < 0) return true;
+    return (o1 == 0 && on_segment(c, a, b)) || (o2 == 0 && on_segment(d, a, b)) ||
+           (o3 == 0 && on_segment(a, c, d)) || (o4 == 0 && on_segment(b, c, d));
+}
+
+static void segments() {
+    std::mt19937_64 rng(13);
+    bool contact = true, points = true, overlaps = true, symmetric = true;
+    size_t crossings = 0, overlapping = 0;
+    for (int trial = 0; trial < 50000; ++trial) {
+        // Tiny grids give collinear, overlapping, touching and point segments
+        int64_t range = trial % 2 ? 3 : 1000;
+        std::uniform_int_distribution<int64_t> coordinate(-range, range);
+        PointZ2 a(coordinate(rng), coordinate(rng)), b(coordinate(rng), coordinate(rng)),
+            c(coordinate(rng), coordinate(rng)), d(coordinate(rng), coordinate(rng));
+        auto found = segment_intersection(a, b, c, d);
+        contact = contact && (found.contact != SegmentContact::None) == meet(a, b, c, d) &&
+                  intersection(a, b, c, d) == meet(a, b, c, d);
+        symmetric = symmetric && segment_intersection(c, d, a, b).contact == found.contact;
+
+        if (found.contact == SegmentContact::Point) {
+            points = points && on_segment(found.point, a, b) && on_segment(found.point, c, d);
+            ++crossings;
+        } else if (found.contact == SegmentContact::Overlap) {
+            // The overlap runs between points on both segments, and the
+            // segments share nothing beyond it
+            bool ordered = found.first[X] < found.last[X] ||
+                           (found.first[X] == found.last[X] && found.first[Y] < found.last[Y]);
+            overlaps = overlaps && ordered && on_segment(found.first, a, b) && on_segment(found.first, c, d) &&
+                       on_segment(found.last, a, b) && on_segment(found.last, c, d);
+            for (const PointZ2& end : {a, b, c, d}) {
+                bool on_both = on_segment(end, a, b) && on_segment(end, c, d);
+                overlaps = overlaps && on_both == on_segment(end, found.first, found.last);
+            }
+            ++overlapping;
+        }
+    }
+    check(contact, "segment_intersection finds the same contacts as the floating-point predicates");
+    check(symmetric, "segment_intersection does not depend on the order of the segments");
+    check(points, "intersection points lie on both segments");
+    check(overlaps, "overlaps are the shared piece of both segments");
+    check(crossings > 1000 && overlapping > 100, "random segments include crossings and overlaps");
+
+    // Diagonals of the full range cross at the origin; nearly parallel
+    // long segments cross at a point no double holds
+    auto centre = segment_intersection(PointZ2(-limit, -limit), PointZ2(limit, limit), PointZ2(-limit, limit),
+                                       PointZ2(limit, -limit));
+    check(centre.contact == SegmentContact::Point && centre.point.x.sign() == 0 && centre.point.y.sign() == 0,
+          "diagonals at the limit cross at the origin");
+    PointZ2 a(-limit, -limit), b(limit, limit - 1), c(-limit, -limit + 1), d(limit, limit - 3);
+    auto close = segment_intersection(a, b, c, d);
+    check(close.contact == SegmentContact::Point && crosses_second(close, a, b, c, d),
+          "nearly parallel segments at the limit cross exactly");
+
+    // Random crossings over the whole range, with coordinates that are
+    // still exact doubles
+    std::uniform_int_distribution<int64_t> large(-limit, limit);
+    auto draw = [&] { return PointZ2(large(rng) & ~int64_t{0xff}, large(rng) & ~int64_t{0xff}); };
+    bool agree = true, exact = true;
+    for (int trial = 0; trial < 20000; ++trial) {
+        PointZ2 p = draw(), q = draw(), r = draw(), t = draw();
+        auto found = segment_intersection(p, q, r, t);
+        double o1 = orient2d(real(p), real(q), real(r)), o2 = orient2d(real(p), real(q), real(t));
+        double o3 = orient2d(real(r), real(t), real(p)), o4 = orient2d(real(r), real(t), real(q));
+        agree = agree && (found.contact == SegmentContact::Point) == (o1 * o2 < 0 && o3 * o4 < 0);
+        if (found.contact == SegmentContact::Point) exact = exact && crosses_second(found, p, q, r, t);
+    }
+    check(agree, "segments over the whole range cross as the floating-point predicates say");
+    check(exact, "crossings over the whole range lie on both lines");
+
+    auto collinear = segment_intersection(PointZ2(-limit, 0), PointZ2(limit, 0), PointZ2(limit, 0),
+                                          PointZ2(0, 0));
+    check(collinear.contact == SegmentContact::Overlap && collinear.first == PointZ2(0, 0) &&
+              collinear.last == PointZ2(limit, 0),
+          "collinear segments at the limit overlap");
+    auto touching = segment_intersection(PointZ2(-limit, 0), PointZ2(0, 0), PointZ2(0, 0), PointZ2(limit, 0));
+    check(touching.contact == SegmentContact::Point && touching.point.x.sign() == 0,
+          "collinear segments touching end to end meet at a point");
+    check(!intersection(PointZ2(-limit, 0), PointZ2(-1, 0), PointZ2(0, 0), PointZ2(limit, 0)),
+          "collinear segments with a gap do not meet");
+    check(intersection(PointZ2(5, 5), PointZ2(5, 5), PointZ2(0, 0), PointZ2(10, 10)) &&
+              !intersection(PointZ2(5, 6), PointZ2(5, 6), PointZ2(0, 0), PointZ2(10, 10)),
+          "point segments meet only segments through them");
+}
+
+int main() {
+    wide_arithmetic();
+    predicates();
+    extremes();
+    segments();
+    return failures == 0 ? 0 : 1;
+}
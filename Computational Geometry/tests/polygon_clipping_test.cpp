@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "PolygonClipping.hpp"
+#include "Predicates.hpp"
+
+using namespace GeomCore;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+constexpr std::array<BooleanOperation, 4> operations{BooleanOperation::Union, BooleanOperation::Intersection,
+                                                     BooleanOperation::Difference,
+                                                     BooleanOperation::SymmetricDifference};
+
+static double signed_area(const PointR2* ring, size_t n) {
+    double area = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const PointR2& p = ring[i];
+        const PointR2& q = ring[(i + 1) % n];
+        area += p[X] * q[Y] - q[X] * p[Y];
+    }
+    return area / 2.0;
+}
+
+// Sum of the signed ring areas, which is the area of a result whose holes
+// run clockwise
+static double area(const RingSet& rings) {
+    double total = 0.0;
+    for (size_t k = 0; k < rings.ring_count(); ++k) total += signed_area(rings.ring(k), rings.ring_size(k));
+    return total;
+}
+
+// Even-odd membership of a point on no edge
+static bool inside(const RingSet& rings, const PointR2& p) {
+    bool in = false;
+    for (size_t k = 0; k < rings.ring_count(); ++k) {
+        const PointR2* ring = rings.ring(k);
+        size_t n = rings.ring_size(k);
+        for (size_t i = 0, j = n - 1; i < n; j = i++) {
+            const PointR2& a = ring[i];
+            const PointR2& b = ring[j];
+            if ((a[Y] > p[Y]) != (b[Y] > p[Y]) && p[X] < (b[X] - a[X]) * (p[Y] - a[Y]) / (b[Y] - a[Y]) + a[X]) {
+                in = !in;
+            }
+        }
+    }
+    return in;
+}
+
+static bool expected_inside(BooleanOperation op, bool in_a, bool in_b) {
+    switch (op) {
+        case BooleanOperation::Union: return in_a || in_b;
+        case BooleanOperation::Intersection: return in_a && in_b;
+        case BooleanOperation::Difference: return in_a && !in_b;
+        case BooleanOperation::SymmetricDifference: return in_a != in_b;
+    }
+    return false;
+}
+
+// Rings have at least three vertices and none where the boundary goes
+// straight on
+static bool well_formed(const RingSet& rings) {
+    for (size_t k = 0; k < rings.ring_count(); ++k) {
+        const PointR2* ring = rings.ring(k);
+        size_t n = rings.ring_size(k);
+        if (n < 3) return false;
+        for (size_t i = 0; i < n; ++i) {
+            if (orient2d(ring[i], ring[(i + 1) % n], ring[(i + 2) % n]) == 0.0) return false;
+        }
+    }
+    return true;
+}
+
+static bool same_rings(const RingSet& a, const RingSet& b) {
+    return a.points == b.points && a.offsets == b.offsets;
+}
+
+// Checks all four operations on a pair: membership on a sample grid whose
+// points avoid the integer lattice, the area identities between the
+// results, and the ring shapes
+static void check_pair(const RingSet& a, const RingSet& b, const char* what) {
+    PolygonClipper clipper;
+    std::array<RingSet, 4> result;
+    for (size_t i = 0; i < operations.size(); ++i) result[i] = clipper.compute(a, b, operations[i]);
+
+    double lo = 1e300, hi = -1e300;
+    for (const RingSet* rings : {&a, &b}) {
+        for (const PointR2& p : rings->points) {
+            lo = std::min({lo, p[X], p[Y]});
+            hi = std::max({hi, p[X], p[Y]});
+        }
+    }
+    bool membership = true;
+    constexpr int samples = 97;
+    for (int i = 0; i < samples && membership; ++i) {
+        for (int j = 0; j < samples && membership; ++j) {
+            PointR2 p(lo - 0.5 + (hi - lo + 1.0) * (i + 0.3183) / samples,
+                      lo - 0.5 + (hi - lo + 1.0) * (j + 0.7071) / samples);
+            bool in_a = inside(a, p), in_b = inside(b, p);
+            for (size_t k = 0; k < operations.size(); ++k) {
+                membership = membership && inside(result[k], p) == expected_inside(operations[k], in_a, in_b);
+            }
+        }
+    }
+    check(membership, what);
+
+    double u = area(result[0]), n = area(result[1]), d = area(result[2]), x = area(result[3]);
+    double reverse = area(clipper.compute(b, a, BooleanOperation::Difference));
+    double tolerance = 1e-9 * std::max(1.0, u);
+    check(u >= -tolerance && n >= -tolerance && d >= -tolerance && x >= -tolerance, what);
+    check(std::fabs(u - (d + reverse + n)) <= tolerance, what);
+    check(std::fabs(x - (d + reverse)) <= tolerance, what);
+
+    bool shapes = true;
+    for (const RingSet& rings : result) shapes = shapes && well_formed(rings);
+    check(shapes, what);
+}
+
+// Simple polygon through random integer points sorted by angle about a
+// centre, counter-clockwise; redrawn until every edge turns left about the
+// centre, so the centre sees the whole ring
+static std::vector<PointR2> star_polygon(std::mt19937& rng, int cx, int cy, int radius, size_t n) {
+    std::uniform_int_distribution<int> offset(-radius, radius);
+    PointR2 c(cx, cy);
+    std::vector<PointR2> ring;
+    for (bool star = false; !star;) {
+        ring.clear();
+        while (ring.size() < n) {
+            PointR2 p(cx + offset(rng), cy + offset(rng));
+            bool repeated = p == c;
+            for (const PointR2& q : ring) repeated = repeated || orient2d(c, p, q) == 0.0;
+            if (!repeated) ring.push_back(p);
+        }
+        std::sort(ring.begin(), ring.end(), [&](const PointR2& p, const PointR2& q) {
+            return std::atan2(p[Y] - cy, p[X] - cx) < std::atan2(q[Y] - cy, q[X] - cx);
+        });
+        star = true;
+        for (size_t i = 0; i < n; ++i) star = star && orient2d(c, ring[i], ring[(i + 1) % n]) > 0.0;
+    }
+    return ring;
+}
+
+static RingSet box(double x0, double y0, double x1, double y1) {
+    RingSet rings;
+    rings.add_ring({PointR2(x0, y0), PointR2(x1, y0), PointR2(x1, y1), PointR2(x0, y1)});
+    return rings;
+}
+
+static void random_pairs(std::vector<RingSet>& a, std::vector<RingSet>& b) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> centre(-3, 3);
+    std::uniform_int_distribution<size_t> size(3, 12);
+    for (int trial = 0; trial < 60; ++trial) {
+        RingSet first, second;
+        auto ring = star_polygon(rng, centre(rng), centre(rng), 8, size(rng));
+        first.add_ring(ring);
+        second.add_ring(star_polygon(rng, centre(rng), centre(rng), 8, size(rng)));
+        // Every third first operand gets a clockwise square hole
+        if (trial % 3 == 0) {
+            PointR2 c(centre(rng), centre(rng));
+            std::vector<PointR2> hole{c + PointR2(-1, -1), c + PointR2(-1, 1), c + PointR2(1, 1), c + PointR2(1, -1)};
+            bool contained = true;
+            for (const PointR2& p : hole) contained = contained && inside(first, p);
+            if (contained) first.add_ring(hole);
+        }
+        check_pair(first, second, "random polygons match point membership");
+        if (first.ring_count() == 1) {
+            PolygonClipper clipper;
+            double total = area(clipper.compute(first, second, BooleanOperation::Difference)) +
+                           area(clipper.compute(first, second, BooleanOperation::Intersection));
+            check(std::fabs(total - signed_area(ring.data(), ring.size())) <= 1e-9,
+                  "difference and intersection partition the first operand");
+        }
+        a.push_back(std::move(first));
+        b.push_back(std::move(second));
+    }
+}
+
+static void degenerate_pairs(std::vector<RingSet>& a, std::vector<RingSet>& b) {
+    auto add = [&](const RingSet& first, const RingSet& second, const char* what) {
+        check_pair(first, second, what);
+        a.push_back(first);
+        b.push_back(second);
+    };
+    PolygonClipper clipper;
+
+    // Squares sharing a whole edge merge into one rectangle
+    RingSet left = box(0, 0, 2, 2), right = box(2, 0, 4, 2);
+    add(left, right, "squares sharing an edge");
+    RingSet merged = clipper.compute(left, right, BooleanOperation::Union);
+    check(merged.ring_count() == 1 && merged.ring_size(0) == 4 && area(merged) == 8.0,
+          "union across a shared edge is one rectangle");
+    check(clipper.compute(left, right, BooleanOperation::Intersection).empty(),
+          "squares sharing an edge have an empty intersection");
+
+    // Partly overlapping collinear edges, touching at a corner, and nested
+    add(box(0, 0, 4, 2), box(1, 2, 6, 5), "boxes overlapping along part of an edge");
+    add(box(0, 0, 2, 2), box(2, 2, 4, 4), "boxes touching at a corner");
+    add(box(0, 0, 6, 6), box(1, 1, 3, 3), "nested boxes");
+    add(box(0, 0, 6, 6), box(0, 0, 3, 6), "boxes sharing three edges");
+
+    // Identical operands, one given clockwise
+    RingSet square = box(0, 0, 3, 3), clockwise;
+    clockwise.add_ring({PointR2(0, 0), PointR2(0, 3), PointR2(3, 3), PointR2(3, 0)});
+    add(square, clockwise, "identical squares with opposite orientation");
+    check(area(clipper.compute(square, clockwise, BooleanOperation::Intersection)) == 9.0,
+          "identical squares intersect in the square");
+    check(clipper.compute(square, clockwise, BooleanOperation::SymmetricDifference).empty(),
+          "identical squares have an empty symmetric difference");
+
+    // A square with a hole against a square filling the hole exactly
+    RingSet frame = box(0, 0, 6, 6);
+    frame.add_ring({PointR2(2, 2), PointR2(2, 4), PointR2(4, 4), PointR2(4, 2)});
+    add(frame, box(2, 2, 4, 4), "square filling a hole");
+    RingSet filled = clipper.compute(frame, box(2, 2, 4, 4), BooleanOperation::Union);
+    check(filled.ring_count() == 1 && area(filled) == 36.0, "filling a hole leaves one ring");
+
+    // Input vertices where the boundary goes straight on, and an empty operand
+    RingSet straight;
+    straight.add_ring({PointR2(0, 0), PointR2(1, 0), PointR2(2, 0), PointR2(2, 2), PointR2(0, 2)});
+    add(straight, box(1, 1, 3, 3), "operand with a straight vertex");
+    add(box(0, 0, 1, 1), RingSet{}, "empty second operand");
+    check(clipper.compute(RingSet{}, box(0, 0, 1, 1), BooleanOperation::Intersection).empty(),
+          "intersection with an empty operand is empty");
+}
+
+// The batch form gives what one PolygonClipper gives pair by pair
+static void batch_matches_serial(const std::vector<RingSet>& a, const std::vector<RingSet>& b) {
+    PolygonClipper clipper;
+    for (BooleanOperation op : operations) {
+        std::vector<RingSet> serial;
+        for (size_t i = 0; i < a.size(); ++i) serial.push_back(clipper.compute(a[i], b[i], op));
+        for (unsigned threads : {1u, 4u}) {
+            std::vector<RingSet> batch;
+            boolean_operation(a, b, op, batch, threads);
+            bool same = batch.size() == serial.size();
+            for (size_t i = 0; same && i < serial.size(); ++i) same = same_rings(batch[i], serial[i]);
+            check(same, "batch boolean_operation matches serial");
+        }
+    }
+
+    bool threw = false;
+    std::vector<RingSet> out;
+    try {
+        boolean_operation(a, std::vector<RingSet>(1), BooleanOperation::Union, out);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    check(threw, "operand lists of different sizes throw");
+}
+
+int main() {
+    std::vector<RingSet> a, b;
+    random_pairs(a, b);
+    degenerate_pairs(a, b);
+    batch_matches_serial(a, b);
+    return failures == 0 ? 0 : 1;
+}
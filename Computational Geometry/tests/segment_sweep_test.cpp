@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "Predicates.hpp"
+#include "SegmentIntersection.hpp"
+
+using namespace GeomCore;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+using segment_pair = std::pair<uint32_t, uint32_t>;
+
+// Whether the closed segments share a point, by exact orientations
+static bool meet(const SegmentR2& s, const SegmentR2& t) {
+    auto within = [](const PointR2& a, const PointR2& b, const PointR2& p) {
+        return std::min(a[X], b[X]) <= p[X] && p[X] <= std::max(a[X], b[X]) &&
+               std::min(a[Y], b[Y]) <= p[Y] && p[Y] <= std::max(a[Y], b[Y]);
+    };
+    double o1 = orient2d(s[0], s[1], t[0]), o2 = orient2d(s[0], s[1], t[1]);
+    double o3 = orient2d(t[0], t[1], s[0]), o4 = orient2d(t[0], t[1], s[1]);
+    if (((o1 > 0 && o2 < 0) || (o1 < 0 && o2 > 0)) && ((o3 > 0 && o4 < 0) || (o3 < 0 && o4 > 0))) return true;
+    return (o1 == 0 && within(s[0], s[1], t[0])) || (o2 == 0 && within(s[0], s[1], t[1])) ||
+           (o3 == 0 && within(t[0], t[1], s[0])) || (o4 == 0 && within(t[0], t[1], s[1]));
+}
+
+static std::set<segment_pair> brute_force(const std::vector<SegmentR2>& segments) {
+    std::set<segment_pair> pairs;
+    for (uint32_t i = 0; i < segments.size(); ++i) {
+        for (uint32_t j = i + 1; j < segments.size(); ++j) {
+            if (meet(segments[i], segments[j])) pairs.insert({i, j});
+        }
+    }
+    return pairs;
+}
+
+static double distance_to_segment(const PointR2& p, const SegmentR2& s) {
+    PointR2 d = s[1] - s[0];
+    double length = dot_product(d, d);
+    double t = length > 0.0 ? std::clamp(dot_product(p - s[0], d) / length, 0.0, 1.0) : 0.0;
+    return (p - (s[0] + d * t)).magnitude();
+}
+
+static void check_sweep(const std::vector<SegmentR2>& segments, const char* what) {
+    auto expected = brute_force(segments);
+    SegmentSweep sweep;
+    auto found = sweep.intersections(segments);
+
+    std::set<segment_pair> pairs;
+    bool on_segments = true, ascending = true;
+    for (const auto& meeting : found) {
+        const auto& s = meeting.segments;
+        ascending = ascending && s.size() >= 2 && std::is_sorted(s.begin(), s.end()) &&
+                    std::adjacent_find(s.begin(), s.end()) == s.end();
+        for (size_t i = 0; i < s.size(); ++i) {
+            on_segments = on_segments && distance_to_segment(meeting.point, segments[s[i]]) <= 1e-12;
+            for (size_t j = i + 1; j < s.size(); ++j) pairs.insert({s[i], s[j]});
+        }
+    }
+    check(pairs == expected, what);
+    check(on_segments, what);
+    check(ascending, what);
+
+    // No point reported twice
+    std::set<std::pair<double, double>> points;
+    for (const auto& meeting : found) points.emplace(meeting.point[X], meeting.point[Y]);
+    check(points.size() == found.size(), what);
+
+    // The flat form reports the same points in the same order
+    std::vector<PointR2> flat_points;
+    std::vector<uint32_t> offsets, meeting_segments;
+    sweep.intersections(segments.data(), segments.size(), flat_points, offsets, meeting_segments);
+    bool flat = flat_points.size() == found.size() && offsets.size() == found.size() + 1;
+    for (size_t k = 0; flat && k < found.size(); ++k) {
+        std::vector<uint32_t> s(meeting_segments.begin() + offsets[k], meeting_segments.begin() + offsets[k + 1]);
+        flat = flat_points[k] == found[k].point && s == found[k].segments;
+    }
+    check(flat, what);
+
+    std::array<uint32_t, 2> witness{};
+    bool any = sweep.any_intersection(segments.data(), segments.size(), &witness);
+    check(any == !expected.empty(), what);
+    if (any) check(expected.count({std::min(witness[0], witness[1]), std::max(witness[0], witness[1])}) > 0, what);
+}
+
+static void random_segments() {
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> coordinate(-1.0, 1.0), length(0.0, 0.3);
+        std::vector<SegmentR2> segments;
+        for (int i = 0; i < 400; ++i) {
+            PointR2 a(coordinate(rng), coordinate(rng));
+            PointR2 b(a[X] + length(rng) - 0.15, a[Y] + length(rng) - 0.15);
+            segments.push_back({a, b});
+        }
+        check_sweep(segments, "random segments match brute force");
+    }
+}
+
+static void degenerate_segments() {
+    // Integer segments on a small grid: shared endpoints, T-junctions,
+    // collinear overlaps, vertical and horizontal segments, many through
+    // one point
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> coordinate(0, 6);
+    std::vector<SegmentR2> grid;
+    while (grid.size() < 150) {
+        PointR2 a(coordinate(rng), coordinate(rng)), b(coordinate(rng), coordinate(rng));
+        if (a != b) grid.push_back({a, b});
+    }
+    check_sweep(grid, "grid segments match brute force");
+
+    // A star of segments all crossing at the origin, with copies of some
+    std::vector<SegmentR2> star;
+    for (int k = -4; k <= 4; ++k) {
+        star.push_back({PointR2(-4.0, k), PointR2(4.0, -k)});
+        star.push_back({PointR2(k, -4.0), PointR2(-k, 4.0)});
+    }
+    star.push_back(star[3]);
+    check_sweep(star, "concurrent segments match brute force");
+
+    // Collinear chains: overlapping, nested and end-to-end
+    std::vector<SegmentR2> chain{{PointR2(0, 0), PointR2(4, 4)}, {PointR2(1, 1), PointR2(2, 2)},
+                                 {PointR2(4, 4), PointR2(6, 6)}, {PointR2(3, 3), PointR2(5, 5)},
+                                 {PointR2(0, 2), PointR2(0, 5)}, {PointR2(0, 3), PointR2(0, 4)},
+                                 {PointR2(-1, 1), PointR2(1, -1)}};
+    check_sweep(chain, "collinear segments match brute force");
+
+    check_sweep({{PointR2(0, 0), PointR2(1, 0)}, {PointR2(2, 0), PointR2(3, 1)}},
+                "disjoint segments have no intersections");
+}
+
+// A polygon is simple if no two edges meet except consecutive ones at
+// their shared vertex
+static bool brute_force_simple(const std::vector<PointR2>& ring) {
+    size_t n = ring.size();
+    if (n < 3) return false;
+    for (size_t i = 0; i < n; ++i) {
+        SegmentR2 s{ring[i], ring[(i + 1) % n]};
+        for (size_t j = i + 1; j < n; ++j) {
+            SegmentR2 t{ring[j], ring[(j + 1) % n]};
+            bool consecutive = j == i + 1 || (i == 0 && j == n - 1);
+            if (!consecutive) {
+                if (meet(s, t)) return false;
+                continue;
+            }
+            // Consecutive edges may share only their common vertex
+            const PointR2& shared = j == i + 1 ? ring[j] : ring[i];
+            const PointR2& far_s = j == i + 1 ? s[0] : s[1];
+            const PointR2& far_t = j == i + 1 ? t[1] : t[0];
+            if (orient2d(far_s, shared, far_t) == 0.0 &&
+                dot_product(far_s - shared, far_t - shared) > 0.0) return false;
+            if (far_s == far_t) return false;
+        }
+    }
+    return true;
+}
+
+static void simple_polygons() {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> coordinate(0, 5);
+    size_t agree = 0, simple = 0, total = 0;
+    for (int trial = 0; trial < 3000; ++trial) {
+        std::vector<PointR2> ring(3 + trial % 5);
+        for (auto& p : ring) p = PointR2(coordinate(rng), coordinate(rng));
+        bool expected = brute_force_simple(ring);
+        agree += is_simple_polygon(ring) == expected;
+        simple += expected;
+        ++total;
+    }
+    check(agree == total, "is_simple_polygon matches brute force");
+    check(simple > 100 && simple < total, "random rings include simple and non-simple ones");
+
+    // A star-shaped ring sorted by angle is simple; pinching it is not
+    std::vector<PointR2> star;
+    for (int k = 0; k < 64; ++k) {
+        double angle = 2.0 * 3.141592653589793 * k / 64, radius = k % 2 ? 1.0 : 2.0;
+        star.emplace_back(radius * std::cos(angle), radius * std::sin(angle));
+    }
+    check(is_simple_polygon(star), "star-shaped ring is simple");
+    star[10] = star[40];
+    check(!is_simple_polygon(star), "ring through one point twice is not simple");
+}
+
+int main() {
+    random_segments();
+    degenerate_segments();
+    simple_polygons();
+    return failures == 0 ? 0 : 1;
+}
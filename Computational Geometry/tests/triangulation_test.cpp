@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Predicates.hpp"
+#include "RingSet.hpp"
+#include "Triangulation.hpp"
+
+using namespace GeomCore;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+// Twice the signed area, exact for the integer coordinates used here
+static double twice_area(const PointR2* ring, size_t n) {
+    double area = 0.0;
+    for (size_t i = 0, j = n - 1; i < n; j = i++) area += ring[j][X] * ring[i][Y] - ring[i][X] * ring[j][Y];
+    return area;
+}
+
+// Vertices left once repeated consecutive ones are dropped, across the
+// seam as well
+static size_t distinct_vertices(const PointR2* ring, size_t n) {
+    size_t m = 0;
+    for (size_t i = 0; i < n; ++i) m += ring[i] != ring[(i + 1) % n];
+    return n > 0 && m == 0 ? 1 : m;
+}
+
+// Simple polygon through random integer points sorted by angle about a
+// centre that sees the whole ring, in either orientation
+static std::vector<PointR2> star_polygon(std::mt19937& rng, size_t n, bool clockwise) {
+    std::uniform_int_distribution<int> offset(-1000, 1000);
+    PointR2 c(0, 0);
+    std::vector<PointR2> ring;
+    for (bool star = false; !star;) {
+        ring.clear();
+        while (ring.size() < n) {
+            PointR2 p(offset(rng), offset(rng));
+            bool repeated = p == c;
+            for (const PointR2& q : ring) repeated = repeated || orient2d(c, p, q) == 0.0;
+            if (!repeated) ring.push_back(p);
+        }
+        std::sort(ring.begin(), ring.end(), [](const PointR2& p, const PointR2& q) {
+            return std::atan2(p[Y], p[X]) < std::atan2(q[Y], q[X]);
+        });
+        star = true;
+        for (size_t i = 0; i < n; ++i) star = star && orient2d(c, ring[i], ring[(i + 1) % n]) > 0.0;
+    }
+    if (clockwise) std::reverse(ring.begin(), ring.end());
+    return ring;
+}
+
+// Rectangle whose top edge zigzags by dy, straight when dy = 0, and whose
+// bottom edge has a vertex under every top vertex; many split, merge and
+// collinear vertices
+static std::vector<PointR2> zigzag(int teeth, int dy) {
+    std::vector<PointR2> ring;
+    for (int t = 0; t <= 2 * teeth; ++t) ring.emplace_back(t, 0);
+    ring.emplace_back(2 * teeth, 10);
+    for (int t = 2 * teeth - 1; t > 0; --t) ring.emplace_back(t, t % 2 ? 10 + dy : 10 - dy);
+    ring.emplace_back(0, 10);
+    return ring;
+}
+
+// A mix of random stars, zigzags, collinear and tiny rings, repeated
+// vertices and rings closed by repeating their first point
+static RingSet polygon_batch(size_t count) {
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<size_t> size(3, 40);
+    RingSet batch;
+    for (size_t k = 0; k < count; ++k) {
+        std::vector<PointR2> ring;
+        switch (k % 10) {
+            case 0: ring = zigzag(2 + k % 7, k % 3 == 0 ? 5 : 0); break;
+            case 1: ring = {PointR2(0, 0), PointR2(1, 1), PointR2(3, 3), PointR2(2, 2)}; break;
+            case 2: ring.resize(k % 3, PointR2(k, k)); break;
+            case 3: {
+                ring = star_polygon(rng, size(rng), false);
+                ring.insert(ring.begin() + 2, ring[2]);
+                ring.push_back(ring.front());
+                break;
+            }
+            default: ring = star_polygon(rng, size(rng), k % 2 == 1);
+        }
+        batch.add_ring(ring);
+    }
+    return batch;
+}
+
+static void single_polygons(const RingSet& batch) {
+    Triangulator triangulator;
+    bool counts = true, orientation = true, areas = true, indices = true;
+    for (size_t k = 0; k < batch.ring_count(); ++k) {
+        const PointR2* ring = batch.ring(k);
+        size_t n = batch.ring_size(k);
+        std::vector<IndexTriangle> triangles;
+        triangulator.triangulate(ring, n, triangles);
+
+        double area = n >= 3 ? std::fabs(twice_area(ring, n)) : 0.0;
+        size_t m = distinct_vertices(ring, n);
+        counts = counts && triangles.size() == (area > 0.0 ? m - 2 : 0);
+
+        double total = 0.0;
+        for (const IndexTriangle& t : triangles) {
+            indices = indices && t[0] < n && t[1] < n && t[2] < n;
+            if (!indices) break;
+            double o = orient2d(ring[t[0]], ring[t[1]], ring[t[2]]);
+            orientation = orientation && o >= 0.0;
+            total += o;
+        }
+        areas = areas && total == area;
+    }
+    check(counts, "an n-gon gives n - 2 triangles and a flat ring none");
+    check(indices, "triangles index the polygon");
+    check(orientation, "triangles are counter-clockwise");
+    check(areas, "triangle areas sum to the polygon area");
+}
+
+static void batch_matches_serial(const RingSet& batch) {
+    // Expected: each polygon on its own, shifted to index the whole array
+    std::vector<IndexTriangle> expected;
+    std::vector<uint32_t> expected_offsets{0};
+    Triangulator triangulator;
+    for (size_t k = 0; k < batch.ring_count(); ++k) {
+        std::vector<IndexTriangle> local;
+        triangulator.triangulate(batch.ring(k), batch.ring_size(k), local);
+        for (const IndexTriangle& t : local) {
+            uint32_t base = batch.offsets[k];
+            expected.push_back({t[0] + base, t[1] + base, t[2] + base});
+        }
+        expected_offsets.push_back(static_cast<uint32_t>(expected.size()));
+    }
+
+    for (unsigned threads : {1u, 4u, 0u}) {
+        std::vector<IndexTriangle> triangles{{7, 7, 7}};
+        std::vector<uint32_t> offsets;
+        triangulate_polygons(batch, triangles, offsets, threads);
+        check(triangles == expected && offsets == expected_offsets, "batch triangulation matches serial");
+
+        triangulate_polygons(batch.points.data(), batch.offsets.data(), batch.ring_count(), triangles, offsets,
+                             threads);
+        check(triangles == expected && offsets == expected_offsets, "flat batch triangulation matches serial");
+    }
+
+    std::vector<IndexTriangle> triangles;
+    std::vector<uint32_t> offsets;
+    triangulate_polygons(RingSet{}, triangles, offsets, 4);
+    check(triangles.empty() && offsets == std::vector<uint32_t>{0}, "empty batch gives no triangles");
+}
+
+// A self-intersecting polygon is reported by its index, from any thread
+static void errors_name_the_polygon(RingSet batch) {
+    size_t bad = batch.ring_count();
+    batch.add_ring({PointR2(0, 0), PointR2(2, 2), PointR2(2, 0), PointR2(0, 2)});
+    for (unsigned threads : {1u, 4u}) {
+        std::vector<IndexTriangle> triangles;
+        std::vector<uint32_t> offsets;
+        std::string message;
+        try {
+            triangulate_polygons(batch, triangles, offsets, threads);
+        } catch (const std::invalid_argument& e) {
+            message = e.what();
+        }
+        check(message.rfind("triangulate_polygons: polygon " + std::to_string(bad) + ": ", 0) == 0,
+              "errors name the self-intersecting polygon");
+    }
+}
+
+int main() {
+    // Enough polygons for several blocks per thread
+    RingSet batch = polygon_batch(3000);
+    single_polygons(batch);
+    batch_matches_serial(batch);
+    errors_name_the_polygon(batch);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "parallel.hpp"
+#include "spectral_graph.hpp"
+
+// Text formats understood by the edge loader
+enum class edge_format {
+    whitespace,     // "from to [weight]" separated by spaces or tabs
+    csv,            // "from,to[,weight]"
+    matrix_market   // coordinate real/integer/pattern, general or symmetric
+};
+
+struct edge_load_options {
+    edge_format format = edge_format::whitespace;
+    bool is_directed = false;
+    int vertex_count = -1;          // -1: use the Matrix Market header or scan the input
+    int index_base = 0;             // Subtracted from every index; Matrix Market is always 1-based
+    size_t chunk_bytes = 1 << 22;   // Bytes read and parsed per round
+    unsigned threads = 0;           // 0: hardware concurrency
+};
+
+// Information gathered from the input before the edges themselves
+struct edge_stream_header {
+    int rows = -1;
+    int cols = -1;
+    long long entries = -1;
+    bool symmetric = false;
+    bool pattern = false;
+};
+
+namespace edge_loader_detail {
+
+    inline const char* skip_blanks(const char* p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        return p;
+    }
+
+    inline const char* skip_separator(const char* p, const char* end, edge_format format) {
+        p = skip_blanks(p, end);
+        if (format == edge_format::csv && p < end && *p == ',') {
+            p = skip_blanks(p + 1, end);
+        }
+        return p;
+    }
+
+    template<typename Number>
+    inline const char* parse_number(const char* p, const char* end, Number& value) {
+        if (p < end && *p == '+') ++p;
+        auto [next, ec] = std::from_chars(p, end, value);
+        return ec == std::errc{} ? next : nullptr;
+    }
+
+    // Parse every line in [begin, end) into `out`. Blank lines and lines
+    // starting with '#' or '%' are skipped; a line with only two fields gets
+    // weight 1.
+    inline void parse_range(const char* begin, const char* end, const edge_load_options& options,
+                            int index_base, bool pattern, std::vector<Spectral_Graph::edge>& out) {
+        const char* line = begin;
+        while (line < end) {
+            const char* eol = static_cast<const char*>(std::memchr(line, '\n', end - line));
+            if (!eol) eol = end;
+
+            const char* p = skip_blanks(line, eol);
+            if (p < eol && *p != '#' && *p != '%') {
+                int u = 0, v = 0;
+                double w = 1.0;
+
+                p = parse_number(p, eol, u);
+                if (p) p = parse_number(skip_separator(p, eol, options.format), eol, v);
+                if (!p) {
+                    throw std::runtime_error("Malformed edge line: " + std::string(line, eol));
+                }
+
+                p = skip_separator(p, eol, options.format);
+                if (!pattern && p < eol) {
+                    p = parse_number(p, eol, w);
+                    if (!p) {
+                        throw std::runtime_error("Malformed edge weight: " + std::string(line, eol));
+                    }
+                }
+
+                out.emplace_back(u - index_base, v - index_base, w);
+            }
+            line = eol + 1;
+        }
+    }
+
+    inline edge_stream_header read_matrix_market_header(std::istream& in) {
+        edge_stream_header header;
+        std::string line;
+
+        if (!std::getline(in, line) || line.rfind("%%MatrixMarket", 0) != 0) {
+            throw std::runtime_error("Missing Matrix Market banner");
+        }
+
+        std::istringstream banner(line);
+        std::string tag, object, layout, field, symmetry;
+        banner >> tag >> object >> layout >> field >> symmetry;
+        std::transform(layout.begin(), layout.end(), layout.begin(), ::tolower);
+        std::transform(field.begin(), field.end(), field.begin(), ::tolower);
+        std::transform(symmetry.begin(), symmetry.end(), symmetry.begin(), ::tolower);
+
+        if (layout != "coordinate") {
+            throw std::runtime_error("Only coordinate Matrix Market files are supported");
+        }
+        if (field != "real" && field != "integer" && field != "pattern") {
+            throw std::runtime_error("Unsupported Matrix Market field: " + field);
+        }
+        if (symmetry != "general" && symmetry != "symmetric") {
+            throw std::runtime_error("Unsupported Matrix Market symmetry: " + symmetry);
+        }
+        header.pattern = field == "pattern";
+        header.symmetric = symmetry == "symmetric";
+
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '%') continue;
+            std::istringstream size_line(line);
+            if (!(size_line >> header.rows >> header.cols >> header.entries)) {
+                throw std::runtime_error("Malformed Matrix Market size line");
+            }
+            return header;
+        }
+        throw std::runtime_error("Missing Matrix Market size line");
+    }
+
+}
+
+// Stream every edge of `in` into sink(from, to, weight), in input order.
+//
+// The input is read `chunk_bytes` at a time. Each chunk is cut at its last
+// newline, split into one slice per worker along line boundaries and parsed
+// in parallel with std::from_chars; the per-slice results are then handed to
+// the sink on the calling thread. Memory use is bounded by the chunk size,
+// independent of the length of the input.
+template<typename Sink>
+edge_stream_header stream_edges(std::istream& in, const edge_load_options& options, Sink&& sink) {
+    using namespace edge_loader_detail;
+
+    edge_stream_header header;
+    int index_base = options.index_base;
+    if (options.format == edge_format::matrix_market) {
+        header = read_matrix_market_header(in);
+        index_base = 1;
+    }
+
+    unsigned threads = options.threads == 0 ? default_thread_count() : options.threads;
+    size_t chunk_bytes = std::max<size_t>(options.chunk_bytes, 64);
+
+    std::vector<char> buffer;
+    std::vector<std::vector<Spectral_Graph::edge>> parsed(threads);
+    std::vector<const char*> cuts;
+    size_t carry = 0;
+
+    for (;;) {
+        buffer.resize(carry + chunk_bytes);
+        in.read(buffer.data() + carry, static_cast<std::streamsize>(chunk_bytes));
+        size_t filled = carry + static_cast<size_t>(in.gcount());
+        bool at_end = !in;
+
+        if (filled == 0) break;
+
+        // Parse complete lines only; the tail is carried into the next round
+        size_t usable = filled;
+        if (!at_end) {
+            const char* data = buffer.data();
+            size_t last = filled;
+            while (last > 0 && data[last - 1] != '\n') --last;
+            if (last == 0) {
+                // A single line longer than the chunk: read more before parsing
+                carry = filled;
+                chunk_bytes *= 2;
+                continue;
+            }
+            usable = last;
+        }
+
+        const char* begin = buffer.data();
+        const char* end = begin + usable;
+
+        cuts.assign(1, begin);
+        for (unsigned t = 1; t < threads; ++t) {
+            const char* target = begin + usable * t / threads;
+            if (target <= cuts.back()) continue;
+            const char* nl = static_cast<const char*>(std::memchr(target, '\n', end - target));
+            if (!nl) break;
+            cuts.push_back(nl + 1);
+        }
+        cuts.push_back(end);
+
+        size_t slices = cuts.size() - 1;
+        parallel_for(slices, [&](size_t s) {
+            parsed[s].clear();
+            parse_range(cuts[s], cuts[s + 1], options, index_base, header.pattern, parsed[s]);
+        }, threads);
+
+        for (size_t s = 0; s < slices; ++s) {
+            for (const auto& [u, v, w] : parsed[s]) {
+                sink(u, v, w);
+            }
+        }
+
+        if (at_end) break;
+
+        carry = filled - usable;
+        std::memmove(buffer.data(), buffer.data() + usable, carry);
+    }
+
+    return header;
+}
+
+template<typename Sink>
+edge_stream_header stream_edges(const std::string& path, const edge_load_options& options, Sink&& sink) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open edge file: " + path);
+    }
+    return stream_edges(in, options, std::forward<Sink>(sink));
+}
+
+namespace edge_loader_detail {
+
+    // Resolve the vertex count and directedness for a file, scanning it once
+    // for the largest index when neither the options nor a header provide it
+    inline std::pair<int, bool> resolve_shape(const std::string& path, const edge_load_options& options) {
+        if (options.format == edge_format::matrix_market) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                throw std::runtime_error("Cannot open edge file: " + path);
+            }
+            auto header = read_matrix_market_header(in);
+            int n = options.vertex_count >= 0 ? options.vertex_count : std::max(header.rows, header.cols);
+            return {n, options.is_directed && !header.symmetric};
+        }
+
+        if (options.vertex_count >= 0) {
+            return {options.vertex_count, options.is_directed};
+        }
+
+        int max_index = -1;
+        stream_edges(path, options, [&](int u, int v, double) {
+            max_index = std::max(max_index, std::max(u, v));
+        });
+        return {max_index + 1, options.is_directed};
+    }
+
+}
+
+// Load a dense spectral graph from an edge file
+inline Spectral_Graph load_spectral_graph(const std::string& path, const edge_load_options& options = {}) {
+    auto [n, is_directed] = edge_loader_detail::resolve_shape(path, options);
+    return Spectral_Graph::from_edge_stream([&](auto&& sink) {
+        stream_edges(path, options, sink);
+    }, n, is_directed);
+}
+
+// Load a sparse spectral graph from an edge file. The file is streamed twice,
+// so only the final sparse matrix has to fit in memory.
+inline Sparse_Spectral_Graph load_sparse_spectral_graph(const std::string& path, const edge_load_options& options = {}) {
+    auto [n, is_directed] = edge_loader_detail::resolve_shape(path, options);
+    return Sparse_Spectral_Graph::from_edge_stream([&](auto&& sink) {
+        stream_edges(path, options, sink);
+    }, n, is_directed);
+}
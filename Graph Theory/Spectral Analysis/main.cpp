@@ -1,7 +1,11 @@
 #include <iostream>
 #include <vector>
 #include <iomanip>
+#include <sstream>
 #include "spectral_graph.hpp"
+#include "edge_loader.hpp"
+#include "k_core.hpp"
+#include "spectral_view.hpp"
 
 void print_matrix(const Spectral_Graph::matrix& matrix, const std::string& label) {
     std::cout << label << ":\n";
@@ -86,6 +90,35 @@ int main() {
         }
         std::cout << "\n";
 
+        // Streamed Matrix Market input
+        std::istringstream market(
+            "%%MatrixMarket matrix coordinate real symmetric\n"
+            "% triangle with a pendant vertex\n"
+            "4 4 4\n"
+            "2 1 1.0\n3 2 2.0\n3 1 1.5\n4 3 1.0\n");
+        edge_load_options market_options;
+        market_options.format = edge_format::matrix_market;
+        Spectral_Graph streamed_graph = Spectral_Graph::from_edge_stream([&](auto&& sink) {
+            stream_edges(market, market_options, sink);
+        }, vertex_count);
+        print_vector(streamed_graph.eigenvalues(), "Streamed Graph Laplacian Eigenvalues");
+
+        // Prune to the 2-core before spectral analysis
+        auto cores = k_core_decomposition(graph);
+        std::cout << "Degeneracy: " << cores.degeneracy << "\n";
+        auto two_core = extract_k_core(graph, 2, cores);
+        print_vector(two_core.graph.eigenvalues(), "2-Core Laplacian Eigenvalues");
+
+        // Views over slices of the graph without copying it
+        auto ego = ego_vertices(graph, 3, 1);
+        Spectral_Graph_View<> ego_view(graph, ego);
+        print_vector(ego_view.eigenvalues(), "Ego Network of Vertex 3 Eigenvalues");
+
+        auto heavy = [](int, int, double w) { return w >= 1.5; };
+        Spectral_Graph_View<decltype(heavy)> heavy_view(graph, heavy);
+        std::cout << "Heavy edges: " << heavy_view.edge_count()
+                  << ", connected: " << (heavy_view.is_connected() ? "Yes" : "No") << "\n";
+
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
         return 1;
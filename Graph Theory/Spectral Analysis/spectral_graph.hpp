@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <numeric>
 #include <queue>
+#include <utility>
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
 
@@ -23,7 +24,8 @@ public:
     using edge = std::tuple<int, int, double>;
     using vector = std::vector<double>;
 
-    // Construct graph from adjacency matrix
+    // Construct graph from adjacency matrix; an empty matrix gives the graph
+    // with no vertices
     Spectral_Graph(matrix adj, bool is_directed = false)
         : adjacency_(std::move(adj)), 
           size_(adjacency_.size()), 
@@ -35,8 +37,20 @@ public:
 
     // Construct graph from edge list
     static Spectral_Graph from_edges(const std::vector<edge>& edges, int n, bool is_directed = false) {
+        return from_edge_stream([&](auto&& sink) {
+            for (const auto& [u, v, w] : edges) {
+                sink(u, v, w);
+            }
+        }, n, is_directed);
+    }
+
+    // Construct graph from an edge producer. `produce` is called once with a
+    // sink taking (from, to, weight), so edges are written straight into the
+    // adjacency matrix without an intermediate edge list.
+    template<typename Producer>
+    static Spectral_Graph from_edge_stream(Producer&& produce, int n, bool is_directed = false) {
         matrix adj(n, std::vector<double>(n, 0.0));
-        for (const auto& [u, v, w] : edges) {
+        produce([&](int u, int v, double w) {
             if (u < 0 || u >= n || v < 0 || v >= n) {
                 throw std::out_of_range("Vertex index out of bounds");
             }
@@ -47,12 +61,13 @@ public:
             if (!is_directed) {
                 adj[v][u] = w;
             }
-        }
+        });
         return Spectral_Graph(std::move(adj), is_directed);
     }
 
     // Compute eigenvalues of Laplacian matrix
     std::vector<double> eigenvalues() const {
+        if (size_ == 0) return {};
         Eigen::MatrixXd L = to_eigen_matrix(laplacian_);
         Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(L);
         if (solver.info() != Eigen::Success) {
@@ -67,6 +82,7 @@ public:
 
     // Compute eigenvectors of Laplacian matrix
     std::vector<vector> eigenvectors() const {
+        if (size_ == 0) return {};
         Eigen::MatrixXd L = to_eigen_matrix(laplacian_);
         Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(L);
         if (solver.info() != Eigen::Success) {
@@ -161,9 +177,6 @@ private:
     bool is_directed_;
 
     void validate_adjacency_matrix() const {
-        if (size_ == 0) {
-            throw std::invalid_argument("Adjacency matrix cannot be empty");
-        }
         for (const auto& row : adjacency_) {
             if (row.size() != size_) {
                 throw std::invalid_argument("Adjacency matrix must be square");
@@ -241,20 +254,88 @@ public:
         adjacency_.resize(n, n);
         adjacency_.setFromTriplets(triplets.begin(), triplets.end());
 
-        // Compute degree matrix D
-        degree_matrix_.resize(n, n);
-        std::vector<Eigen::Triplet<double>> deg_triplets;
-        for (int i = 0; i < n; ++i) {
-            double deg = 0.0;
-            for (Eigen::SparseMatrix<double>::InnerIterator it(adjacency_, i); it; ++it) {
-                deg += it.value();
+        compute_degree_and_laplacian();
+    }
+
+    // Construct graph from an edge producer that can be replayed. `produce` is
+    // called twice with a sink taking (from, to, weight) and must produce the
+    // same edges both times, or std::runtime_error is thrown. The first pass
+    // counts entries per column, the second writes each entry straight into
+    // its column's slots of the compressed storage. Each column is then
+    // sorted by row and duplicate edges are summed, matching setFromTriplets,
+    // in O(E log d) overall for maximum column size d.
+    template<typename Producer>
+    static Sparse_Spectral_Graph from_edge_stream(Producer&& produce, int n, bool is_directed = false) {
+        using index = sparse_matrix::StorageIndex;
+        Sparse_Spectral_Graph graph(n, is_directed);
+
+        std::vector<size_t> column_start(static_cast<size_t>(n) + 1, 0);
+        produce([&](int u, int v, double) {
+            if (u < 0 || u >= n || v < 0 || v >= n) {
+                throw std::out_of_range("Vertex index out of bounds");
+            }
+            ++column_start[v + 1];
+            if (!is_directed) {
+                ++column_start[u + 1];
+            }
+        });
+        std::partial_sum(column_start.begin(), column_start.end(), column_start.begin());
+
+        std::vector<std::pair<index, double>> entries(column_start[n]);
+        // The second pass must replay the first exactly; a stream that
+        // yields different edges the second time, say a file changed in
+        // between, is caught before it writes outside a column's slots
+        std::vector<size_t> cursor(column_start.begin(), column_start.end() - 1);
+        auto place = [&](int column, int row, double w) {
+            if (column < 0 || column >= n || row < 0 || row >= n) {
+                throw std::out_of_range("Vertex index out of bounds");
+            }
+            if (cursor[column] >= column_start[column + 1]) {
+                throw std::runtime_error("Edge stream changed between passes");
+            }
+            entries[cursor[column]++] = {static_cast<index>(row), w};
+        };
+        produce([&](int u, int v, double w) {
+            place(v, u, w);
+            if (!is_directed) {
+                place(u, v, w);
+            }
+        });
+        for (int c = 0; c < n; ++c) {
+            if (cursor[c] != column_start[c + 1]) {
+                throw std::runtime_error("Edge stream changed between passes");
             }
-            deg_triplets.emplace_back(i, i, deg);
         }
-        degree_matrix_.setFromTriplets(deg_triplets.begin(), deg_triplets.end());
 
-        // Laplacian L = D - A
-        laplacian_ = degree_matrix_ - adjacency_;
+        // Sort and merge each column in place, packing the columns together
+        size_t filled = 0;
+        for (int c = 0; c < n; ++c) {
+            auto first = entries.begin() + column_start[c], last = entries.begin() + column_start[c + 1];
+            std::sort(first, last, [](const auto& a, const auto& b) { return a.first < b.first; });
+            column_start[c] = filled;
+            for (auto it = first; it != last; ++it) {
+                if (filled > column_start[c] && entries[filled - 1].first == it->first) {
+                    entries[filled - 1].second += it->second;
+                } else {
+                    entries[filled++] = *it;
+                }
+            }
+        }
+        column_start[n] = filled;
+
+        sparse_matrix& adjacency = graph.adjacency_;
+        adjacency.resize(n, n);
+        adjacency.resizeNonZeros(static_cast<Eigen::Index>(filled));
+        for (int c = 0; c <= n; ++c) {
+            adjacency.outerIndexPtr()[c] = static_cast<index>(column_start[c]);
+        }
+        for (size_t k = 0; k < filled; ++k) {
+            adjacency.innerIndexPtr()[k] = entries[k].first;
+            adjacency.valuePtr()[k] = entries[k].second;
+        }
+
+        graph.compute_degree_and_laplacian();
+        return graph;
     }
 
     // Eigenvalues of sparse Laplacian
@@ -270,10 +351,38 @@ public:
         return result;
     }
 
+    // Get graph properties
+    size_t vertex_count() const { return size_; }
+    const sparse_matrix& get_adjacency() const { return adjacency_; }
+    const sparse_matrix& get_laplacian() const { return laplacian_; }
+    const sparse_matrix& get_degree_matrix() const { return degree_matrix_; }
+    bool is_directed_graph() const { return is_directed_; }
+
 private:
     sparse_matrix adjacency_;
     sparse_matrix degree_matrix_;
     sparse_matrix laplacian_;
     size_t size_;
     bool is_directed_;
+
+    Sparse_Spectral_Graph(int n, bool is_directed) : size_(n), is_directed_(is_directed) {}
+
+    void compute_degree_and_laplacian() {
+        int n = static_cast<int>(size_);
+
+        // Compute degree matrix D
+        degree_matrix_.resize(n, n);
+        std::vector<Eigen::Triplet<double>> deg_triplets;
+        for (int i = 0; i < n; ++i) {
+            double deg = 0.0;
+            for (Eigen::SparseMatrix<double>::InnerIterator it(adjacency_, i); it; ++it) {
+                deg += it.value();
+            }
+            deg_triplets.emplace_back(i, i, deg);
+        }
+        degree_matrix_.setFromTriplets(deg_triplets.begin(), deg_triplets.end());
+
+        // Laplacian L = D - A
+        laplacian_ = degree_matrix_ - adjacency_;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+
+#include "spectral_graph.hpp"
+
+struct keep_all_weights {
+    constexpr bool operator()(int, int, double) const { return true; }
+};
+
+// Read-only view of a Spectral_Graph restricted to a vertex subset and to
+// the edges accepted by keep_edge(from, to, weight). Vertices are addressed
+// by their position in the view; the view reads weights from the graph's
+// adjacency matrix on demand and never copies it. The vertex list is
+// referenced and must outlive the view.
+template<typename EdgeFilter = keep_all_weights>
+class Spectral_Graph_View {
+public:
+    using vector = Spectral_Graph::vector;
+
+    // View of the vertices in `vertices`, in that order
+    Spectral_Graph_View(const Spectral_Graph& g, const std::vector<int>& vertices, EdgeFilter keep_edge = {})
+        : graph_(&g), vertices_(&vertices), keep_edge_(std::move(keep_edge)) {
+        for (int v : vertices) {
+            if (v < 0 || static_cast<size_t>(v) >= g.vertex_count()) {
+                throw std::out_of_range("Vertex index out of bounds");
+            }
+        }
+    }
+
+    // View of every vertex, filtering edges only
+    explicit Spectral_Graph_View(const Spectral_Graph& g, EdgeFilter keep_edge = {})
+        : graph_(&g), vertices_(nullptr), keep_edge_(std::move(keep_edge)) {}
+
+    size_t vertex_count() const {
+        return vertices_ ? vertices_->size() : graph_->vertex_count();
+    }
+
+    // Index of view vertex i in the underlying graph
+    int original_vertex(size_t i) const {
+        return vertices_ ? (*vertices_)[i] : static_cast<int>(i);
+    }
+
+    double weight(size_t i, size_t j) const {
+        int u = original_vertex(i), v = original_vertex(j);
+        double w = graph_->get_adjacency()[u][v];
+        return w != 0.0 && keep_edge_(u, v, w) ? w : 0.0;
+    }
+
+    double degree(size_t i) const {
+        double total = 0.0;
+        for (size_t j = 0; j < vertex_count(); ++j) {
+            total += weight(i, j);
+        }
+        return total;
+    }
+
+    size_t edge_count() const {
+        double total = 0.0;
+        for (size_t i = 0; i < vertex_count(); ++i) {
+            total += degree(i);
+        }
+        return static_cast<size_t>(graph_->is_directed_graph() ? total : total / 2);
+    }
+
+    // Check connectivity via BFS over the visible edges
+    bool is_connected() const {
+        size_t n = vertex_count();
+        if (n == 0) return true;
+        std::vector<bool> visited(n, false);
+        std::queue<size_t> queue;
+        queue.push(0);
+        visited[0] = true;
+        size_t count = 1;
+
+        while (!queue.empty()) {
+            size_t u = queue.front();
+            queue.pop();
+            for (size_t v = 0; v < n; ++v) {
+                if (!visited[v] && weight(u, v) != 0.0) {
+                    visited[v] = true;
+                    queue.push(v);
+                    ++count;
+                }
+            }
+        }
+        return count == n;
+    }
+
+    // y = L x for the view's Laplacian L = D - A, without forming L
+    vector laplacian_multiply(const vector& x) const {
+        size_t n = vertex_count();
+        if (x.size() != n) {
+            throw std::invalid_argument("Vector size does not match view");
+        }
+        vector y(n, 0.0);
+        for (size_t i = 0; i < n; ++i) {
+            double sum = 0.0;
+            for (size_t j = 0; j < n; ++j) {
+                double w = weight(i, j);
+                sum += w * (x[i] - x[j]);
+            }
+            y[i] = sum;
+        }
+        return y;
+    }
+
+    // Eigenvalues of the view's Laplacian. Only the k x k Laplacian of the
+    // view is formed, never the full graph's.
+    std::vector<double> eigenvalues() const {
+        size_t n = vertex_count();
+        Eigen::MatrixXd L = Eigen::MatrixXd::Zero(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                double w = weight(i, j);
+                if (w == 0.0) continue;
+                // A self-loop adds to the degree and cancels its own
+                // adjacency entry, as in compute_laplacian
+                L(i, i) += w;
+                if (j != i) L(i, j) = -w;
+            }
+        }
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(L);
+        if (solver.info() != Eigen::Success) {
+            throw std::runtime_error("Eigenvalue computation failed");
+        }
+        auto evals = solver.eigenvalues();
+        std::vector<double> result(evals.data(), evals.data() + evals.size());
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    double algebraic_connectivity() const {
+        auto evals = eigenvalues();
+        return evals.size() < 2 ? 0.0 : evals[1];
+    }
+
+    // Copy the view into a standalone graph
+    Spectral_Graph materialize() const {
+        size_t n = vertex_count();
+        Spectral_Graph::matrix adj(n, std::vector<double>(n, 0.0));
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                adj[i][j] = weight(i, j);
+            }
+        }
+        return Spectral_Graph(std::move(adj), graph_->is_directed_graph());
+    }
+
+private:
+    const Spectral_Graph* graph_;
+    const std::vector<int>* vertices_;
+    EdgeFilter keep_edge_;
+};
+
+// Vertices within `radius` hops of `center`, in BFS order
+inline std::vector<int> ego_vertices(const Spectral_Graph& g, int center, size_t radius) {
+    size_t n = g.vertex_count();
+    if (center < 0 || static_cast<size_t>(center) >= n) {
+        throw std::out_of_range("Vertex index out of bounds");
+    }
+
+    const auto& adj = g.get_adjacency();
+    std::vector<size_t> depth(n, static_cast<size_t>(-1));
+    std::vector<int> order{center};
+    depth[center] = 0;
+
+    for (size_t head = 0; head < order.size(); ++head) {
+        int u = order[head];
+        if (depth[u] == radius) continue;
+        for (size_t v = 0; v < n; ++v) {
+            if (adj[u][v] != 0.0 && depth[v] == static_cast<size_t>(-1)) {
+                depth[v] = depth[u] + 1;
+                order.push_back(static_cast<int>(v));
+            }
+        }
+    }
+    return order;
+}
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "concurrent_graph.hpp"
+
+// One writer publishes batches while readers check every snapshot they
+// take. Batch k, published as version k, joins hub k to batch_size leaves
+// of its own and removes the edges batch k - 2 added, so after version v
+// exactly the hubs of batches v - 1 and v have edges, each all of them.
+
+using shared_graph = concurrent_graph<int, void>;
+
+static constexpr int batch_count = 2000;
+static constexpr int batch_size = 8;
+static constexpr int reader_count = 3;
+
+static int leaf(int batch, int j) { return batch_count + 1 + batch * batch_size + j; }
+
+static void write_batches(shared_graph& g, std::atomic<bool>& done) {
+    for (int k = 1; k <= batch_count; ++k) {
+        g.update([k](shared_graph::editor& e) {
+            for (int j = 0; j < batch_size; ++j) e.add_edge(k, leaf(k, j));
+            if (k > 2) {
+                for (int j = 0; j < batch_size; ++j) e.remove_edge(k - 2, leaf(k - 2, j));
+            }
+        });
+    }
+    done.store(true, std::memory_order_release);
+}
+
+// Returns the number of violations seen
+static long check_snapshots(const shared_graph& g, const std::atomic<bool>& done) {
+    long violations = 0;
+    uint64_t last = 0;
+    auto report = [&](const char* what, uint64_t v, int k) {
+        if (violations++ < 10) std::fprintf(stderr, "version %llu, batch %d: %s\n", (unsigned long long)v, k, what);
+    };
+    while (!done.load(std::memory_order_acquire)) {
+        shared_graph::snapshot s = g.get_snapshot();
+        uint64_t v = s.version_number();
+        if (v < last) report("version went backwards", v, 0);
+        last = v;
+
+        // Each batch near the version is wholly present or wholly absent
+        int newest = static_cast<int>(v);
+        for (int k = std::max(1, newest - 3); k <= std::min(batch_count, newest + 1); ++k) {
+            bool live = k <= newest && k > newest - 2;
+            size_t degree = s.has_node(k) ? s.get_adjacent(k).size() : 0;
+            if (degree != (live ? static_cast<size_t>(batch_size) : 0)) report("batch partly visible", v, k);
+
+            // Undirected edges appear in both directions
+            if (!s.has_node(k)) continue;
+            for (int neighbor : s.get_adjacent(k)) {
+                if (!s.has_edge(neighbor, k)) report("edge seen in one direction only", v, k);
+            }
+            for (int j = 0; j < batch_size; ++j) {
+                if (s.has_edge(leaf(k, j), k) != s.has_edge(k, leaf(k, j))) report("asymmetric leaf edge", v, k);
+            }
+        }
+    }
+    return violations;
+}
+
+int main() {
+    shared_graph g;
+    std::atomic<bool> done{false};
+    std::vector<long> violations(reader_count, 0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < reader_count; ++r) {
+        readers.emplace_back([&, r] { violations[r] = check_snapshots(g, done); });
+    }
+    write_batches(g, done);
+    for (auto& t : readers) t.join();
+
+    long total = 0;
+    for (long v : violations) total += v;
+
+    // Final state after all writers: only the last two batches have edges
+    auto s = g.get_snapshot();
+    if (s.version_number() != batch_count) ++total;
+    if (s.get_adjacent(batch_count).size() != batch_size || s.get_adjacent(batch_count - 2).size() != 0) ++total;
+
+    if (total != 0) std::fprintf(stderr, "FAILED: %ld violations\n", total);
+    return total == 0 ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "graph.hpp"
+#include "graph_view.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+using weighted_graph = graph<int, double>;
+using unweighted_graph = graph<int, void>;
+
+constexpr int vertex_count = 40;
+
+// Random weighted graph with a few self-loops, and the same edges unweighted
+static weighted_graph random_graph(unsigned seed, unweighted_graph& plain) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    weighted_graph g;
+    for (int u = 0; u < vertex_count; ++u) {
+        g.add_node(u);
+        plain.add_node(u);
+    }
+    for (int u = 0; u < vertex_count; ++u) {
+        for (int v = u; v < vertex_count; ++v) {
+            if (coin(rng) >= (u == v ? 0.1 : 0.08)) continue;
+            double w = coin(rng);
+            g.add_edge(u, v, w);
+            plain.add_edge(u, v);
+        }
+    }
+    return g;
+}
+
+// Copy a view into a standalone graph, edge by edge through get_adjacent
+template<typename View>
+static weighted_graph materialize(const View& view) {
+    weighted_graph g;
+    for (int u : view.get_nodes()) g.add_node(u);
+    for (int u : view.get_nodes()) {
+        for (const auto& [v, w] : view.get_adjacent(u)) g.add_edge(u, v, w);
+    }
+    return g;
+}
+
+// Depth of every node reached from source, checking that nodes are visited
+// in nondecreasing depth order
+template<typename Graph>
+static std::unordered_map<int, size_t> bfs_depths(const Graph& g, int source, size_t max_depth) {
+    std::unordered_map<int, size_t> depth;
+    size_t last = 0;
+    bool ordered = true, once = true;
+    breadth_first_search(g, source, max_depth, [&](int node, size_t d) {
+        ordered = ordered && d >= last && d <= max_depth;
+        once = depth.emplace(node, d).second && once;
+        last = d;
+    });
+    check(ordered, "BFS visits nodes by nondecreasing depth");
+    check(once, "BFS visits every node once");
+    return depth;
+}
+
+// Hop distances over edges accepted by keep_edge, by repeated relaxation
+template<typename KeepEdge>
+static std::vector<size_t> distances(const weighted_graph& g, int source, KeepEdge keep_edge) {
+    std::vector<size_t> d(vertex_count, static_cast<size_t>(-1));
+    d[source] = 0;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int u = 0; u < vertex_count; ++u) {
+            if (d[u] == static_cast<size_t>(-1)) continue;
+            for (const auto& [v, w] : g.get_adjacent(u)) {
+                if (keep_edge(u, v, w) && d[u] + 1 < d[v]) {
+                    d[v] = d[u] + 1;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return d;
+}
+
+static void edge_filter(const weighted_graph& g, const unweighted_graph& plain) {
+    auto heavy = filter_edges(g, [](int, int, double w) { return w > 0.5; });
+    check(heavy.node_count() == static_cast<size_t>(vertex_count), "edge filter keeps every node");
+
+    bool edges = true, adjacency = true, data = true;
+    for (int u = 0; u < vertex_count; ++u) {
+        size_t expected_size = 0;
+        for (int v = 0; v < vertex_count; ++v) {
+            bool expected = g.has_edge(u, v) && g.get_edge_data(u, v) > 0.5;
+            edges = edges && heavy.has_edge(u, v) == expected;
+            if (!expected) continue;
+            ++expected_size;
+            data = data && heavy.get_edge_data(u, v) == g.get_edge_data(u, v);
+        }
+        size_t seen = 0;
+        for (const auto& [v, w] : heavy.get_adjacent(u)) {
+            adjacency = adjacency && w > 0.5 && g.get_edge_data(u, v) == w;
+            ++seen;
+        }
+        adjacency = adjacency && seen == expected_size && heavy.get_adjacent(u).size() == expected_size;
+    }
+    check(edges, "edge filter has_edge matches the predicate");
+    check(adjacency, "edge filter adjacency holds exactly the accepted edges");
+    check(data, "edge filter reads edge data from the graph");
+
+    bool threw = false;
+    for (int u = 0; u < vertex_count && !threw; ++u) {
+        for (int v = 0; v < vertex_count && !threw; ++v) {
+            if (!g.has_edge(u, v) || g.get_edge_data(u, v) > 0.5) continue;
+            try {
+                heavy.get_edge_data(u, v);
+            } catch (const std::out_of_range&) {
+                threw = true;
+            }
+        }
+    }
+    check(threw, "edge filter hides the data of rejected edges");
+
+    // Unweighted graphs call the edge predicate without data
+    auto forward = filter_edges(plain, [](int from, int to) { return from < to; });
+    bool directed = true;
+    for (int u = 0; u < vertex_count; ++u) {
+        for (int v = 0; v < vertex_count; ++v) {
+            directed = directed && forward.has_edge(u, v) == (plain.has_edge(u, v) && u < v);
+        }
+        for (int v : forward.get_adjacent(u)) directed = directed && u < v;
+    }
+    check(directed, "unweighted edge filter applies the predicate per direction");
+}
+
+static void node_filter(const weighted_graph& g) {
+    std::unordered_set<int> even;
+    for (int u = 0; u < vertex_count; u += 2) even.insert(u);
+    auto sub = induced_subgraph(g, even);
+    check(sub.node_count() == even.size(), "induced subgraph keeps the chosen nodes");
+
+    bool nodes = true, edges = true, adjacency = true;
+    for (int u = 0; u < vertex_count; ++u) {
+        nodes = nodes && sub.has_node(u) == (u % 2 == 0);
+        for (int v = 0; v < vertex_count; ++v) {
+            edges = edges && sub.has_edge(u, v) == (u % 2 == 0 && v % 2 == 0 && g.has_edge(u, v));
+        }
+        if (u % 2 != 0) continue;
+        for (const auto& entry : sub.get_adjacent(u)) adjacency = adjacency && entry.first % 2 == 0;
+    }
+    check(nodes, "induced subgraph has_node matches the set");
+    check(edges, "induced subgraph keeps exactly the edges between chosen nodes");
+    check(adjacency, "induced subgraph adjacency skips other nodes");
+
+    bool threw = false;
+    try {
+        sub.get_adjacent(1);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    check(threw, "induced subgraph rejects adjacency of a hidden node");
+
+    // Both filters at once, and BFS over the view against its copy
+    auto keep_node = [](int node) { return node % 3 != 0; };
+    auto keep_edge = [](int, int, double w) { return w < 0.7; };
+    filtered_graph_view<weighted_graph, decltype(keep_node), decltype(keep_edge)> view(g, keep_node, keep_edge);
+    auto copy = materialize(view);
+    bool same = true;
+    for (int source : view.get_nodes()) {
+        same = same && bfs_depths(view, source, 3) == bfs_depths(copy, source, 3);
+    }
+    check(same, "BFS over a filtered view matches BFS over its materialized copy");
+    check(bfs_depths(view, 3, 5).empty(), "BFS from a hidden node visits nothing");
+}
+
+static void ego_networks(const weighted_graph& g) {
+    for (size_t radius : {size_t{0}, size_t{1}, size_t{2}}) {
+        for (int center = 0; center < vertex_count; ++center) {
+            ego_network<int, double> ego(g, center, radius);
+            auto d = distances(g, center, [](int, int, double) { return true; });
+
+            bool members = ego.center() == center, edges = true;
+            size_t expected_count = 0;
+            for (int u = 0; u < vertex_count; ++u) {
+                bool inside = d[u] <= radius;
+                expected_count += inside;
+                members = members && ego.has_node(u) == inside;
+                for (int v = 0; v < vertex_count; ++v) {
+                    bool expected = inside && d[v] <= radius && g.has_edge(u, v);
+                    edges = edges && ego.has_edge(u, v) == expected;
+                    if (expected) edges = edges && ego.get_edge_data(u, v) == g.get_edge_data(u, v);
+                }
+            }
+            members = members && ego.node_count() == expected_count && ego.get_nodes().size() == expected_count;
+            check(members, "ego network holds the nodes within the radius");
+            check(edges, "ego network holds the induced edges");
+
+            // BFS over the ego network reaches the same depths as its copy
+            auto copy = materialize(ego);
+            check(bfs_depths(ego, center, radius) == bfs_depths(copy, center, radius),
+                  "BFS over an ego network matches BFS over its materialized copy");
+        }
+    }
+}
+
+// Depths found by BFS on the graph itself and through filter_edges
+static void bfs_depths_match_distances(const weighted_graph& g) {
+    auto keep = [](int, int, double w) { return w > 0.3; };
+    auto view = filter_edges(g, keep);
+    bool graph_depths = true, view_depths = true;
+    for (int source = 0; source < vertex_count; ++source) {
+        auto all = distances(g, source, [](int, int, double) { return true; });
+        auto kept = distances(g, source, keep);
+        for (auto [node, depth] : bfs_depths(g, source, static_cast<size_t>(-1))) {
+            graph_depths = graph_depths && all[node] == depth;
+        }
+        size_t reached = 0;
+        for (auto [node, depth] : bfs_depths(view, source, static_cast<size_t>(-1))) {
+            view_depths = view_depths && kept[node] == depth;
+            ++reached;
+        }
+        for (size_t d : kept) reached -= d != static_cast<size_t>(-1);
+        view_depths = view_depths && reached == 0;
+    }
+    check(graph_depths, "BFS depths on the graph are hop distances");
+    check(view_depths, "BFS depths through an edge filter are hop distances over kept edges");
+}
+
+int main() {
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        unweighted_graph plain;
+        auto g = random_graph(seed, plain);
+        edge_filter(g, plain);
+        node_filter(g);
+        ego_networks(g);
+        bfs_depths_match_distances(g);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+#include <cstdio>
+#include <vector>
+
+#include "k_core.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+// A triangle with a pendant vertex: core numbers 2, 2, 2, 1
+static const std::vector<Spectral_Graph::edge> edges{{0, 1, 1.0}, {1, 2, 1.0}, {2, 0, 1.0}, {2, 3, 1.0}};
+static const std::vector<edge> sparse_edges{{0, 1, 1.0}, {1, 2, 1.0}, {2, 0, 1.0}, {2, 3, 1.0}};
+
+// Both overloads return a graph with no vertices for a k above the
+// degeneracy, rather than one throwing and the other not
+static void empty_core_is_empty_graph() {
+    auto dense = extract_k_core(Spectral_Graph::from_edges(edges, 4), 3);
+    check(dense.graph.vertex_count() == 0, "dense empty core has no vertices");
+    check(dense.vertices.empty(), "dense empty core maps no vertices");
+    check(dense.graph.is_connected(), "dense empty core counts as connected");
+    check(dense.graph.eigenvalues().empty(), "dense empty core has no eigenvalues");
+    check(dense.graph.eigenvectors().empty(), "dense empty core has no eigenvectors");
+
+    auto sparse = extract_k_core(Sparse_Spectral_Graph(sparse_edges, 4), 3);
+    check(sparse.graph.vertex_count() == 0, "sparse empty core has no vertices");
+    check(sparse.vertices.empty(), "sparse empty core maps no vertices");
+}
+
+static void overloads_agree() {
+    auto dense = extract_k_core(Spectral_Graph::from_edges(edges, 4), 2);
+    auto sparse = extract_k_core(Sparse_Spectral_Graph(sparse_edges, 4), 2);
+    check(dense.vertices == std::vector<int>({0, 1, 2}), "dense 2-core is the triangle");
+    check(sparse.vertices == dense.vertices, "sparse 2-core matches dense");
+    check(dense.graph.edge_count() == 3, "dense 2-core keeps the triangle's edges");
+}
+
+int main() {
+    empty_core_is_empty_graph();
+    overloads_agree();
+    return failures == 0 ? 0 : 1;
+}
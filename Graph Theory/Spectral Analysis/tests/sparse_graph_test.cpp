@@ -0,0 +1,101 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "spectral_graph.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+static bool same_matrix(const Sparse_Spectral_Graph::sparse_matrix& a, const Sparse_Spectral_Graph::sparse_matrix& b) {
+    if (a.nonZeros() != b.nonZeros()) return false;
+    return (Eigen::MatrixXd(a) - Eigen::MatrixXd(b)).cwiseAbs().maxCoeff() < 1e-12;
+}
+
+// Streaming must give the triplet constructor's matrix, duplicate edges
+// and self-loops included
+static void stream_matches_triplets(bool directed) {
+    std::mt19937 rng(7);
+    int n = 60;
+    std::vector<edge> edges;
+    for (int i = 0; i < 400; ++i) {
+        edges.emplace_back(static_cast<int>(rng() % n), static_cast<int>(rng() % n), 1.0 + rng() % 5);
+    }
+    edges.emplace_back(3, 3, 2.0);
+    edges.emplace_back(4, 5, 1.0);
+    edges.emplace_back(4, 5, 1.5);
+
+    Sparse_Spectral_Graph expected(edges, n, directed);
+    auto streamed = Sparse_Spectral_Graph::from_edge_stream([&](auto&& sink) {
+        for (const auto& e : edges) sink(e.from, e.to, e.weight);
+    }, n, directed);
+    check(same_matrix(streamed.get_adjacency(), expected.get_adjacency()), "streamed adjacency matches triplets");
+    check(same_matrix(streamed.get_laplacian(), expected.get_laplacian()), "streamed Laplacian matches triplets");
+    check(streamed.get_adjacency().isCompressed(), "streamed adjacency is compressed");
+}
+
+// A star streamed in random order fills one column of every edge
+static void star_in_random_order() {
+    int leaves = 20000;
+    std::vector<int> order(leaves);
+    for (int i = 0; i < leaves; ++i) order[i] = i + 1;
+    std::shuffle(order.begin(), order.end(), std::mt19937(11));
+    auto star = Sparse_Spectral_Graph::from_edge_stream([&](auto&& sink) {
+        for (int leaf : order) sink(0, leaf, 1.0);
+    }, leaves + 1);
+    const auto& adjacency = star.get_adjacency();
+    check(adjacency.nonZeros() == 2 * leaves, "star has one entry per edge direction");
+    check(adjacency.col(0).sum() == leaves, "star centre column holds every leaf");
+    bool sorted = true;
+    for (Eigen::Index k = adjacency.outerIndexPtr()[0] + 1; k < adjacency.outerIndexPtr()[1]; ++k) {
+        sorted = sorted && adjacency.innerIndexPtr()[k - 1] < adjacency.innerIndexPtr()[k];
+    }
+    check(sorted, "star centre column is sorted by row");
+}
+
+// A stream that yields more, fewer or different edges on its second pass
+// throws rather than writing outside the slots the first pass counted
+static void changed_stream_throws() {
+    auto throws_on_replay = [](auto second_pass) {
+        int pass = 0;
+        try {
+            Sparse_Spectral_Graph::from_edge_stream([&](auto&& sink) {
+                sink(0, 1, 1.0);
+                sink(1, 2, 1.0);
+                if (pass++ > 0) second_pass(sink);
+            }, 4);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    check(throws_on_replay([](auto&& sink) { sink(0, 1, 1.0); }), "extra edge on replay throws");
+    check(throws_on_replay([](auto&& sink) { sink(2, 3, 1.0); }), "edge to an uncounted column throws");
+
+    int pass = 0;
+    bool threw = false;
+    try {
+        Sparse_Spectral_Graph::from_edge_stream([&](auto&& sink) {
+            if (pass++ == 0) sink(0, 1, 1.0);
+        }, 2, true);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    check(threw, "missing edge on replay throws");
+}
+
+int main() {
+    stream_matches_triplets(false);
+    stream_matches_triplets(true);
+    star_in_random_order();
+    changed_stream_throws();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "spectral_graph.hpp"
+#include "spectral_view.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+static bool same_values(const std::vector<double>& a, const std::vector<double>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::fabs(a[i] - b[i]) > 1e-9) return false;
+    }
+    return true;
+}
+
+// A self-loop adds its weight to the degree and nothing off the diagonal
+static void self_loop_matches_materialized_view() {
+    auto g = Spectral_Graph::from_edges({{0, 1, 1.0}, {1, 1, 2.0}, {1, 2, 1.0}}, 3);
+    Spectral_Graph_View<> view(g);
+    auto expected = view.materialize().eigenvalues();
+    check(same_values(view.eigenvalues(), expected), "view eigenvalues match materialize() with a self-loop");
+    check(same_values(view.eigenvalues(), g.eigenvalues()), "view eigenvalues match the graph with a self-loop");
+
+    std::vector<int> subset{1, 2};
+    Spectral_Graph_View<> induced(g, subset);
+    check(same_values(induced.eigenvalues(), induced.materialize().eigenvalues()),
+          "induced view eigenvalues match materialize() with a self-loop");
+}
+
+int main() {
+    self_loop_matches_materialized_view();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include "graph.hpp"
+
+// Graph for one or more writers and many concurrent readers.
+//
+// The nodes are hash-partitioned into blocks, and the graph state is an
+// immutable version: a version number plus one shared pointer per block,
+// each block mapping its nodes to shared adjacency lists. Readers take a
+// snapshot by copying the current version pointer and then query it without
+// any locking; a snapshot never changes, no matter what writers do
+// afterwards. Writers are serialized by a mutex. A write copies the node
+// table of each block it touches, which shares the adjacency lists, and
+// deep-copies only the adjacency lists it changes; the result is published
+// as a new version by swapping the version pointer. Old versions, blocks and
+// lists are freed when their last snapshot goes away.
+//
+// The version pointer is a std::atomic<std::shared_ptr>, so a snapshot is
+// one atomic load and readers never wait for each other or for a writer
+// working on its editor. libstdc++ implements that atomic with a lock bit in
+// the reference-count word, which ThreadSanitizer does not model; run the
+// sanitizer with "Spectral Analysis/tests/concurrent_graph.tsan.supp" to
+// silence its reports on the atomic's internals.
+template<NodeType node_type, EdgeDataType edge_data>
+class concurrent_graph {
+public:
+    static constexpr bool is_weighted = !std::is_void_v<edge_data>;
+
+    using adjacency_type = std::conditional_t<is_weighted,
+        std::unordered_map<node_type, std::conditional_t<is_weighted, edge_data, char>>,
+        std::unordered_set<node_type>>;
+
+private:
+    struct block {
+        std::unordered_map<node_type, std::shared_ptr<const adjacency_type>> adj_list;
+    };
+
+    struct version {
+        uint64_t number = 0;
+        size_t node_count = 0;
+        std::vector<std::shared_ptr<const block>> blocks;
+    };
+
+public:
+    // Consistent read-only view of one version
+    class snapshot {
+    public:
+        bool has_node(const node_type& node) const {
+            const auto& adj = block_for(node).adj_list;
+            return adj.find(node) != adj.end();
+        }
+
+        bool has_edge(const node_type& from, const node_type& to) const {
+            const auto& adj = block_for(from).adj_list;
+            auto it = adj.find(from);
+            if (it == adj.end()) return false;
+            return it->second->count(to) > 0;
+        }
+
+        const adjacency_type& get_adjacent(const node_type& node) const {
+            return *block_for(node).adj_list.at(node);
+        }
+
+        template<typename D = edge_data>
+        requires (!std::is_void_v<D>)
+        const D& get_edge_data(const node_type& from, const node_type& to) const {
+            return get_adjacent(from).at(to);
+        }
+
+        std::vector<node_type> get_nodes() const {
+            std::vector<node_type> nodes;
+            nodes.reserve(state->node_count);
+            for (const auto& b : state->blocks) {
+                for (const auto& pair : b->adj_list) {
+                    nodes.push_back(pair.first);
+                }
+            }
+            return nodes;
+        }
+
+        size_t node_count() const { return state->node_count; }
+
+        // Versions increase by one with every published write
+        uint64_t version_number() const { return state->number; }
+
+    private:
+        friend class concurrent_graph;
+
+        explicit snapshot(std::shared_ptr<const version> v) : state(std::move(v)) {}
+
+        const block& block_for(const node_type& node) const {
+            return *state->blocks[std::hash<node_type>{}(node) % state->blocks.size()];
+        }
+
+        std::shared_ptr<const version> state;
+    };
+
+    // Write access to a pending version. All changes made through one
+    // editor are published together, and the editor sees its own changes.
+    // The first change to a block copies that block's node table, and the
+    // first change to a node's adjacency list copies that list.
+    class editor {
+    public:
+        void add_node(const node_type& node) {
+            auto [it, inserted] = mutable_block(node).adj_list.try_emplace(node);
+            if (!inserted) return;
+            it->second = std::make_shared<adjacency_type>();
+            owned.insert(node);
+            ++pending->node_count;
+        }
+
+        void remove_node(const node_type& node) {
+            auto& own = mutable_block(node).adj_list;
+            auto it = own.find(node);
+            if (it == own.end()) return;
+
+#ifndef DIRECTED_GRAPH
+            // Undirected: only the neighbors' lists can refer to the node
+            std::vector<node_type> neighbors;
+            for (const auto& entry : *it->second) {
+                if constexpr (is_weighted) {
+                    neighbors.push_back(entry.first);
+                } else {
+                    neighbors.push_back(entry);
+                }
+            }
+            own.erase(it);
+            owned.erase(node);
+            for (const auto& neighbor : neighbors) {
+                if (neighbor != node) mutable_list(neighbor).erase(node);
+            }
+#else
+            own.erase(it);
+            owned.erase(node);
+            // Directed: incoming edges can be anywhere; copy only the lists that have one
+            std::vector<node_type> sources;
+            for (const auto& b : pending->blocks) {
+                for (const auto& pair : b->adj_list) {
+                    if (pair.second->count(node)) sources.push_back(pair.first);
+                }
+            }
+            for (const auto& source : sources) {
+                mutable_list(source).erase(node);
+            }
+#endif
+            --pending->node_count;
+        }
+
+        template<typename D = edge_data>
+        requires (std::is_void_v<D>)
+        void add_edge(const node_type& from, const node_type& to) {
+            add_node(from);
+            add_node(to);
+            mutable_list(from).insert(to);
+#ifndef DIRECTED_GRAPH
+            mutable_list(to).insert(from);
+#endif
+        }
+
+        template<typename D = edge_data>
+        requires (!std::is_void_v<D>)
+        void add_edge(const node_type& from, const node_type& to, const D& data) {
+            add_node(from);
+            add_node(to);
+            mutable_list(from)[to] = data;
+#ifndef DIRECTED_GRAPH
+            mutable_list(to)[from] = data;
+#endif
+        }
+
+        void remove_edge(const node_type& from, const node_type& to) {
+            erase_entry(from, to);
+#ifndef DIRECTED_GRAPH
+            erase_entry(to, from);
+#endif
+        }
+
+        // Read access to the pending state
+        const snapshot& view() const { return preview; }
+
+    private:
+        friend class concurrent_graph;
+
+        explicit editor(const version& base)
+            : pending(std::make_shared<version>(base)),
+              copied(base.blocks.size(), false),
+              preview(pending) {
+            ++pending->number;
+        }
+
+        void erase_entry(const node_type& from, const node_type& to) {
+            const auto& adj = pending->blocks[block_index(from)]->adj_list;
+            auto it = adj.find(from);
+            if (it == adj.end() || !it->second->count(to)) return;
+            mutable_list(from).erase(to);
+        }
+
+        size_t block_index(const node_type& node) const {
+            return std::hash<node_type>{}(node) % pending->blocks.size();
+        }
+
+        block& mutable_block(const node_type& node) {
+            return mutable_block_at(block_index(node));
+        }
+
+        // Copy-on-write: the first change to a block in this editor copies
+        // its node table, sharing the adjacency lists
+        block& mutable_block_at(size_t b) {
+            if (!copied[b]) {
+                pending->blocks[b] = std::make_shared<block>(*pending->blocks[b]);
+                copied[b] = true;
+            }
+            return const_cast<block&>(*pending->blocks[b]);
+        }
+
+        // Adjacency list of an existing node, copied on its first change in
+        // this editor. Lists made or copied here are never shared yet.
+        adjacency_type& mutable_list(const node_type& node) {
+            auto& list = mutable_block(node).adj_list.at(node);
+            if (owned.insert(node).second) {
+                list = std::make_shared<adjacency_type>(*list);
+            }
+            return const_cast<adjacency_type&>(*list);
+        }
+
+        std::shared_ptr<version> pending;
+        std::vector<bool> copied;
+        std::unordered_set<node_type> owned;
+        snapshot preview;
+    };
+
+    explicit concurrent_graph(size_t block_count = 64) {
+        if (block_count == 0) {
+            throw std::invalid_argument("Block count must be positive");
+        }
+        auto initial = std::make_shared<version>();
+        auto empty = std::make_shared<const block>();
+        initial->blocks.assign(block_count, empty);
+        current.store(std::move(initial));
+    }
+
+    concurrent_graph(const concurrent_graph&) = delete;
+    concurrent_graph& operator=(const concurrent_graph&) = delete;
+
+    // Current version, taken without locking
+    snapshot get_snapshot() const {
+        return snapshot(current.load(std::memory_order_acquire));
+    }
+
+    // Apply f(editor&) and publish all of its changes as one new version.
+    // If f throws, nothing is published. Besides the lists it changes, an
+    // update copies the node table of every block it touches, about
+    // node_count() / block count pointers each, so batching many changes
+    // into one update shares that cost.
+    template<typename Function>
+    uint64_t update(Function&& f) {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        editor e(*get_snapshot().state);
+        f(e);
+        uint64_t number = e.pending->number;
+        std::shared_ptr<const version> published(std::move(e.pending));
+        published = current.exchange(std::move(published), std::memory_order_acq_rel);
+        // The replaced version, if unreferenced, is freed here, after the swap
+        return number;
+    }
+
+    // Single-change writers, each publishing one version and paying one
+    // update's copying; prefer update() for batches
+    void add_node(const node_type& node) {
+        update([&](editor& e) { e.add_node(node); });
+    }
+
+    void remove_node(const node_type& node) {
+        update([&](editor& e) { e.remove_node(node); });
+    }
+
+    template<typename D = edge_data>
+    requires (std::is_void_v<D>)
+    void add_edge(const node_type& from, const node_type& to) {
+        update([&](editor& e) { e.add_edge(from, to); });
+    }
+
+    template<typename D = edge_data>
+    requires (!std::is_void_v<D>)
+    void add_edge(const node_type& from, const node_type& to, const D& data) {
+        update([&](editor& e) { e.add_edge(from, to, data); });
+    }
+
+    void remove_edge(const node_type& from, const node_type& to) {
+        update([&](editor& e) { e.remove_edge(from, to); });
+    }
+
+    // Single-query readers, each on the version current at the call
+    bool has_node(const node_type& node) const {
+        return get_snapshot().has_node(node);
+    }
+
+    bool has_edge(const node_type& from, const node_type& to) const {
+        return get_snapshot().has_edge(from, to);
+    }
+
+private:
+    std::atomic<std::shared_ptr<const version>> current;
+    std::mutex writer_mutex;
+};
@@ -2,6 +2,7 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include <type_traits>
 #include <concepts>
 
@@ -23,11 +24,12 @@ concept NodeType =
     std::copy_constructible<T> &&
     std::is_copy_assignable_v<T>;
 
-// Edge data co
+// Edge data must be copyable; void selects the unweighted specialization
 template<typename T>
 concept EdgeDataType = 
-    std::copy_constructible<T> &&
-    std::is_copy_assignable_v<T>;
+    std::is_void_v<T> ||
+    (std::copy_constructible<T> &&
+     std::is_copy_assignable_v<T>);
 
 // Primary template for weighted graphs
 template<NodeType node_type, EdgeDataType edge_data>
@@ -41,6 +43,8 @@ public:
     bool has_edge(const node_type& from, const node_type& to) const;
     const std::unordered_map<node_type, edge_data>& get_adjacent(const node_type& node) const;
     const edge_data& get_edge_data(const node_type& from, const node_type& to) const;
+    std::vector<node_type> get_nodes() const;
+    size_t node_count() const;
 
 private:
     std::unordered_map<node_type, std::unordered_map<node_type, edge_data>> adj_list;
@@ -57,6 +61,8 @@ public:
     bool has_node(const node_type& node) const;
     bool has_edge(const node_type& from, const node_type& to) const;
     const std::unordered_set<node_type>& get_adjacent(const node_type& node) const;
+    std::vector<node_type> get_nodes() const;
+    size_t node_count() const;
 
 private:
     std::unordered_map<node_type, std::unordered_set<node_type>> adj_list;
@@ -121,6 +127,21 @@ const edge_data& graph<node_type, edge_data>::get_edge_data(const node_type& fro
     return adj_list.at(from).at(to);
 }
 
+template<NodeType node_type, EdgeDataType edge_data>
+std::vector<node_type> graph<node_type, edge_data>::get_nodes() const {
+    std::vector<node_type> nodes;
+    nodes.reserve(adj_list.size());
+    for (const auto& pair : adj_list) {
+        nodes.push_back(pair.first);
+    }
+    return nodes;
+}
+
+template<NodeType node_type, EdgeDataType edge_data>
+size_t graph<node_type, edge_data>::node_count() const {
+    return adj_list.size();
+}
+
 // Method definitions for unweighted graphs
 
 template<NodeType node_type>
@@ -174,3 +195,18 @@ template<NodeType node_type>
 const std::unordered_set<node_type>& graph<node_type, void>::get_adjacent(const node_type& node) const {
     return adj_list.at(node);
 }
+
+template<NodeType node_type>
+std::vector<node_type> graph<node_type, void>::get_nodes() const {
+    std::vector<node_type> nodes;
+    nodes.reserve(adj_list.size());
+    for (const auto& pair : adj_list) {
+        nodes.push_back(pair.first);
+    }
+    return nodes;
+}
+
+template<NodeType node_type>
+size_t graph<node_type, void>::node_count() const {
+    return adj_list.size();
+}
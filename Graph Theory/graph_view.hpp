@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace graph_view_detail {
+
+    template<typename Entry>
+    const auto& adjacent_node(const Entry& entry) {
+        if constexpr (requires { entry.first; }) {
+            return entry.first;
+        } else {
+            return entry;
+        }
+    }
+
+    struct keep_all {
+        template<typename... Args>
+        constexpr bool operator()(const Args&...) const { return true; }
+    };
+
+}
+
+// Lazily filtered range over one adjacency container of an underlying graph.
+// Iterating yields the same entries as the graph's get_adjacent (nodes for
+// unweighted graphs, (node, data) pairs for weighted ones) minus the ones the
+// view hides; nothing is copied.
+template<typename Container, typename Keep>
+class adjacent_range {
+public:
+    using base_iterator = typename Container::const_iterator;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename Container::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        iterator() = default;
+        iterator(base_iterator it, base_iterator end, const Keep* keep) : it(it), end(end), keep(keep) {
+            skip();
+        }
+
+        reference operator*() const { return *it; }
+        pointer operator->() const { return &*it; }
+
+        iterator& operator++() {
+            ++it;
+            skip();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const iterator& other) const { return it == other.it; }
+        bool operator!=(const iterator& other) const { return it != other.it; }
+
+    private:
+        void skip() {
+            while (it != end && !(*keep)(*it)) ++it;
+        }
+
+        base_iterator it{};
+        base_iterator end{};
+        const Keep* keep = nullptr;
+    };
+
+    adjacent_range(const Container& container, Keep keep) : container(&container), keep(std::move(keep)) {}
+
+    iterator begin() const { return iterator(container->begin(), container->end(), &keep); }
+    iterator end() const { return iterator(container->end(), container->end(), &keep); }
+
+    bool empty() const { return begin() == end(); }
+
+    size_t size() const {
+        size_t count = 0;
+        for (auto it = begin(); it != end(); ++it) ++count;
+        return count;
+    }
+
+private:
+    const Container* container;
+    Keep keep;
+};
+
+// Read-only view of a graph restricted by a node predicate and an edge
+// predicate. The view holds a pointer to the graph and the two predicates;
+// queries are answered against the graph's own adjacency data. Edge
+// predicates are called as keep_edge(from, to) for unweighted graphs and as
+// keep_edge(from, to, data) for weighted ones.
+template<typename Graph, typename NodeFilter, typename EdgeFilter>
+class filtered_graph_view {
+public:
+    filtered_graph_view(const Graph& g, NodeFilter keep_node, EdgeFilter keep_edge)
+        : base(&g), keep_node(std::move(keep_node)), keep_edge(std::move(keep_edge)) {}
+
+    template<typename Node>
+    bool has_node(const Node& node) const {
+        return base->has_node(node) && keep_node(node);
+    }
+
+    template<typename Node>
+    bool has_edge(const Node& from, const Node& to) const {
+        if (!has_node(from) || !has_node(to)) return false;
+        const auto& adj = base->get_adjacent(from);
+        auto it = adj.find(to);
+        return it != adj.end() && accepts(from, *it);
+    }
+
+    template<typename Node>
+    auto get_adjacent(const Node& node) const {
+        if (!has_node(node)) {
+            throw std::out_of_range("Node not in view");
+        }
+        const auto& adj = base->get_adjacent(node);
+        auto keep = [this, node](const auto& entry) { return accepts(node, entry); };
+        return adjacent_range<std::decay_t<decltype(adj)>, decltype(keep)>(adj, keep);
+    }
+
+    template<typename Node>
+    const auto& get_edge_data(const Node& from, const Node& to) const {
+        if (!has_edge(from, to)) {
+            throw std::out_of_range("Edge not in view");
+        }
+        return base->get_edge_data(from, to);
+    }
+
+    auto get_nodes() const {
+        auto nodes = base->get_nodes();
+        std::erase_if(nodes, [this](const auto& node) { return !keep_node(node); });
+        return nodes;
+    }
+
+    size_t node_count() const { return get_nodes().size(); }
+
+    const Graph& underlying() const { return *base; }
+
+private:
+    template<typename Node, typename Entry>
+    bool accepts(const Node& from, const Entry& entry) const {
+        const auto& to = graph_view_detail::adjacent_node(entry);
+        if (!keep_node(to)) return false;
+        if constexpr (requires { entry.second; }) {
+            return keep_edge(from, to, entry.second);
+        } else {
+            return keep_edge(from, to);
+        }
+    }
+
+    const Graph* base;
+    NodeFilter keep_node;
+    EdgeFilter keep_edge;
+};
+
+// Subgraph induced by the nodes in `nodes`. The set is referenced, not
+// copied, and must outlive the view.
+template<NodeType node_type, EdgeDataType edge_data>
+auto induced_subgraph(const graph<node_type, edge_data>& g, const std::unordered_set<node_type>& nodes) {
+    auto keep_node = [&nodes](const node_type& node) { return nodes.count(node) > 0; };
+    return filtered_graph_view<graph<node_type, edge_data>, decltype(keep_node), graph_view_detail::keep_all>(
+        g, keep_node, {});
+}
+
+// All nodes, with only the edges accepted by `keep_edge`
+template<NodeType node_type, EdgeDataType edge_data, typename EdgeFilter>
+auto filter_edges(const graph<node_type, edge_data>& g, EdgeFilter keep_edge) {
+    return filtered_graph_view<graph<node_type, edge_data>, graph_view_detail::keep_all, EdgeFilter>(
+        g, {}, std::move(keep_edge));
+}
+
+// Breadth-first traversal over a graph or view, stopping `max_depth` hops
+// from the source. visit(node, depth) is called once per reached node.
+template<typename Graph, typename Node, typename Visitor>
+void breadth_first_search(const Graph& g, const Node& source, size_t max_depth, Visitor&& visit) {
+    if (!g.has_node(source)) return;
+
+    std::unordered_map<Node, size_t> depth;
+    std::queue<Node> queue;
+    depth.emplace(source, 0);
+    queue.push(source);
+
+    while (!queue.empty()) {
+        Node u = queue.front();
+        queue.pop();
+        size_t d = depth.at(u);
+        visit(u, d);
+        if (d == max_depth) continue;
+
+        for (const auto& entry : g.get_adjacent(u)) {
+            const auto& v = graph_view_detail::adjacent_node(entry);
+            if (depth.emplace(v, d + 1).second) {
+                queue.push(v);
+            }
+        }
+    }
+}
+
+template<typename Graph, typename Node, typename Visitor>
+void breadth_first_search(const Graph& g, const Node& source, Visitor&& visit) {
+    breadth_first_search(g, source, static_cast<size_t>(-1), std::forward<Visitor>(visit));
+}
+
+// Ego network: the subgraph induced by every node within `radius` hops of
+// `center`. Only the member set is stored; adjacency stays in the graph.
+template<NodeType node_type, EdgeDataType edge_data>
+class ego_network {
+public:
+    ego_network(const graph<node_type, edge_data>& g, const node_type& center, size_t radius)
+        : center_node(center), view(induced_subgraph(g, members)) {
+        breadth_first_search(g, center, radius, [this](const node_type& node, size_t) {
+            members.insert(node);
+        });
+    }
+
+    // The view refers to `members`, so the ego network stays where it was built
+    ego_network(const ego_network&) = delete;
+    ego_network& operator=(const ego_network&) = delete;
+
+    bool has_node(const node_type& node) const { return view.has_node(node); }
+    bool has_edge(const node_type& from, const node_type& to) const { return view.has_edge(from, to); }
+    auto get_adjacent(const node_type& node) const { return view.get_adjacent(node); }
+
+    template<typename D = edge_data>
+    requires (!std::is_void_v<D>)
+    const D& get_edge_data(const node_type& from, const node_type& to) const {
+        return view.get_edge_data(from, to);
+    }
+
+    std::vector<node_type> get_nodes() const { return {members.begin(), members.end()}; }
+    size_t node_count() const { return members.size(); }
+    const node_type& center() const { return center_node; }
+
+private:
+    node_type center_node;
+    std::unordered_set<node_type> members;
+    decltype(induced_subgraph(std::declval<const graph<node_type, edge_data>&>(),
+                              std::declval<const std::unordered_set<node_type>&>())) view;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker count used when a caller passes 0 threads
+inline unsigned default_thread_count() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+// Run f(begin, end, worker) over [0, count) in blocks of `grain` indices.
+// Blocks are handed out from a shared counter, so workers that finish early
+// keep taking blocks from the rest of the range instead of sitting idle.
+// The first exception thrown by a worker is rethrown on the calling thread.
+template<typename Function>
+void parallel_blocks(size_t count, size_t grain, unsigned threads, Function&& f) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+    if (threads == 0) threads = default_thread_count();
+
+    size_t blocks = (count + grain - 1) / grain;
+    unsigned workers = static_cast<unsigned>(std::min<size_t>(threads, blocks));
+
+    if (workers <= 1) {
+        for (size_t begin = 0; begin < count; begin += grain) {
+            f(begin, std::min(count, begin + grain), 0u);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto run = [&](unsigned worker) {
+        try {
+            for (;;) {
+                size_t begin = next.fetch_add(grain, std::memory_order_relaxed);
+                if (begin >= count) break;
+                f(begin, std::min(count, begin + grain), worker);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+            next.store(count, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (unsigned w = 1; w < workers; ++w) {
+        pool.emplace_back(run, w);
+    }
+    run(0);
+    for (auto& t : pool) t.join();
+
+    if (error) std::rethrow_exception(error);
+}
+
+// Run f(i) for every i in [0, count)
+template<typename Function>
+void parallel_for(size_t count, Function&& f, unsigned threads = 0, size_t grain = 1) {
+    parallel_blocks(count, grain, threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) f(i);
+    });
+}
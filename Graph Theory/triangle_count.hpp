@@ -0,0 +1,321 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "graph.hpp"
+#include "parallel.hpp"
+
+// Undirected adjacency snapshot in compressed sparse row form. Vertices are
+// renumbered by increasing degree (ties by insertion order) and every edge is
+// stored once, in the row of its lower-ranked endpoint, so each row holds
+// only the higher-ranked neighbors in ascending order.
+template<NodeType node_type>
+struct sorted_adjacency {
+    std::vector<node_type> nodes;        // rank -> node
+    std::vector<uint32_t> offsets;       // row r is neighbors[offsets[r], offsets[r + 1])
+    std::vector<uint32_t> neighbors;
+    std::vector<uint32_t> degree;        // full undirected degree per rank
+
+    size_t node_count() const { return nodes.size(); }
+    size_t edge_count() const { return neighbors.size(); }
+};
+
+// Triangle totals for a snapshot, indexed by rank
+struct triangle_census {
+    uint64_t triangles = 0;
+    std::vector<uint64_t> per_node;      // triangles through each vertex
+    std::vector<double> clustering;      // local clustering coefficient per vertex
+    double average_clustering = 0.0;
+    double transitivity = 0.0;           // 3 * triangles / connected triples
+};
+
+namespace triangle_detail {
+
+    template<typename Entry>
+    const auto& adjacent_node(const Entry& entry) {
+        if constexpr (requires { entry.first; }) {
+            return entry.first;
+        } else {
+            return entry;
+        }
+    }
+
+    // Merge-based intersection of two ascending, duplicate-free lists.
+    // on_match(x) is called for every common element; returns the count.
+    template<typename OnMatch>
+    uint64_t intersect_scalar(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, OnMatch&& on_match) {
+        uint64_t count = 0;
+        size_t i = 0, j = 0;
+        while (i < na && j < nb) {
+            if (a[i] < b[j]) {
+                ++i;
+            } else if (b[j] < a[i]) {
+                ++j;
+            } else {
+                on_match(a[i]);
+                ++count;
+                ++i;
+                ++j;
+            }
+        }
+        return count;
+    }
+
+    template<typename OnMatch>
+    void emit_mask(unsigned mask, const uint32_t* block, uint64_t& count, OnMatch& on_match) {
+        count += static_cast<uint64_t>(std::popcount(mask));
+        while (mask) {
+            on_match(block[std::countr_zero(mask)]);
+            mask &= mask - 1;
+        }
+    }
+
+    // Block-wise intersection: a block of `a` is compared against every
+    // rotation of a block of `b`, and the block with the smaller maximum is
+    // advanced. Matches of an `a` block are collected in a bit mask until the
+    // block is retired, so each common element is reported once. The scalar
+    // merge finishes whatever is left of the shorter tails.
+    template<typename OnMatch>
+    uint64_t intersect_sorted(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, OnMatch&& on_match) {
+        uint64_t count = 0;
+        size_t i = 0, j = 0;
+
+#if defined(__AVX2__)
+        const __m256i rotations[7] = {
+            _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0),
+            _mm256_setr_epi32(2, 3, 4, 5, 6, 7, 0, 1),
+            _mm256_setr_epi32(3, 4, 5, 6, 7, 0, 1, 2),
+            _mm256_setr_epi32(4, 5, 6, 7, 0, 1, 2, 3),
+            _mm256_setr_epi32(5, 6, 7, 0, 1, 2, 3, 4),
+            _mm256_setr_epi32(6, 7, 0, 1, 2, 3, 4, 5),
+            _mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6)
+        };
+        unsigned pending = 0;
+        while (i + 8 <= na && j + 8 <= nb) {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+            __m256i hit = _mm256_cmpeq_epi32(va, vb);
+            for (const auto& rotation : rotations) {
+                hit = _mm256_or_si256(hit, _mm256_cmpeq_epi32(va, _mm256_permutevar8x32_epi32(vb, rotation)));
+            }
+            pending |= static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(hit)));
+
+            uint32_t a_max = a[i + 7], b_max = b[j + 7];
+            if (a_max <= b_max) {
+                emit_mask(pending, a + i, count, on_match);
+                pending = 0;
+                i += 8;
+            }
+            if (b_max <= a_max) {
+                j += 8;
+            }
+        }
+        emit_mask(pending, a + i, count, on_match);
+#elif defined(__SSE2__) || defined(_M_X64)
+        unsigned pending = 0;
+        while (i + 4 <= na && j + 4 <= nb) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+            __m128i hit = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                             _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+                _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                             _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+            pending |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(hit)));
+
+            uint32_t a_max = a[i + 3], b_max = b[j + 3];
+            if (a_max <= b_max) {
+                emit_mask(pending, a + i, count, on_match);
+                pending = 0;
+                i += 4;
+            }
+            if (b_max <= a_max) {
+                j += 4;
+            }
+        }
+        emit_mask(pending, a + i, count, on_match);
+#endif
+
+        // Elements of the current `a` block already reported matched entries
+        // of `b` before index j, so the scalar merge cannot report them again
+        return count + intersect_scalar(a + i, na - i, b + j, nb - j, on_match);
+    }
+
+}
+
+// Build a degree-ordered snapshot of `g`. Edge directions and self loops are
+// ignored, so a graph compiled with DIRECTED_GRAPH is treated as its
+// underlying undirected graph.
+template<NodeType node_type, EdgeDataType edge_data>
+sorted_adjacency<node_type> make_sorted_adjacency(const graph<node_type, edge_data>& g, unsigned threads = 0) {
+    using triangle_detail::adjacent_node;
+
+    sorted_adjacency<node_type> snapshot;
+    std::vector<node_type> nodes = g.get_nodes();
+    size_t n = nodes.size();
+
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    std::vector<size_t> approx_degree(n);
+    for (size_t i = 0; i < n; ++i) {
+        approx_degree[i] = g.get_adjacent(nodes[i]).size();
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return approx_degree[a] < approx_degree[b];
+    });
+
+    std::unordered_map<node_type, uint32_t> rank;
+    rank.reserve(n);
+    snapshot.nodes.reserve(n);
+    for (uint32_t r = 0; r < n; ++r) {
+        snapshot.nodes.push_back(nodes[order[r]]);
+        rank.emplace(nodes[order[r]], r);
+    }
+
+    // Every adjacency entry lands in the row of its lower-ranked endpoint
+    std::vector<uint32_t> row_size(n + 1, 0);
+    for (uint32_t r = 0; r < n; ++r) {
+        for (const auto& entry : g.get_adjacent(snapshot.nodes[r])) {
+            uint32_t s = rank.at(adjacent_node(entry));
+            if (s != r) ++row_size[std::min(r, s)];
+        }
+    }
+
+    std::vector<uint32_t> offsets(n + 1, 0);
+    std::partial_sum(row_size.begin(), row_size.end() - 1, offsets.begin() + 1);
+    std::vector<uint32_t> raw(offsets[n]);
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (uint32_t r = 0; r < n; ++r) {
+        for (const auto& entry : g.get_adjacent(snapshot.nodes[r])) {
+            uint32_t s = rank.at(adjacent_node(entry));
+            if (s != r) raw[cursor[std::min(r, s)]++] = std::max(r, s);
+        }
+    }
+
+    // Sort each row and drop the second copy of every undirected edge
+    std::vector<uint32_t> unique_size(n, 0);
+    parallel_for(n, [&](size_t r) {
+        auto first = raw.begin() + offsets[r];
+        auto last = raw.begin() + offsets[r + 1];
+        std::sort(first, last);
+        unique_size[r] = static_cast<uint32_t>(std::unique(first, last) - first);
+    }, threads, 256);
+
+    snapshot.offsets.assign(n + 1, 0);
+    for (size_t r = 0; r < n; ++r) {
+        snapshot.offsets[r + 1] = snapshot.offsets[r] + unique_size[r];
+    }
+    snapshot.neighbors.resize(snapshot.offsets[n]);
+    snapshot.degree.assign(n, 0);
+    for (size_t r = 0; r < n; ++r) {
+        std::copy_n(raw.begin() + offsets[r], unique_size[r], snapshot.neighbors.begin() + snapshot.offsets[r]);
+        snapshot.degree[r] += unique_size[r];
+        for (uint32_t i = 0; i < unique_size[r]; ++i) {
+            ++snapshot.degree[raw[offsets[r] + i]];
+        }
+    }
+
+    return snapshot;
+}
+
+// Count every triangle of the snapshot once
+template<NodeType node_type>
+uint64_t count_triangles(const sorted_adjacency<node_type>& snapshot, unsigned threads = 0) {
+    if (threads == 0) threads = default_thread_count();
+    std::vector<uint64_t> partial(threads, 0);
+    const uint32_t* adj = snapshot.neighbors.data();
+    const auto& off = snapshot.offsets;
+
+    parallel_blocks(snapshot.node_count(), 64, threads, [&](size_t begin, size_t end, unsigned worker) {
+        uint64_t local = 0;
+        for (size_t u = begin; u < end; ++u) {
+            for (uint32_t e = off[u]; e < off[u + 1]; ++e) {
+                uint32_t v = adj[e];
+                local += triangle_detail::intersect_sorted(adj + off[u], off[u + 1] - off[u],
+                                                           adj + off[v], off[v + 1] - off[v],
+                                                           [](uint32_t) {});
+            }
+        }
+        partial[worker] += local;
+    });
+
+    return std::accumulate(partial.begin(), partial.end(), uint64_t{0});
+}
+
+// Count triangles through every vertex and derive clustering coefficients.
+// Each triangle u < v < w is found once, from the row of u, and credited to
+// all three corners in a per-worker counter array.
+template<NodeType node_type>
+triangle_census census_triangles(const sorted_adjacency<node_type>& snapshot, unsigned threads = 0) {
+    if (threads == 0) threads = default_thread_count();
+    size_t n = snapshot.node_count();
+    const uint32_t* adj = snapshot.neighbors.data();
+    const auto& off = snapshot.offsets;
+
+    std::vector<std::vector<uint64_t>> local(threads);
+
+    parallel_blocks(n, 64, threads, [&](size_t begin, size_t end, unsigned worker) {
+        auto& counts = local[worker];
+        if (counts.empty()) counts.assign(n, 0);
+        for (size_t u = begin; u < end; ++u) {
+            for (uint32_t e = off[u]; e < off[u + 1]; ++e) {
+                uint32_t v = adj[e];
+                uint64_t found = triangle_detail::intersect_sorted(
+                    adj + off[u], off[u + 1] - off[u],
+                    adj + off[v], off[v + 1] - off[v],
+                    [&](uint32_t w) { ++counts[w]; });
+                counts[u] += found;
+                counts[v] += found;
+            }
+        }
+    });
+
+    triangle_census census;
+    census.per_node.assign(n, 0);
+    for (const auto& counts : local) {
+        if (counts.empty()) continue;
+        for (size_t r = 0; r < n; ++r) census.per_node[r] += counts[r];
+    }
+
+    census.clustering.assign(n, 0.0);
+    uint64_t corner_total = 0;
+    double triples = 0.0, clustering_sum = 0.0;
+    for (size_t r = 0; r < n; ++r) {
+        corner_total += census.per_node[r];
+        double d = snapshot.degree[r];
+        double pairs = d * (d - 1.0) / 2.0;
+        triples += pairs;
+        if (pairs > 0.0) {
+            census.clustering[r] = static_cast<double>(census.per_node[r]) / pairs;
+            clustering_sum += census.clustering[r];
+        }
+    }
+
+    census.triangles = corner_total / 3;
+    census.average_clustering = n == 0 ? 0.0 : clustering_sum / static_cast<double>(n);
+    census.transitivity = triples == 0.0 ? 0.0 : 3.0 * static_cast<double>(census.triangles) / triples;
+    return census;
+}
+
+// Local clustering coefficient of every node of `g`
+template<NodeType node_type, EdgeDataType edge_data>
+std::unordered_map<node_type, double> clustering_coefficients(const graph<node_type, edge_data>& g, unsigned threads = 0) {
+    auto snapshot = make_sorted_adjacency(g, threads);
+    auto census = census_triangles(snapshot, threads);
+
+    std::unordered_map<node_type, double> result;
+    result.reserve(snapshot.node_count());
+    for (size_t r = 0; r < snapshot.node_count(); ++r) {
+        result.emplace(snapshot.nodes[r], census.clustering[r]);
+    }
+    return result;
+}